@@ -1,15 +1,185 @@
 #include <iostream>
+#include <cerrno>
+#include <chrono>
 #include <cmath>
 #include <cstdlib>
 #include <ctime>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <thread>
+#include "DiceEngine.h"
+#include "DiceDistribution.h"
+#include "DiceNotation.h"
 using namespace std;
-int main() { 
+
+// Build: g++ -O2 -std=c++17 -pthread Dice.cpp DiceEngine.cpp DiceDistribution.cpp DiceNotation.cpp -o dice
+// Usage: dice                      roll two dice once
+//        dice <rolls> [threads] [seed]
+//                                  simulate 2d6 rolls (1 to 2^48) and report rolls/sec;
+//                                  a given seed gives the same histogram on
+//                                  any thread count
+//        dice --dist "3d6+2d10" [--exact]
+//                                  exact PMF/CDF, mean and variance of a sum
+//        dice --roll "4d6kh3" [times]  roll a notation (kh/kl/dh/dl, !, d%)
+//        dice --bench "4d6kh3" ...     expressions/sec for each notation
+
+void reportInvalidNotation(const string& notation) {
+    cout << "Error: Invalid dice notation: " << notation << " (at most " << DicePool::maxDice
+         << " dice of up to " << DicePool::maxSides << " sides per term)" << endl;
+}
+
+// Counts are plain decimal digits up to maximum; strtoull alone wraps "-5"
+// around to a huge count
+bool readCount(const char* text, uint64_t maximum, uint64_t& count) {
+    if (*text < '0' || *text > '9') {
+        return false;
+    }
+    errno = 0;
+    char* end;
+    unsigned long long value = strtoull(text, &end, 10);
+    if (*end != '\0' || errno == ERANGE || value > maximum) {
+        return false;
+    }
+    count = value;
+    return true;
+}
+
+void reportInvalidCount(const char* name, const char* text, uint64_t minimum) {
+    cout << "Error: Invalid " << name << ": " << text << " (a whole number from " << minimum
+         << " to " << DiceSimulation::maxRolls << ")" << endl;
+}
+
+int showDistribution(const string& notation, bool exact) {
+    DicePool pool;
+    if (!DicePool::parse(notation, pool)) {
+        reportInvalidNotation(notation);
+        return 1;
+    }
+    if (!pool.isPlainSum()) {
+        cout << "Error: " << pool.toString() << " keeps or explodes dice; --dist takes plain sums!" << endl;
+        return 1;
+    }
+    if (!DiceDistribution::fits(pool) || (exact && !ExactDiceCounts::fits(pool))) {
+        cout << "Error: " << pool.toString() << " has too many outcomes for "
+             << (exact ? "exact counts" : "a distribution") << "!" << endl;
+        return 1;
+    }
+    
+    clock_t start = clock();
+    DiceDistribution distribution = DiceDistribution::of(pool);
+    double milliseconds = 1000.0 * (clock() - start) / CLOCKS_PER_SEC;
+    
+    cout << "Distribution of " << pool.toString() << " (" << milliseconds << " ms)" << endl;
+    cout << "Mean: " << distribution.mean() << ", variance: " << distribution.variance()
+         << ", std dev: " << sqrt(distribution.variance()) << endl;
+    
+    vector<double> pmf = distribution.pmf();
+    vector<double> cdf = distribution.cdf();
+    if (exact) {
+        ExactDiceCounts counts = ExactDiceCounts::of(pool);
+        cout << "Total outcomes: " << counts.totalOutcomes() << endl;
+        for (size_t i = 0; i < pmf.size(); i++) {
+            long long sum = distribution.getMinimum() + (long long)i;
+            cout << setw(6) << sum << "  " << counts.waysFor(sum) << endl;
+        }
+        return 0;
+    }
+    for (size_t i = 0; i < pmf.size(); i++) {
+        cout << setw(6) << distribution.getMinimum() + (long long)i << "  "
+             << scientific << setprecision(6) << pmf[i] << "  " << cdf[i] << defaultfloat << endl;
+    }
+    return 0;
+}
+
+int rollNotation(const string& notation, uint64_t times, Xoshiro256& generator) {
+    RollPlan plan;
+    if (!RollPlan::compile(notation, plan)) {
+        reportInvalidNotation(notation);
+        return 1;
+    }
+    PlanRoller roller(generator);
+    for (uint64_t i = 0; i < times; i++) {
+        cout << notation << ": " << roller.roll(plan) << endl;
+    }
+    return 0;
+}
+
+int benchmarkNotation(int argc, char* argv[], Xoshiro256& generator) {
+    const size_t rolls = 10000000;
+    const size_t batch = 4096;
+    vector<long long> results(batch);
+    PlanRoller roller(generator);
+    
+    for (int i = 2; i < argc; i++) {
+        RollPlan plan;
+        if (!RollPlan::compile(argv[i], plan)) {
+            reportInvalidNotation(argv[i]);
+            return 1;
+        }
+        
+        double total = 0;
+        auto start = chrono::steady_clock::now();
+        for (size_t done = 0; done < rolls; done += batch) {
+            roller.rollMany(plan, results.data(), batch);
+            total += results[0];
+        }
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        cout << setw(16) << plan.getText() << ": " << rolls / seconds / 1e6 << " M expressions/sec"
+             << " (checksum " << total << ")" << endl;
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[]) { 
 //write a program to roll a dice to get two random value btw 1 - 6
-srand(time(0));
-int dice1 = (rand() % 6) + 1;
-int dice2 = (rand() % 6) + 1;
-cout << "Dice 1: " << dice1 << endl;
-cout << "Dice 2: " << dice2 << endl;
+Xoshiro256 generator(uint64_t(time(0)) ^ (uint64_t(clock()) << 32));
+
+if (argc > 2 && string(argv[1]) == "--dist") {
+    return showDistribution(argv[2], argc > 3 && string(argv[3]) == "--exact");
+}
+
+if (argc > 2 && string(argv[1]) == "--roll") {
+    uint64_t times = 1;
+    if (argc > 3 && !readCount(argv[3], DiceSimulation::maxRolls, times)) {
+        reportInvalidCount("roll count", argv[3], 0);
+        return 1;
+    }
+    return rollNotation(argv[2], times, generator);
+}
+if (argc > 2 && string(argv[1]) == "--bench") {
+    return benchmarkNotation(argc, argv, generator);
+}
+
+if (argc < 2) {
+    int dice1 = generator.bounded(6) + 1;
+    int dice2 = generator.bounded(6) + 1;
+    cout << "Dice 1: " << dice1 << endl;
+    cout << "Dice 2: " << dice2 << endl;
+    return 0;
+}
+
+uint64_t rolls = 0;
+unsigned threads = argc > 2 ? unsigned(atoi(argv[2])) : thread::hardware_concurrency();
+if (!readCount(argv[1], DiceSimulation::maxRolls, rolls) || rolls == 0) {
+    reportInvalidCount("roll count", argv[1], 1);
+    cout << "Usage: " << argv[0] << " <rolls> [threads] [seed]" << endl;
+    return 1;
+}
+if (threads == 0) {
+    threads = 1;
+}
+
+uint64_t seed = argc > 3 ? strtoull(argv[3], nullptr, 10) : generator.next();
+DiceSimulation simulation(2, 6, seed);
+SimulationResult result = simulation.run(rolls, threads);
+
+cout << "Rolled 2d6 " << result.rolls << " times on " << threads << " thread(s), seed " << seed << endl;
+for (size_t sum = 2; sum < result.histogram.size(); sum++) {
+    cout << setw(3) << sum << ": " << setw(14) << result.histogram[sum] << "  "
+         << fixed << setprecision(4) << 100.0 * result.histogram[sum] / result.rolls << "%" << endl;
+}
+cout << defaultfloat << setprecision(6) << "Mean: " << result.mean() << endl;
+cout << "Time: " << result.seconds << " s, " << result.rollsPerSecond() / 1e6 << " M rolls/sec" << endl;
 return 0;
 }
-  
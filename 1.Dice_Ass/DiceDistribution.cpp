@@ -0,0 +1,515 @@
+#include "DiceDistribution.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <complex>
+#include <cstdlib>
+
+using namespace std;
+
+namespace {
+
+const size_t directConvolutionLimit = 512;   // smaller operand size
+const double pi = 3.14159265358979323846;
+
+// In-place iterative radix-2 FFT; size must be a power of two
+void fft(vector<complex<double>>& data, bool inverse) {
+    size_t n = data.size();
+    for (size_t i = 1, j = 0; i < n; i++) {
+        size_t bit = n >> 1;
+        for (; j & bit; bit >>= 1) {
+            j ^= bit;
+        }
+        j ^= bit;
+        if (i < j) {
+            swap(data[i], data[j]);
+        }
+    }
+
+    vector<complex<double>> twiddles(n / 2);
+    for (size_t k = 0; k < n / 2; k++) {
+        twiddles[k] = polar(1.0, (inverse ? 2.0 : -2.0) * pi * double(k) / double(n));
+    }
+    for (size_t length = 2; length <= n; length <<= 1) {
+        size_t half = length / 2;
+        size_t stride = n / length;
+        for (size_t start = 0; start < n; start += length) {
+            for (size_t k = 0; k < half; k++) {
+                complex<double> odd = data[start + k + half] * twiddles[k * stride];
+                data[start + k + half] = data[start + k] - odd;
+                data[start + k] += odd;
+            }
+        }
+    }
+}
+
+bool readNumber(const string& text, size_t& position, unsigned long long& value) {
+    size_t start = position;
+    value = 0;
+    while (position < text.size() && isdigit(static_cast<unsigned char>(text[position]))) {
+        value = value * 10 + unsigned(text[position] - '0');
+        if (value > 1000000000ULL) {
+            return false;
+        }
+        position++;
+    }
+    return position > start;
+}
+
+} // namespace
+
+// DicePool
+DicePool::DicePool() {
+    modifier = 0;
+}
+
+bool DicePool::parse(const string& notation, DicePool& pool) {
+    string text;
+    for (char c : notation) {
+        if (!isspace(static_cast<unsigned char>(c))) {
+            text += char(tolower(static_cast<unsigned char>(c)));
+        }
+    }
+    pool = DicePool();
+    if (text.empty()) {
+        return false;
+    }
+
+    size_t position = 0;
+    while (position < text.size()) {
+        int sign = 1;
+        if (text[position] == '+' || text[position] == '-') {
+            sign = text[position] == '-' ? -1 : 1;
+            position++;
+        } else if (position > 0) {
+            return false;
+        }
+
+        unsigned long long count = 1;
+        bool hasCount = readNumber(text, position, count);
+        if (!hasCount) {
+            count = 1;
+        }
+        if (position >= text.size() || text[position] != 'd') {
+            if (!hasCount) {
+                return false;
+            }
+            pool.modifier += sign * (long long)count;
+            continue;
+        }
+        position++;
+
+        unsigned long long sides = 0;
+        if (position < text.size() && text[position] == '%') {
+            sides = 100;
+            position++;
+        } else if (!readNumber(text, position, sides)) {
+            return false;
+        }
+        if (sides == 0 || sides > maxSides || count > maxDice) {
+            return false;
+        }
+
+        DiceTerm term;
+        term.count = sign * int(count);
+        term.sides = unsigned(sides);
+        term.keep = unsigned(count);
+        term.keepMode = KeepMode::All;
+        term.explode = false;
+
+        if (position < text.size() && text[position] == '!') {
+            term.explode = true;
+            position++;
+        }
+
+        // kh N, kl N, k N (= kh), dh N, dl N
+        if (position < text.size() && (text[position] == 'k' || text[position] == 'd')) {
+            bool drop = text[position] == 'd';
+            position++;
+            bool highest = true;
+            if (position < text.size() && (text[position] == 'h' || text[position] == 'l')) {
+                highest = text[position] == 'h';
+                position++;
+            } else if (drop) {
+                // A bare "d" here would read as another die
+                return false;
+            }
+            unsigned long long amount = 0;
+            if (!readNumber(text, position, amount) || amount > count) {
+                return false;
+            }
+            if (drop) {
+                // Dropping the highest keeps the lowest and vice versa
+                term.keep = unsigned(count - amount);
+                term.keepMode = highest ? KeepMode::Lowest : KeepMode::Highest;
+            } else {
+                term.keep = unsigned(amount);
+                term.keepMode = highest ? KeepMode::Highest : KeepMode::Lowest;
+            }
+            if (term.keep == count) {
+                term.keepMode = KeepMode::All;
+            }
+        }
+        if (count > 0) {
+            pool.terms.push_back(term);
+        }
+    }
+    return true;
+}
+
+string DicePool::toString() const {
+    string text;
+    for (const DiceTerm& term : terms) {
+        if (term.count < 0) {
+            text += "-";
+        } else if (!text.empty()) {
+            text += "+";
+        }
+        text += std::to_string(abs(term.count)) + "d" + std::to_string(term.sides);
+        if (term.explode) {
+            text += "!";
+        }
+        if (term.keepMode != KeepMode::All) {
+            text += (term.keepMode == KeepMode::Highest ? "kh" : "kl") + std::to_string(term.keep);
+        }
+    }
+    if (modifier != 0 || text.empty()) {
+        if (modifier >= 0 && !text.empty()) {
+            text += "+";
+        }
+        text += std::to_string(modifier);
+    }
+    return text;
+}
+
+bool DicePool::isPlainSum() const {
+    for (const DiceTerm& term : terms) {
+        if (term.explode || term.keepMode != KeepMode::All) {
+            return false;
+        }
+    }
+    return true;
+}
+
+unsigned long long DicePool::sumCount() const {
+    unsigned long long sums = 1;
+    for (const DiceTerm& term : terms) {
+        sums += (unsigned long long)abs(term.count) * (term.sides - 1);
+    }
+    return sums;
+}
+
+// DiceDistribution
+bool DiceDistribution::fits(const DicePool& pool) {
+    return pool.sumCount() <= maxSums;
+}
+
+DiceDistribution::DiceDistribution() {
+    minimum = 0;
+    probabilities.assign(1, 1.0);
+}
+
+DiceDistribution DiceDistribution::constant(long long value) {
+    DiceDistribution result;
+    result.minimum = value;
+    return result;
+}
+
+DiceDistribution DiceDistribution::die(unsigned sides) {
+    DiceDistribution result;
+    result.minimum = 1;
+    result.probabilities.assign(max(sides, 1u), 1.0 / max(sides, 1u));
+    return result;
+}
+
+DiceDistribution DiceDistribution::of(const DicePool& pool) {
+    DiceDistribution result = constant(pool.modifier);
+    for (const DiceTerm& term : pool.terms) {
+        DiceDistribution dice = die(term.sides).power(unsigned(abs(term.count)));
+        result = result + (term.count < 0 ? dice.negate() : dice);
+    }
+    return result;
+}
+
+DiceDistribution DiceDistribution::power(unsigned count) const {
+    DiceDistribution result;
+    DiceDistribution base = *this;
+    while (count > 0) {
+        if (count & 1) {
+            result = result + base;
+        }
+        count >>= 1;
+        if (count > 0) {
+            base = base + base;
+        }
+    }
+    return result;
+}
+
+DiceDistribution DiceDistribution::negate() const {
+    DiceDistribution result;
+    result.minimum = -getMaximum();
+    result.probabilities.assign(probabilities.rbegin(), probabilities.rend());
+    return result;
+}
+
+DiceDistribution DiceDistribution::operator+(const DiceDistribution& other) const {
+    DiceDistribution result;
+    result.minimum = minimum + other.minimum;
+    result.probabilities = convolve(probabilities, other.probabilities);
+    return result;
+}
+
+vector<double> DiceDistribution::convolve(const vector<double>& a, const vector<double>& b) {
+    if (a.empty() || b.empty()) {
+        return vector<double>();
+    }
+    size_t outputSize = a.size() + b.size() - 1;
+    vector<double> result(outputSize, 0.0);
+
+    if (min(a.size(), b.size()) <= directConvolutionLimit) {
+        for (size_t i = 0; i < a.size(); i++) {
+            for (size_t j = 0; j < b.size(); j++) {
+                result[i + j] += a[i] * b[j];
+            }
+        }
+        return result;
+    }
+
+    // Both operands in one complex transform: z = a + ib
+    size_t n = 1;
+    while (n < outputSize) {
+        n <<= 1;
+    }
+    vector<complex<double>> z(n);
+    for (size_t i = 0; i < a.size(); i++) {
+        z[i].real(a[i]);
+    }
+    for (size_t i = 0; i < b.size(); i++) {
+        z[i].imag(b[i]);
+    }
+    fft(z, false);
+
+    vector<complex<double>> product(n);
+    for (size_t k = 0; k < n; k++) {
+        complex<double> mirror = conj(z[(n - k) & (n - 1)]);
+        complex<double> transformA = (z[k] + mirror) * 0.5;
+        complex<double> transformB = (z[k] - mirror) * complex<double>(0.0, -0.5);
+        product[k] = transformA * transformB;
+    }
+    fft(product, true);
+
+    // Round-off leaves tiny negative tails; clamp and renormalize
+    double total = 0.0;
+    for (size_t i = 0; i < outputSize; i++) {
+        result[i] = max(0.0, product[i].real() / double(n));
+        total += result[i];
+    }
+    double massA = 0.0;
+    double massB = 0.0;
+    for (double value : a) {
+        massA += value;
+    }
+    for (double value : b) {
+        massB += value;
+    }
+    double expected = massA * massB;
+    if (total > 0.0) {
+        for (double& value : result) {
+            value *= expected / total;
+        }
+    }
+    return result;
+}
+
+long long DiceDistribution::getMinimum() const {
+    return minimum;
+}
+
+long long DiceDistribution::getMaximum() const {
+    return minimum + (long long)probabilities.size() - 1;
+}
+
+double DiceDistribution::probability(long long sum) const {
+    if (sum < minimum || sum > getMaximum()) {
+        return 0.0;
+    }
+    return probabilities[size_t(sum - minimum)];
+}
+
+double DiceDistribution::cumulative(long long sum) const {
+    if (sum < minimum) {
+        return 0.0;
+    }
+    double total = 0.0;
+    size_t last = size_t(min(sum, getMaximum()) - minimum);
+    for (size_t i = 0; i <= last; i++) {
+        total += probabilities[i];
+    }
+    return min(total, 1.0);
+}
+
+vector<double> DiceDistribution::pmf() const {
+    return probabilities;
+}
+
+vector<double> DiceDistribution::cdf() const {
+    vector<double> result(probabilities.size());
+    double total = 0.0;
+    for (size_t i = 0; i < probabilities.size(); i++) {
+        total += probabilities[i];
+        result[i] = min(total, 1.0);
+    }
+    return result;
+}
+
+double DiceDistribution::mean() const {
+    double total = 0.0;
+    for (size_t i = 0; i < probabilities.size(); i++) {
+        total += double(minimum + (long long)i) * probabilities[i];
+    }
+    return total;
+}
+
+double DiceDistribution::variance() const {
+    double center = mean();
+    double total = 0.0;
+    for (size_t i = 0; i < probabilities.size(); i++) {
+        double deviation = double(minimum + (long long)i) - center;
+        total += deviation * deviation * probabilities[i];
+    }
+    return total;
+}
+
+// ExactDiceCounts
+void ExactDiceCounts::add(BigCount& a, const BigCount& b) {
+    if (a.size() < b.size()) {
+        a.resize(b.size(), 0);
+    }
+    uint64_t carry = 0;
+    for (size_t i = 0; i < a.size(); i++) {
+        uint64_t sum = uint64_t(a[i]) + (i < b.size() ? b[i] : 0) + carry;
+        a[i] = uint32_t(sum);
+        carry = sum >> 32;
+        if (carry == 0 && i >= b.size()) {
+            break;
+        }
+    }
+    if (carry != 0) {
+        a.push_back(uint32_t(carry));
+    }
+}
+
+void ExactDiceCounts::subtract(BigCount& a, const BigCount& b) {
+    int64_t borrow = 0;
+    for (size_t i = 0; i < a.size(); i++) {
+        int64_t difference = int64_t(a[i]) - (i < b.size() ? int64_t(b[i]) : 0) - borrow;
+        borrow = difference < 0 ? 1 : 0;
+        a[i] = uint32_t(difference + (borrow << 32));
+        if (borrow == 0 && i >= b.size()) {
+            break;
+        }
+    }
+    while (!a.empty() && a.back() == 0) {
+        a.pop_back();
+    }
+}
+
+void ExactDiceCounts::multiply(BigCount& a, uint32_t factor) {
+    uint64_t carry = 0;
+    for (size_t i = 0; i < a.size(); i++) {
+        uint64_t product = uint64_t(a[i]) * factor + carry;
+        a[i] = uint32_t(product);
+        carry = product >> 32;
+    }
+    if (carry != 0) {
+        a.push_back(uint32_t(carry));
+    }
+}
+
+string ExactDiceCounts::toDecimal(BigCount value) {
+    if (value.empty()) {
+        return "0";
+    }
+    vector<uint32_t> groups;   // base 10^9, least significant first
+    while (!value.empty()) {
+        uint64_t remainder = 0;
+        for (size_t i = value.size(); i-- > 0;) {
+            uint64_t current = (remainder << 32) | value[i];
+            value[i] = uint32_t(current / 1000000000u);
+            remainder = current % 1000000000u;
+        }
+        groups.push_back(uint32_t(remainder));
+        while (!value.empty() && value.back() == 0) {
+            value.pop_back();
+        }
+    }
+    string text = std::to_string(groups.back());
+    for (size_t i = groups.size() - 1; i-- > 0;) {
+        string digits = std::to_string(groups[i]);
+        text += string(9 - digits.size(), '0') + digits;
+    }
+    return text;
+}
+
+// Convolves the counts with one uniform die: each new count is the sum of
+// the `sides` previous ones, kept as a running window
+void ExactDiceCounts::addDie(unsigned sides, bool negative) {
+    size_t oldSize = ways.size();
+    vector<BigCount> next(oldSize + sides - 1);
+    BigCount window;
+    for (size_t s = 0; s < next.size(); s++) {
+        if (s < oldSize) {
+            add(window, ways[s]);
+        }
+        if (s >= sides) {
+            subtract(window, ways[s - sides]);
+        }
+        next[s] = window;
+    }
+    ways.swap(next);
+    minimum += negative ? -(long long)sides : 1;
+    multiply(total, sides);
+}
+
+bool ExactDiceCounts::fits(const DicePool& pool) {
+    // The total, the largest count, has sum of count * log2(sides) bits
+    double bits = 0;
+    for (const DiceTerm& term : pool.terms) {
+        bits += abs(term.count) * log2(double(term.sides));
+    }
+    double limbs = floor(bits / 32) + 1;
+    return pool.sumCount() <= maxLimbs && double(pool.sumCount()) * limbs <= double(maxLimbs);
+}
+
+ExactDiceCounts ExactDiceCounts::of(const DicePool& pool) {
+    ExactDiceCounts result;
+    result.minimum = pool.modifier;
+    result.ways.assign(1, BigCount(1, 1));
+    result.total = BigCount(1, 1);
+    for (const DiceTerm& term : pool.terms) {
+        for (int i = 0; i < abs(term.count); i++) {
+            result.addDie(term.sides, term.count < 0);
+        }
+    }
+    return result;
+}
+
+long long ExactDiceCounts::getMinimum() const {
+    return minimum;
+}
+
+long long ExactDiceCounts::getMaximum() const {
+    return minimum + (long long)ways.size() - 1;
+}
+
+string ExactDiceCounts::waysFor(long long sum) const {
+    if (sum < minimum || sum > getMaximum()) {
+        return "0";
+    }
+    return toDecimal(ways[size_t(sum - minimum)]);
+}
+
+string ExactDiceCounts::totalOutcomes() const {
+    return toDecimal(total);
+}
@@ -0,0 +1,117 @@
+#ifndef DICEDISTRIBUTION_H
+#define DICEDISTRIBUTION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+enum class KeepMode : uint8_t {
+    All,
+    Highest,
+    Lowest
+};
+
+// A sum of dice such as "3d6+2d10+5" or "200d6-1d4".  Each term rolls
+// `count` dice with `sides` faces; a negative count subtracts them.
+// Rolled notation adds d% (100 sides), exploding dice ("3d6!") and keep
+// or drop ("4d6kh3", "2d20kl1", "5d10dl2", "k" alone meaning "kh"); the
+// distributions only take plain sums.
+struct DiceTerm {
+    int count;
+    unsigned sides;
+    unsigned keep;       // dice kept when keepMode is not All
+    KeepMode keepMode;
+    bool explode;
+};
+
+// One parser for every notation the program reads; RollPlan compiles its
+// steps from the pool.
+struct DicePool {
+    static const unsigned maxDice = 100000;      // per term
+    static const unsigned maxSides = 1000000;
+
+    std::vector<DiceTerm> terms;
+    long long modifier;
+
+    DicePool();
+    static bool parse(const std::string& notation, DicePool& pool);
+    std::string toString() const;
+    // No keep or exploding terms, so the distributions apply
+    bool isPlainSum() const;
+    // Number of possible sums, maximum - minimum + 1, for plain sums
+    unsigned long long sumCount() const;
+};
+
+// Exact probability mass function of a dice sum, stored as normalized
+// doubles from getMinimum() to getMaximum().  A pool of n identical dice is
+// built by exponentiation by squaring of the single-die polynomial; each
+// convolution is done directly for small operands and through an FFT once
+// both are large.  Probabilities never overflow; FFT products carry about
+// 1e-16 absolute error, so use ExactDiceCounts for far-tail values.
+// of() needs the pool to fit in maxSums sums; check fits() first.
+class DiceDistribution {
+private:
+    long long minimum;
+    std::vector<double> probabilities;
+
+public:
+    static const size_t maxSums = size_t(1) << 20;
+
+    DiceDistribution();   // certain sum of 0
+
+    static bool fits(const DicePool& pool);
+
+    static DiceDistribution constant(long long value);
+    static DiceDistribution die(unsigned sides);
+    static DiceDistribution of(const DicePool& pool);
+
+    DiceDistribution power(unsigned count) const;
+    DiceDistribution negate() const;
+    DiceDistribution operator+(const DiceDistribution& other) const;
+
+    long long getMinimum() const;
+    long long getMaximum() const;
+    double probability(long long sum) const;
+    double cumulative(long long sum) const;   // P(S <= sum)
+    std::vector<double> pmf() const;
+    std::vector<double> cdf() const;
+    double mean() const;
+    double variance() const;
+
+    // Polynomial product; switches to FFT above a size threshold
+    static std::vector<double> convolve(const std::vector<double>& a, const std::vector<double>& b);
+};
+
+// Arbitrary-precision number of ways to roll each sum, built one die at a
+// time with a sliding-window sum (additions and subtractions only).  The
+// counts grow with the dice, so of() takes pools whose sums times limbs per
+// count stay within maxLimbs (16 MB); check fits() first.
+class ExactDiceCounts {
+private:
+    typedef std::vector<uint32_t> BigCount;   // little-endian base 2^32
+
+    long long minimum;
+    std::vector<BigCount> ways;
+    BigCount total;
+
+    static void add(BigCount& a, const BigCount& b);
+    static void subtract(BigCount& a, const BigCount& b);   // requires a >= b
+    static void multiply(BigCount& a, uint32_t factor);
+    static std::string toDecimal(BigCount value);
+
+    void addDie(unsigned sides, bool negative);
+
+public:
+    static const size_t maxLimbs = size_t(1) << 22;
+
+    static bool fits(const DicePool& pool);
+    static ExactDiceCounts of(const DicePool& pool);
+
+    long long getMinimum() const;
+    long long getMaximum() const;
+    std::string waysFor(long long sum) const;
+    std::string totalOutcomes() const;
+};
+
+#endif // DICEDISTRIBUTION_H
@@ -0,0 +1,323 @@
+#include "DiceEngine.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+using namespace std;
+
+namespace {
+
+inline uint64_t rotl(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+uint64_t splitMix64(uint64_t& x) {
+    uint64_t z = (x += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+// Lemire's rejection threshold: 2^32 mod range
+inline uint32_t rejectionThreshold(uint32_t range) {
+    return uint32_t(0u - range) % range;
+}
+
+} // namespace
+
+// Xoshiro256
+Xoshiro256::Xoshiro256(uint64_t seed) {
+    for (int i = 0; i < 4; i++) {
+        state[i] = splitMix64(seed);
+    }
+}
+
+uint64_t Xoshiro256::next() {
+    uint64_t result = rotl(state[1] * 5, 7) * 9;
+    uint64_t t = state[1] << 17;
+    state[2] ^= state[0];
+    state[3] ^= state[1];
+    state[1] ^= state[2];
+    state[0] ^= state[3];
+    state[2] ^= t;
+    state[3] = rotl(state[3], 45);
+    return result;
+}
+
+uint32_t Xoshiro256::bounded(uint32_t range) {
+    uint64_t m = (next() >> 32) * range;
+    uint32_t low = uint32_t(m);
+    if (low < range) {
+        uint32_t threshold = rejectionThreshold(range);
+        while (low < threshold) {
+            m = (next() >> 32) * range;
+            low = uint32_t(m);
+        }
+    }
+    return uint32_t(m >> 32);
+}
+
+void Xoshiro256::jump() {
+    static const uint64_t polynomial[4] = {
+        0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL,
+        0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL
+    };
+    uint64_t jumped[4] = {0, 0, 0, 0};
+    for (int i = 0; i < 4; i++) {
+        for (int bit = 0; bit < 64; bit++) {
+            if (polynomial[i] & (uint64_t(1) << bit)) {
+                for (int j = 0; j < 4; j++) {
+                    jumped[j] ^= state[j];
+                }
+            }
+            next();
+        }
+    }
+    memcpy(state, jumped, sizeof(state));
+}
+
+// BulkRoller
+BulkRoller::BulkRoller(Xoshiro256& source) {
+    for (size_t lane = 0; lane < lanes; lane++) {
+        for (int i = 0; i < 4; i++) {
+            state[i][lane] = source.state[i];
+        }
+        source.jump();
+    }
+}
+
+void BulkRoller::step(uint64_t* out) {
+    uint64_t* s0 = state[0];
+    uint64_t* s1 = state[1];
+    uint64_t* s2 = state[2];
+    uint64_t* s3 = state[3];
+    for (size_t i = 0; i < lanes; i++) {
+        // x * 5 and x * 9 as shift-adds so the loop vectorizes without a
+        // 64-bit vector multiply
+        uint64_t x = (s1[i] << 2) + s1[i];
+        x = rotl(x, 7);
+        out[i] = (x << 3) + x;
+        uint64_t t = s1[i] << 17;
+        s2[i] ^= s0[i];
+        s3[i] ^= s1[i];
+        s1[i] ^= s2[i];
+        s0[i] ^= s3[i];
+        s2[i] ^= t;
+        s3[i] = rotl(s3[i], 45);
+    }
+}
+
+void BulkRoller::fill(uint32_t* out, size_t count, uint32_t sides) {
+    const size_t width = 2 * lanes;
+    const uint32_t threshold = rejectionThreshold(sides);
+    uint64_t draws[lanes];
+    uint32_t faces[width];
+    uint32_t low[width];
+
+    size_t produced = 0;
+    while (produced < count) {
+        step(draws);
+        uint32_t rejected = 0;
+        for (size_t i = 0; i < lanes; i++) {
+            uint64_t first = uint64_t(uint32_t(draws[i])) * sides;
+            uint64_t second = (draws[i] >> 32) * sides;
+            faces[i] = uint32_t(first >> 32) + 1;
+            faces[i + lanes] = uint32_t(second >> 32) + 1;
+            low[i] = uint32_t(first);
+            low[i + lanes] = uint32_t(second);
+            rejected |= uint32_t(low[i] < threshold) | uint32_t(low[i + lanes] < threshold);
+        }
+
+        if (rejected == 0 && count - produced >= width) {
+            memcpy(out + produced, faces, sizeof(faces));
+            produced += width;
+            continue;
+        }
+        for (size_t i = 0; i < width && produced < count; i++) {
+            if (low[i] >= threshold) {
+                out[produced++] = faces[i];
+            }
+        }
+    }
+}
+
+void BulkRoller::fillBits(uint32_t* out, size_t count) {
+    uint64_t draws[lanes];
+    for (size_t produced = 0; produced < count; produced += 2 * lanes) {
+        step(draws);
+        for (size_t i = 0; i < lanes; i++) {
+            out[produced + i] = uint32_t(draws[i]);
+            out[produced + lanes + i] = uint32_t(draws[i] >> 32);
+        }
+    }
+}
+
+// PhiloxRoller
+namespace {
+
+const uint32_t philoxMultiplier0 = 0xD2511F53u;
+const uint32_t philoxMultiplier1 = 0xCD9E8D57u;
+const uint32_t philoxWeyl0 = 0x9E3779B9u;
+const uint32_t philoxWeyl1 = 0xBB67AE85u;
+
+} // namespace
+
+PhiloxRoller::PhiloxRoller(uint64_t seed, uint64_t stream) {
+    key[0] = uint32_t(seed);
+    key[1] = uint32_t(seed >> 32);
+    streamLow = uint32_t(stream);
+    streamHigh = uint32_t(stream >> 32);
+    position = 0;
+}
+
+// Four 32-bit outputs for each of `lanes` consecutive counters, lane-major
+void PhiloxRoller::step(uint32_t* out) {
+    uint32_t c0[lanes], c1[lanes], c2[lanes], c3[lanes];
+    for (size_t i = 0; i < lanes; i++) {
+        uint64_t counter = position + i;
+        c0[i] = uint32_t(counter);
+        c1[i] = uint32_t(counter >> 32);
+        c2[i] = streamLow;
+        c3[i] = streamHigh;
+    }
+    position += lanes;
+
+    uint32_t k0 = key[0];
+    uint32_t k1 = key[1];
+    for (int round = 0; round < 10; round++) {
+        for (size_t i = 0; i < lanes; i++) {
+            uint64_t product0 = uint64_t(philoxMultiplier0) * c0[i];
+            uint64_t product1 = uint64_t(philoxMultiplier1) * c2[i];
+            uint32_t next0 = uint32_t(product1 >> 32) ^ c1[i] ^ k0;
+            uint32_t next2 = uint32_t(product0 >> 32) ^ c3[i] ^ k1;
+            c1[i] = uint32_t(product1);
+            c3[i] = uint32_t(product0);
+            c0[i] = next0;
+            c2[i] = next2;
+        }
+        k0 += philoxWeyl0;
+        k1 += philoxWeyl1;
+    }
+
+    for (size_t i = 0; i < lanes; i++) {
+        out[i] = c0[i];
+        out[i + lanes] = c1[i];
+        out[i + 2 * lanes] = c2[i];
+        out[i + 3 * lanes] = c3[i];
+    }
+}
+
+void PhiloxRoller::fill(uint32_t* out, size_t count, uint32_t sides) {
+    const size_t width = 4 * lanes;
+    const uint32_t threshold = rejectionThreshold(sides);
+    uint32_t draws[width];
+    uint32_t faces[width];
+    uint32_t low[width];
+
+    size_t produced = 0;
+    while (produced < count) {
+        step(draws);
+        uint32_t rejected = 0;
+        for (size_t i = 0; i < width; i++) {
+            uint64_t m = uint64_t(draws[i]) * sides;
+            faces[i] = uint32_t(m >> 32) + 1;
+            low[i] = uint32_t(m);
+            rejected |= uint32_t(low[i] < threshold);
+        }
+
+        if (rejected == 0 && count - produced >= width) {
+            memcpy(out + produced, faces, sizeof(faces));
+            produced += width;
+            continue;
+        }
+        for (size_t i = 0; i < width && produced < count; i++) {
+            if (low[i] >= threshold) {
+                out[produced++] = faces[i];
+            }
+        }
+    }
+}
+
+// SimulationResult
+double SimulationResult::rollsPerSecond() const {
+    return seconds > 0 ? rolls / seconds : 0;
+}
+
+double SimulationResult::mean() const {
+    double total = 0;
+    for (size_t sum = 0; sum < histogram.size(); sum++) {
+        total += double(sum) * double(histogram[sum]);
+    }
+    return rolls > 0 ? total / double(rolls) : 0;
+}
+
+// DiceSimulation
+DiceSimulation::DiceSimulation(unsigned diceCount, unsigned sides, uint64_t seed) {
+    this->diceCount = max(diceCount, 1u);
+    this->sides = max(sides, 1u);
+    this->seed = seed;
+}
+
+SimulationResult DiceSimulation::run(uint64_t rolls, unsigned threads) {
+    const size_t bins = size_t(diceCount) * sides + 1;
+    // Rounded up without forming rolls + blockRolls - 1, which can wrap
+    const uint64_t blocks = rolls / blockRolls + (rolls % blockRolls != 0);
+    threads = unsigned(max<uint64_t>(1, min<uint64_t>(threads, blocks)));
+    vector<vector<uint64_t>> counts(threads);
+
+    auto worker = [&](unsigned index) {
+        const size_t batch = 4096;
+        const unsigned dice = diceCount;
+        vector<uint32_t> faces(batch * dice);
+        // Four interleaved copies so consecutive equal sums do not serialize
+        // on the same counter
+        vector<uint64_t> local(4 * bins, 0);
+
+        for (uint64_t block = index; block < blocks; block += threads) {
+            PhiloxRoller roller(seed, block);
+            uint64_t share = min(blockRolls, rolls - block * blockRolls);
+            while (share > 0) {
+                size_t n = size_t(min<uint64_t>(share, batch));
+                roller.fill(faces.data(), n * dice, sides);
+                const uint32_t* face = faces.data();
+                for (size_t r = 0; r < n; r++) {
+                    uint32_t sum = 0;
+                    for (unsigned d = 0; d < dice; d++) {
+                        sum += face[d];
+                    }
+                    face += dice;
+                    local[(r & 3) * bins + sum]++;
+                }
+                share -= n;
+            }
+        }
+
+        counts[index].assign(bins, 0);
+        for (size_t copy = 0; copy < 4; copy++) {
+            for (size_t sum = 0; sum < bins; sum++) {
+                counts[index][sum] += local[copy * bins + sum];
+            }
+        }
+    };
+
+    auto start = chrono::steady_clock::now();
+    vector<thread> pool;
+    for (unsigned t = 0; t < threads; t++) {
+        pool.emplace_back(worker, t);
+    }
+    for (auto& running : pool) {
+        running.join();
+    }
+
+    SimulationResult result;
+    result.histogram.assign(bins, 0);
+    for (const auto& local : counts) {
+        for (size_t sum = 0; sum < local.size(); sum++) {
+            result.histogram[sum] += local[sum];
+        }
+    }
+    result.rolls = rolls;
+    result.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    return result;
+}
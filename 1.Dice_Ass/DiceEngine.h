@@ -0,0 +1,109 @@
+#ifndef DICEENGINE_H
+#define DICEENGINE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// xoshiro256** (Blackman & Vigna), seeded through splitmix64
+class Xoshiro256 {
+private:
+    uint64_t state[4];
+
+    friend class BulkRoller;
+
+public:
+    explicit Xoshiro256(uint64_t seed);
+
+    uint64_t next();
+
+    // Uniform integer in [0, range) using Lemire's multiply-shift with
+    // rejection, so there is no modulo bias
+    uint32_t bounded(uint32_t range);
+
+    // Advances the stream by 2^128 steps; successive jumps give
+    // non-overlapping streams for parallel workers
+    void jump();
+};
+
+// Several xoshiro256** streams stepped in lockstep (structure of arrays) so
+// the state update and the bounded-integer multiply vectorize.  Each 64-bit
+// draw yields two 32-bit samples.  Cache-line aligned so per-thread rollers
+// never share a line.
+class alignas(64) BulkRoller {
+public:
+    static const size_t lanes = 8;
+
+private:
+    uint64_t state[4][lanes];
+
+    void step(uint64_t* out);
+
+public:
+    // Takes `lanes` consecutive jumps from the source generator
+    explicit BulkRoller(Xoshiro256& source);
+
+    // Faces 1..sides for count dice
+    void fill(uint32_t* out, size_t count, uint32_t sides);
+
+    // Raw 32-bit draws; count is rounded up to a multiple of 2 * lanes
+    void fillBits(uint32_t* out, size_t count);
+};
+
+// Philox4x32-10 (Salmon et al.), a counter-based generator: the output for
+// (key, counter) is computed directly, so any stream can start anywhere
+// without stepping through earlier values.  A PhiloxRoller reads stream
+// `stream` of the key derived from `seed`; lanes counters are evaluated in
+// lockstep so the rounds vectorize.
+class PhiloxRoller {
+public:
+    static const size_t lanes = 8;
+
+private:
+    uint32_t key[2];
+    uint32_t streamLow;
+    uint32_t streamHigh;
+    uint64_t position;
+
+    void step(uint32_t* out);
+
+public:
+    PhiloxRoller(uint64_t seed, uint64_t stream);
+
+    // Faces 1..sides for count dice, continuing the stream
+    void fill(uint32_t* out, size_t count, uint32_t sides);
+};
+
+struct SimulationResult {
+    std::vector<uint64_t> histogram;   // histogram[sum] for sums 0 .. dice*sides
+    uint64_t rolls;
+    double seconds;
+
+    double rollsPerSecond() const;
+    double mean() const;
+};
+
+// Rolls diceCount dice with `sides` faces `rolls` times across threads and
+// counts the sums.  The rolls are cut into fixed blocks of blockRolls and
+// block b always draws from Philox stream b of the seed, whatever thread
+// runs it, so a given seed produces the same histogram bit for bit on any
+// thread count.  Threads take blocks t, t + threads, ... with no shared
+// state; each fills its own histogram and they are merged at the end.
+// run() takes at most maxRolls rolls (days of work at current speeds).
+class DiceSimulation {
+public:
+    static constexpr uint64_t blockRolls = uint64_t(1) << 16;
+    static constexpr uint64_t maxRolls = uint64_t(1) << 48;
+
+private:
+    unsigned diceCount;
+    unsigned sides;
+    uint64_t seed;
+
+public:
+    DiceSimulation(unsigned diceCount, unsigned sides, uint64_t seed);
+
+    SimulationResult run(uint64_t rolls, unsigned threads);
+};
+
+#endif // DICEENGINE_H
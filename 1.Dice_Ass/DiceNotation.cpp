@@ -0,0 +1,157 @@
+#include "DiceNotation.h"
+#include <algorithm>
+#include <cstdlib>
+
+using namespace std;
+
+// RollPlan
+RollPlan::RollPlan() {
+    modifier = 0;
+    scratchSize = 0;
+}
+
+bool RollPlan::compile(const string& notation, RollPlan& plan) {
+    plan = RollPlan();
+    plan.text = notation;
+    DicePool pool;
+    if (!DicePool::parse(notation, pool)) {
+        return false;
+    }
+
+    plan.modifier = pool.modifier;
+    for (const DiceTerm& term : pool.terms) {
+        RollStep step;
+        step.count = uint32_t(abs(term.count));
+        step.sides = term.sides;
+        step.keep = term.keep;
+        step.sign = term.count < 0 ? -1 : 1;
+        step.keepMode = term.keepMode;
+        step.explode = term.explode;
+        if (step.keepMode != KeepMode::All) {
+            plan.scratchSize = max(plan.scratchSize, step.count);
+        }
+        plan.steps.push_back(step);
+    }
+    return true;
+}
+
+const string& RollPlan::getText() const {
+    return text;
+}
+
+const vector<RollStep>& RollPlan::getSteps() const {
+    return steps;
+}
+
+long long RollPlan::getModifier() const {
+    return modifier;
+}
+
+uint32_t RollPlan::getScratchSize() const {
+    return scratchSize;
+}
+
+// PlanRoller
+PlanRoller::PlanRoller(Xoshiro256& generator) : source(generator) {
+    bits.resize(bufferSize);
+    cursor = bufferSize;
+}
+
+// Lemire's bounded integer over the buffered bits
+uint32_t PlanRoller::face(uint32_t sides) {
+    if (cursor == bufferSize) {
+        source.fillBits(bits.data(), bufferSize);
+        cursor = 0;
+    }
+    uint64_t m = uint64_t(bits[cursor++]) * sides;
+    uint32_t low = uint32_t(m);
+    if (low < sides) {
+        uint32_t threshold = uint32_t(0u - sides) % sides;
+        while (low < threshold) {
+            if (cursor == bufferSize) {
+                source.fillBits(bits.data(), bufferSize);
+                cursor = 0;
+            }
+            m = uint64_t(bits[cursor++]) * sides;
+            low = uint32_t(m);
+        }
+    }
+    return uint32_t(m >> 32) + 1;
+}
+
+uint32_t PlanRoller::rollDie(uint32_t sides, bool explode) {
+    uint32_t value = face(sides);
+    if (!explode) {
+        return value;
+    }
+    uint32_t total = value;
+    for (uint32_t i = 0; value == sides && i < RollPlan::maxExplosions; i++) {
+        value = face(sides);
+        total += value;
+    }
+    return total;
+}
+
+long long PlanRoller::rollKept(const RollStep& step) {
+    uint32_t* dice = scratch.data();
+    uint32_t count = step.count;
+    long long sum = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        dice[i] = rollDie(step.sides, step.explode);
+        sum += dice[i];
+    }
+
+    uint32_t drop = count - step.keep;
+    bool highest = step.keepMode == KeepMode::Highest;
+    // One die in or out: a single min/max scan
+    if (drop == 1 || step.keep == 1) {
+        bool findMinimum = highest == (drop == 1);
+        uint32_t extreme = dice[0];
+        for (uint32_t i = 1; i < count; i++) {
+            extreme = findMinimum ? min(extreme, dice[i]) : max(extreme, dice[i]);
+        }
+        return drop == 1 ? sum - extreme : extreme;
+    }
+
+    // Otherwise partition the dropped dice to the front
+    if (highest) {
+        nth_element(dice, dice + drop, dice + count);
+    } else {
+        nth_element(dice, dice + drop, dice + count, greater<uint32_t>());
+    }
+    long long kept = 0;
+    for (uint32_t i = drop; i < count; i++) {
+        kept += dice[i];
+    }
+    return kept;
+}
+
+void PlanRoller::reserve(const RollPlan& plan) {
+    if (scratch.size() < plan.getScratchSize()) {
+        scratch.resize(plan.getScratchSize());
+    }
+}
+
+long long PlanRoller::roll(const RollPlan& plan) {
+    reserve(plan);
+    long long total = plan.getModifier();
+    for (const RollStep& step : plan.getSteps()) {
+        long long value = 0;
+        if (step.keepMode == KeepMode::All) {
+            for (uint32_t i = 0; i < step.count; i++) {
+                value += rollDie(step.sides, step.explode);
+            }
+        } else {
+            value = rollKept(step);
+        }
+        total += step.sign * value;
+    }
+    return total;
+}
+
+void PlanRoller::rollMany(const RollPlan& plan, long long* out, size_t count) {
+    reserve(plan);
+    for (size_t i = 0; i < count; i++) {
+        out[i] = roll(plan);
+    }
+}
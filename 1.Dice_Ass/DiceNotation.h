@@ -0,0 +1,70 @@
+#ifndef DICENOTATION_H
+#define DICENOTATION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "DiceDistribution.h"
+#include "DiceEngine.h"
+
+// One "NdS" group of a plan.  Exploding dice reroll on the top face and
+// add the new roll (up to maxExplosions times per die); keep selects the
+// highest or lowest `keep` dice afterwards.
+struct RollStep {
+    uint32_t count;
+    uint32_t sides;
+    uint32_t keep;
+    int32_t sign;
+    KeepMode keepMode;
+    bool explode;
+};
+
+// Standard dice notation compiled once into a flat list of steps:
+//   4d6kh3   2d20+5   3d6!   d%   2d20kl1   5d10dl2   1d8+1d6-2
+// DicePool::parse reads the notation; compile lays its terms out for the
+// roller.
+class RollPlan {
+private:
+    std::string text;
+    std::vector<RollStep> steps;
+    long long modifier;
+    uint32_t scratchSize;   // dice that must be held for keep selection
+
+public:
+    static const uint32_t maxExplosions = 100;
+
+    RollPlan();
+    static bool compile(const std::string& notation, RollPlan& plan);
+
+    const std::string& getText() const;
+    const std::vector<RollStep>& getSteps() const;
+    long long getModifier() const;
+    uint32_t getScratchSize() const;
+};
+
+// Executes plans without allocating: random bits come from a reused
+// bulk buffer (refilled by BulkRoller) and keep selection works in a
+// scratch buffer that only grows the first time a larger plan is seen.
+class PlanRoller {
+private:
+    static const size_t bufferSize = 4096;
+
+    BulkRoller source;
+    std::vector<uint32_t> bits;
+    size_t cursor;
+    std::vector<uint32_t> scratch;
+
+    uint32_t face(uint32_t sides);
+    uint32_t rollDie(uint32_t sides, bool explode);
+    long long rollKept(const RollStep& step);
+
+public:
+    explicit PlanRoller(Xoshiro256& generator);
+
+    void reserve(const RollPlan& plan);
+    long long roll(const RollPlan& plan);
+    void rollMany(const RollPlan& plan, long long* out, size_t count);
+};
+
+#endif // DICENOTATION_H
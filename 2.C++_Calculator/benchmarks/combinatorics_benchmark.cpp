@@ -0,0 +1,130 @@
+// Combinatorics benchmark: table-backed factorial and nCr against the loops
+// callers wrote by hand (1..n on every call), gamma against std::tgamma with
+// the largest relative difference, gamma and logGamma at edge cases (ulps
+// from std::tgamma / std::lgamma), and exact nCr digits at a few sizes.
+// Build: g++ -O2 -std=c++17 -pthread -I./core benchmarks/combinatorics_benchmark.cpp core/*.cpp -o combinatorics_benchmark
+// Usage: combinatorics_benchmark [calls]
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "../core/Combinatorics.h"
+#include "../core/NumberTheory.h"
+
+using namespace std;
+
+template <typename Body>
+double bestSeconds(int runs, Body body) {
+    double best = 1e30;
+    for (int run = 0; run < runs; run++) {
+        auto start = chrono::steady_clock::now();
+        body();
+        best = min(best, chrono::duration<double>(chrono::steady_clock::now() - start).count());
+    }
+    return best;
+}
+
+double loopFactorial(double n) {
+    double result = 1;
+    for (double i = 2; i <= n; i++) {
+        result *= i;
+    }
+    return result;
+}
+
+double loopCombinations(double n, double k) {
+    return loopFactorial(n) / (loopFactorial(k) * loopFactorial(n - k));
+}
+
+// Distance in units in the last place, subnormals included
+double ulps(double value, double reference) {
+    if (value == reference || (isnan(value) && isnan(reference))) {
+        return 0;
+    }
+    if (!isfinite(value) || !isfinite(reference)) {
+        return HUGE_VAL;
+    }
+    int exponent;
+    frexp(reference, &exponent);
+    return fabs(value - reference) / ldexp(1.0, max(exponent, -1021) - 53);
+}
+
+int main(int argc, char* argv[]) {
+    size_t calls = argc > 1 ? size_t(max(1000, atoi(argv[1]))) : size_t(1000000);
+
+    mt19937_64 random(5);
+    vector<double> ns(calls), ks(calls), xs(calls);
+    for (size_t i = 0; i < calls; i++) {
+        ns[i] = double(random() % 171);
+        ks[i] = double(random() % (uint64_t(ns[i]) + 1));
+        xs[i] = uniform_real_distribution<double>(-20.0, 170.0)(random);
+    }
+
+    double sink = 0;
+    double tableFactorial = bestSeconds(3, [&]() {
+        for (size_t i = 0; i < calls; i++) sink += Combinatorics::factorial(ns[i]);
+    });
+    double loopFactorialTime = bestSeconds(3, [&]() {
+        for (size_t i = 0; i < calls; i++) sink += loopFactorial(ns[i]);
+    });
+    double tableCombinations = bestSeconds(3, [&]() {
+        for (size_t i = 0; i < calls; i++) sink += Combinatorics::combinations(ns[i], ks[i]);
+    });
+    double loopCombinationsTime = bestSeconds(3, [&]() {
+        for (size_t i = 0; i < calls; i++) sink += loopCombinations(ns[i], ks[i]);
+    });
+    double gammaTime = bestSeconds(3, [&]() {
+        for (size_t i = 0; i < calls; i++) sink += Combinatorics::gamma(xs[i]);
+    });
+    double libmGamma = bestSeconds(3, [&]() {
+        for (size_t i = 0; i < calls; i++) sink += tgamma(xs[i]);
+    });
+
+    double worst = 0;
+    for (size_t i = 0; i < calls; i++) {
+        double reference = tgamma(xs[i]);
+        if (isfinite(reference) && reference != 0) {
+            worst = max(worst, fabs(Combinatorics::gamma(xs[i]) / reference - 1));
+        }
+    }
+
+    cout << calls << " calls, n in [0, 170]" << endl << endl;
+    cout << fixed << setprecision(1);
+    cout << setw(14) << "" << setw(12) << "table ns" << setw(12) << "loop ns" << setw(10) << "speedup" << endl;
+    cout << setw(14) << "factorial" << setw(12) << tableFactorial / calls * 1e9
+         << setw(12) << loopFactorialTime / calls * 1e9 << setw(9) << loopFactorialTime / tableFactorial << "x" << endl;
+    cout << setw(14) << "nCr" << setw(12) << tableCombinations / calls * 1e9
+         << setw(12) << loopCombinationsTime / calls * 1e9 << setw(9) << loopCombinationsTime / tableCombinations << "x" << endl;
+    cout << endl << "gamma: " << gammaTime / calls * 1e9 << " ns, std::tgamma " << libmGamma / calls * 1e9
+         << " ns, largest relative difference " << scientific << setprecision(2) << worst << endl << endl;
+
+    // Overflow at the real threshold, reflection down to the subnormals,
+    // logGamma next to its zeros at 1 and 2
+    const double gammaCases[] = { 171.5, 171.62, 171.7, -171.5, -184.5, -8.81, -0.5, 0.968, 1.99, 1e-300 };
+    const double logGammaCases[] = { 0.968, 1.0001, 1.9999, 2.0001, -2.74767, 0.5, 14.5, 1e6 };
+    cout << "edge cases (ulps from libm)" << endl;
+    for (double x : gammaCases) {
+        double value = Combinatorics::gamma(x);
+        cout << setw(14) << defaultfloat << setprecision(6) << x << "  gamma " << setw(14) << value
+             << fixed << setprecision(1) << setw(8) << ulps(value, tgamma(x)) << endl;
+    }
+    for (double x : logGammaCases) {
+        double value = Combinatorics::logGamma(x);
+        cout << setw(14) << defaultfloat << setprecision(6) << x << "  logGamma " << setw(11) << value
+             << fixed << setprecision(1) << setw(8) << ulps(value, lgamma(x)) << endl;
+    }
+    cout << endl;
+
+    cout << fixed << setprecision(3);
+    const uint64_t sizes[] = { 1000, 10000, 100000 };
+    for (uint64_t n : sizes) {
+        size_t digits = 0;
+        double seconds = bestSeconds(3, [&]() { digits = NumberTheory::binomial(n, n / 2).size(); });
+        cout << "exact C(" << n << ", " << n / 2 << "): " << digits << " digits in " << seconds * 1000 << " ms" << endl;
+    }
+    return sink == 42 ? 1 : 0;
+}
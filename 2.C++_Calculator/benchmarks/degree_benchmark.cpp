@@ -0,0 +1,105 @@
+// Degree-mode trig benchmark: the exact quadrant reduction and special-angle
+// table (CalcKernels::sine/cosine/tangent with degrees = true) against the
+// previous path (reduce modulo 360, convert to radians, radian kernel) and
+// against libm on the converted argument.  Reports time per call and how
+// many results differ from the exact value on common angles.
+// Build: g++ -O2 -std=c++17 -pthread -I./core benchmarks/degree_benchmark.cpp core/*.cpp -o degree_benchmark
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "../core/CalcKernels.h"
+
+using namespace std;
+
+typedef double (*Function)(double);
+
+// Before exact reduction: two roundings in degreesToRadians
+double previousArgument(double x) {
+    double reduced = CalcKernels::exactRemainder(x, 360.0);
+    if (reduced > 180.0) reduced -= 360.0;
+    if (reduced < -180.0) reduced += 360.0;
+    return CalcKernels::degreesToRadians(reduced);
+}
+
+double currentSine(double x) { return CalcKernels::sine(x, true); }
+double currentCosine(double x) { return CalcKernels::cosine(x, true); }
+double currentTangent(double x) { return CalcKernels::tangent(x, true); }
+double previousSine(double x) { return CalcKernels::sineRadians(previousArgument(x)); }
+double previousCosine(double x) { return CalcKernels::cosineRadians(previousArgument(x)); }
+double previousTangent(double x) { return CalcKernels::tangentRadians(previousArgument(x)); }
+double libmSine(double x) { return sin(x * CalcKernels::pi / 180.0); }
+double libmCosine(double x) { return cos(x * CalcKernels::pi / 180.0); }
+double libmTangent(double x) { return tan(x * CalcKernels::pi / 180.0); }
+
+double nanosecondsPerCall(Function function, const vector<double>& input, vector<double>& out) {
+    double best = 1e30;
+    for (int run = 0; run < 5; run++) {
+        auto start = chrono::steady_clock::now();
+        for (size_t i = 0; i < input.size(); i++) {
+            out[i] = function(input[i]);
+        }
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        best = min(best, seconds * 1e9 / double(input.size()));
+    }
+    return best;
+}
+
+size_t differences(const vector<double>& x, const vector<double>& y) {
+    size_t count = 0;
+    for (size_t i = 0; i < x.size(); i++) {
+        if (x[i] != y[i]) {
+            count++;
+        }
+    }
+    return count;
+}
+
+int main() {
+    const size_t count = size_t(1) << 20;
+    // Multiples of 15, 18 and 22.5 degrees, then arbitrary angles
+    const double steps[] = { 15.0, 18.0, 22.5 };
+    vector<double> common(count), random(count);
+    mt19937_64 generator(7);
+    uniform_int_distribution<int> multiple(-96, 96);
+    uniform_real_distribution<double> angle(-720.0, 720.0);
+    for (size_t i = 0; i < count; i++) {
+        common[i] = steps[i % 3] * multiple(generator);
+        random[i] = angle(generator);
+    }
+
+    struct Row {
+        const char* name;
+        Function current;
+        Function previous;
+        Function libm;
+    };
+    const Row rows[] = {
+        { "sin", currentSine, previousSine, libmSine },
+        { "cos", currentCosine, previousCosine, libmCosine },
+        { "tan", currentTangent, previousTangent, libmTangent },
+    };
+
+    cout << count << " calls per input set, ns per call (inexact results on common angles)" << endl << endl;
+    cout << setw(11) << "" << setw(25) << "current" << setw(25) << "previous" << setw(25) << "libm" << endl;
+    vector<double> exact(count), out(count);
+    for (const Row& row : rows) {
+        nanosecondsPerCall(row.current, common, exact);
+        cout << setw(4) << row.name << " common" << fixed << setprecision(2)
+             << setw(15) << nanosecondsPerCall(row.current, common, out) << setw(10) << "(0)";
+        double previous = nanosecondsPerCall(row.previous, common, out);
+        cout << setw(15) << previous << setw(10) << ("(" + to_string(differences(out, exact)) + ")");
+        double libm = nanosecondsPerCall(row.libm, common, out);
+        cout << setw(15) << libm << setw(10) << ("(" + to_string(differences(out, exact)) + ")") << endl;
+
+        cout << setw(4) << row.name << " random"
+             << setw(15) << nanosecondsPerCall(row.current, random, out) << setw(10) << ""
+             << setw(15) << nanosecondsPerCall(row.previous, random, out) << setw(10) << ""
+             << setw(15) << nanosecondsPerCall(row.libm, random, out) << endl;
+    }
+    return 0;
+}
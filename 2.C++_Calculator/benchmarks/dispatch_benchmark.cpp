@@ -0,0 +1,188 @@
+// CPU dispatch benchmark: runs the CalculatorEngine batch operations on
+// every tier this CPU supports, checks each result bit for bit against the
+// scalar tier and reports throughput.  Inputs mix ordinary values with the
+// cases the vector kernels hand back to the scalar path (|x| >= 720
+// degrees, radians beyond the reduction limit, exp overflow, subnormals,
+// domain errors, inf, NaN, signed zeros).  sincos and the polar
+// conversions compare both of their outputs.
+// Build: g++ -O2 -std=c++17 -pthread -I./core benchmarks/dispatch_benchmark.cpp core/*.cpp -o dispatch_benchmark
+// Usage: dispatch_benchmark [elements]
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <vector>
+#include "../core/CalcKernels.h"
+#include "../core/CalculatorEngine.h"
+#include "../core/CpuDispatch.h"
+
+using namespace std;
+
+template <typename Body>
+double bestSeconds(int runs, Body body) {
+    double best = 1e30;
+    for (int run = 0; run < runs; run++) {
+        auto start = chrono::steady_clock::now();
+        body();
+        best = min(best, chrono::duration<double>(chrono::steady_clock::now() - start).count());
+    }
+    return best;
+}
+
+bool sameBits(const vector<double>& x, const vector<double>& y) {
+    return x.size() == y.size() && memcmp(x.data(), y.data(), x.size() * sizeof(double)) == 0;
+}
+
+int main(int argc, char* argv[]) {
+    size_t count = argc > 1 ? size_t(max(64, atoi(argv[1]))) : size_t(1) << 20;
+    // Odd length so every tier also runs its scalar tail
+    count |= 1;
+
+    mt19937_64 random(42);
+    uniform_real_distribution<double> wide(-720.0, 720.0);
+    uniform_real_distribution<double> turns(-1.0e4, 1.0e4);
+    uniform_real_distribution<double> radians(-2.0e6, 2.0e6);
+    const double special[] = {
+        0.0, -0.0, 90.0, -90.0, 180.0, -180.0, 270.0, 359.999, -360.0, 360.0, 540.0, -719.5,
+        720.0, 45.0, 1.0e300,
+        numeric_limits<double>::infinity(), -numeric_limits<double>::infinity(),
+        numeric_limits<double>::quiet_NaN(), CalcKernels::reductionLimit, 0.785398163397448279
+    };
+    const size_t specialCount = sizeof(special) / sizeof(special[0]);
+    const double scientificSpecial[] = {
+        0.0, -0.0, 1.0, -1.0, 0.5, 2.0, 22.0, -22.0, 708.5, 709.9, -745.5, 710.4, 1.0e-300, 4.0e-320,
+        -4.0e-320, 1.0e300, 0x1p-28, 0.99999999, 1.00000001, 10.0, 1000.0,
+        numeric_limits<double>::infinity(), -numeric_limits<double>::infinity(),
+        numeric_limits<double>::quiet_NaN()
+    };
+    const size_t scientificSpecialCount = sizeof(scientificSpecial) / sizeof(scientificSpecial[0]);
+    uniform_real_distribution<double> exponent(-300.0, 300.0);
+    uniform_real_distribution<double> unit(-1.0, 1.0);
+
+    vector<double> a(count), b(count), degreeAngles(count), radianAngles(count), values(count), exponents(count);
+    for (size_t i = 0; i < count; i++) {
+        a[i] = wide(random);
+        b[i] = i % 7 == 0 ? 0.0 : wide(random);
+        degreeAngles[i] = i % 13 == 0 ? special[(i / 13) % specialCount]
+                        : i % 5 == 0 ? turns(random) : wide(random);
+        radianAngles[i] = i % 13 == 0 ? special[(i / 13) % specialCount]
+                        : i % 3 == 0 ? radians(random) : wide(random) / 100.0;
+        values[i] = i % 11 == 0 ? scientificSpecial[(i / 11) % scientificSpecialCount]
+                  : i % 5 == 0 ? pow(10.0, exponent(random))
+                  : i % 5 == 1 ? unit(random) : wide(random) / 20.0;
+        exponents[i] = i % 7 == 0 ? scientificSpecial[(i / 7) % scientificSpecialCount]
+                     : i % 3 == 0 ? double(int(wide(random) / 10.0)) : wide(random) / 100.0;
+    }
+
+    // Degree 19 takes the four-chain Estrin path, degree 4 Horner's rule
+    vector<double> coefficients(20);
+    for (double& c : coefficients) {
+        c = unit(random);
+    }
+    const vector<double> quartic(coefficients.begin(), coefficients.begin() + 5);
+
+    struct Case {
+        const char* name;
+        char operation;
+        const char* function;
+        bool degrees;
+    };
+    const Case cases[] = {
+        { "add", '+', nullptr, false },
+        { "subtract", '-', nullptr, false },
+        { "multiply", '*', nullptr, false },
+        { "divide", '/', nullptr, false },
+        { "sin deg", 0, "sin", true },
+        { "cos deg", 0, "cos", true },
+        { "tan deg", 0, "tan", true },
+        { "sin rad", 0, "sin", false },
+        { "cos rad", 0, "cos", false },
+        { "tan rad", 0, "tan", false },
+        { "exp", 0, "exp", false },
+        { "ln", 0, "ln", false },
+        { "log10", 0, "log10", false },
+        { "sqrt", 0, "sqrt", false },
+        { "pow", '^', nullptr, false },
+        { "sinh", 0, "sinh", false },
+        { "cosh", 0, "cosh", false },
+        { "tanh", 0, "tanh", false },
+        { "asinh", 0, "asinh", false },
+        { "acosh", 0, "acosh", false },
+        { "atanh", 0, "atanh", false },
+        { "sincos deg", 's', nullptr, true },
+        { "sincos rad", 's', nullptr, false },
+        { "to xy deg", 'r', nullptr, true },
+        { "to xy rad", 'r', nullptr, false },
+        { "polar deg", 'p', nullptr, true },
+        { "polar rad", 'p', nullptr, false },
+        { "poly deg 4", '4', nullptr, false },
+        { "poly deg 19", 'P', nullptr, false },
+    };
+    const CpuTier tiers[] = { CpuTier::Scalar, CpuTier::SSE2, CpuTier::AVX2, CpuTier::AVX512, CpuTier::NEON };
+
+    CalculatorEngine engine;
+    CpuTier original = CpuDispatch::activeTier();
+    cout << "Detected tier: " << CpuDispatch::tierName(CpuDispatch::detectedTier())
+         << ", active: " << CpuDispatch::tierName(original) << ", " << count << " elements" << endl << endl;
+    cout << setw(10) << "case";
+    for (CpuTier tier : tiers) {
+        if (CpuDispatch::kernelsFor(tier) != nullptr) {
+            cout << setw(14) << CpuDispatch::tierName(tier);
+        }
+    }
+    cout << "   (M elements/s)" << endl;
+
+    bool allSame = true;
+    // The pair operations fill a second output too
+    vector<double> out(count), reference(count), second(count), secondReference(count);
+    for (const Case& test : cases) {
+        engine.setAngleMode(test.degrees, false);
+        const vector<double>& input = test.degrees ? degreeAngles : radianAngles;
+        cout << setw(10) << test.name;
+        for (CpuTier tier : tiers) {
+            if (!CpuDispatch::setTier(tier)) {
+                continue;
+            }
+            double seconds = bestSeconds(5, [&]() {
+                if (test.operation == '4' || test.operation == 'P') {
+                    engine.evaluatePolynomial(test.operation == 'P' ? coefficients : quartic,
+                                              values.data(), out.data(), count);
+                } else if (test.operation == 's') {
+                    engine.performSineCosine(input.data(), out.data(), second.data(), count);
+                } else if (test.operation == 'r') {
+                    engine.polarToRectangular(values.data(), input.data(), out.data(), second.data(), count);
+                } else if (test.operation == 'p') {
+                    engine.rectangularToPolar(values.data(), exponents.data(), out.data(), second.data(), count);
+                } else if (test.operation == '^') {
+                    engine.performPowerOperation(values.data(), exponents.data(), out.data(), count);
+                } else if (test.function == nullptr) {
+                    engine.performBasicOperation(a.data(), b.data(), out.data(), count, test.operation);
+                } else if (engine.isValidScientificFunction(test.function)) {
+                    engine.performScientificOperation(test.function, values.data(), out.data(), count);
+                } else {
+                    engine.performTrigOperation(test.function, input.data(), out.data(), count);
+                }
+            });
+            bool same = true;
+            if (tier == CpuTier::Scalar) {
+                reference = out;
+                secondReference = second;
+            } else {
+                same = sameBits(out, reference) && sameBits(second, secondReference);
+                allSame = allSame && same;
+            }
+            cout << fixed << setprecision(1) << setw(13) << count / seconds / 1e6 << (same ? " " : "!");
+        }
+        cout << endl;
+    }
+    CpuDispatch::setTier(original);
+
+    cout << endl << (allSame ? "All tiers match the scalar results bit for bit"
+                             : "MISMATCH: results marked ! differ from scalar") << endl;
+    return allSame ? 0 : 1;
+}
@@ -0,0 +1,56 @@
+// Expression benchmark: interpreter vs JIT (scalar and packed) throughput,
+// with a bit-for-bit comparison of the results.
+// Build: g++ -O2 -std=c++17 -I./core benchmarks/expression_benchmark.cpp core/*.cpp -o expression_benchmark
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <vector>
+#include "../core/Expression.h"
+#include "../core/JitCompiler.h"
+
+using namespace std;
+
+double millionsPerSecond(size_t count, chrono::steady_clock::time_point start) {
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    return count / seconds / 1e6;
+}
+
+int main() {
+    const size_t count = 10000000;
+    const char* expressions[] = {
+        "x * x - 3 * x + 2",
+        "(x + 1) / (x - 1) - x / 7",
+        "sin(x) * 2 + x / 3",
+    };
+
+    vector<double> x(count);
+    for (size_t i = 0; i < count; i++) {
+        x[i] = -500.0 + 1000.0 * double(i) / double(count);
+    }
+    vector<double> reference(count), jitted(count);
+
+    cout << "JIT supported: " << (JitFunction::isSupported() ? "yes" : "no") << endl;
+    cout << "expression\tinterp M/s\tjit M/s\tidentical" << endl;
+
+    for (const char* text : expressions) {
+        Expression expression;
+        expression.compile(text, true);
+
+        auto start = chrono::steady_clock::now();
+        for (size_t i = 0; i < count; i++) {
+            reference[i] = expression.interpret(x[i]);
+        }
+        double interpreted = millionsPerSecond(count, start);
+
+        expression.setJitThreshold(1);
+        expression.evaluate(0.0);
+        start = chrono::steady_clock::now();
+        expression.evaluateArray(x.data(), jitted.data(), count);
+        double compiled = millionsPerSecond(count, start);
+
+        bool identical = memcmp(reference.data(), jitted.data(), count * sizeof(double)) == 0;
+        cout << text << "\t" << interpreted << "\t" << compiled << "\t"
+             << (identical ? "yes" : "NO") << endl;
+    }
+    return 0;
+}
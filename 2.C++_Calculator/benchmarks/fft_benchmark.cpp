@@ -0,0 +1,80 @@
+// FFT benchmark: times the fast transform from 2^10 to 2^24 points and
+// validates it against the naive DFT.
+// Build: g++ -O2 -std=c++17 -I./core benchmarks/fft_benchmark.cpp core/*.cpp -o fft_benchmark
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "../core/FFT.h"
+
+using namespace std;
+
+int main() {
+    FFT fft;
+    mt19937_64 rng(42);
+    uniform_real_distribution<double> dist(-1.0, 1.0);
+
+    cout << "threads: " << fft.getThreadCount() << endl;
+    cout << "size\tfft ms\tdft ms\tmax error" << endl;
+
+    for (int bits = 10; bits <= 24; bits++) {
+        size_t n = size_t(1) << bits;
+        vector<complex<double>> input(n);
+        for (auto& x : input) {
+            x = complex<double>(dist(rng), dist(rng));
+        }
+
+        auto start = chrono::steady_clock::now();
+        vector<complex<double>> fast = fft.forward(input);
+        double fftMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+        // The full naive DFT is O(n^2); beyond 2^14 only a sample of bins is
+        // checked, each computed directly in O(n).
+        double dftMs = 0.0;
+        double maxError = 0.0;
+        if (bits <= 14) {
+            start = chrono::steady_clock::now();
+            vector<complex<double>> slow = FFT::naiveDFT(input);
+            dftMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+            for (size_t k = 0; k < n; k++) {
+                maxError = max(maxError, abs(fast[k] - slow[k]));
+            }
+        } else {
+            for (size_t k = 0; k < n; k += n / 16 + 1) {
+                complex<double> sum = 0;
+                for (size_t j = 0; j < n; j++) {
+                    sum += input[j] * polar(1.0, -2.0 * M_PI * double((k * j) % n) / double(n));
+                }
+                maxError = max(maxError, abs(fast[k] - sum));
+            }
+        }
+
+        cout << "2^" << bits << "\t" << fftMs << "\t";
+        if (bits <= 14) {
+            cout << dftMs;
+        } else {
+            cout << "-";
+        }
+        cout << "\t" << maxError << endl;
+    }
+
+    // Mixed-radix and Bluestein sizes (1009 and 10007 are prime) are
+    // checked against the naive DFT as well
+    for (size_t n : {12, 360, 1000, 1009, 3 * 5 * 7 * 11, 2 * 1009, 10007}) {
+        vector<complex<double>> input(n);
+        for (auto& x : input) {
+            x = complex<double>(dist(rng), dist(rng));
+        }
+        auto start = chrono::steady_clock::now();
+        vector<complex<double>> fast = fft.forward(input);
+        double fftMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+        vector<complex<double>> slow = FFT::naiveDFT(input);
+        double maxError = 0.0;
+        for (size_t k = 0; k < n; k++) {
+            maxError = max(maxError, abs(fast[k] - slow[k]));
+        }
+        cout << n << "\t" << fftMs << " ms, max error " << maxError << endl;
+    }
+    return 0;
+}
@@ -0,0 +1,151 @@
+// Number text benchmark: NumberFormat against the paths the front ends used
+// before, ostringstream (console and Memory; six digits by default, 17 to
+// round-trip), snprintf %.17g, and stod / strtod / istringstream for
+// parsing.  Also counts values that do not read back bit for bit.
+// Build: g++ -O2 -std=c++17 -pthread -I./core benchmarks/format_benchmark.cpp core/*.cpp -o format_benchmark
+// Usage: format_benchmark [values]
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "../core/NumberFormat.h"
+
+using namespace std;
+
+template <typename Body>
+double bestSeconds(int runs, Body body) {
+    double best = 1e30;
+    for (int run = 0; run < runs; run++) {
+        auto start = chrono::steady_clock::now();
+        body();
+        best = min(best, chrono::duration<double>(chrono::steady_clock::now() - start).count());
+    }
+    return best;
+}
+
+bool sameBits(double a, double b) {
+    return memcmp(&a, &b, sizeof(double)) == 0;
+}
+
+int main(int argc, char* argv[]) {
+    size_t count = argc > 1 ? size_t(max(1000, atoi(argv[1]))) : size_t(200000);
+
+    // Half calculator-like results (a few digits, moderate exponents), half
+    // arbitrary bit patterns; normal only, as stod throws on subnormals
+    mt19937_64 random(11);
+    vector<double> values(count);
+    for (size_t i = 0; i < count; i++) {
+        if (i % 2 == 0) {
+            values[i] = double(random() % 100000) / 100 * pow(10.0, int(random() % 13) - 6);
+        } else {
+            uint64_t bits;
+            do {
+                bits = random();
+                memcpy(&values[i], &bits, sizeof(double));
+            } while (!isnormal(values[i]));
+        }
+    }
+
+    size_t sink = 0;
+    vector<string> texts(count);
+    double formatTime = bestSeconds(3, [&]() {
+        char buffer[NumberFormat::bufferSize];
+        for (size_t i = 0; i < count; i++) sink += NumberFormat::format(values[i], buffer, sizeof(buffer));
+    });
+    double toStringTime = bestSeconds(3, [&]() {
+        for (size_t i = 0; i < count; i++) texts[i] = NumberFormat::toString(values[i]);
+    });
+    double snprintfTime = bestSeconds(3, [&]() {
+        char buffer[32];
+        for (size_t i = 0; i < count; i++) sink += size_t(snprintf(buffer, sizeof(buffer), "%.17g", values[i]));
+    });
+    double streamTime = bestSeconds(3, [&]() {
+        for (size_t i = 0; i < count; i++) {
+            ostringstream out;
+            out << setprecision(17) << values[i];
+            sink += out.str().size();
+        }
+    });
+    double defaultStreamTime = bestSeconds(3, [&]() {
+        for (size_t i = 0; i < count; i++) {
+            ostringstream out;
+            out << values[i];
+            sink += out.str().size();
+        }
+    });
+
+    double parsed = 0;
+    double parseTime = bestSeconds(3, [&]() {
+        for (size_t i = 0; i < count; i++) {
+            double value;
+            NumberFormat::parse(texts[i], value);
+            parsed += value;
+        }
+    });
+    double stodTime = bestSeconds(3, [&]() {
+        for (size_t i = 0; i < count; i++) parsed += stod(texts[i]);
+    });
+    double strtodTime = bestSeconds(3, [&]() {
+        for (size_t i = 0; i < count; i++) parsed += strtod(texts[i].c_str(), nullptr);
+    });
+    double streamParseTime = bestSeconds(3, [&]() {
+        for (size_t i = 0; i < count; i++) {
+            istringstream in(texts[i]);
+            double value;
+            in >> value;
+            parsed += value;
+        }
+    });
+
+    // Round trips: shortest text through parse, and the stream's default
+    // six digits through strtod
+    size_t formatFailures = 0, streamFailures = 0, totalLength = 0, streamLength = 0;
+    for (size_t i = 0; i < count; i++) {
+        double back;
+        if (!NumberFormat::parse(texts[i], back) || !sameBits(back, values[i])) {
+            formatFailures++;
+        }
+        ostringstream out;
+        out << values[i];
+        if (!sameBits(strtod(out.str().c_str(), nullptr), values[i])) {
+            streamFailures++;
+        }
+        totalLength += texts[i].size();
+        out.str("");
+        out << setprecision(17) << values[i];
+        streamLength += out.str().size();
+    }
+
+    cout << count << " values" << endl << endl;
+    cout << fixed << setprecision(1);
+    cout << "format (ns/value)" << endl;
+    cout << setw(28) << "NumberFormat::format" << setw(10) << formatTime / count * 1e9 << endl;
+    cout << setw(28) << "NumberFormat::toString" << setw(10) << toStringTime / count * 1e9 << endl;
+    cout << setw(28) << "snprintf %.17g" << setw(10) << snprintfTime / count * 1e9
+         << setw(9) << snprintfTime / formatTime << "x" << endl;
+    cout << setw(28) << "ostringstream precision 17" << setw(10) << streamTime / count * 1e9
+         << setw(9) << streamTime / formatTime << "x" << endl;
+    cout << setw(28) << "ostringstream default" << setw(10) << defaultStreamTime / count * 1e9
+         << setw(9) << defaultStreamTime / formatTime << "x" << endl;
+    cout << endl << "parse (ns/value)" << endl;
+    cout << setw(28) << "NumberFormat::parse" << setw(10) << parseTime / count * 1e9 << endl;
+    cout << setw(28) << "stod" << setw(10) << stodTime / count * 1e9
+         << setw(9) << stodTime / parseTime << "x" << endl;
+    cout << setw(28) << "strtod" << setw(10) << strtodTime / count * 1e9
+         << setw(9) << strtodTime / parseTime << "x" << endl;
+    cout << setw(28) << "istringstream" << setw(10) << streamParseTime / count * 1e9
+         << setw(9) << streamParseTime / parseTime << "x" << endl;
+    cout << endl << "average length: shortest " << double(totalLength) / count
+         << ", precision 17 " << double(streamLength) / count << endl;
+    cout << "not read back exactly: NumberFormat " << formatFailures
+         << ", ostringstream default " << streamFailures << endl;
+    return sink == 42 && parsed == 42 ? 1 : 0;
+}
@@ -0,0 +1,131 @@
+// Polynomial benchmark: CalculatorEngine::evaluatePolynomial over 10M
+// points on every tier this CPU supports, next to a plain Horner loop (what
+// callers wrote by hand before), then least-squares fits of the same size by
+// QR and by normal equations with the largest coefficient error against
+// the generating polynomial.  Degrees of 15 and up use the four-chain
+// Estrin form.
+// Build: g++ -O2 -std=c++17 -pthread -I./core benchmarks/polynomial_benchmark.cpp core/*.cpp -o polynomial_benchmark
+// Usage: polynomial_benchmark [points]
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "../core/CalculatorEngine.h"
+#include "../core/CpuDispatch.h"
+
+using namespace std;
+
+template <typename Body>
+double bestSeconds(int runs, Body body) {
+    double best = 1e30;
+    for (int run = 0; run < runs; run++) {
+        auto start = chrono::steady_clock::now();
+        body();
+        best = min(best, chrono::duration<double>(chrono::steady_clock::now() - start).count());
+    }
+    return best;
+}
+
+double largestError(const vector<double>& fitted, const vector<double>& truth) {
+    double error = 0.0;
+    for (size_t i = 0; i < truth.size(); i++) {
+        error = max(error, fabs(fitted[i] - truth[i]));
+    }
+    return error;
+}
+
+int main(int argc, char* argv[]) {
+    size_t count = argc > 1 ? size_t(max(1000, atoi(argv[1]))) : size_t(10000000);
+
+    mt19937_64 random(7);
+    uniform_real_distribution<double> unit(-1.0, 1.0);
+    normal_distribution<double> noise(0.0, 1e-3);
+    vector<double> xs(count), ys(count), out(count);
+    for (size_t i = 0; i < count; i++) {
+        xs[i] = unit(random);
+    }
+
+    const CpuTier tiers[] = { CpuTier::Scalar, CpuTier::SSE2, CpuTier::AVX2, CpuTier::AVX512, CpuTier::NEON };
+    CalculatorEngine engine;
+    CpuTier original = CpuDispatch::activeTier();
+    cout << "Detected tier: " << CpuDispatch::tierName(CpuDispatch::detectedTier())
+         << ", active: " << CpuDispatch::tierName(original) << ", " << count << " points" << endl << endl;
+    cout << setw(8) << "degree" << setw(12) << "loop";
+    for (CpuTier tier : tiers) {
+        if (CpuDispatch::kernelsFor(tier) != nullptr) {
+            cout << setw(12) << CpuDispatch::tierName(tier);
+        }
+    }
+    cout << "   (M points/s)" << endl;
+
+    for (size_t degree : { 3, 7, 15, 31 }) {
+        vector<double> coefficients(degree + 1);
+        for (double& c : coefficients) {
+            c = unit(random);
+        }
+        double loop = bestSeconds(3, [&]() {
+            for (size_t i = 0; i < count; i++) {
+                double result = coefficients[degree];
+                for (size_t k = degree; k > 0; k--) {
+                    result = result * xs[i] + coefficients[k - 1];
+                }
+                out[i] = result;
+            }
+        });
+        cout << setw(8) << degree << fixed << setprecision(1) << setw(12) << count / loop / 1e6;
+        for (CpuTier tier : tiers) {
+            if (!CpuDispatch::setTier(tier)) {
+                continue;
+            }
+            double seconds = bestSeconds(3, [&]() {
+                engine.evaluatePolynomial(coefficients, xs.data(), out.data(), count);
+            });
+            cout << setw(12) << count / seconds / 1e6;
+        }
+        cout << endl;
+        CpuDispatch::setTier(original);
+    }
+
+    cout << endl << setw(22) << "fit" << setw(14) << "QR" << setw(14) << "normal eq."
+         << "   (M points/s, largest coefficient error)" << endl;
+    const vector<double> cubic = { 0.5, -1.25, 2.0, 0.75 };
+    for (size_t i = 0; i < count; i++) {
+        ys[i] = cubic[0] + xs[i] * (cubic[1] + xs[i] * (cubic[2] + xs[i] * cubic[3])) + noise(random);
+    }
+    const vector<double> plane = { 1.0, 2.0, -3.0, 0.5, 4.0 };
+    vector<double> features(count * 4), zs(count);
+    for (size_t i = 0; i < count; i++) {
+        double z = plane[0];
+        for (size_t k = 0; k < 4; k++) {
+            features[i * 4 + k] = unit(random);
+            z += plane[k + 1] * features[i * 4 + k];
+        }
+        zs[i] = z + noise(random);
+    }
+
+    for (int test = 0; test < 2; test++) {
+        cout << setw(22) << (test == 0 ? "cubic" : "linear, 4 features");
+        for (FitMethod method : { FitMethod::QR, FitMethod::NormalEquations }) {
+            vector<double> fitted;
+            double seconds = bestSeconds(2, [&]() {
+                if (test == 0) {
+                    engine.fitPolynomial(xs.data(), ys.data(), count, 3, fitted, method);
+                } else {
+                    engine.fitLinear(features.data(), 4, zs.data(), count, fitted, method);
+                }
+            });
+            cout << fixed << setprecision(1) << setw(7) << count / seconds / 1e6
+                 << scientific << setprecision(0) << setw(7) << largestError(fitted, test == 0 ? cubic : plane);
+        }
+        cout << endl;
+    }
+
+    vector<double> fitted;
+    engine.fitPolynomial(xs.data(), ys.data(), count, 3, fitted);
+    engine.storeCoefficients("cubic", fitted);
+    return 0;
+}
@@ -0,0 +1,54 @@
+// Precision benchmark: batch arithmetic and trig throughput for each
+// instantiation of BasicCalculatorEngine.
+// Build: g++ -O2 -std=c++17 -I./core benchmarks/precision_benchmark.cpp core/*.cpp -o precision_benchmark
+// With __float128: add -DCALC_ENABLE_FLOAT128 and link -lquadmath
+#include <chrono>
+#include <iostream>
+#include <vector>
+#include "../core/CalculatorEngine.h"
+
+using namespace std;
+
+template <typename T>
+double millionsPerSecond(BasicCalculatorEngine<T>& engine, const vector<T>& a, const vector<T>& b,
+                         vector<T>& out, char operation, const char* function, int repeats) {
+    auto start = chrono::steady_clock::now();
+    for (int r = 0; r < repeats; r++) {
+        if (function == nullptr) {
+            engine.performBasicOperation(a.data(), b.data(), out.data(), a.size(), operation);
+        } else {
+            engine.performTrigOperation(function, a.data(), out.data(), a.size());
+        }
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    return double(a.size()) * repeats / seconds / 1e6;
+}
+
+template <typename T>
+void run() {
+    const size_t count = 1 << 16;
+    vector<T> a(count), b(count), out(count);
+    for (size_t i = 0; i < count; i++) {
+        a[i] = T(double(i % 720) - 360.0 + 0.25);
+        b[i] = T(double(i % 17) + 1.0);
+    }
+
+    BasicCalculatorEngine<T> engine;
+    cout << PrecisionTraits<T>::name()
+         << "\tadd " << millionsPerSecond(engine, a, b, out, '+', nullptr, 2000)
+         << "\tmul " << millionsPerSecond(engine, a, b, out, '*', nullptr, 2000)
+         << "\tdiv " << millionsPerSecond(engine, a, b, out, '/', nullptr, 500)
+         << "\tsin " << millionsPerSecond(engine, a, b, out, 0, "sin", 20)
+         << "\tatan " << millionsPerSecond(engine, a, b, out, 0, "atan", 20)
+         << "  (M ops/s)" << endl;
+}
+
+int main() {
+    run<float>();
+    run<double>();
+    run<long double>();
+#ifdef CALC_HAVE_FLOAT128
+    run<__float128>();
+#endif
+    return 0;
+}
@@ -0,0 +1,125 @@
+// Number theory benchmark: counting the primes below 10^10 with the
+// segmented sieve on 1..N threads (checked against the known pi(x)), a
+// plain whole-array sieve at 10^9 for reference, then Miller-Rabin and
+// Pollard-Brent throughput on random 64-bit inputs.
+// Build: g++ -O2 -std=c++17 -pthread -I./core benchmarks/primes_benchmark.cpp core/*.cpp -o primes_benchmark
+// Usage: primes_benchmark [limit] [max threads]
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+#include "../core/NumberTheory.h"
+#include "../core/ThreadPool.h"
+
+using namespace std;
+
+template <typename Body>
+double bestSeconds(int runs, Body body) {
+    double best = 1e30;
+    for (int run = 0; run < runs; run++) {
+        auto start = chrono::steady_clock::now();
+        body();
+        best = min(best, chrono::duration<double>(chrono::steady_clock::now() - start).count());
+    }
+    return best;
+}
+
+// Odd-only sieve over one bit array, crossing off every prime
+uint64_t plainCount(uint64_t limit) {
+    vector<bool> composite(size_t(limit / 2 + 1), false);
+    for (uint64_t p = 3; p * p <= limit; p += 2) {
+        if (!composite[size_t(p / 2)]) {
+            for (uint64_t multiple = p * p; multiple <= limit; multiple += 2 * p) {
+                composite[size_t(multiple / 2)] = true;
+            }
+        }
+    }
+    uint64_t count = 1;
+    for (uint64_t n = 3; n <= limit; n += 2) {
+        count += composite[size_t(n / 2)] ? 0 : 1;
+    }
+    return count;
+}
+
+uint64_t knownCount(uint64_t limit) {
+    const uint64_t powers[][2] = {
+        { 1000000ULL, 78498ULL }, { 10000000ULL, 664579ULL }, { 100000000ULL, 5761455ULL },
+        { 1000000000ULL, 50847534ULL }, { 10000000000ULL, 455052511ULL },
+        { 100000000000ULL, 4118054813ULL }, { 1000000000000ULL, 37607912018ULL }
+    };
+    for (const auto& power : powers) {
+        if (power[0] == limit) {
+            return power[1];
+        }
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    uint64_t limit = argc > 1 ? strtoull(argv[1], nullptr, 10) : 10000000000ULL;
+    unsigned maxThreads = argc > 2 ? unsigned(max(1, atoi(argv[2]))) : max(1u, thread::hardware_concurrency());
+    limit = min(max(limit, uint64_t(100)), NumberTheory::maxSieveLimit);
+    uint64_t expected = knownCount(limit);
+
+    uint64_t plainLimit = min(limit, uint64_t(1000000000));
+    uint64_t plainResult = 0;
+    double plain = bestSeconds(1, [&]() { plainResult = plainCount(plainLimit); });
+    double segmented = bestSeconds(3, [&]() { NumberTheory::countPrimes(plainLimit); });
+    cout << "pi(" << plainLimit << ") = " << plainResult << ": plain sieve " << fixed << setprecision(3)
+         << plain << " s, segmented (all threads) " << segmented << " s" << endl << endl;
+
+    cout << "pi(" << limit << ")" << (expected ? "" : " (no reference value)") << endl;
+    cout << setw(8) << "threads" << setw(14) << "count" << setw(12) << "seconds" << setw(10) << "speedup" << endl;
+    double base = 0;
+    for (unsigned threads = 1; threads <= maxThreads; threads++) {
+        ThreadPool::setGlobalWorkers(threads - 1);
+        uint64_t count = 0;
+        double seconds = bestSeconds(threads == 1 ? 1 : 2, [&]() { count = NumberTheory::countPrimes(limit); });
+        if (threads == 1) {
+            base = seconds;
+        }
+        cout << setw(8) << threads << setw(14) << count << setw(12) << setprecision(3) << seconds
+             << setw(9) << setprecision(2) << base / seconds << "x"
+             << (expected && count != expected ? "  WRONG" : "") << endl;
+    }
+    cout << endl;
+
+    mt19937_64 random(11);
+    const size_t testCount = 1000000;
+    vector<uint64_t> candidates(testCount);
+    for (uint64_t& n : candidates) {
+        n = random() | 1;
+    }
+    size_t primes = 0;
+    double test = bestSeconds(3, [&]() {
+        primes = 0;
+        for (uint64_t n : candidates) {
+            primes += NumberTheory::isPrime(n) ? 1 : 0;
+        }
+    });
+    cout << "isPrime: " << testCount << " random odd 64-bit, " << primes << " prime, "
+         << setprecision(1) << testCount / test / 1e6 << " M/s" << endl;
+
+    // Semiprimes of two ~32-bit primes: the hard case for rho
+    const size_t factorCount = 2000;
+    vector<uint64_t> semiprimes(factorCount);
+    for (uint64_t& n : semiprimes) {
+        n = NumberTheory::nextPrime(random() >> 33 | (uint64_t(1) << 30))
+          * NumberTheory::nextPrime(random() >> 32 | (uint64_t(1) << 31));
+    }
+    bool correct = true;
+    double factor = bestSeconds(3, [&]() {
+        for (uint64_t n : semiprimes) {
+            vector<uint64_t> factors = NumberTheory::factorize(n);
+            correct = correct && factors.size() == 2 && factors[0] * factors[1] == n;
+        }
+    });
+    cout << "factorize: " << factorCount << " semiprimes near 2^62, " << setprecision(1)
+         << factor / factorCount * 1e6 << " us each" << (correct ? "" : "  WRONG") << endl;
+    return 0;
+}
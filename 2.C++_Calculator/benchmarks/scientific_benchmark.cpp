@@ -0,0 +1,117 @@
+// Scientific batch benchmark: exp, ln, log10, sqrt, pow and the hyperbolic
+// functions through CalculatorEngine::performScientificOperation (and
+// performPowerOperation) on every tier this CPU supports, next to the
+// radian sine batch they are meant to keep up with.  Inputs stay inside
+// each function's domain so the vector path is measured, not the scalar
+// fallback; dispatch_benchmark covers the edge cases.  The last column is
+// the function's throughput on the active tier relative to sin.
+// Build: g++ -O2 -std=c++17 -pthread -I./core benchmarks/scientific_benchmark.cpp core/*.cpp -o scientific_benchmark
+// Usage: scientific_benchmark [elements]
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "../core/CalculatorEngine.h"
+#include "../core/CpuDispatch.h"
+
+using namespace std;
+
+template <typename Body>
+double bestSeconds(int runs, Body body) {
+    double best = 1e30;
+    for (int run = 0; run < runs; run++) {
+        auto start = chrono::steady_clock::now();
+        body();
+        best = min(best, chrono::duration<double>(chrono::steady_clock::now() - start).count());
+    }
+    return best;
+}
+
+int main(int argc, char* argv[]) {
+    size_t count = argc > 1 ? size_t(max(64, atoi(argv[1]))) : size_t(1) << 20;
+
+    mt19937_64 random(11);
+    uniform_real_distribution<double> angle(-10.0, 10.0);
+    uniform_real_distribution<double> argument(-20.0, 20.0);
+    uniform_real_distribution<double> positive(1.0e-3, 1.0e3);
+    uniform_real_distribution<double> atLeastOne(1.0, 50.0);
+    uniform_real_distribution<double> unit(-0.99, 0.99);
+    uniform_real_distribution<double> exponent(-4.0, 4.0);
+    vector<double> angles(count), arguments(count), positives(count), large(count), units(count), exponents(count);
+    for (size_t i = 0; i < count; i++) {
+        angles[i] = angle(random);
+        arguments[i] = argument(random);
+        positives[i] = positive(random);
+        large[i] = atLeastOne(random);
+        units[i] = unit(random);
+        exponents[i] = exponent(random);
+    }
+
+    struct Case {
+        const char* function;
+        const vector<double>* input;
+    };
+    const Case cases[] = {
+        { "sin", &angles },
+        { "exp", &arguments },
+        { "ln", &positives },
+        { "log10", &positives },
+        { "sqrt", &positives },
+        { "pow", &positives },
+        { "sinh", &arguments },
+        { "cosh", &arguments },
+        { "tanh", &arguments },
+        { "asinh", &arguments },
+        { "acosh", &large },
+        { "atanh", &units },
+    };
+    const CpuTier tiers[] = { CpuTier::Scalar, CpuTier::SSE2, CpuTier::AVX2, CpuTier::AVX512, CpuTier::NEON };
+
+    CalculatorEngine engine;
+    engine.setAngleMode(false, false);
+    CpuTier original = CpuDispatch::activeTier();
+    cout << "Detected tier: " << CpuDispatch::tierName(CpuDispatch::detectedTier())
+         << ", active: " << CpuDispatch::tierName(original) << ", " << count << " elements" << endl << endl;
+    cout << setw(8) << "function";
+    for (CpuTier tier : tiers) {
+        if (CpuDispatch::kernelsFor(tier) != nullptr) {
+            cout << setw(12) << CpuDispatch::tierName(tier);
+        }
+    }
+    cout << setw(12) << "vs sin" << "   (M elements/s)" << endl;
+
+    vector<double> out(count);
+    double sineRate = 0.0;
+    for (const Case& test : cases) {
+        cout << setw(8) << test.function;
+        double activeRate = 0.0;
+        for (CpuTier tier : tiers) {
+            if (!CpuDispatch::setTier(tier)) {
+                continue;
+            }
+            double seconds = bestSeconds(5, [&]() {
+                if (string(test.function) == "sin") {
+                    engine.performTrigOperation("sin", test.input->data(), out.data(), count);
+                } else if (string(test.function) == "pow") {
+                    engine.performPowerOperation(test.input->data(), exponents.data(), out.data(), count);
+                } else {
+                    engine.performScientificOperation(test.function, test.input->data(), out.data(), count);
+                }
+            });
+            double rate = count / seconds / 1e6;
+            if (tier == original) {
+                activeRate = rate;
+            }
+            cout << fixed << setprecision(1) << setw(12) << rate;
+        }
+        if (sineRate == 0.0) {
+            sineRate = activeRate;
+        }
+        cout << setprecision(2) << setw(11) << activeRate / sineRate << "x" << endl;
+    }
+    CpuDispatch::setTier(original);
+    return 0;
+}
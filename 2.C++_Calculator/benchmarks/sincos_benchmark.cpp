@@ -0,0 +1,146 @@
+// Fused sine/cosine benchmark: CalculatorEngine::performSineCosine against
+// the sin batch followed by the cos batch on the same angles, on every
+// tier this CPU supports, in radians and degrees.  The single-value rows
+// time one engine call per angle (performSineCosine against two
+// performTrigOperation calls).  The polar rows show the conversions next
+// to them.  Angles stay within +-720 degrees (+-4 pi) so the vector path
+// is measured; dispatch_benchmark covers the edge cases.  First it checks
+// that the sincos and toRectangular kernels agree bit for bit with the sin
+// and cos kernels in float, double and long double, on every integer
+// degree in +-720 and on radian angles, and exits with 1 if they do not.
+// Build: g++ -O2 -std=c++17 -pthread -I./core benchmarks/sincos_benchmark.cpp core/*.cpp -o sincos_benchmark
+// Usage: sincos_benchmark [elements]
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "../core/CalcKernels.h"
+#include "../core/CalculatorEngine.h"
+#include "../core/CpuDispatch.h"
+#include "../core/TrigCalculator.h"
+
+using namespace std;
+
+template <typename Body>
+double bestSeconds(int runs, Body body) {
+    double best = 1e30;
+    for (int run = 0; run < runs; run++) {
+        auto start = chrono::steady_clock::now();
+        body();
+        best = min(best, chrono::duration<double>(chrono::steady_clock::now() - start).count());
+    }
+    return best;
+}
+
+template <typename T>
+bool sameValue(T x, T y) {
+    return (x == y && signbit(x) == signbit(y)) || (x != x && y != y);
+}
+
+template <typename T>
+bool checkSineCosine(const char* name) {
+    typedef BasicTrigCalculator<T> Trig;
+    int mismatches = 0;
+    for (bool degrees : { true, false }) {
+        for (int i = -720; i <= 720; i++) {
+            T angle = degrees ? T(i) : T(i) / T(100);
+            T sine, cosine, x, y;
+            Trig::sineCosineKernel(angle, degrees, sine, cosine);
+            Trig::toRectangularKernel(T(3), angle, degrees, x, y);
+            if (!sameValue(sine, Trig::sineKernel(angle, degrees)) || !sameValue(cosine, Trig::cosineKernel(angle, degrees))
+                || !sameValue(x, T(3) * cosine) || !sameValue(y, T(3) * sine)) {
+                mismatches++;
+            }
+        }
+    }
+    cout << setw(12) << name << " sincos and to x, y: ";
+    if (mismatches == 0) {
+        cout << "match sin and cos bit for bit" << endl;
+    } else {
+        cout << "MISMATCH at " << mismatches << " angles" << endl;
+    }
+    return mismatches == 0;
+}
+
+int main(int argc, char* argv[]) {
+    bool kernelsAgree = checkSineCosine<float>("float");
+    kernelsAgree = checkSineCosine<double>("double") && kernelsAgree;
+    kernelsAgree = checkSineCosine<long double>("long double") && kernelsAgree;
+    if (!kernelsAgree) {
+        return 1;
+    }
+
+    size_t count = argc > 1 ? size_t(max(64, atoi(argv[1]))) : size_t(1) << 20;
+
+    mt19937_64 random(5);
+    uniform_real_distribution<double> degree(-720.0, 720.0);
+    uniform_real_distribution<double> magnitude(0.0, 100.0);
+    uniform_real_distribution<double> coordinate(-100.0, 100.0);
+    vector<double> degreeAngles(count), radianAngles(count), magnitudes(count), xs(count), ys(count);
+    for (size_t i = 0; i < count; i++) {
+        degreeAngles[i] = degree(random);
+        radianAngles[i] = degreeAngles[i] * CalcKernels::pi / 180.0;
+        magnitudes[i] = magnitude(random);
+        xs[i] = coordinate(random);
+        ys[i] = coordinate(random);
+    }
+
+    const CpuTier tiers[] = { CpuTier::Scalar, CpuTier::SSE2, CpuTier::AVX2, CpuTier::AVX512, CpuTier::NEON };
+    CalculatorEngine engine;
+    CpuTier original = CpuDispatch::activeTier();
+    cout << "Detected tier: " << CpuDispatch::tierName(CpuDispatch::detectedTier())
+         << ", active: " << CpuDispatch::tierName(original) << ", " << count << " elements" << endl;
+
+    vector<double> first(count), second(count);
+    for (bool degrees : { false, true }) {
+        engine.setAngleMode(degrees, false);
+        const vector<double>& angles = degrees ? degreeAngles : radianAngles;
+        cout << endl << setw(10) << (degrees ? "degrees" : "radians") << setw(14) << "sin + cos"
+             << setw(14) << "sincos" << setw(10) << "speedup" << setw(14) << "to x, y" << setw(14) << "to polar"
+             << "   (M angles/s)" << endl;
+
+        size_t single = count / 16;
+        double separate = bestSeconds(3, [&]() {
+            for (size_t i = 0; i < single; i++) {
+                first[i] = engine.performTrigOperation("sin", angles[i]);
+                second[i] = engine.performTrigOperation("cos", angles[i]);
+            }
+        });
+        double fused = bestSeconds(3, [&]() {
+            for (size_t i = 0; i < single; i++) {
+                engine.performSineCosine(angles[i], first[i], second[i]);
+            }
+        });
+        cout << setw(10) << "single" << fixed << setprecision(1) << setw(14) << single / separate / 1e6
+             << setw(14) << single / fused / 1e6 << setprecision(2) << setw(9) << separate / fused << "x" << endl;
+
+        for (CpuTier tier : tiers) {
+            if (!CpuDispatch::setTier(tier)) {
+                continue;
+            }
+            separate = bestSeconds(5, [&]() {
+                engine.performTrigOperation("sin", angles.data(), first.data(), count);
+                engine.performTrigOperation("cos", angles.data(), second.data(), count);
+            });
+            fused = bestSeconds(5, [&]() {
+                engine.performSineCosine(angles.data(), first.data(), second.data(), count);
+            });
+            double rectangular = bestSeconds(5, [&]() {
+                engine.polarToRectangular(magnitudes.data(), angles.data(), first.data(), second.data(), count);
+            });
+            double polar = bestSeconds(5, [&]() {
+                engine.rectangularToPolar(xs.data(), ys.data(), first.data(), second.data(), count);
+            });
+            cout << setw(10) << CpuDispatch::tierName(tier) << fixed << setprecision(1)
+                 << setw(14) << count / separate / 1e6 << setw(14) << count / fused / 1e6
+                 << setprecision(2) << setw(9) << separate / fused << "x" << setprecision(1)
+                 << setw(14) << count / rectangular / 1e6 << setw(14) << count / polar / 1e6 << endl;
+        }
+        CpuDispatch::setTier(original);
+    }
+    return 0;
+}
@@ -0,0 +1,100 @@
+// Thread pool benchmark: speedup of the CalculatorEngine batch entry points
+// and of an unevenly loaded parallelFor for 1 .. N threads (the caller plus
+// N-1 workers).  Results are checked against the single-thread run.
+// Build: g++ -O2 -std=c++17 -pthread -I./core benchmarks/threadpool_benchmark.cpp core/*.cpp -o threadpool_benchmark
+// Usage: threadpool_benchmark [max threads]
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include "../core/CalculatorEngine.h"
+#include "../core/ThreadPool.h"
+
+using namespace std;
+
+template <typename Body>
+double bestSeconds(int runs, Body body) {
+    double best = 1e30;
+    for (int run = 0; run < runs; run++) {
+        auto start = chrono::steady_clock::now();
+        body();
+        best = min(best, chrono::duration<double>(chrono::steady_clock::now() - start).count());
+    }
+    return best;
+}
+
+int main(int argc, char* argv[]) {
+    unsigned maxThreads = argc > 1 ? unsigned(max(1, atoi(argv[1]))) : max(1u, thread::hardware_concurrency());
+    const size_t basicCount = size_t(1) << 24;
+    const size_t trigCount = size_t(1) << 22;
+    const size_t unevenCount = size_t(1) << 14;
+
+    vector<double> a(basicCount), b(basicCount), out(basicCount);
+    for (size_t i = 0; i < basicCount; i++) {
+        a[i] = double(i % 1000) * 0.25;
+        b[i] = double(i % 17) + 1.0;
+    }
+    vector<double> angles(trigCount), sines(trigCount);
+    for (size_t i = 0; i < trigCount; i++) {
+        angles[i] = double(i % 3600) / 10.0;
+    }
+    // Iteration i costs O(i): static splitting would leave the last chunk
+    // doing most of the work
+    vector<double> uneven(unevenCount);
+    auto unevenBody = [&uneven](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            double sum = 0;
+            for (size_t k = 0; k < i; k++) {
+                sum += sqrt(double(k));
+            }
+            uneven[i] = sum;
+        }
+    };
+
+    CalculatorEngine engine;
+    vector<double> referenceProduct, referenceSines, referenceUneven;
+    double baseMultiply = 0, baseSine = 0, baseUneven = 0;
+
+    cout << "Batch multiply: " << basicCount << " elements, sin: " << trigCount
+         << " elements, uneven loop: " << unevenCount << " iterations" << endl << endl;
+    cout << setw(8) << "threads" << setw(14) << "multiply GB/s" << setw(10) << "speedup"
+         << setw(12) << "sin M/s" << setw(10) << "speedup"
+         << setw(12) << "uneven ms" << setw(10) << "speedup" << endl;
+
+    for (unsigned threads = 1; threads <= maxThreads; threads++) {
+        ThreadPool::setGlobalWorkers(threads - 1);
+
+        double multiply = bestSeconds(5, [&]() {
+            engine.performBasicOperation(a.data(), b.data(), out.data(), basicCount, '*');
+        });
+        double sine = bestSeconds(3, [&]() {
+            engine.performTrigOperation("sin", angles.data(), sines.data(), trigCount);
+        });
+        double unevenTime = bestSeconds(3, [&]() {
+            ThreadPool::global().parallelFor(size_t(0), unevenCount, unevenBody, 64);
+        });
+
+        bool same = true;
+        if (threads == 1) {
+            referenceProduct = out;
+            referenceSines = sines;
+            referenceUneven = uneven;
+            baseMultiply = multiply;
+            baseSine = sine;
+            baseUneven = unevenTime;
+        } else {
+            same = out == referenceProduct && sines == referenceSines && uneven == referenceUneven;
+        }
+        double bytes = 3.0 * sizeof(double) * basicCount;
+        cout << fixed << setprecision(2) << setw(8) << threads
+             << setw(14) << bytes / multiply / 1e9 << setw(9) << baseMultiply / multiply << "x"
+             << setw(12) << trigCount / sine / 1e6 << setw(9) << baseSine / sine << "x"
+             << setw(12) << unevenTime * 1000 << setw(9) << baseUneven / unevenTime << "x"
+             << (same ? "" : "  MISMATCH") << endl;
+    }
+    return 0;
+}
@@ -0,0 +1,121 @@
+// Worksheet benchmark: a 1M-cell sheet of 1000 independent blocks, each an
+// input feeding 999 formula cells.  Reports full recalculation per thread
+// count, a small change set (10 inputs) and an angle mode flip.
+// Usage: worksheet_benchmark [max threads]
+// Build: g++ -O2 -std=c++17 -pthread -I./core benchmarks/worksheet_benchmark.cpp core/*.cpp -o worksheet_benchmark
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../core/Worksheet.h"
+
+using namespace std;
+
+const size_t blocks = 1000;
+const size_t cellsPerBlock = 1000;
+
+double secondsSince(chrono::steady_clock::time_point start) {
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+uint64_t checksum(Worksheet& sheet, const vector<size_t>& ids) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (size_t id : ids) {
+        double value = sheet.getValue(id);
+        uint64_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        hash = (hash ^ bits) * 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+int main(int argc, char* argv[]) {
+    static const char* const shapes[] = {"a * sin(b)", "a + b / 2", "(a - b) * 0.5", "cos(a) + b"};
+    Worksheet sheet;
+    vector<size_t> inputs;
+    vector<size_t> all;
+
+    // Cell n of a block reads cell n-1 and one of the eight cells before it
+    auto start = chrono::steady_clock::now();
+    uint32_t random = 12345;
+    for (size_t block = 0; block < blocks; block++) {
+        string prefix = "c" + to_string(block) + "_";
+        string input = prefix + "0";
+        sheet.setValue(input, double(block % 360));
+        inputs.push_back(sheet.getCellId(input));
+        all.push_back(inputs.back());
+        for (size_t n = 1; n < cellsPerBlock; n++) {
+            random = random * 1664525u + 1013904223u;
+            size_t back = 1 + (random >> 16) % min<size_t>(n, 8);
+            string formula = shapes[n % 4];
+            formula.replace(formula.find('a'), 1, prefix + to_string(n - 1));
+            formula.replace(formula.rfind('b'), 1, prefix + to_string(n - back));
+            string cell = prefix + to_string(n);
+            sheet.setFormula(cell, formula);
+            all.push_back(sheet.getCellId(cell));
+        }
+    }
+    double buildSeconds = secondsSince(start);
+    start = chrono::steady_clock::now();
+    size_t evaluated = sheet.recalculate();
+    cout << "Cells: " << sheet.getCellCount() << ", built in " << fixed << setprecision(2)
+         << buildSeconds << " s, first recalculation " << evaluated << " cells in "
+         << secondsSince(start) * 1000 << " ms" << endl << endl;
+
+    // Full recalculation: every input changes
+    unsigned hardware = argc > 1 ? unsigned(max(1, atoi(argv[1]))) : max(1u, thread::hardware_concurrency());
+    uint64_t reference = 0;
+    double single = 0;
+    cout << "Full recalculation" << endl;
+    cout << setw(8) << "threads" << setw(12) << "ms" << setw(10) << "speedup" << endl;
+    for (unsigned threads = 1; threads <= hardware; threads *= 2) {
+        sheet.setThreadCount(threads);
+        double best = 1e30;
+        for (int run = 0; run < 3; run++) {
+            for (size_t id : inputs) {
+                sheet.setValue(id, double((run + 1) * 7 % 360));
+            }
+            start = chrono::steady_clock::now();
+            sheet.recalculate();
+            best = min(best, secondsSince(start));
+        }
+        uint64_t sum = checksum(sheet, all);
+        if (threads == 1) {
+            reference = sum;
+            single = best;
+        }
+        cout << setw(8) << threads << setw(12) << best * 1000 << setw(9) << single / best << "x"
+             << (sum == reference ? "" : "  MISMATCH") << endl;
+        if (threads * 2 > hardware && threads != hardware) {
+            threads = hardware / 2;
+        }
+    }
+    sheet.setThreadCount(hardware);
+
+    // Small change set
+    const int runs = 100;
+    size_t changedCells = 0;
+    start = chrono::steady_clock::now();
+    for (int run = 0; run < runs; run++) {
+        for (size_t k = 0; k < 10; k++) {
+            sheet.setValue(inputs[(run * 97 + k * 101) % blocks], double(run + k));
+        }
+        changedCells += sheet.recalculate();
+    }
+    cout << endl << "10 changed inputs: " << changedCells / runs << " cells recomputed in "
+         << setprecision(3) << secondsSince(start) / runs * 1000 << " ms" << endl;
+
+    // Angle mode flip
+    start = chrono::steady_clock::now();
+    sheet.setAngleMode(false);
+    evaluated = sheet.recalculate();
+    cout << "Angle mode flip: " << evaluated << " cells recomputed in "
+         << setprecision(2) << secondsSince(start) * 1000 << " ms" << endl;
+    return 0;
+}
@@ -1,7 +1,15 @@
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
 #include <iostream>
 #include <limits>
 #include <string>
+#include <vector>
 #include "core/CalculatorEngine.h"
+#include "core/EngineStats.h"
+#include "core/NumberFormat.h"
+#include "core/Tracer.h"
+#include "core/TableEvaluator.h"
 
 using namespace std;
 
@@ -19,7 +27,9 @@ void showMenu() {
     cout << "5. Clear memory (MC)" << endl;
     cout << "6. Show memory status" << endl;
     cout << "7. Toggle angle mode (Degrees/Radians)" << endl;
-    cout << "8. Exit" << endl;
+    cout << "8. Complex numbers & spectrum" << endl;
+    cout << "9. Combinatorics (n!, nPr, nCr, gamma)" << endl;
+    cout << "10. Exit" << endl;
     cout << "Choose an option: ";
 }
 
@@ -35,8 +45,346 @@ void showTrigMenu() {
     cout << "Choose a function: ";
 }
 
-int main() {
+void showComplexMenu() {
+    cout << "\n=== Complex Numbers & Spectrum ===" << endl;
+    cout << "1. Complex arithmetic (+, -, *, /)" << endl;
+    cout << "2. Polar to rectangular" << endl;
+    cout << "3. Rectangular to polar" << endl;
+    cout << "4. Complex trigonometric function" << endl;
+    cout << "5. Magnitude spectrum (FFT)" << endl;
+    cout << "6. Back to main menu" << endl;
+    cout << "Choose an option: ";
+}
+
+void showCombinatoricsMenu() {
+    cout << "\n=== Combinatorics ===" << endl;
+    cout << "1. Factorial (n!)" << endl;
+    cout << "2. Permutations (nPr)" << endl;
+    cout << "3. Combinations (nCr)" << endl;
+    cout << "4. Exact combinations (all digits)" << endl;
+    cout << "5. Gamma function" << endl;
+    cout << "6. Back to main menu" << endl;
+    cout << "Choose an option: ";
+}
+
+double readNumber() {
+    string token;
+    double value;
+    while (!(cin >> token) || !NumberFormat::parse(token, value)) {
+        cout << "Invalid input! Please enter a number: ";
+        clearInput();
+    }
+    return value;
+}
+
+complex<double> readComplex() {
+    cout << "  real part: ";
+    double re = readNumber();
+    cout << "  imaginary part: ";
+    double im = readNumber();
+    return complex<double>(re, im);
+}
+
+void runComplexMenu(CalculatorEngine& engine) {
+    int choice;
+    do {
+        showComplexMenu();
+        while (!(cin >> choice)) {
+            cout << "Invalid input! Please enter a number: ";
+            clearInput();
+        }
+        
+        switch (choice) {
+            case 1: {
+                cout << "Enter first complex number:" << endl;
+                complex<double> a = readComplex();
+                char operation;
+                cout << "Enter operation (+, -, *, /): ";
+                cin >> operation;
+                cout << "Enter second complex number:" << endl;
+                complex<double> b = readComplex();
+                complex<double> result = engine.performComplexOperation(a, b, operation);
+                cout << "= " << ComplexCalculator::toString(result) << endl;
+                break;
+            }
+            case 2: {
+                cout << "Enter magnitude: ";
+                double magnitude = readNumber();
+                cout << "Enter angle (" << engine.getAngleModeString() << "): ";
+                double angle = readNumber();
+                complex<double> result = engine.polarToRectangular(magnitude, angle);
+                cout << "= " << ComplexCalculator::toString(result) << endl;
+                break;
+            }
+            case 3: {
+                cout << "Enter complex number:" << endl;
+                complex<double> value = readComplex();
+                cout << "magnitude = " << NumberFormat::toString(engine.complexMagnitude(value))
+                     << ", angle = " << NumberFormat::toString(engine.complexArgument(value))
+                     << " (" << engine.getAngleModeString() << ")" << endl;
+                break;
+            }
+            case 4: {
+                string function;
+                cout << "Enter function (sin, cos, tan, asin, acos, atan): ";
+                cin >> function;
+                cout << "Enter complex argument:" << endl;
+                complex<double> value = readComplex();
+                complex<double> result = engine.performComplexTrigOperation(function, value);
+                cout << function << "(" << ComplexCalculator::toString(value) << ") = "
+                     << ComplexCalculator::toString(result) << endl;
+                break;
+            }
+            case 5: {
+                cout << "Number of samples: ";
+                int count;
+                while (!(cin >> count) || count <= 0) {
+                    cout << "Invalid input! Please enter a positive number: ";
+                    clearInput();
+                }
+                vector<double> samples(count);
+                cout << "Enter " << count << " samples: ";
+                for (int i = 0; i < count; i++) {
+                    samples[i] = readNumber();
+                }
+                vector<double> spectrum = engine.computeSpectrum(samples);
+                for (size_t k = 0; k < spectrum.size(); k++) {
+                    cout << "  bin " << k << ": " << NumberFormat::toString(spectrum[k]) << endl;
+                }
+                break;
+            }
+            case 6:
+                cout << "Returning to main menu..." << endl;
+                break;
+            default:
+                cout << "Invalid choice! Please select 1-6." << endl;
+                break;
+        }
+    } while (choice != 6);
+}
+
+void runCombinatoricsMenu(CalculatorEngine& engine) {
+    int choice;
+    do {
+        showCombinatoricsMenu();
+        while (!(cin >> choice)) {
+            cout << "Invalid input! Please enter a number: ";
+            clearInput();
+        }
+        
+        switch (choice) {
+            case 1: {
+                cout << "Enter n: ";
+                double n = readNumber();
+                double result = engine.factorial(n);
+                cout << NumberFormat::toString(n) << "! = " << NumberFormat::toString(result) << endl;
+                break;
+            }
+            case 2:
+            case 3: {
+                cout << "Enter n: ";
+                double n = readNumber();
+                cout << "Enter k: ";
+                double k = readNumber();
+                double result = choice == 2 ? engine.permutations(n, k) : engine.combinations(n, k);
+                cout << (choice == 2 ? "P(" : "C(") << NumberFormat::toString(n) << ", " << NumberFormat::toString(k)
+                     << ") = " << NumberFormat::toString(result) << endl;
+                break;
+            }
+            case 4: {
+                cout << "Enter n and k: ";
+                unsigned long long n, k;
+                while (!(cin >> n >> k)) {
+                    cout << "Invalid input! Please enter two non-negative integers: ";
+                    clearInput();
+                }
+                string digits = engine.exactCombinations(n, k);
+                if (!digits.empty()) {
+                    cout << "C(" << n << ", " << k << ") = " << digits << endl;
+                }
+                break;
+            }
+            case 5: {
+                cout << "Enter x: ";
+                double x = readNumber();
+                double result = engine.gamma(x);
+                cout << "gamma(" << NumberFormat::toString(x) << ") = " << NumberFormat::toString(result) << endl;
+                break;
+            }
+            case 6:
+                cout << "Returning to main menu..." << endl;
+                break;
+            default:
+                cout << "Invalid choice! Please select 1-6." << endl;
+                break;
+        }
+    } while (choice != 6);
+}
+
+// Batch mode: calculator --table <file> "<name = expression>" <output> [--binary] [--radians]
+int runTableMode(int argc, char* argv[]) {
+    if (argc < 5) {
+        cout << "Usage: " << argv[0] << " --table <input.csv|input.tbl> \"out = expression\" <output> [--binary] [--radians]" << endl;
+        return 1;
+    }
+    bool binaryOutput = false;
+    TableEvaluator table;
+    for (int i = 5; i < argc; i++) {
+        string flag = argv[i];
+        if (flag == "--binary") {
+            binaryOutput = true;
+        } else if (flag == "--radians") {
+            table.setAngleMode(false);
+        }
+    }
+    
+    if (!table.open(argv[2])) {
+        return 1;
+    }
+    size_t rows = table.evaluateToFile(argv[3], argv[4], binaryOutput);
+    if (rows == 0 && table.getRowCount() != 0) {
+        return 1;
+    }
+    cout << "Wrote " << rows << " rows to " << argv[4] << endl;
+    return 0;
+}
+
+bool parseInteger(const char* text, uint64_t& value) {
+    char* end = nullptr;
+    errno = 0;
+    value = strtoull(text, &end, 10);
+    if (text[0] == '-' || end == text || *end != '\0' || errno == ERANGE) {
+        cout << "Error: '" << text << "' is not an unsigned 64-bit integer!" << endl;
+        return false;
+    }
+    return true;
+}
+
+void printIntegers(const vector<uint64_t>& values) {
+    for (size_t i = 0; i < values.size(); i++) {
+        cout << (i > 0 ? " " : "") << values[i];
+    }
+    cout << endl;
+}
+
+// Batch mode: calculator --number <command> <integers...>
+//   isprime n... | next n... | factor n... | gcd a b | lcm a b |
+//   modpow base exponent modulus | count limit | primes low high |
+//   ncr n k (exact)
+int runNumberMode(int argc, char* argv[]) {
+    const string usage = string("Usage: ") + argv[0] + " --number isprime|next|factor <n...> | gcd|lcm <a> <b>"
+                         " | modpow <base> <exponent> <modulus> | count <limit> | primes <low> <high> | ncr <n> <k>";
+    if (argc < 4) {
+        cout << usage << endl;
+        return 1;
+    }
+    string command = argv[2];
+    vector<uint64_t> args;
+    for (int i = 3; i < argc; i++) {
+        uint64_t value;
+        if (!parseInteger(argv[i], value)) {
+            return 1;
+        }
+        args.push_back(value);
+    }
+    
+    CalculatorEngine calc;
+    if (command == "isprime" || command == "next" || command == "factor") {
+        for (uint64_t n : args) {
+            if (command == "isprime") {
+                cout << n << (calc.isPrime(n) ? " is prime" : " is not prime") << endl;
+            } else if (command == "next") {
+                uint64_t prime = calc.nextPrime(n);
+                if (prime == 0) {
+                    return 1;
+                }
+                cout << prime << endl;
+            } else {
+                cout << n << ":";
+                for (uint64_t factor : calc.factorize(n)) {
+                    cout << " " << factor;
+                }
+                cout << endl;
+            }
+        }
+        return 0;
+    }
+    
+    if ((command == "gcd" || command == "lcm" || command == "primes" || command == "ncr") && args.size() == 2) {
+        if (command == "ncr") {
+            string digits = calc.exactCombinations(args[0], args[1]);
+            if (digits.empty()) {
+                return 1;
+            }
+            cout << digits << endl;
+        } else if (command == "gcd") {
+            cout << calc.gcd(args[0], args[1]) << endl;
+        } else if (command == "lcm") {
+            uint64_t result = calc.lcm(args[0], args[1]);
+            if (result == 0 && args[0] != 0 && args[1] != 0) {
+                return 1;
+            }
+            cout << result << endl;
+        } else {
+            vector<uint64_t> primes = calc.primesBetween(args[0], args[1]);
+            if (calc.getState().errors != 0) {
+                return 1;
+            }
+            printIntegers(primes);
+        }
+        return 0;
+    }
+    if (command == "modpow" && args.size() == 3) {
+        uint64_t result = calc.modPow(args[0], args[1], args[2]);
+        if (calc.getState().errors != 0) {
+            return 1;
+        }
+        cout << result << endl;
+        return 0;
+    }
+    if (command == "count" && args.size() == 1) {
+        uint64_t count = calc.countPrimes(args[0]);
+        if (calc.getState().errors != 0) {
+            return 1;
+        }
+        cout << count << endl;
+        return 0;
+    }
+    cout << usage << endl;
+    return 1;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && string(argv[1]) == "--table") {
+        return runTableMode(argc, argv);
+    }
+    if (argc > 1 && string(argv[1]) == "--number") {
+        return runNumberMode(argc, argv);
+    }
+    
+    // --stats records per-operation counts and latencies, shown on exit;
+    // --trace <file> writes a Chrome trace of the engine calls on exit;
+    // --record <file> logs the session for calc_replay
+    bool showStats = false;
+    string tracePath;
+    string recordPath;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--stats") {
+            showStats = true;
+        } else if (arg == "--trace" && i + 1 < argc) {
+            tracePath = argv[++i];
+        } else if (arg == "--record" && i + 1 < argc) {
+            recordPath = argv[++i];
+        }
+    }
+    EngineStats::setEnabled(showStats);
+    Tracer::setEnabled(!tracePath.empty());
+    
     CalculatorEngine engine;
+    if (!recordPath.empty()) {
+        engine.startRecording(recordPath);
+    }
     double num1, num2, result;
     char operation;
     int choice;
@@ -61,13 +409,11 @@ int main() {
                         num1 = engine.recallFromMemory();
                     } else {
                         cout << "Memory is empty! Enter a number: ";
-                        while (!(cin >> num1)) {
-                            cout << "Invalid input! Please enter a number: ";
-                            clearInput();
-                        }
+                        num1 = readNumber();
                     }
-                } else {
-                    num1 = stod(input);
+                } else if (!NumberFormat::parse(input, num1)) {
+                    cout << "Invalid input! Please enter a number: ";
+                    num1 = readNumber();
                 }
                 
                 cout << "Enter operation (+, -, *, /): ";
@@ -81,17 +427,16 @@ int main() {
                         num2 = engine.recallFromMemory();
                     } else {
                         cout << "Memory is empty! Enter a number: ";
-                        while (!(cin >> num2)) {
-                            cout << "Invalid input! Please enter a number: ";
-                            clearInput();
-                        }
+                        num2 = readNumber();
                     }
-                } else {
-                    num2 = stod(input);
+                } else if (!NumberFormat::parse(input, num2)) {
+                    cout << "Invalid input! Please enter a number: ";
+                    num2 = readNumber();
                 }
                 
                 result = engine.performBasicOperation(num1, num2, operation);
-                cout << num1 << " " << operation << " " << num2 << " = " << result << endl;
+                cout << NumberFormat::toString(num1) << " " << operation << " " << NumberFormat::toString(num2)
+                     << " = " << NumberFormat::toString(result) << endl;
                 break;
             }
             case 2: {
@@ -109,57 +454,39 @@ int main() {
                     switch (trigChoice) {
                         case 1:
                             cout << "Enter angle: ";
-                            while (!(cin >> angle)) {
-                                cout << "Invalid input! Please enter a number: ";
-                                clearInput();
-                            }
+                            angle = readNumber();
                             trigResult = engine.performTrigOperation("sin", angle);
-                            cout << "sin(" << angle << ") = " << trigResult << endl;
+                            cout << "sin(" << NumberFormat::toString(angle) << ") = " << NumberFormat::toString(trigResult) << endl;
                             break;
                         case 2:
                             cout << "Enter angle: ";
-                            while (!(cin >> angle)) {
-                                cout << "Invalid input! Please enter a number: ";
-                                clearInput();
-                            }
+                            angle = readNumber();
                             trigResult = engine.performTrigOperation("cos", angle);
-                            cout << "cos(" << angle << ") = " << trigResult << endl;
+                            cout << "cos(" << NumberFormat::toString(angle) << ") = " << NumberFormat::toString(trigResult) << endl;
                             break;
                         case 3:
                             cout << "Enter angle: ";
-                            while (!(cin >> angle)) {
-                                cout << "Invalid input! Please enter a number: ";
-                                clearInput();
-                            }
+                            angle = readNumber();
                             trigResult = engine.performTrigOperation("tan", angle);
-                            cout << "tan(" << angle << ") = " << trigResult << endl;
+                            cout << "tan(" << NumberFormat::toString(angle) << ") = " << NumberFormat::toString(trigResult) << endl;
                             break;
                         case 4:
                             cout << "Enter value (-1 to 1): ";
-                            while (!(cin >> value)) {
-                                cout << "Invalid input! Please enter a number: ";
-                                clearInput();
-                            }
+                            value = readNumber();
                             trigResult = engine.performTrigOperation("asin", value);
-                            cout << "asin(" << value << ") = " << trigResult << endl;
+                            cout << "asin(" << NumberFormat::toString(value) << ") = " << NumberFormat::toString(trigResult) << endl;
                             break;
                         case 5:
                             cout << "Enter value (-1 to 1): ";
-                            while (!(cin >> value)) {
-                                cout << "Invalid input! Please enter a number: ";
-                                clearInput();
-                            }
+                            value = readNumber();
                             trigResult = engine.performTrigOperation("acos", value);
-                            cout << "acos(" << value << ") = " << trigResult << endl;
+                            cout << "acos(" << NumberFormat::toString(value) << ") = " << NumberFormat::toString(trigResult) << endl;
                             break;
                         case 6:
                             cout << "Enter value: ";
-                            while (!(cin >> value)) {
-                                cout << "Invalid input! Please enter a number: ";
-                                clearInput();
-                            }
+                            value = readNumber();
                             trigResult = engine.performTrigOperation("atan", value);
-                            cout << "atan(" << value << ") = " << trigResult << endl;
+                            cout << "atan(" << NumberFormat::toString(value) << ") = " << NumberFormat::toString(trigResult) << endl;
                             break;
                         case 7:
                             cout << "Returning to main menu..." << endl;
@@ -174,10 +501,7 @@ int main() {
             case 3: {
                 cout << "Enter value to store in memory: ";
                 double value;
-                while (!(cin >> value)) {
-                    cout << "Invalid input! Please enter a number: ";
-                    clearInput();
-                }
+                value = readNumber();
                 engine.storeInMemory(value);
                 break;
             }
@@ -194,14 +518,27 @@ int main() {
                 engine.setAngleMode(!engine.getAngleMode());
                 break;
             case 8:
+                runComplexMenu(engine);
+                break;
+            case 9:
+                runCombinatoricsMenu(engine);
+                break;
+            case 10:
                 cout << "Thank you for using the calculator!" << endl;
                 break;
             default:
-                cout << "Invalid choice! Please select 1-8." << endl;
+                cout << "Invalid choice! Please select 1-10." << endl;
                 break;
         }
         
-    } while (choice != 8);
+    } while (choice != 10);
     
+    if (showStats) {
+        cout << "\n=== Engine Statistics ===" << endl;
+        cout << EngineStats::snapshot().toString();
+    }
+    if (!tracePath.empty() && Tracer::writeChromeTrace(tracePath)) {
+        cout << "Trace written to " << tracePath << endl;
+    }
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,581 @@
+#ifndef CALCKERNELS_H
+#define CALCKERNELS_H
+
+#include <cstddef>
+#include <limits>
+
+// Header-only, state-free math kernels usable in constexpr contexts.
+// CalculatorEngine and TrigCalculator call these at runtime, so a value
+// folded at compile time is the value the engine would return, e.g.
+//
+//     constexpr double halfSine = CalcKernels::sine(30.0, true);
+//
+// The trig kernels reduce by pi/2 as fdlibm does for medium arguments,
+// keeping the reduction's tail, which is accurate for |x| < reductionLimit
+// radians; TrigCalculator hands larger runtime arguments to libm.  Degree arguments are reduced modulo 90
+// exactly, and common angles (multiples of 15, 18 and 22.5 degrees) are
+// exact: sine(30.0, true) is 0.5 and cosine(90.0, true) is 0.
+
+namespace CalcKernels {
+
+constexpr double pi = 3.14159265358979323846;
+constexpr double reductionLimit = 823549.6;     // 2^19 * pi/2
+
+// Basic arithmetic for any precision; division by zero yields 0 like
+// CalculatorEngine::divide
+template <typename T> constexpr T add(T a, T b) { return a + b; }
+template <typename T> constexpr T subtract(T a, T b) { return a - b; }
+template <typename T> constexpr T multiply(T a, T b) { return a * b; }
+template <typename T> constexpr T divide(T a, T b) { return b == 0 ? T(0) : a / b; }
+
+template <typename T>
+constexpr T basicOperation(T a, T b, char operation) {
+    return operation == '+' ? add(a, b)
+         : operation == '-' ? subtract(a, b)
+         : operation == '*' ? multiply(a, b)
+         : operation == '/' ? divide(a, b)
+         : T(0);
+}
+
+constexpr bool isValidOperation(char operation) {
+    return operation == '+' || operation == '-' || operation == '*' || operation == '/';
+}
+
+// c[0] + c[1] x + ... + c[terms - 1] x^(terms - 1), 0 for no terms.
+// Short polynomials use Horner's rule.  From estrinTerms coefficients on,
+// the terms are dealt by index mod 4 into four Horner chains in x^4 and
+// joined by the top of Estrin's scheme, (h0 + x h1) + x^2 (h2 + x h3): the
+// chains are independent, so the dependency chain is a quarter as long.
+// The CPU tiers evaluate the same scheme lane by lane.
+constexpr size_t estrinTerms = 16;
+
+template <typename T>
+constexpr T polynomial(const T* c, size_t terms, T x) {
+    if (terms == 0) return T(0);
+    if (terms < estrinTerms) {
+        T result = c[terms - 1];
+        for (size_t i = terms - 1; i > 0; i--) result = result * x + c[i - 1];
+        return result;
+    }
+    T x2 = x * x;
+    T x4 = x2 * x2;
+    size_t rest = terms % 4;
+    size_t top = terms - rest - 4;     // highest group of four
+    T h0 = c[top], h1 = c[top + 1], h2 = c[top + 2], h3 = c[top + 3];
+    if (rest > 0) h0 = c[top + 4] * x4 + h0;
+    if (rest > 1) h1 = c[top + 5] * x4 + h1;
+    if (rest > 2) h2 = c[top + 6] * x4 + h2;
+    for (size_t k = top; k > 0; k -= 4) {
+        h0 = h0 * x4 + c[k - 4];
+        h1 = h1 * x4 + c[k - 3];
+        h2 = h2 * x4 + c[k - 2];
+        h3 = h3 * x4 + c[k - 1];
+    }
+    return (h0 + x * h1) + x2 * (h2 + x * h3);
+}
+
+// Helpers
+constexpr bool isFinite(double x) { return x - x == 0; }
+constexpr double absolute(double x) { return x < 0 ? -x : x; }
+
+// Newton iteration for x >= 0 after scaling x into [1/4, 4] by powers of 4
+constexpr double squareRoot(double x) {
+    if (!(x > 0) || !isFinite(x)) return x;
+    double scale = 1.0;
+    while (x > 4.0) { x *= 0.25; scale *= 2.0; }
+    while (x < 0.25) { x *= 4.0; scale *= 0.5; }
+    double guess = 0.5 * (1.0 + x);           // at or above the root
+    for (int i = 0; i < 64; i++) {
+        double next = 0.5 * (guess + x / guess);
+        if (!(next < guess)) break;
+        guess = next;
+    }
+    return guess * scale;
+}
+
+// Exact x mod m for positive finite m: every subtraction of m * 2^k is exact
+constexpr double exactRemainder(double x, double m) {
+    bool negative = x < 0;
+    double r = negative ? -x : x;
+    if (r >= m) {
+        double step = m;
+        while (step * 2 <= r) step *= 2;
+        while (step >= m) {
+            if (r >= step) r -= step;
+            step /= 2;
+        }
+    }
+    return negative ? -r : r;
+}
+
+constexpr double degreesToRadians(double degrees) { return degrees * pi / 180.0; }
+constexpr double radiansToDegrees(double radians) { return radians * 180.0 / pi; }
+
+// Kernels on [-pi/4, pi/4] for x + y, y the tail of a reduced argument
+// below half an ulp of x (fdlibm __kernel_sin / __kernel_cos)
+constexpr double sinPolynomial(double x, double y) {
+    double z = x * x;
+    double v = z * x;
+    double r = 8.33333333332248946124e-03 + z * (-1.98412698298579493134e-04 +
+               z * (2.75573137070700676789e-06 + z * (-2.50507602534068634195e-08 +
+               z * 1.58969099521155010221e-10)));
+    return x - ((z * (0.5 * y - v * r) - y) - v * -1.66666666666666324348e-01);
+}
+
+constexpr double cosPolynomial(double x, double y) {
+    double z = x * x;
+    double r = z * (4.16666666666666019037e-02 + z * (-1.38888888888741095749e-03 +
+               z * (2.48015872894767294178e-05 + z * (-2.75573143513906633035e-07 +
+               z * (2.08757232129817482790e-09 + z * -1.13596475577881948265e-11)))));
+    double hz = 0.5 * z;
+    double w = 1.0 - hz;
+    return w + (((1.0 - w) - hz) + (z * r - x * y));
+}
+
+// High 26 bits of x (Veltkamp), so products of two such parts are exact
+constexpr double highPart(double x) {
+    double c = 134217729.0 * x;
+    return c - (c - x);
+}
+
+// tan(x + y) for even quadrants, -1 / tan(x + y) for odd ones (fdlibm
+// __kernel_tan, with the Veltkamp split for its low-word masking)
+constexpr double tanPolynomial(double x, double y, bool odd) {
+    const double pio4 = 7.85398163397448278999e-01;
+    const double pio4Lo = 3.06161699786838301793e-17;
+    // |x| >= 0.674..., tested on the exact square so that the sign is only
+    // looked at for big x (a branch on it mispredicts on mixed signs)
+    double original = x;
+    bool big = x * x >= 0.674335479736328125 * 0.674335479736328125;
+    if (big) {
+        x = (pio4 - absolute(x)) + (pio4Lo - (x < 0 ? -y : y));
+        y = 0.0;
+    }
+    double z = x * x;
+    double w = z * z;
+    double r = 1.33333333333201242699e-01 + w * (2.18694882948595424599e-02 +
+               w * (3.59207910759131235356e-03 + w * (5.88041240820264096874e-04 +
+               w * (7.81794442939557092300e-05 + w * -1.85586374855275456654e-05))));
+    double v = z * (5.39682539762260521377e-02 + w * (8.86323982359930005737e-03 +
+               w * (1.45620945432529025516e-03 + w * (2.46463134818469906812e-04 +
+               w * (7.14072491382608190305e-05 + w * 2.59073051863633712884e-05)))));
+    double s = z * x;
+    r = y + z * (s * (r + v) + y);
+    r += 3.33333333333334091986e-01 * s;
+    w = x + r;
+    if (big) {
+        double iy = odd ? -1.0 : 1.0;
+        double result = iy - 2.0 * (x - (w * w / (w + iy) - r));
+        return original < 0 ? -result : result;
+    }
+    if (!odd) return w;
+    // -1 / w to within an ulp: w = high + tail, a = -1 / w
+    double high = highPart(w);
+    double tail = r - (high - x);
+    double a = -1.0 / w;
+    double t = highPart(a);
+    double e = 1.0 + t * high;
+    return t + a * (e + t * tail);
+}
+
+// x = quadrant * pi/2 + r + tail, |r| <= pi/4 (fdlibm __ieee754_rem_pio2
+// for medium arguments).  pi/2 is split in 33-bit parts, so fn times each
+// is exact; r keeps 85 bits of the reduction, and when it cancels more than
+// 16 bits a second and third part carry it to 118 and 151.
+struct Reduced {
+    double r;
+    double tail;
+    long long quadrant;
+};
+
+constexpr double pio2Part1 = 1.57079632673412561417e+00;
+constexpr double pio2Tail1 = 6.07710050650619224932e-11;
+
+constexpr Reduced reduceHalfPi(double x) {
+    double t = x * 6.36619772367581382433e-01;
+    double rounded = t < 0 ? t - 0.5 : t + 0.5;
+    long long n = absolute(rounded) < 9.0e18 ? static_cast<long long>(rounded) : 0;
+    double fn = static_cast<double>(n);
+    double r = x - fn * pio2Part1;
+    double w = fn * pio2Tail1;
+    double y0 = r - w;
+    if (absolute(y0) < absolute(x) * 0x1p-16) {
+        double previous = r;
+        w = fn * 6.07710050630396597660e-11;
+        r = previous - w;
+        w = fn * 2.02226624879595063154e-21 - ((previous - r) - w);
+        y0 = r - w;
+        if (absolute(y0) < absolute(x) * 0x1p-49) {
+            previous = r;
+            w = fn * 2.02226624871116645580e-21;
+            r = previous - w;
+            w = fn * 8.47842766036889956997e-32 - ((previous - r) - w);
+            y0 = r - w;
+        }
+    }
+    return Reduced{y0, (r - y0) - w, n};
+}
+
+constexpr double sineRadians(double x) {
+    if (!isFinite(x)) return x - x;
+    if (absolute(x) < 7.85398163397448278999e-01) return sinPolynomial(x, 0.0);
+    Reduced reduced = reduceHalfPi(x);
+    switch (reduced.quadrant & 3) {
+        case 0: return sinPolynomial(reduced.r, reduced.tail);
+        case 1: return cosPolynomial(reduced.r, reduced.tail);
+        case 2: return -sinPolynomial(reduced.r, reduced.tail);
+        default: return -cosPolynomial(reduced.r, reduced.tail);
+    }
+}
+
+constexpr double cosineRadians(double x) {
+    if (!isFinite(x)) return x - x;
+    if (absolute(x) < 7.85398163397448278999e-01) return cosPolynomial(x, 0.0);
+    Reduced reduced = reduceHalfPi(x);
+    switch (reduced.quadrant & 3) {
+        case 0: return cosPolynomial(reduced.r, reduced.tail);
+        case 1: return -sinPolynomial(reduced.r, reduced.tail);
+        case 2: return -cosPolynomial(reduced.r, reduced.tail);
+        default: return sinPolynomial(reduced.r, reduced.tail);
+    }
+}
+
+// Both from one reduction; the same bits as sineRadians and cosineRadians
+struct SineCosine {
+    double sine;
+    double cosine;
+};
+
+constexpr SineCosine sineCosineRadians(double x) {
+    if (!isFinite(x)) return SineCosine{x - x, x - x};
+    Reduced reduced = reduceHalfPi(x);
+    double s = sinPolynomial(reduced.r, reduced.tail);
+    double c = cosPolynomial(reduced.r, reduced.tail);
+    switch (reduced.quadrant & 3) {
+        case 0: return SineCosine{s, c};
+        case 1: return SineCosine{c, -s};
+        case 2: return SineCosine{-s, -c};
+        default: return SineCosine{-c, s};
+    }
+}
+
+constexpr double tangentRadians(double x) {
+    if (!isFinite(x)) return x - x;
+    Reduced reduced = reduceHalfPi(x);
+    return tanPolynomial(reduced.r, reduced.tail, (reduced.quadrant & 1) != 0);
+}
+
+// x * y - product exactly (Dekker), for |x|, |y| below 2^996
+constexpr double productError(double x, double y, double product) {
+    double xHigh = highPart(x), xLow = x - xHigh;
+    double yHigh = highPart(y), yLow = y - yHigh;
+    return ((xHigh * yHigh - product) + xHigh * yLow + xLow * yHigh) + xLow * yLow;
+}
+
+// fdlibm atan: reduce to |q| < 0.4375 around atan(0.5), atan(1), atan(1.5)
+// or pi/2 (each as hi + lo), then an odd polynomial of degree 23.  Unlike
+// fdlibm the rounding error of the reduction (and of the argument, as tail)
+// is carried into the sum, so the angle is good to about half an ulp; it
+// comes back as high + low for callers that add to it.
+constexpr double atanHi[] = {
+    0.0, 4.63647609000806093515e-01, 7.85398163397448278999e-01,
+    9.82793723247329054082e-01, 1.57079632679489655800e+00
+};
+constexpr double atanLo[] = {
+    0.0, 2.26987774529616870924e-17, 3.06161699786838301793e-17,
+    1.39033110312309984516e-17, 6.12323399573676603587e-17
+};
+
+// atan(q) - q
+constexpr double atanSeries(double q) {
+    double z = q * q;
+    double w = z * z;
+    double s1 = z * (3.33333333333329318027e-01 + w * (1.42857142725034663711e-01 +
+                w * (9.09088713343650656196e-02 + w * (6.66107313738753120669e-02 +
+                w * (4.97687799461593236017e-02 + w * 1.62858201153657823623e-02)))));
+    double s2 = w * (-1.99999999998764832476e-01 + w * (-1.11111104054623557880e-01 +
+                w * (-7.69187620504482999495e-02 + w * (-5.83357013379057348645e-02 +
+                w * -3.65315727442169155270e-02))));
+    return q * (s1 + s2);
+}
+
+struct Angle {
+    double high;
+    double low;
+};
+
+// atan(a + tail) for a >= 0 (inf included), |tail| <= ulp(a)
+constexpr Angle arctangentParts(double a, double tail) {
+    int id = 0;
+    double num = a, den = 1.0, denTail = 0.0;
+    if (a >= 0.4375) {
+        if (a < 0.6875) {
+            id = 1;
+            num = 2.0 * a - 1.0;
+            den = 2.0 + a;
+            denTail = (a - (den - 2.0)) + tail;
+            tail *= 2.0;
+        } else if (a < 1.1875) {
+            id = 2;
+            num = a - 1.0;
+            den = a + 1.0;
+            denTail = (1.0 - (den - a)) + tail;
+        } else if (a < 2.4375) {
+            id = 3;
+            double scaled = 1.5 * a;
+            num = a - 1.5;
+            den = 1.0 + scaled;
+            denTail = (1.0 - (den - scaled)) + productError(1.5, a, scaled) + 1.5 * tail;
+        } else {
+            id = 4;
+            num = -1.0;
+            den = a;
+            denTail = tail;
+            tail = 0.0;
+        }
+    }
+    // q + qTail = (num + tail) / (den + denTail); the numerators above are exact
+    double q = num / den;
+    double qTail = tail;
+    if (id > 0) {
+        double product = q * den;
+        qTail = den < 0x1p54 ? ((num - product) - productError(q, den, product) + tail - q * denTail) / den : 0.0;
+    }
+    // atan(q + qTail) = atan(q) + qTail / (1 + q^2), the latter close
+    // enough; hi + q is summed exactly (|q| < hi or hi = 0)
+    double sum = atanHi[id] + q;
+    double rest = (q - (sum - atanHi[id])) - ((atanSeries(q) - atanLo[id]) - (qTail - qTail * (q * q)));
+    double high = sum + rest;
+    return Angle{high, (sum - high) + rest};
+}
+
+constexpr double arctangentRadians(double x) {
+    if (x != x) return x;
+    double result = arctangentParts(absolute(x), 0.0).high;
+    return x < 0 ? -result : result;
+}
+
+// fdlibm e_atan2 quadrant handling around atan(|y / x|), the quotient's
+// rounding error passed on as the tail
+constexpr double arctangent2Radians(double y, double x) {
+    const double piLo = 1.2246467991473531772e-16;     // pi - double(pi)
+    if (x != x || y != y) return x + y;
+    // The sign of a zero shows in 1 / zero (so zeros do not fold at compile time)
+    bool negativeX = x < 0 || (x == 0 && 1.0 / x < 0);
+    bool negativeY = y < 0 || (y == 0 && 1.0 / y < 0);
+    double ax = absolute(x);
+    double ay = absolute(y);
+    double angle = 0.0;
+    if (ay == 0) {
+        angle = negativeX ? pi : 0.0;
+    } else if (ax == 0) {
+        angle = pi / 2;
+    } else if (!isFinite(ax)) {
+        angle = !isFinite(ay) ? (negativeX ? 3 * pi / 4 : pi / 4) : (negativeX ? pi : 0.0);
+    } else if (!isFinite(ay)) {
+        angle = pi / 2;
+    } else {
+        double q = ay / ax;
+        double tail = 0.0;
+        if (q < 0x1p54 && ax < 0x1p900) {
+            double product = q * ax;
+            tail = ((ay - product) - productError(q, ax, product)) / ax;
+        }
+        Angle a = arctangentParts(q, tail);
+        if (negativeX) {
+            // pi - a with the rounding of the difference kept
+            double difference = pi - a.high;
+            angle = difference + (((pi - difference) - a.high) + (piLo - a.low));
+        } else {
+            angle = a.high;
+        }
+    }
+    return negativeY ? -angle : angle;
+}
+
+constexpr double arcsineRadians(double x) {
+    if (absolute(x) == 1.0) return x * (pi / 2);
+    return arctangentRadians(x / squareRoot((1.0 - x) * (1.0 + x)));
+}
+
+constexpr double arccosineRadians(double x) {
+    if (x == -1.0) return pi;
+    return 2.0 * arctangentRadians(squareRoot((1.0 - x) / (1.0 + x)));
+}
+
+// Degree arguments.  x = 90 * quadrant + r with |r| <= 45 is computed
+// exactly, so the only rounding before the polynomials is one multiply by
+// pi/180.  Multiples of 15, 18 and 22.5 degrees skip even that and come
+// from a table of correctly rounded values.
+constexpr double degree = 1.74532925199432957692e-02;    // pi/180
+
+// n is the nearest integer to x / 90 (adding and subtracting 1.5 * 2^52
+// rounds without a branch on the sign) up to the rounding of that
+// quotient, which below 2^40 leaves |r| <= 45 + 2^-12.  The subtraction is
+// exact: 90 * n is an integer and the ulp of x at most 1.  Larger x are
+// integers and are first reduced modulo 360, exactly, into that range.
+constexpr Reduced reduceDegrees(double x) {
+    double reduced = absolute(x) < 0x1p40 ? x : exactRemainder(x, 360.0);
+    double t = reduced * (1.0 / 90.0);
+    long long n = static_cast<long long>((t + 0x1.8p52) - 0x1.8p52);
+    return Reduced{reduced - 90.0 * static_cast<double>(n), 0.0, n};
+}
+
+struct SpecialAngle {
+    double degrees;
+    double sine;
+    double cosine;
+    double tangent;
+    double cotangent;
+};
+
+constexpr SpecialAngle specialAngles[] = {
+    { 0.0, 0.0, 1.0, 0.0, std::numeric_limits<double>::infinity() },
+    { 15.0, 0.25881904510252074, 0.9659258262890683, 0.2679491924311227, 3.732050807568877 },
+    { 18.0, 0.30901699437494745, 0.9510565162951535, 0.32491969623290634, 3.0776835371752536 },
+    { 22.5, 0.3826834323650898, 0.9238795325112867, 0.41421356237309503, 2.414213562373095 },
+    { 30.0, 0.5, 0.8660254037844386, 0.5773502691896257, 1.7320508075688772 },
+    { 36.0, 0.5877852522924731, 0.8090169943749475, 0.7265425280053609, 1.3763819204711736 },
+    { 45.0, 0.7071067811865476, 0.7071067811865476, 1.0, 1.0 },
+};
+constexpr int specialAngleCount = sizeof(specialAngles) / sizeof(specialAngles[0]);
+
+// specialAngles index by half degrees, so the lookup needs no search
+struct SpecialAngleTable {
+    signed char byHalfDegree[91];
+
+    constexpr SpecialAngleTable() : byHalfDegree() {
+        for (int i = 0; i <= 90; i++) byHalfDegree[i] = -1;
+        for (int i = 0; i < specialAngleCount; i++) {
+            byHalfDegree[static_cast<int>(specialAngles[i].degrees * 2)] = static_cast<signed char>(i);
+        }
+    }
+};
+constexpr SpecialAngleTable specialAngleTable;
+
+// Table index for a reduced angle, or -1
+constexpr int specialAngleIndex(double r) {
+    double halfDegrees = absolute(r) * 2.0;
+    int whole = static_cast<int>(halfDegrees);
+    return whole <= 90 && halfDegrees == whole ? specialAngleTable.byHalfDegree[whole] : -1;
+}
+
+// sin and cos of r degrees, |r| <= 45.  Results that are exactly zero come
+// out as +0 in the other quadrants (sin 180 = +0, cos 90 = +0).
+constexpr double sineReduced(double r) {
+    int special = specialAngleIndex(r);
+    if (special < 0) return sinPolynomial(r * degree, 0.0);
+    return r < 0 ? -specialAngles[special].sine : specialAngles[special].sine;
+}
+
+constexpr double cosineReduced(double r) {
+    int special = specialAngleIndex(r);
+    return special < 0 ? cosPolynomial(r * degree, 0.0) : specialAngles[special].cosine;
+}
+
+constexpr double sineDegrees(double x) {
+    if (!isFinite(x)) return x - x;
+    Reduced reduced = reduceDegrees(x);
+    switch (reduced.quadrant & 3) {
+        case 0: return sineReduced(reduced.r);
+        case 1: return cosineReduced(reduced.r);
+        case 2: return 0.0 - sineReduced(reduced.r);
+        default: return 0.0 - cosineReduced(reduced.r);
+    }
+}
+
+constexpr double cosineDegrees(double x) {
+    if (!isFinite(x)) return x - x;
+    Reduced reduced = reduceDegrees(x);
+    switch (reduced.quadrant & 3) {
+        case 0: return cosineReduced(reduced.r);
+        case 1: return 0.0 - sineReduced(reduced.r);
+        case 2: return 0.0 - cosineReduced(reduced.r);
+        default: return sineReduced(reduced.r);
+    }
+}
+
+constexpr SineCosine sineCosineDegrees(double x) {
+    if (!isFinite(x)) return SineCosine{x - x, x - x};
+    Reduced reduced = reduceDegrees(x);
+    int special = specialAngleIndex(reduced.r);
+    double s = 0.0;
+    double c = 0.0;
+    if (special < 0) {
+        double a = reduced.r * degree;
+        s = sinPolynomial(a, 0.0);
+        c = cosPolynomial(a, 0.0);
+    } else {
+        s = reduced.r < 0 ? -specialAngles[special].sine : specialAngles[special].sine;
+        c = specialAngles[special].cosine;
+    }
+    switch (reduced.quadrant & 3) {
+        case 0: return SineCosine{s, c};
+        case 1: return SineCosine{c, 0.0 - s};
+        case 2: return SineCosine{0.0 - s, 0.0 - c};
+        default: return SineCosine{0.0 - c, s};
+    }
+}
+
+// Poles follow tanPi: tan 90 = +inf, tan 270 = tan -90 = -inf
+constexpr double tangentDegrees(double x) {
+    if (!isFinite(x)) return x - x;
+    Reduced reduced = reduceDegrees(x);
+    bool odd = (reduced.quadrant & 1) != 0;
+    double r = reduced.r;
+    if (odd && r == 0) {
+        return (reduced.quadrant & 3) == 1 ? std::numeric_limits<double>::infinity()
+                                            : -std::numeric_limits<double>::infinity();
+    }
+    int special = specialAngleIndex(r);
+    if (special >= 0) {
+        double value = odd ? -specialAngles[special].cotangent : specialAngles[special].tangent;
+        return r < 0 ? -value : value;
+    }
+    return tanPolynomial(r * degree, 0.0, odd);
+}
+
+// Angle-mode aware kernels used by TrigCalculator
+constexpr double sine(double angle, bool degrees) {
+    return degrees ? sineDegrees(angle) : sineRadians(angle);
+}
+
+constexpr double cosine(double angle, bool degrees) {
+    return degrees ? cosineDegrees(angle) : cosineRadians(angle);
+}
+
+constexpr double tangent(double angle, bool degrees) {
+    return degrees ? tangentDegrees(angle) : tangentRadians(angle);
+}
+
+constexpr SineCosine sineCosine(double angle, bool degrees) {
+    return degrees ? sineCosineDegrees(angle) : sineCosineRadians(angle);
+}
+
+// Inverse functions return 0 outside [-1, 1], like TrigCalculator
+constexpr double arcsine(double value, bool degrees) {
+    if (value < -1 || value > 1) return 0;
+    double result = arcsineRadians(value);
+    return degrees ? radiansToDegrees(result) : result;
+}
+
+constexpr double arccosine(double value, bool degrees) {
+    if (value < -1 || value > 1) return 0;
+    double result = arccosineRadians(value);
+    return degrees ? radiansToDegrees(result) : result;
+}
+
+constexpr double arctangent(double value, bool degrees) {
+    double result = arctangentRadians(value);
+    return degrees ? radiansToDegrees(result) : result;
+}
+
+// Angle of the point (x, y), in (-180, 180] degrees or (-pi, pi]
+constexpr double arctangent2(double y, double x, bool degrees) {
+    double result = arctangent2Radians(y, x);
+    return degrees ? radiansToDegrees(result) : result;
+}
+
+} // namespace CalcKernels
+
+#endif // CALCKERNELS_H
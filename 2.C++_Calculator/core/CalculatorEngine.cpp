@@ -1,133 +1,895 @@
 #include "CalculatorEngine.h"
+#include "CalcKernels.h"
+#include "CpuDispatch.h"
+#include "EngineStats.h"
+#include "ThreadPool.h"
+#include "Tracer.h"
 #include <iostream>
+#include <type_traits>
 
 using namespace std;
 
-CalculatorEngine::CalculatorEngine() {
+namespace {
+
+// Below these sizes a batch is not worth splitting across threads
+const size_t parallelBasicCount = size_t(1) << 16;
+const size_t parallelTrigCount = 4096;
+
+// Runs body(begin, end) over [0, count), on the global pool when large
+template <typename Body>
+void forRange(size_t count, size_t threshold, Body body) {
+    if (count < threshold) {
+        body(size_t(0), count);
+    } else {
+        ThreadPool::global().parallelFor(size_t(0), count, body);
+    }
+}
+
+} // namespace
+
+template <typename T>
+BasicCalculatorEngine<T>::BasicCalculatorEngine() {
     lastResult = 0.0;
+    pendingErrors = 0;
+    publishState();
 }
 
 // Basic arithmetic operations
-double CalculatorEngine::add(double a, double b) {
-    return a + b;
+template <typename T>
+T BasicCalculatorEngine<T>::add(T a, T b) {
+    return CalcKernels::add(a, b);
 }
 
-double CalculatorEngine::subtract(double a, double b) {
-    return a - b;
+template <typename T>
+T BasicCalculatorEngine<T>::subtract(T a, T b) {
+    return CalcKernels::subtract(a, b);
 }
 
-double CalculatorEngine::multiply(double a, double b) {
-    return a * b;
+template <typename T>
+T BasicCalculatorEngine<T>::multiply(T a, T b) {
+    return CalcKernels::multiply(a, b);
 }
 
-double CalculatorEngine::divide(double a, double b) {
+template <typename T>
+T BasicCalculatorEngine<T>::divide(T a, T b) {
     if (b == 0) {
+        EngineStats::recordError(EngineStats::DivisionByZero);
+        pendingErrors |= StateDivisionByZero;
         cout << "Error: Division by zero!" << endl;
-        return 0;
     }
-    return a / b;
+    return CalcKernels::divide(a, b);
 }
 
-double CalculatorEngine::performBasicOperation(double a, double b, char operation) {
-    double result = 0.0;
+template <typename T>
+T BasicCalculatorEngine<T>::performBasicOperation(T a, T b, char operation) {
+    T result = 0.0;
+    StatsTimer timer;
+    TraceScope trace("CalculatorEngine::performBasicOperation");
     
     switch (operation) {
         case '+':
+            timer.setOperation(EngineStats::Add);
             result = add(a, b);
             break;
         case '-':
+            timer.setOperation(EngineStats::Subtract);
             result = subtract(a, b);
             break;
         case '*':
+            timer.setOperation(EngineStats::Multiply);
             result = multiply(a, b);
             break;
         case '/':
+            timer.setOperation(EngineStats::Divide);
             result = divide(a, b);
             break;
         default:
+            EngineStats::recordError(EngineStats::InvalidOperation);
+            pendingErrors |= StateInvalidOperation;
+            publishState();
             cout << "Invalid operation!" << endl;
             return 0;
     }
     
+    if (recorder) {
+        recorder->recordBasic(double(a), double(b), operation, double(result));
+    }
     lastResult = result;
+    publishState();
     return result;
 }
 
 // Trigonometric operations
-double CalculatorEngine::performTrigOperation(const string& function, double value) {
-    double result = 0.0;
+template <typename T>
+T BasicCalculatorEngine<T>::performTrigOperation(const string& function, T value) {
+    T result = 0.0;
+    StatsTimer timer;
+    TraceScope trace("CalculatorEngine::performTrigOperation");
     
     if (function == "sin" || function == "sine") {
+        timer.setOperation(EngineStats::Sine);
         result = trigCalc.sine(value);
     } else if (function == "cos" || function == "cosine") {
+        timer.setOperation(EngineStats::Cosine);
         result = trigCalc.cosine(value);
     } else if (function == "tan" || function == "tangent") {
+        timer.setOperation(EngineStats::Tangent);
         result = trigCalc.tangent(value);
     } else if (function == "asin" || function == "arcsine") {
+        timer.setOperation(EngineStats::Arcsine);
+        if (value < -1 || value > 1) pendingErrors |= StateDomainError;
         result = trigCalc.arcsine(value);
     } else if (function == "acos" || function == "arccosine") {
+        timer.setOperation(EngineStats::Arccosine);
+        if (value < -1 || value > 1) pendingErrors |= StateDomainError;
         result = trigCalc.arccosine(value);
     } else if (function == "atan" || function == "arctangent") {
+        timer.setOperation(EngineStats::Arctangent);
         result = trigCalc.arctangent(value);
     } else {
+        EngineStats::recordError(EngineStats::InvalidOperation);
+        pendingErrors |= StateInvalidOperation;
+        publishState();
         cout << "Invalid trigonometric function!" << endl;
         return 0;
     }
     
+    if (recorder) {
+        recorder->recordTrig(function, double(value), double(result));
+    }
     lastResult = result;
+    publishState();
     return result;
 }
 
-void CalculatorEngine::setAngleMode(bool degrees) {
-    trigCalc.setAngleMode(degrees);
+template <typename T>
+void BasicCalculatorEngine<T>::performSineCosine(T angle, T& sine, T& cosine) {
+    StatsTimer timer(EngineStats::SineCosine);
+    TraceScope trace("CalculatorEngine::performSineCosine");
+    trigCalc.sineCosine(angle, sine, cosine);
+    lastResult = sine;
+    publishState();
 }
 
-bool CalculatorEngine::getAngleMode() {
+// Exponential, logarithmic and hyperbolic operations
+template <typename T>
+T BasicCalculatorEngine<T>::performScientificOperation(const string& function, T value) {
+    T result = 0.0;
+    StatsTimer timer;
+    TraceScope trace("CalculatorEngine::performScientificOperation");
+    
+    if (function == "exp") {
+        timer.setOperation(EngineStats::Exponential);
+        result = scientificCalc.exponential(value);
+    } else if (function == "ln" || function == "log") {
+        timer.setOperation(EngineStats::Logarithm);
+        if (value <= 0) pendingErrors |= StateDomainError;
+        result = scientificCalc.logarithm(value);
+    } else if (function == "log10") {
+        timer.setOperation(EngineStats::Logarithm10);
+        if (value <= 0) pendingErrors |= StateDomainError;
+        result = scientificCalc.logarithm10(value);
+    } else if (function == "sqrt") {
+        timer.setOperation(EngineStats::SquareRoot);
+        if (value < 0) pendingErrors |= StateDomainError;
+        result = scientificCalc.squareRoot(value);
+    } else if (function == "sinh") {
+        timer.setOperation(EngineStats::HyperbolicSine);
+        result = scientificCalc.hyperbolicSine(value);
+    } else if (function == "cosh") {
+        timer.setOperation(EngineStats::HyperbolicCosine);
+        result = scientificCalc.hyperbolicCosine(value);
+    } else if (function == "tanh") {
+        timer.setOperation(EngineStats::HyperbolicTangent);
+        result = scientificCalc.hyperbolicTangent(value);
+    } else if (function == "asinh" || function == "arsinh") {
+        timer.setOperation(EngineStats::InverseHyperbolicSine);
+        result = scientificCalc.inverseHyperbolicSine(value);
+    } else if (function == "acosh" || function == "arcosh") {
+        timer.setOperation(EngineStats::InverseHyperbolicCosine);
+        if (value < 1) pendingErrors |= StateDomainError;
+        result = scientificCalc.inverseHyperbolicCosine(value);
+    } else if (function == "atanh" || function == "artanh") {
+        timer.setOperation(EngineStats::InverseHyperbolicTangent);
+        if (value <= -1 || value >= 1) pendingErrors |= StateDomainError;
+        result = scientificCalc.inverseHyperbolicTangent(value);
+    } else {
+        EngineStats::recordError(EngineStats::InvalidOperation);
+        pendingErrors |= StateInvalidOperation;
+        publishState();
+        cout << "Invalid scientific function!" << endl;
+        return 0;
+    }
+    
+    lastResult = result;
+    publishState();
+    return result;
+}
+
+template <typename T>
+T BasicCalculatorEngine<T>::power(T base, T exponent) {
+    StatsTimer timer(EngineStats::Power);
+    TraceScope trace("CalculatorEngine::power");
+    if (BasicScientificCalculator<T>::isPowerDomainError(base, exponent)) {
+        pendingErrors |= StateDomainError;
+    }
+    lastResult = scientificCalc.power(base, exponent);
+    publishState();
+    return lastResult;
+}
+
+template <typename T>
+void BasicCalculatorEngine<T>::setAngleMode(bool degrees, bool announce) {
+    if (recorder) {
+        recorder->recordAngleMode(degrees);
+    }
+    trigCalc.setAngleMode(degrees, announce);
+    complexCalc.setAngleMode(degrees);
+    publishState();
+}
+
+template <typename T>
+bool BasicCalculatorEngine<T>::getAngleMode() {
     return trigCalc.getAngleMode();
 }
 
-string CalculatorEngine::getAngleModeString() {
+template <typename T>
+string BasicCalculatorEngine<T>::getAngleModeString() {
     return trigCalc.getAngleMode() ? "Degrees" : "Radians";
 }
 
+// Batch operations
+template <typename T>
+void BasicCalculatorEngine<T>::performBasicOperation(const T* a, const T* b, T* out, size_t count, char operation) {
+    StatsTimer timer(EngineStats::BatchBasic);
+    TraceScope trace("CalculatorEngine::performBasicOperation[]");
+    if (!isValidOperation(operation)) {
+        cout << "Invalid operation!" << endl;
+        return;
+    }
+    
+    // double and float run on the kernels for this CPU (see CpuDispatch.h);
+    // the wider precisions get one loop per operation
+    if constexpr (is_same<T, double>::value) {
+        ArrayKernels::BinaryKernel kernel = CpuDispatch::kernels().forOperation(operation);
+        forRange(count, parallelBasicCount, [=](size_t begin, size_t end) {
+            kernel(a + begin, b + begin, out + begin, end - begin);
+        });
+    } else if constexpr (is_same<T, float>::value) {
+        ArrayKernels::FloatBinaryKernel kernel = CpuDispatch::kernels().forFloatOperation(operation);
+        forRange(count, parallelBasicCount, [=](size_t begin, size_t end) {
+            kernel(a + begin, b + begin, out + begin, end - begin);
+        });
+    } else {
+        switch (operation) {
+            case '+':
+                forRange(count, parallelBasicCount, [=](size_t begin, size_t end) {
+                    for (size_t i = begin; i < end; i++) out[i] = CalcKernels::add(a[i], b[i]);
+                });
+                break;
+            case '-':
+                forRange(count, parallelBasicCount, [=](size_t begin, size_t end) {
+                    for (size_t i = begin; i < end; i++) out[i] = CalcKernels::subtract(a[i], b[i]);
+                });
+                break;
+            case '*':
+                forRange(count, parallelBasicCount, [=](size_t begin, size_t end) {
+                    for (size_t i = begin; i < end; i++) out[i] = CalcKernels::multiply(a[i], b[i]);
+                });
+                break;
+            case '/':
+                forRange(count, parallelBasicCount, [=](size_t begin, size_t end) {
+                    for (size_t i = begin; i < end; i++) out[i] = CalcKernels::divide(a[i], b[i]);
+                });
+                break;
+        }
+    }
+    
+    if (count > 0) {
+        lastResult = out[count - 1];
+        publishState();
+    }
+}
+
+template <typename T>
+void BasicCalculatorEngine<T>::performTrigOperation(const string& function, const T* values, T* out, size_t count) {
+    StatsTimer timer(EngineStats::BatchTrig);
+    TraceScope trace("CalculatorEngine::performTrigOperation[]");
+    typename BasicTrigCalculator<T>::Kernel kernel = BasicTrigCalculator<T>::kernelFor(function);
+    if (kernel == nullptr) {
+        cout << "Invalid trigonometric function!" << endl;
+        return;
+    }
+    
+    forRange(count, parallelTrigCount, [&](size_t begin, size_t end) {
+        trigCalc.applyArray(kernel, values + begin, out + begin, end - begin);
+    });
+    if (count > 0) {
+        lastResult = out[count - 1];
+        publishState();
+    }
+}
+
+template <typename T>
+void BasicCalculatorEngine<T>::performScientificOperation(const string& function, const T* values, T* out, size_t count) {
+    StatsTimer timer(EngineStats::BatchScientific);
+    TraceScope trace("CalculatorEngine::performScientificOperation[]");
+    typename BasicScientificCalculator<T>::Kernel kernel = BasicScientificCalculator<T>::kernelFor(function);
+    if (kernel == nullptr) {
+        cout << "Invalid scientific function!" << endl;
+        return;
+    }
+    
+    forRange(count, parallelTrigCount, [=](size_t begin, size_t end) {
+        BasicScientificCalculator<T>::applyArray(kernel, values + begin, out + begin, end - begin);
+    });
+    if (count > 0) {
+        lastResult = out[count - 1];
+        publishState();
+    }
+}
+
+template <typename T>
+void BasicCalculatorEngine<T>::performPowerOperation(const T* bases, const T* exponents, T* out, size_t count) {
+    StatsTimer timer(EngineStats::BatchScientific);
+    TraceScope trace("CalculatorEngine::performPowerOperation[]");
+    forRange(count, parallelTrigCount, [=](size_t begin, size_t end) {
+        BasicScientificCalculator<T>::applyPower(bases + begin, exponents + begin, out + begin, end - begin);
+    });
+    if (count > 0) {
+        lastResult = out[count - 1];
+        publishState();
+    }
+}
+
+template <typename T>
+void BasicCalculatorEngine<T>::performSineCosine(const T* angles, T* sines, T* cosines, size_t count) {
+    StatsTimer timer(EngineStats::BatchTrig);
+    TraceScope trace("CalculatorEngine::performSineCosine[]");
+    forRange(count, parallelTrigCount, [&](size_t begin, size_t end) {
+        trigCalc.applySineCosine(angles + begin, sines + begin, cosines + begin, end - begin);
+    });
+    if (count > 0) {
+        lastResult = sines[count - 1];
+        publishState();
+    }
+}
+
+template <typename T>
+void BasicCalculatorEngine<T>::polarToRectangular(const T* magnitudes, const T* angles, T* xs, T* ys, size_t count) {
+    StatsTimer timer(EngineStats::BatchPolar);
+    TraceScope trace("CalculatorEngine::polarToRectangular[]");
+    forRange(count, parallelTrigCount, [&](size_t begin, size_t end) {
+        trigCalc.applyToRectangular(magnitudes + begin, angles + begin, xs + begin, ys + begin, end - begin);
+    });
+}
+
+template <typename T>
+void BasicCalculatorEngine<T>::rectangularToPolar(const T* xs, const T* ys, T* magnitudes, T* angles, size_t count) {
+    StatsTimer timer(EngineStats::BatchPolar);
+    TraceScope trace("CalculatorEngine::rectangularToPolar[]");
+    forRange(count, parallelTrigCount, [&](size_t begin, size_t end) {
+        trigCalc.applyToPolar(xs + begin, ys + begin, magnitudes + begin, angles + begin, end - begin);
+    });
+}
+
+// Polynomials
+template <typename T>
+T BasicCalculatorEngine<T>::evaluatePolynomial(const vector<T>& coefficients, T x) {
+    StatsTimer timer(EngineStats::PolynomialEval);
+    lastResult = BasicPolynomial<T>::evaluate(coefficients, x);
+    publishState();
+    return lastResult;
+}
+
+template <typename T>
+void BasicCalculatorEngine<T>::evaluatePolynomial(const vector<T>& coefficients, const T* xs, T* out, size_t count) {
+    StatsTimer timer(EngineStats::PolynomialEval);
+    TraceScope trace("CalculatorEngine::evaluatePolynomial[]");
+    forRange(count, parallelTrigCount, [&](size_t begin, size_t end) {
+        BasicPolynomial<T>::evaluate(coefficients, xs + begin, out + begin, end - begin);
+    });
+    if (count > 0) {
+        lastResult = out[count - 1];
+        publishState();
+    }
+}
+
+template <typename T>
+bool BasicCalculatorEngine<T>::fitPolynomial(const T* xs, const T* ys, size_t count, size_t degree,
+                                             vector<T>& coefficients, FitMethod method) {
+    StatsTimer timer(EngineStats::PolynomialFit);
+    TraceScope trace("CalculatorEngine::fitPolynomial");
+    if (!BasicPolynomial<T>::fit(xs, ys, count, degree, coefficients, method)) {
+        pendingErrors |= StateDomainError;
+        publishState();
+        cout << "Error: Need at least " << degree + 1 << " distinct points for a degree " << degree << " fit!" << endl;
+        return false;
+    }
+    return true;
+}
+
+template <typename T>
+bool BasicCalculatorEngine<T>::fitLinear(const T* features, size_t featureCount, const T* ys, size_t count,
+                                         vector<T>& coefficients, FitMethod method) {
+    StatsTimer timer(EngineStats::PolynomialFit);
+    TraceScope trace("CalculatorEngine::fitLinear");
+    if (!BasicPolynomial<T>::fitLinear(features, featureCount, ys, count, coefficients, method)) {
+        pendingErrors |= StateDomainError;
+        publishState();
+        cout << "Error: Regression needs at least " << featureCount + 1 << " rows of independent features!" << endl;
+        return false;
+    }
+    return true;
+}
+
+// Number theory
+template <typename T>
+void BasicCalculatorEngine<T>::integerRangeError(const char* message) {
+    EngineStats::recordError(EngineStats::IntegerRange);
+    pendingErrors |= StateDomainError;
+    publishState();
+    cout << "Error: " << message << endl;
+}
+
+template <typename T>
+bool BasicCalculatorEngine<T>::isPrime(uint64_t n) {
+    StatsTimer timer(EngineStats::PrimeTest);
+    return NumberTheory::isPrime(n);
+}
+
+template <typename T>
+uint64_t BasicCalculatorEngine<T>::nextPrime(uint64_t n) {
+    StatsTimer timer(EngineStats::PrimeTest);
+    uint64_t result = NumberTheory::nextPrime(n);
+    if (result == 0) {
+        integerRangeError("No 64-bit prime above that value!");
+        return 0;
+    }
+    lastResult = T(result);
+    publishState();
+    return result;
+}
+
+template <typename T>
+vector<uint64_t> BasicCalculatorEngine<T>::factorize(uint64_t n) {
+    StatsTimer timer(EngineStats::Factorize);
+    TraceScope trace("CalculatorEngine::factorize");
+    return NumberTheory::factorize(n);
+}
+
+template <typename T>
+uint64_t BasicCalculatorEngine<T>::gcd(uint64_t a, uint64_t b) {
+    StatsTimer timer(EngineStats::IntegerArithmetic);
+    uint64_t result = NumberTheory::gcd(a, b);
+    lastResult = T(result);
+    publishState();
+    return result;
+}
+
+template <typename T>
+uint64_t BasicCalculatorEngine<T>::lcm(uint64_t a, uint64_t b) {
+    StatsTimer timer(EngineStats::IntegerArithmetic);
+    uint64_t result = NumberTheory::lcm(a, b);
+    if (result == 0 && a != 0 && b != 0) {
+        integerRangeError("Least common multiple exceeds 64 bits!");
+        return 0;
+    }
+    lastResult = T(result);
+    publishState();
+    return result;
+}
+
+template <typename T>
+uint64_t BasicCalculatorEngine<T>::modPow(uint64_t base, uint64_t exponent, uint64_t modulus) {
+    StatsTimer timer(EngineStats::IntegerArithmetic);
+    if (modulus == 0) {
+        integerRangeError("Modulus cannot be zero!");
+        return 0;
+    }
+    uint64_t result = NumberTheory::modPow(base, exponent, modulus);
+    lastResult = T(result);
+    publishState();
+    return result;
+}
+
+template <typename T>
+uint64_t BasicCalculatorEngine<T>::countPrimes(uint64_t limit) {
+    StatsTimer timer(EngineStats::PrimeCount);
+    TraceScope trace("CalculatorEngine::countPrimes");
+    if (limit > NumberTheory::maxSieveLimit) {
+        integerRangeError("Sieve limit is 2^42!");
+        return 0;
+    }
+    uint64_t result = NumberTheory::countPrimes(limit);
+    lastResult = T(result);
+    publishState();
+    return result;
+}
+
+template <typename T>
+vector<uint64_t> BasicCalculatorEngine<T>::primesBetween(uint64_t low, uint64_t high) {
+    StatsTimer timer(EngineStats::PrimeCount);
+    TraceScope trace("CalculatorEngine::primesBetween");
+    if (high > NumberTheory::maxSieveLimit) {
+        integerRangeError("Sieve limit is 2^42!");
+        return vector<uint64_t>();
+    }
+    if (low <= high && high - low > NumberTheory::maxPrimeRange) {
+        integerRangeError("Prime range too large, 2^28 numbers at most!");
+        return vector<uint64_t>();
+    }
+    vector<uint64_t> primes = NumberTheory::primesBetween(low, high);
+    publishState();
+    return primes;
+}
+
+// Combinatorics
+template <typename T>
+T BasicCalculatorEngine<T>::combinatoricsResult(T result, const char* error) {
+    if (result != result) {
+        EngineStats::recordError(EngineStats::CombinatoricsDomain);
+        pendingErrors |= StateDomainError;
+        publishState();
+        cout << "Error: " << error << endl;
+        return 0;
+    }
+    lastResult = result;
+    publishState();
+    return result;
+}
+
+template <typename T>
+T BasicCalculatorEngine<T>::factorial(T n) {
+    StatsTimer timer(EngineStats::Factorial);
+    return combinatoricsResult(BasicCombinatorics<T>::factorial(n), "Factorial of a negative integer!");
+}
+
+template <typename T>
+T BasicCalculatorEngine<T>::gamma(T x) {
+    StatsTimer timer(EngineStats::Gamma);
+    return combinatoricsResult(BasicCombinatorics<T>::gamma(x), "Gamma has poles at 0 and the negative integers!");
+}
+
+template <typename T>
+T BasicCalculatorEngine<T>::permutations(T n, T k) {
+    StatsTimer timer(EngineStats::Permutations);
+    return combinatoricsResult(BasicCombinatorics<T>::permutations(n, k), "nPr needs non-negative integers!");
+}
+
+template <typename T>
+T BasicCalculatorEngine<T>::combinations(T n, T k) {
+    StatsTimer timer(EngineStats::Combinations);
+    return combinatoricsResult(BasicCombinatorics<T>::combinations(n, k), "nCr needs non-negative integers!");
+}
+
+template <typename T>
+string BasicCalculatorEngine<T>::exactCombinations(uint64_t n, uint64_t k) {
+    StatsTimer timer(EngineStats::Combinations);
+    TraceScope trace("CalculatorEngine::exactCombinations");
+    if (n > NumberTheory::maxExactBinomial) {
+        integerRangeError("Exact nCr is limited to n <= 100000!");
+        return string();
+    }
+    return NumberTheory::binomial(n, k);
+}
+
+// Complex and spectral operations
+template <typename T>
+complex<double> BasicCalculatorEngine<T>::performComplexOperation(complex<double> a, complex<double> b, char operation) {
+    switch (operation) {
+        case '+':
+            return complexCalc.add(a, b);
+        case '-':
+            return complexCalc.subtract(a, b);
+        case '*':
+            return complexCalc.multiply(a, b);
+        case '/':
+            return complexCalc.divide(a, b);
+        default:
+            cout << "Invalid operation!" << endl;
+            return 0;
+    }
+}
+
+template <typename T>
+complex<double> BasicCalculatorEngine<T>::performComplexTrigOperation(const string& function, complex<double> value) {
+    if (function == "sin" || function == "sine") {
+        return complexCalc.sine(value);
+    } else if (function == "cos" || function == "cosine") {
+        return complexCalc.cosine(value);
+    } else if (function == "tan" || function == "tangent") {
+        return complexCalc.tangent(value);
+    } else if (function == "asin" || function == "arcsine") {
+        return complexCalc.arcsine(value);
+    } else if (function == "acos" || function == "arccosine") {
+        return complexCalc.arccosine(value);
+    } else if (function == "atan" || function == "arctangent") {
+        return complexCalc.arctangent(value);
+    }
+    cout << "Invalid trigonometric function!" << endl;
+    return 0;
+}
+
+template <typename T>
+complex<double> BasicCalculatorEngine<T>::polarToRectangular(double magnitude, double angle) {
+    return complexCalc.fromPolar(magnitude, angle);
+}
+
+template <typename T>
+double BasicCalculatorEngine<T>::complexMagnitude(complex<double> value) {
+    return complexCalc.magnitude(value);
+}
+
+template <typename T>
+double BasicCalculatorEngine<T>::complexArgument(complex<double> value) {
+    return complexCalc.argument(value);
+}
+
+template <typename T>
+vector<double> BasicCalculatorEngine<T>::computeSpectrum(const vector<double>& samples) {
+    if (samples.empty()) {
+        cout << "Error: No samples to transform!" << endl;
+        return vector<double>();
+    }
+    return fft.magnitudeSpectrum(samples);
+}
+
+// Expressions
+template <typename T>
+Expression* BasicCalculatorEngine<T>::getCompiledExpression(const string& expression) {
+    auto it = expressionCache.find(expression);
+    if (it != expressionCache.end() && it->second->getAngleMode() == trigCalc.getAngleMode()) {
+        return it->second.get();
+    }
+    
+    if (expressionCache.size() >= 64) {
+        expressionCache.clear();
+    }
+    unique_ptr<Expression> compiled(new Expression());
+    if (!compiled->compile(expression, trigCalc.getAngleMode())) {
+        return nullptr;
+    }
+    Expression* result = compiled.get();
+    expressionCache[expression] = move(compiled);
+    return result;
+}
+
+template <typename T>
+double BasicCalculatorEngine<T>::evaluateExpression(const string& expression, double x) {
+    StatsTimer timer(EngineStats::ExpressionEval);
+    TraceScope trace("CalculatorEngine::evaluateExpression");
+    Expression* compiled = getCompiledExpression(expression);
+    if (compiled == nullptr) {
+        return 0;
+    }
+    double result = compiled->evaluate(x);
+    lastResult = T(result);
+    publishState();
+    return result;
+}
+
+template <typename T>
+vector<double> BasicCalculatorEngine<T>::evaluateExpression(const string& expression, const vector<double>& xValues) {
+    StatsTimer timer(EngineStats::ExpressionEval);
+    TraceScope trace("CalculatorEngine::evaluateExpression");
+    vector<double> results(xValues.size());
+    Expression* compiled = getCompiledExpression(expression);
+    if (compiled == nullptr) {
+        return results;
+    }
+    compiled->evaluateArray(xValues.data(), results.data(), xValues.size());
+    if (!results.empty()) {
+        lastResult = T(results.back());
+        publishState();
+    }
+    return results;
+}
+
 // Memory operations
-void CalculatorEngine::storeInMemory(double value) {
+template <typename T>
+void BasicCalculatorEngine<T>::storeInMemory(T value) {
+    StatsTimer timer(EngineStats::MemoryStore);
+    TraceScope trace("CalculatorEngine::storeInMemory");
+    if (recorder) {
+        recorder->recordMemoryStore(double(value));
+    }
     memory.store(value);
+    publishState();
 }
 
-double CalculatorEngine::recallFromMemory() {
-    return memory.recall();
+template <typename T>
+T BasicCalculatorEngine<T>::recallFromMemory() {
+    StatsTimer timer(EngineStats::MemoryRecall);
+    TraceScope trace("CalculatorEngine::recallFromMemory");
+    T value = memory.recall();
+    if (recorder) {
+        recorder->recordMemoryRecall(double(value));
+    }
+    return value;
 }
 
-void CalculatorEngine::clearMemory() {
+template <typename T>
+void BasicCalculatorEngine<T>::clearMemory() {
+    StatsTimer timer(EngineStats::MemoryClear);
+    TraceScope trace("CalculatorEngine::clearMemory");
+    if (recorder) {
+        recorder->recordMemoryClear();
+    }
     memory.clear();
+    publishState();
 }
 
-bool CalculatorEngine::hasMemoryValue() {
+template <typename T>
+bool BasicCalculatorEngine<T>::hasMemoryValue() {
     return !memory.isEmpty();
 }
 
-void CalculatorEngine::showMemoryStatus() {
+template <typename T>
+void BasicCalculatorEngine<T>::showMemoryStatus() {
     memory.displayStatus();
 }
 
+template <typename T>
+bool BasicCalculatorEngine<T>::storeVariable(const string& name, T value) {
+    return memory.storeVariable(name, value);
+}
+
+template <typename T>
+T BasicCalculatorEngine<T>::recallVariable(const string& name) {
+    return memory.recallVariable(name);
+}
+
+template <typename T>
+bool BasicCalculatorEngine<T>::hasVariable(const string& name) {
+    return memory.hasVariable(name);
+}
+
+template <typename T>
+void BasicCalculatorEngine<T>::clearVariable(const string& name) {
+    memory.clearVariable(name);
+}
+
+template <typename T>
+void BasicCalculatorEngine<T>::clearVariables() {
+    memory.clearVariables();
+}
+
+template <typename T>
+vector<string> BasicCalculatorEngine<T>::getVariableNames() {
+    return memory.getVariableNames();
+}
+
+template <typename T>
+size_t BasicCalculatorEngine<T>::getVariableId(const string& name) {
+    return memory.intern(name);
+}
+
+template <typename T>
+T BasicCalculatorEngine<T>::getVariable(size_t id) {
+    return memory.getVariable(id);
+}
+
+template <typename T>
+void BasicCalculatorEngine<T>::setVariable(size_t id, T value) {
+    memory.setVariable(id, value);
+}
+
+template <typename T>
+bool BasicCalculatorEngine<T>::storeCoefficients(const string& name, const vector<T>& coefficients) {
+    return memory.storeCoefficients(name, coefficients);
+}
+
+template <typename T>
+vector<T> BasicCalculatorEngine<T>::recallCoefficients(const string& name) {
+    return memory.recallCoefficients(name);
+}
+
+template <typename T>
+bool BasicCalculatorEngine<T>::hasCoefficients(const string& name) {
+    return memory.hasCoefficients(name);
+}
+
+template <typename T>
+void BasicCalculatorEngine<T>::clearCoefficients(const string& name) {
+    memory.clearCoefficients(name);
+}
+
+template <typename T>
+vector<string> BasicCalculatorEngine<T>::getCoefficientNames() {
+    return memory.getCoefficientNames();
+}
+
+template <typename T>
+typename BasicMemory<T>::Snapshot BasicCalculatorEngine<T>::saveMemory() {
+    return memory.snapshot();
+}
+
+template <typename T>
+void BasicCalculatorEngine<T>::restoreMemory(const typename BasicMemory<T>::Snapshot& snapshot) {
+    memory.restore(snapshot);
+    publishState();
+}
+
 // Result management
-double CalculatorEngine::getLastResult() {
+template <typename T>
+T BasicCalculatorEngine<T>::getLastResult() {
     return lastResult;
 }
 
-void CalculatorEngine::setLastResult(double result) {
+template <typename T>
+void BasicCalculatorEngine<T>::setLastResult(T result) {
     lastResult = result;
+    publishState();
+}
+
+template <typename T>
+const EngineStateBlock* BasicCalculatorEngine<T>::getStateBlock() {
+    return stateMirror.get();
+}
+
+template <typename T>
+EngineStateSnapshot BasicCalculatorEngine<T>::getState() {
+    return stateMirror.read();
+}
+
+template <typename T>
+void BasicCalculatorEngine<T>::publishState() {
+    stateMirror.publish(double(lastResult), double(memory.peek()), !memory.isEmpty(),
+                        trigCalc.getAngleMode(), pendingErrors);
+    pendingErrors = 0;
 }
 
 // Validation
-bool CalculatorEngine::isValidOperation(char operation) {
-    return (operation == '+' || operation == '-' || operation == '*' || operation == '/');
+template <typename T>
+bool BasicCalculatorEngine<T>::isValidOperation(char operation) {
+    return CalcKernels::isValidOperation(operation);
 }
 
-bool CalculatorEngine::isValidTrigFunction(const string& function) {
+template <typename T>
+bool BasicCalculatorEngine<T>::isValidTrigFunction(const string& function) {
     return (function == "sin" || function == "cos" || function == "tan" ||
             function == "asin" || function == "acos" || function == "atan" ||
             function == "sine" || function == "cosine" || function == "tangent" ||
             function == "arcsine" || function == "arccosine" || function == "arctangent");
-}
\ No newline at end of file
+}
+
+template <typename T>
+bool BasicCalculatorEngine<T>::isValidScientificFunction(const string& function) {
+    return BasicScientificCalculator<T>::kernelFor(function) != nullptr;
+}
+
+// Workload recording
+template <typename T>
+bool BasicCalculatorEngine<T>::startRecording(const string& path) {
+    unique_ptr<WorkloadRecorder> opened(new WorkloadRecorder());
+    if (!opened->open(path)) {
+        return false;
+    }
+    recorder = move(opened);
+    // Replays start from the engine's current angle mode and M register
+    recorder->recordAngleMode(trigCalc.getAngleMode());
+    if (memory.isEmpty()) {
+        recorder->recordMemoryClear();
+    } else {
+        recorder->recordMemoryStore(double(memory.peek()));
+    }
+    return true;
+}
+
+template <typename T>
+void BasicCalculatorEngine<T>::stopRecording() {
+    recorder.reset();
+}
+
+template <typename T>
+bool BasicCalculatorEngine<T>::isRecording() {
+    return recorder != nullptr;
+}
+
+template class BasicCalculatorEngine<float>;
+template class BasicCalculatorEngine<double>;
+template class BasicCalculatorEngine<long double>;
+#ifdef CALC_HAVE_FLOAT128
+template class BasicCalculatorEngine<__float128>;
+#endif
@@ -3,44 +3,186 @@
 
 #include "Memory.h"
 #include "TrigCalculator.h"
+#include "ScientificCalculator.h"
+#include "ComplexCalculator.h"
+#include "Polynomial.h"
+#include "NumberTheory.h"
+#include "Combinatorics.h"
+#include "FFT.h"
+#include "Expression.h"
+#include "WorkloadTrace.h"
+#include "EngineState.h"
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
 #include <string>
+#include <vector>
 
-class CalculatorEngine {
+// The engine is instantiated for float, double and long double (and
+// __float128 with CALC_ENABLE_FLOAT128).  Arithmetic, trig and memory run
+// in T; complex numbers, spectra and expressions are double precision.
+template <typename T>
+class BasicCalculatorEngine {
 private:
-    Memory memory;
-    TrigCalculator trigCalc;
-    double lastResult;
+    BasicMemory<T> memory;
+    BasicTrigCalculator<T> trigCalc;
+    BasicScientificCalculator<T> scientificCalc;
+    ComplexCalculator complexCalc;
+    FFT fft;
+    std::map<std::string, std::unique_ptr<Expression>> expressionCache;
+    std::unique_ptr<WorkloadRecorder> recorder;
+    T lastResult;
+    EngineStateMirror stateMirror;
+    uint32_t pendingErrors;   // EngineStateErrors raised by the current call
+    
+    Expression* getCompiledExpression(const std::string& expression);
+    void publishState();
+    void integerRangeError(const char* message);
+    T combinatoricsResult(T result, const char* error);
     
 public:
-    CalculatorEngine();
+    BasicCalculatorEngine();
     
     // Basic arithmetic operations
-    double add(double a, double b);
-    double subtract(double a, double b);
-    double multiply(double a, double b);
-    double divide(double a, double b);
-    double performBasicOperation(double a, double b, char operation);
+    T add(T a, T b);
+    T subtract(T a, T b);
+    T multiply(T a, T b);
+    T divide(T a, T b);
+    T performBasicOperation(T a, T b, char operation);
     
     // Trigonometric operations
-    double performTrigOperation(const std::string& function, double value);
-    void setAngleMode(bool degrees);
+    T performTrigOperation(const std::string& function, T value);
+    void performSineCosine(T angle, T& sine, T& cosine);
+    void setAngleMode(bool degrees, bool announce = true);   // announce prints the new mode
     bool getAngleMode();
     std::string getAngleModeString();
     
+    // Exponential, logarithmic and hyperbolic functions ("exp", "ln",
+    // "log10", "sqrt", "sinh", "acosh", ...) and powers
+    T performScientificOperation(const std::string& function, T value);
+    T power(T base, T exponent);
+    
+    // Batch operations over arrays.  These are silent: division by zero and
+    // domain errors (arcsin, log, sqrt, pow, ...) yield 0 without printing.  Large batches
+    // are split across ThreadPool::global().
+    void performBasicOperation(const T* a, const T* b, T* out, size_t count, char operation);
+    void performTrigOperation(const std::string& function, const T* values, T* out, size_t count);
+    void performScientificOperation(const std::string& function, const T* values, T* out, size_t count);
+    void performPowerOperation(const T* bases, const T* exponents, T* out, size_t count);
+    
+    // Fused sine and cosine (one range reduction per angle) and polar <->
+    // rectangular conversion, in the current angle mode.  Angles from
+    // rectangularToPolar lie in (-180, 180] degrees or (-pi, pi].
+    void performSineCosine(const T* angles, T* sines, T* cosines, size_t count);
+    void polarToRectangular(const T* magnitudes, const T* angles, T* xs, T* ys, size_t count);
+    void rectangularToPolar(const T* xs, const T* ys, T* magnitudes, T* angles, size_t count);
+    
+    // Polynomials, coefficients lowest degree first.  Array evaluation is
+    // split across the pool like the batches.  Fits print an error and
+    // return false when the points cannot determine the coefficients.
+    T evaluatePolynomial(const std::vector<T>& coefficients, T x);
+    void evaluatePolynomial(const std::vector<T>& coefficients, const T* xs, T* out, size_t count);
+    bool fitPolynomial(const T* xs, const T* ys, size_t count, size_t degree, std::vector<T>& coefficients,
+                       FitMethod method = FitMethod::QR);
+    bool fitLinear(const T* features, size_t featureCount, const T* ys, size_t count,
+                   std::vector<T>& coefficients, FitMethod method = FitMethod::QR);
+    
+    // Number theory on unsigned 64-bit integers.  Results that do not fit
+    // (lcm, nextPrime past 2^64 - 59), a zero modulus and sieve limits above
+    // NumberTheory::maxSieveLimit print an error and return 0 or empty.
+    bool isPrime(uint64_t n);
+    uint64_t nextPrime(uint64_t n);
+    std::vector<uint64_t> factorize(uint64_t n);
+    uint64_t gcd(uint64_t a, uint64_t b);
+    uint64_t lcm(uint64_t a, uint64_t b);
+    uint64_t modPow(uint64_t base, uint64_t exponent, uint64_t modulus);
+    uint64_t countPrimes(uint64_t limit);
+    std::vector<uint64_t> primesBetween(uint64_t low, uint64_t high);
+    
+    // Factorial (gamma(n + 1) for non-integers), gamma, nPr and nCr.
+    // Integer arguments within the tables are lookups.  Poles of gamma and
+    // nPr / nCr of anything but non-negative integers print an error and
+    // return 0.  exactCombinations gives every digit of C(n, k) for n up to
+    // NumberTheory::maxExactBinomial.
+    T factorial(T n);
+    T gamma(T x);
+    T permutations(T n, T k);
+    T combinations(T n, T k);
+    std::string exactCombinations(uint64_t n, uint64_t k);
+    
+    // Complex and spectral operations
+    std::complex<double> performComplexOperation(std::complex<double> a, std::complex<double> b, char operation);
+    std::complex<double> performComplexTrigOperation(const std::string& function, std::complex<double> value);
+    std::complex<double> polarToRectangular(double magnitude, double angle);
+    double complexMagnitude(std::complex<double> value);
+    double complexArgument(std::complex<double> value);
+    std::vector<double> computeSpectrum(const std::vector<double>& samples);
+    
+    // Expressions in x, e.g. "sin(x) * 2 + x / 3".  Compiled expressions are
+    // cached so repeated sweeps get promoted to native code once hot.
+    double evaluateExpression(const std::string& expression, double x);
+    std::vector<double> evaluateExpression(const std::string& expression, const std::vector<double>& xValues);
+    
     // Memory operations
-    void storeInMemory(double value);
-    double recallFromMemory();
+    void storeInMemory(T value);
+    T recallFromMemory();
     void clearMemory();
     bool hasMemoryValue();
     void showMemoryStatus();
     
+    // Named registers ("x", "rate", "r1"): identifiers of up to 15
+    // characters.  Ids from getVariableId are stable for the engine's
+    // lifetime and skip the name lookup.
+    bool storeVariable(const std::string& name, T value);
+    T recallVariable(const std::string& name);
+    bool hasVariable(const std::string& name);
+    void clearVariable(const std::string& name);
+    void clearVariables();
+    std::vector<std::string> getVariableNames();
+    size_t getVariableId(const std::string& name);   // VariableTable::npos if invalid
+    T getVariable(size_t id);
+    void setVariable(size_t id, T value);
+    
+    // Named coefficient sets, e.g. a fit kept for later evaluatePolynomial
+    bool storeCoefficients(const std::string& name, const std::vector<T>& coefficients);
+    std::vector<T> recallCoefficients(const std::string& name);
+    bool hasCoefficients(const std::string& name);
+    void clearCoefficients(const std::string& name);
+    std::vector<std::string> getCoefficientNames();
+    
+    typename BasicMemory<T>::Snapshot saveMemory();
+    void restoreMemory(const typename BasicMemory<T>::Snapshot& snapshot);
+    
     // Result management
-    double getLastResult();
-    void setLastResult(double result);
+    T getLastResult();
+    void setLastResult(T result);
+    
+    // State mirror, refreshed after every call that changes what a UI
+    // shows.  The block stays at the same address for the engine's lifetime.
+    const EngineStateBlock* getStateBlock();
+    EngineStateSnapshot getState();
     
     // Validation
     bool isValidOperation(char operation);
     bool isValidTrigFunction(const std::string& function);
+    bool isValidScientificFunction(const std::string& function);
+    
+    // Workload recording: scalar basic/trig calls, memory calls and angle
+    // mode changes are appended to a binary trace for calc_replay
+    bool startRecording(const std::string& path);
+    void stopRecording();
+    bool isRecording();
 };
 
-#endif // CALCULATORENGINE_H
\ No newline at end of file
+extern template class BasicCalculatorEngine<float>;
+extern template class BasicCalculatorEngine<double>;
+extern template class BasicCalculatorEngine<long double>;
+#ifdef CALC_HAVE_FLOAT128
+extern template class BasicCalculatorEngine<__float128>;
+#endif
+
+using CalculatorEngine = BasicCalculatorEngine<double>;
+
+#endif // CALCULATORENGINE_H
@@ -0,0 +1,351 @@
+#include "Combinatorics.h"
+#include "CalcKernels.h"
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+// Exact C(n, k) for n < pascalRows; C(67, 33) is the largest that fits
+const size_t pascalRows = 68;
+
+// B(2k) / (2k (2k - 1)): log gamma(z) ~ (z - 1/2) log z - z + log(2 pi) / 2
+// + sum c_k / z^(2k - 1)
+const double stirlingTerms[][2] = {
+    { 1, 12 }, { -1, 360 }, { 1, 1260 }, { -1, 1680 }, { 1, 1188 }, { -691, 360360 },
+    { 1, 156 }, { -3617, 122400 }, { 43867, 244188 }, { -174611, 125400 }, { 854513, 63756 }
+};
+
+// (gamma(1 + f) - 1) / (f (f - 1)) for 0 <= f <= 1 as a polynomial in
+// t = 2f - 1 (Chebyshev fit, about 1e-17).  Factoring out f (f - 1) keeps
+// gamma(1 + f) - 1 accurate to the last bits next to 1 and 2.
+const double gammaUnitTerms[] = {
+    0x1.d203b725884abp-2, -0x1.08ea88ee561b1p-4, 0x1.49f6dbfb3baaep-5, -0x1.69694049f5f41p-7,
+    0x1.0dd8443282df7p-8, -0x1.5f0383277ad45p-10, 0x1.dc6e890f1150ep-12, -0x1.3d9d6ad960481p-13,
+    0x1.a8de1293b51e5p-15, -0x1.1b8a0a62872adp-16, 0x1.7a61bde9ebc0cp-18, -0x1.f8be21a602705p-20,
+    0x1.5095ef3f0b60ep-21, -0x1.c0da82ad02eaap-23, 0x1.2b6acfe1bc18bp-24, -0x1.8f50572df89cep-26,
+    0x1.0850bd6109ccap-27, -0x1.5fd6daaf1809p-29, 0x1.f4faf28bc6b4ep-31, -0x1.514c244be98f7p-32,
+    0x1.18bbd3545e323p-34, -0x1.61244ff049996p-36, 0x1.773c45321cfap-36, -0x1.018564767b5adp-37
+};
+
+const vector<uint64_t>& pascalTriangle() {
+    // Row n starts at n (n + 1) / 2
+    static const vector<uint64_t> triangle = []() {
+        vector<uint64_t> values(pascalRows * (pascalRows + 1) / 2);
+        for (size_t n = 0; n < pascalRows; n++) {
+            uint64_t* row = &values[n * (n + 1) / 2];
+            const uint64_t* above = n > 0 ? &values[(n - 1) * n / 2] : nullptr;
+            row[0] = row[n] = 1;
+            for (size_t k = 1; k < n; k++) {
+                row[k] = above[k - 1] + above[k];
+            }
+        }
+        return values;
+    }();
+    return triangle;
+}
+
+template <typename T>
+bool isFinite(T x) {
+    return x - x == T(0);
+}
+
+template <typename T>
+T stirlingSeries(T z) {
+    const size_t count = sizeof(stirlingTerms) / sizeof(stirlingTerms[0]);
+    T inverseSquare = T(1) / (z * z);
+    T sum = T(stirlingTerms[count - 1][0]) / T(stirlingTerms[count - 1][1]);
+    for (size_t i = count - 1; i-- > 0;) {
+        sum = sum * inverseSquare + T(stirlingTerms[i][0]) / T(stirlingTerms[i][1]);
+    }
+    return sum / z;
+}
+
+// Stirling's series is accurate to T's precision from here up
+template <typename T>
+T stirlingMinimum() {
+    return PrecisionTraits<T>::epsilon < T(1e-20) ? T(40) : T(15);
+}
+
+template <typename T>
+T stirlingLogGamma(T z) {
+    typedef PrecisionTraits<T> M;
+    const T halfLogTwoPi = M::log(2 * M::pi) / 2;
+    return (z - T(0.5)) * M::log(z) - z + halfLogTwoPi + stirlingSeries(z);
+}
+
+// sin(pi x) from x minus its nearest integer, which is exact, so it is 0
+// at the integers and accurate next to them and for large |x|
+template <typename T>
+T sinPi(T x) {
+    typedef PrecisionTraits<T> M;
+    T nearest = M::floor(x);
+    if (x - nearest > T(0.5)) {
+        nearest += 1;
+    }
+    T sine = M::sin(M::pi * (x - nearest));
+    return nearest - 2 * M::floor(nearest / 2) == 0 ? sine : -sine;
+}
+
+template <typename T>
+struct FactorialTables {
+    vector<T> factorials;      // n! for n <= factorialLimit
+    vector<T> logFactorials;   // log n! for n < logTableSize
+
+    FactorialTables() {
+        typedef PrecisionTraits<T> M;
+        // n! carried as high + low, low holding each product's rounding
+        // error (fma), so high is n! correctly rounded
+        T high = 1, low = 0;
+        factorials.push_back(high);
+        for (size_t n = 1;; n++) {
+            T product = high * T(n);
+            if (!isFinite(product)) {
+                break;
+            }
+            T error = M::fma(high, T(n), -product);
+            T tail = M::fma(low, T(n), error);
+            high = product + tail;
+            low = tail - (high - product);
+            factorials.push_back(high);
+        }
+
+        const size_t size = BasicCombinatorics<T>::logTableSize;
+        logFactorials.resize(size);
+        for (size_t n = 0; n < size; n++) {
+            logFactorials[n] = n < factorials.size() ? M::log(factorials[n]) : stirlingLogGamma(T(n + 1));
+        }
+    }
+};
+
+template <typename T>
+const FactorialTables<T>& tables() {
+    static const FactorialTables<T> instance;
+    return instance;
+}
+
+// Nearest integer when T can hold it exactly (ratios of rounded factorials
+// are off by an ulp or two)
+template <typename T>
+T roundInteger(T value) {
+    typedef PrecisionTraits<T> M;
+    return value < T(1) / M::epsilon ? M::floor(value + T(0.5)) : value;
+}
+
+// gamma(1 + f) - 1 for 0 <= f <= 1
+double gammaUnitOffset(double f) {
+    const size_t count = sizeof(gammaUnitTerms) / sizeof(gammaUnitTerms[0]);
+    return f * (f - 1) * CalcKernels::polynomial(gammaUnitTerms, count, 2 * f - 1);
+}
+
+// Multiplies high + low by (base + k) for first <= k < last, carrying the
+// rounding error of each base + k (the products round; an fma per step
+// would halve the error but costs a libm call without -mfma)
+void multiplyShifted(double base, double first, double last, double& high, double& low) {
+    for (double k = first; k < last; k += 1) {
+        double factor = base + k;
+        double kPart = factor - base;
+        double factorError = (base - (factor - kPart)) + (k - kPart);
+        low = low * factor + high * factorError;
+        high *= factor;
+    }
+}
+
+// gamma(x) in double for -15 <= x < 15: gamma(1 + f) for the fraction f,
+// then up by gamma(x + 1) = x gamma(x) or down by its inverse; within a
+// few ulps like libm's tgamma
+double smallGamma(double x) {
+    double n = floor(x);
+    double f = x - n;
+    double offset = gammaUnitOffset(f);
+    double high = 1 + offset;
+    double low = offset - (high - 1);
+    if (n >= 1) {
+        multiplyShifted(f, 1, n, high, low);
+        return high + low;
+    }
+    double divisorHigh = 1, divisorLow = 0;
+    multiplyShifted(x, 0, 1 - n, divisorHigh, divisorLow);
+    return (high + low) / (divisorHigh + divisorLow);
+}
+
+// gamma(x) = value * scale, scale being half of z^z in Stirling's formula,
+// so that reflection can divide by it separately.  Double below
+// stirlingMinimum uses smallGamma; wider types go from x + m down by
+// gamma(x) = gamma(x + m) / (x (x + 1) ... (x + m - 1)).
+template <typename T>
+T gammaApproximation(T x, T& scale) {
+    typedef PrecisionTraits<T> M;
+    const T minimum = stirlingMinimum<T>();
+    if (sizeof(T) <= sizeof(double) && x < minimum) {
+        scale = 1;
+        return T(smallGamma(double(x)));
+    }
+    T divisor = 1;
+    T z = x;
+    if (z < minimum) {
+        T shift = M::floor(minimum - x) + 1;
+        for (T i = 0; i < shift; i += 1) {
+            divisor *= x + i;
+        }
+        z = x + shift;
+    }
+    scale = M::pow(z, z / 2);
+    return M::sqrt(2 * M::pi / z) * (scale * M::exp(-z)) * M::exp(stirlingSeries(z)) / divisor;
+}
+
+} // namespace
+
+template <typename T>
+size_t BasicCombinatorics<T>::factorialLimit() {
+    return tables<T>().factorials.size() - 1;
+}
+
+template <typename T>
+bool BasicCombinatorics<T>::isNonNegativeInteger(T x) {
+    return x >= 0 && isFinite(x) && PrecisionTraits<T>::floor(x) == x;
+}
+
+template <typename T>
+T BasicCombinatorics<T>::gamma(T x) {
+    if (sizeof(T) < sizeof(double)) {
+        return T(BasicCombinatorics<double>::gamma(double(x)));
+    }
+    const FactorialTables<T>& table = tables<T>();
+    if (x != x) {
+        return x;
+    }
+    if (PrecisionTraits<T>::floor(x) == x) {
+        if (x <= 0) {
+            return T(NAN);
+        }
+        return x - 1 < T(table.factorials.size()) ? table.factorials[size_t(x - 1)] : T(HUGE_VAL);
+    }
+    // gamma(size) = (size - 1)! is the largest finite factorial and gamma
+    // increases past 2, so gamma(size + 1) and everything above overflow
+    if (x >= T(table.factorials.size() + 1)) {
+        return T(HUGE_VAL);
+    }
+    T scale;
+    if (x < -stirlingMinimum<T>()) {
+        // Reflection: gamma(x) = pi / (sin(pi x) (-x) gamma(-x)), dividing
+        // by the two parts of gamma(-x) separately so that results down
+        // to the subnormals survive; -x is exact, 1 - x would not be
+        T sine = sinPi(x);
+        T value = gammaApproximation(-x, scale);
+        if (!isFinite(scale)) {
+            // gamma(-x) is far past overflow, so gamma(x) underflows
+            return sine < 0 ? -T(0) : T(0);
+        }
+        return PrecisionTraits<T>::pi / (sine * -x * value) / scale;
+    }
+    T value = gammaApproximation(x, scale);
+    return value * scale;
+}
+
+template <typename T>
+T BasicCombinatorics<T>::logGamma(T x) {
+    typedef PrecisionTraits<T> M;
+    if (sizeof(T) < sizeof(double)) {
+        return T(BasicCombinatorics<double>::logGamma(double(x)));
+    }
+    if (x != x) {
+        return x;
+    }
+    if (M::floor(x) == x) {
+        if (x <= 0) {
+            return T(HUGE_VAL);
+        }
+        if (x - 1 < T(logTableSize)) {
+            return tables<T>().logFactorials[size_t(x - 1)];
+        }
+    }
+    if (x < stirlingMinimum<T>()) {
+        // libm handles the zeros at 1 and 2 and between the negative poles
+        return M::lgamma(x);
+    }
+    return stirlingLogGamma(x);
+}
+
+template <typename T>
+T BasicCombinatorics<T>::factorial(T n) {
+    const FactorialTables<T>& table = tables<T>();
+    if (isNonNegativeInteger(n)) {
+        return n < T(table.factorials.size()) ? table.factorials[size_t(n)] : T(HUGE_VAL);
+    }
+    return gamma(n + 1);
+}
+
+template <typename T>
+T BasicCombinatorics<T>::logFactorial(T n) {
+    if (isNonNegativeInteger(n) && n < T(logTableSize)) {
+        return tables<T>().logFactorials[size_t(n)];
+    }
+    return logGamma(n + 1);
+}
+
+template <typename T>
+T BasicCombinatorics<T>::permutations(T n, T k) {
+    const FactorialTables<T>& table = tables<T>();
+    if (!isNonNegativeInteger(n) || !isNonNegativeInteger(k)) {
+        return T(NAN);
+    }
+    if (k > n) {
+        return 0;
+    }
+    if (n < T(table.factorials.size())) {
+        return roundInteger(table.factorials[size_t(n)] / table.factorials[size_t(n - k)]);
+    }
+    // n! / (n - k)! >= k!, so k past the table overflows; otherwise k terms
+    if (k >= T(table.factorials.size())) {
+        return T(HUGE_VAL);
+    }
+    T result = 1;
+    for (T i = 0; i < k && isFinite(result); i += 1) {
+        result *= n - i;
+    }
+    return result;
+}
+
+template <typename T>
+T BasicCombinatorics<T>::combinations(T n, T k) {
+    const FactorialTables<T>& table = tables<T>();
+    if (!isNonNegativeInteger(n) || !isNonNegativeInteger(k)) {
+        return T(NAN);
+    }
+    if (k > n) {
+        return 0;
+    }
+    if (n - k < k) {
+        k = n - k;
+    }
+    if (n < T(pascalRows)) {
+        size_t row = size_t(n);
+        return T(pascalTriangle()[row * (row + 1) / 2 + size_t(k)]);
+    }
+    if (n < T(table.factorials.size())) {
+        return roundInteger(table.factorials[size_t(n)] /
+                            (table.factorials[size_t(k)] * table.factorials[size_t(n - k)]));
+    }
+    // Skip the product when log-factorials already say it overflows
+    const T logOverflow = table.logFactorials[table.factorials.size()] + 1;
+    if (logFactorial(n) - logFactorial(k) - logFactorial(n - k) > logOverflow) {
+        return T(HUGE_VAL);
+    }
+    // C(n - k + i, i) for i = 1..k: every partial result is an integer, so
+    // this is exact while it stays below 2^digits
+    T result = 1;
+    for (T i = 1; i <= k && isFinite(result); i += 1) {
+        result = result * (n - k + i) / i;
+    }
+    return result;
+}
+
+template class BasicCombinatorics<float>;
+template class BasicCombinatorics<double>;
+template class BasicCombinatorics<long double>;
+#ifdef CALC_HAVE_FLOAT128
+template class BasicCombinatorics<__float128>;
+#endif
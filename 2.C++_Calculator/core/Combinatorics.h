@@ -0,0 +1,51 @@
+#ifndef COMBINATORICS_H
+#define COMBINATORICS_H
+
+#include <cstddef>
+#include "Precision.h"
+
+// Factorials, permutations, combinations and the gamma function.
+//
+// n! for every n up to the largest finite factorial in T (170 for double,
+// 1754 for long double) and log n! for n < logTableSize come from tables
+// built on first use, so integer arguments cost a lookup; so does nCr for
+// n < 68, which is read from an exact Pascal triangle.  gamma elsewhere is
+// Stirling's series; below x = 15 double (and float through it) steps
+// from a polynomial for gamma on [1, 2] by the recurrence, and wider types
+// shift up to Stirling.  Reflection below -15 (-40 for __float128) keeps
+// results down to the subnormals.  logGamma below the Stirling range is
+// libm's lgamma, which stays accurate next to its zeros.  nCr
+// and nPr past the tables multiply at most k terms, skipping straight to
+// infinity when k! or the log-factorials show the result overflows.
+// Integer results that T represents exactly are rounded to the integer.
+//
+// Domain errors return NaN: poles of gamma (0, -1, -2, ...), and nPr / nCr
+// of anything but non-negative integers.  nCr and nPr with k > n are 0.
+template <typename T>
+class BasicCombinatorics {
+public:
+    static const size_t logTableSize = 4096;
+
+    // Largest n for which n! is finite in T
+    static size_t factorialLimit();
+
+    static T factorial(T n);            // gamma(n + 1) for non-integers
+    static T logFactorial(T n);         // log gamma(n + 1)
+    static T gamma(T x);
+    static T logGamma(T x);             // log |gamma(x)|
+    static T permutations(T n, T k);    // n! / (n - k)!
+    static T combinations(T n, T k);    // n! / (k! (n - k)!)
+
+    static bool isNonNegativeInteger(T x);
+};
+
+extern template class BasicCombinatorics<float>;
+extern template class BasicCombinatorics<double>;
+extern template class BasicCombinatorics<long double>;
+#ifdef CALC_HAVE_FLOAT128
+extern template class BasicCombinatorics<__float128>;
+#endif
+
+using Combinatorics = BasicCombinatorics<double>;
+
+#endif // COMBINATORICS_H
@@ -0,0 +1,95 @@
+#include "ComplexCalculator.h"
+#include "NumberFormat.h"
+#include "TrigCalculator.h"
+
+using namespace std;
+
+ComplexCalculator::ComplexCalculator() {
+    useDegrees = true;
+}
+
+complex<double> ComplexCalculator::toRadians(complex<double> angle) {
+    return useDegrees ? angle * (M_PI / 180.0) : angle;
+}
+
+complex<double> ComplexCalculator::toAngleMode(complex<double> radians) {
+    return useDegrees ? radians * (180.0 / M_PI) : radians;
+}
+
+void ComplexCalculator::setAngleMode(bool degrees) {
+    useDegrees = degrees;
+}
+
+bool ComplexCalculator::getAngleMode() {
+    return useDegrees;
+}
+
+// Arithmetic
+complex<double> ComplexCalculator::add(complex<double> a, complex<double> b) {
+    return a + b;
+}
+
+complex<double> ComplexCalculator::subtract(complex<double> a, complex<double> b) {
+    return a - b;
+}
+
+complex<double> ComplexCalculator::multiply(complex<double> a, complex<double> b) {
+    return a * b;
+}
+
+complex<double> ComplexCalculator::divide(complex<double> a, complex<double> b) {
+    if (b == complex<double>(0.0, 0.0)) {
+        cout << "Error: Division by zero!" << endl;
+        return 0;
+    }
+    return a / b;
+}
+
+// Rectangular / polar conversion
+complex<double> ComplexCalculator::fromPolar(double magnitude, double angle) {
+    if (useDegrees) {
+        angle = angle * M_PI / 180.0;
+    }
+    return polar(magnitude, angle);
+}
+
+double ComplexCalculator::magnitude(complex<double> value) {
+    return abs(value);
+}
+
+double ComplexCalculator::argument(complex<double> value) {
+    double result = arg(value);
+    return useDegrees ? result * 180.0 / M_PI : result;
+}
+
+// Complex trigonometry
+complex<double> ComplexCalculator::sine(complex<double> angle) {
+    return sin(toRadians(angle));
+}
+
+complex<double> ComplexCalculator::cosine(complex<double> angle) {
+    return cos(toRadians(angle));
+}
+
+complex<double> ComplexCalculator::tangent(complex<double> angle) {
+    return tan(toRadians(angle));
+}
+
+// The inverse functions are defined on the whole complex plane, so unlike
+// TrigCalculator there is no domain error for |value| > 1.
+complex<double> ComplexCalculator::arcsine(complex<double> value) {
+    return toAngleMode(asin(value));
+}
+
+complex<double> ComplexCalculator::arccosine(complex<double> value) {
+    return toAngleMode(acos(value));
+}
+
+complex<double> ComplexCalculator::arctangent(complex<double> value) {
+    return toAngleMode(atan(value));
+}
+
+string ComplexCalculator::toString(complex<double> value) {
+    return NumberFormat::toString(value.real()) + (value.imag() < 0 ? " - " : " + ") +
+           NumberFormat::toString(abs(value.imag())) + "i";
+}
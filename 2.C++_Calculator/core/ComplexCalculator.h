@@ -0,0 +1,41 @@
+#ifndef COMPLEXCALCULATOR_H
+#define COMPLEXCALCULATOR_H
+
+#include <complex>
+#include <string>
+
+class ComplexCalculator {
+private:
+    bool useDegrees;
+
+    std::complex<double> toRadians(std::complex<double> angle);
+    std::complex<double> toAngleMode(std::complex<double> radians);
+
+public:
+    ComplexCalculator();
+    void setAngleMode(bool degrees);
+    bool getAngleMode();
+
+    // Arithmetic
+    std::complex<double> add(std::complex<double> a, std::complex<double> b);
+    std::complex<double> subtract(std::complex<double> a, std::complex<double> b);
+    std::complex<double> multiply(std::complex<double> a, std::complex<double> b);
+    std::complex<double> divide(std::complex<double> a, std::complex<double> b);
+
+    // Rectangular / polar conversion (angles follow the angle mode)
+    std::complex<double> fromPolar(double magnitude, double angle);
+    double magnitude(std::complex<double> value);
+    double argument(std::complex<double> value);
+
+    // Complex trigonometry (angles follow the angle mode)
+    std::complex<double> sine(std::complex<double> angle);
+    std::complex<double> cosine(std::complex<double> angle);
+    std::complex<double> tangent(std::complex<double> angle);
+    std::complex<double> arcsine(std::complex<double> value);
+    std::complex<double> arccosine(std::complex<double> value);
+    std::complex<double> arctangent(std::complex<double> value);
+
+    static std::string toString(std::complex<double> value);
+};
+
+#endif // COMPLEXCALCULATOR_H
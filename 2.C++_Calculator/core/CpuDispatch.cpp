@@ -0,0 +1,1419 @@
+#include "CpuDispatch.h"
+#include "CalcKernels.h"
+#include "ScientificCalculator.h"
+#include "ScientificKernels.h"
+#include "TrigCalculator.h"
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define CALC_DISPATCH_X86 1
+#include <immintrin.h>
+#elif defined(__GNUC__) && defined(__aarch64__)
+#define CALC_DISPATCH_NEON 1
+#include <arm_neon.h>
+#if defined(__linux__)
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#endif
+#endif
+
+#if defined(CALC_DISPATCH_X86) || defined(CALC_DISPATCH_NEON)
+#define CALC_DISPATCH_VECTOR 1
+#define CALC_ALWAYS_INLINE inline __attribute__((always_inline))
+// Keep a*b+c as two roundings in every tier (GCC would otherwise fuse it
+// wherever the target has FMA) so the tiers agree with the scalar build
+#if defined(__clang__)
+#define CALC_NO_FP_CONTRACT
+#else
+#define CALC_NO_FP_CONTRACT __attribute__((optimize("fp-contract=off")))
+#endif
+#define CALC_VECTOR_TARGET(isa) __attribute__((target(isa))) CALC_NO_FP_CONTRACT
+#endif
+
+#if defined(__clang__) && defined(CALC_DISPATCH_VECTOR)
+#pragma STDC FP_CONTRACT OFF
+#endif
+
+using namespace std;
+
+namespace {
+
+enum BinaryOperation { AddOperation, SubtractOperation, MultiplyOperation, DivideOperation };
+enum TrigFunction { SineFunction, CosineFunction, TangentFunction };
+enum MathFunction {
+    ExpFunction, LogFunction, Log10Function, SqrtFunction,
+    SinhFunction, CoshFunction, TanhFunction, AsinhFunction, AcoshFunction, AtanhFunction
+};
+
+// Scalar tier: the same kernels the engine uses one value at a time
+template <int Operation, typename E>
+void scalarBasic(const E* a, const E* b, E* out, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        switch (Operation) {
+            case AddOperation: out[i] = CalcKernels::add(a[i], b[i]); break;
+            case SubtractOperation: out[i] = CalcKernels::subtract(a[i], b[i]); break;
+            case MultiplyOperation: out[i] = CalcKernels::multiply(a[i], b[i]); break;
+            default: out[i] = CalcKernels::divide(a[i], b[i]); break;
+        }
+    }
+}
+
+template <int Function>
+double scalarTrig(double value, bool degrees) {
+    switch (Function) {
+        case SineFunction: return TrigCalculator::sineKernel(value, degrees);
+        case CosineFunction: return TrigCalculator::cosineKernel(value, degrees);
+        default: return TrigCalculator::tangentKernel(value, degrees);
+    }
+}
+
+template <int Function>
+void scalarTrigArray(const double* values, double* out, size_t count, bool degrees) {
+    for (size_t i = 0; i < count; i++) {
+        out[i] = scalarTrig<Function>(values[i], degrees);
+    }
+}
+
+template <int Function>
+void scalarTrigFloatArray(const float* values, float* out, size_t count, bool degrees) {
+    for (size_t i = 0; i < count; i++) {
+        out[i] = float(scalarTrig<Function>(values[i], degrees));
+    }
+}
+
+void scalarSineCosine(const double* angles, double* sines, double* cosines, size_t count, bool degrees) {
+    for (size_t i = 0; i < count; i++) {
+        TrigCalculator::sineCosineKernel(angles[i], degrees, sines[i], cosines[i]);
+    }
+}
+
+void scalarToRectangular(const double* magnitudes, const double* angles, double* xs, double* ys,
+                         size_t count, bool degrees) {
+    for (size_t i = 0; i < count; i++) {
+        TrigCalculator::toRectangularKernel(magnitudes[i], angles[i], degrees, xs[i], ys[i]);
+    }
+}
+
+void scalarToPolar(const double* xs, const double* ys, double* magnitudes, double* angles,
+                   size_t count, bool degrees) {
+    for (size_t i = 0; i < count; i++) {
+        TrigCalculator::toPolarKernel(xs[i], ys[i], degrees, magnitudes[i], angles[i]);
+    }
+}
+
+template <int Function>
+double scalarMath(double value) {
+    switch (Function) {
+        case ExpFunction: return ScientificCalculator::expKernel(value);
+        case LogFunction: return ScientificCalculator::logKernel(value);
+        case Log10Function: return ScientificCalculator::log10Kernel(value);
+        case SqrtFunction: return ScientificCalculator::sqrtKernel(value);
+        case SinhFunction: return ScientificCalculator::sinhKernel(value);
+        case CoshFunction: return ScientificCalculator::coshKernel(value);
+        case TanhFunction: return ScientificCalculator::tanhKernel(value);
+        case AsinhFunction: return ScientificCalculator::asinhKernel(value);
+        case AcoshFunction: return ScientificCalculator::acoshKernel(value);
+        default: return ScientificCalculator::atanhKernel(value);
+    }
+}
+
+template <int Function>
+void scalarMathArray(const double* values, double* out, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        out[i] = scalarMath<Function>(values[i]);
+    }
+}
+
+void scalarPower(const double* bases, const double* exponents, double* out, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        out[i] = ScientificCalculator::powerKernel(bases[i], exponents[i]);
+    }
+}
+
+void scalarPolynomial(const double* coefficients, size_t terms, const double* xs, double* out, size_t count) {
+    // Horner spelled out so the choice of scheme is not made per point, on
+    // four points at once: the chains overlap, and the compiler can pair
+    // them into vectors.  Each point still sees the same operations.
+    size_t i = 0;
+    if (terms > 0 && terms < CalcKernels::estrinTerms) {
+        const double top = coefficients[terms - 1];
+        for (; i + 4 <= count; i += 4) {
+            double x0 = xs[i], x1 = xs[i + 1], x2 = xs[i + 2], x3 = xs[i + 3];
+            double r0 = top, r1 = top, r2 = top, r3 = top;
+            for (size_t k = terms - 1; k > 0; k--) {
+                double c = coefficients[k - 1];
+                r0 = r0 * x0 + c;
+                r1 = r1 * x1 + c;
+                r2 = r2 * x2 + c;
+                r3 = r3 * x3 + c;
+            }
+            out[i] = r0;
+            out[i + 1] = r1;
+            out[i + 2] = r2;
+            out[i + 3] = r3;
+        }
+    }
+    for (; i < count; i++) {
+        out[i] = CalcKernels::polynomial(coefficients, terms, xs[i]);
+    }
+}
+
+const ArrayKernels scalarKernels = {
+    CpuTier::Scalar,
+    scalarBasic<AddOperation>, scalarBasic<SubtractOperation>,
+    scalarBasic<MultiplyOperation>, scalarBasic<DivideOperation>,
+    scalarTrigArray<SineFunction>, scalarTrigArray<CosineFunction>, scalarTrigArray<TangentFunction>,
+    scalarSineCosine, scalarToRectangular, scalarToPolar,
+    scalarMathArray<ExpFunction>, scalarMathArray<LogFunction>, scalarMathArray<Log10Function>,
+    scalarMathArray<SqrtFunction>, scalarMathArray<SinhFunction>, scalarMathArray<CoshFunction>,
+    scalarMathArray<TanhFunction>, scalarMathArray<AsinhFunction>, scalarMathArray<AcoshFunction>,
+    scalarMathArray<AtanhFunction>, scalarPower, scalarPolynomial,
+    scalarBasic<AddOperation>, scalarBasic<SubtractOperation>,
+    scalarBasic<MultiplyOperation>, scalarBasic<DivideOperation>,
+    scalarTrigFloatArray<SineFunction>, scalarTrigFloatArray<CosineFunction>,
+    scalarTrigFloatArray<TangentFunction>
+};
+
+#ifdef CALC_DISPATCH_X86
+typedef double Double2 __attribute__((vector_size(16)));
+typedef int Int2 __attribute__((vector_size(8)));
+typedef double Double4 __attribute__((vector_size(32)));
+typedef int Int4 __attribute__((vector_size(16)));
+typedef double Double8 __attribute__((vector_size(64)));
+typedef int Int8 __attribute__((vector_size(32)));
+typedef float Float4 __attribute__((vector_size(16)));
+typedef float Float8 __attribute__((vector_size(32)));
+typedef float Float16 __attribute__((vector_size(64)));
+
+// Square roots have no generic vector form.  These are plain inline (the
+// tier entry points supply the instruction set once they inline them).
+inline __attribute__((target("sse2"))) void vectorSqrt(const Double2& x, Double2& result) {
+    result = (Double2)_mm_sqrt_pd((__m128d)x);
+}
+
+inline __attribute__((target("avx"))) void vectorSqrt(const Double4& x, Double4& result) {
+    result = (Double4)_mm256_sqrt_pd((__m256d)x);
+}
+
+inline __attribute__((target("avx512f"))) void vectorSqrt(const Double8& x, Double8& result) {
+    result = (Double8)_mm512_maskz_sqrt_pd(0xff, (__m512d)x);
+}
+
+// Table lookups (pow's log and exp tables): one gather where the tier has
+// it, one load per lane on SSE2.  Bits are bits, so the exp table's
+// integers come through the double form.
+typedef decltype(Double2{} < 0.0) Long2;
+typedef decltype(Double4{} < 0.0) Long4;
+typedef decltype(Double8{} < 0.0) Long8;
+
+inline __attribute__((target("sse2"))) void vectorGather(const double* table, const Long2& index, Double2& result) {
+    result = Double2{ table[index[0]], table[index[1]] };
+}
+
+inline __attribute__((target("avx2"))) void vectorGather(const double* table, const Long4& index, Double4& result) {
+    result = (Double4)_mm256_i64gather_pd(table, (__m256i)index, sizeof(double));
+}
+
+inline __attribute__((target("avx512f"))) void vectorGather(const double* table, const Long8& index, Double8& result) {
+    result = (Double8)_mm512_mask_i64gather_pd(_mm512_setzero_pd(), 0xff, (__m512i)index, table, sizeof(double));
+}
+#endif
+
+#ifdef CALC_DISPATCH_NEON
+typedef double Double2 __attribute__((vector_size(16)));
+typedef int Int2 __attribute__((vector_size(8)));
+typedef float Float4 __attribute__((vector_size(16)));
+
+inline void vectorSqrt(const Double2& x, Double2& result) {
+    result = (Double2)vsqrtq_f64((float64x2_t)x);
+}
+
+typedef decltype(Double2{} < 0.0) Long2;
+
+inline void vectorGather(const double* table, const Long2& index, Double2& result) {
+    result = Double2{ table[index[0]], table[index[1]] };
+}
+#endif
+
+#ifdef CALC_DISPATCH_VECTOR
+
+// Generic vector bodies.  They are only ever inlined into the per-tier
+// entry points below, which is where the instruction set gets chosen.
+// V is a vector of doubles and I a vector of as many ints; only the
+// arithmetic also takes vectors of floats.
+template <typename V, typename E>
+CALC_ALWAYS_INLINE void loadVector(const E* source, V& v) {
+    __builtin_memcpy(&v, source, sizeof(V));
+}
+
+template <typename V, typename E>
+CALC_ALWAYS_INLINE void storeVector(E* destination, const V& v) {
+    __builtin_memcpy(destination, &v, sizeof(V));
+}
+
+template <typename V, int Operation, typename E>
+CALC_ALWAYS_INLINE void vectorBasic(const E* a, const E* b, E* out, size_t count) {
+    const size_t lanes = sizeof(V) / sizeof(E);
+    size_t i = 0;
+    for (; i + lanes <= count; i += lanes) {
+        V x, y, result;
+        loadVector(a + i, x);
+        loadVector(b + i, y);
+        switch (Operation) {
+            case AddOperation: result = x + y; break;
+            case SubtractOperation: result = x - y; break;
+            case MultiplyOperation: result = x * y; break;
+            default: {
+                V zero = {};
+                result = y == E(0) ? zero : x / y;
+                break;
+            }
+        }
+        storeVector(out + i, result);
+    }
+    scalarBasic<Operation>(a + i, b + i, out + i, count - i);
+}
+
+// CalcKernels::sinPolynomial / cosPolynomial / tanPolynomial, same
+// operation order
+template <typename V>
+CALC_ALWAYS_INLINE void sinPolynomial(const V& x, const V& y, V& result) {
+    V z = x * x;
+    V v = z * x;
+    V r = 8.33333333332248946124e-03 + z * (-1.98412698298579493134e-04 +
+          z * (2.75573137070700676789e-06 + z * (-2.50507602534068634195e-08 +
+          z * 1.58969099521155010221e-10)));
+    result = x - ((z * (0.5 * y - v * r) - y) - v * -1.66666666666666324348e-01);
+}
+
+template <typename V>
+CALC_ALWAYS_INLINE void cosPolynomial(const V& x, const V& y, V& result) {
+    V z = x * x;
+    V r = z * (4.16666666666666019037e-02 + z * (-1.38888888888741095749e-03 +
+          z * (2.48015872894767294178e-05 + z * (-2.75573143513906633035e-07 +
+          z * (2.08757232129817482790e-09 + z * -1.13596475577881948265e-11)))));
+    V hz = 0.5 * z;
+    V w = 1.0 - hz;
+    result = w + (((1.0 - w) - hz) + (z * r - x * y));
+}
+
+template <typename V>
+CALC_ALWAYS_INLINE void highPart(const V& x, V& result) {
+    V c = 134217729.0 * x;
+    result = c - (c - x);
+}
+
+template <typename V>
+CALC_ALWAYS_INLINE void vectorProductError(const V& x, const V& y, const V& product, V& result) {
+    V xHigh, yHigh;
+    highPart(x, xHigh);
+    highPart(y, yHigh);
+    V xLow = x - xHigh, yLow = y - yHigh;
+    result = ((xHigh * yHigh - product) + xHigh * yLow + xLow * yHigh) + xLow * yLow;
+}
+
+// Both of the scalar kernel's branches, then a select
+template <typename V>
+CALC_ALWAYS_INLINE void tanPolynomial(const V& x0, const V& y0, const V& odd, V& result) {
+    V zero = {};
+    // The sign as a factor and the branch as a 0 / 1 flag, kept as values
+    // like vectorToPolar's valid
+    V sign = x0 < 0.0 ? zero - 1.0 : zero + 1.0;
+    V ax = x0 * sign;
+    V small = ax < 0.674335479736328125 ? zero + 1.0 : zero;
+    V reflected = (7.85398163397448278999e-01 - ax) + (3.06161699786838301793e-17 - y0 * sign);
+    V x = small == 1.0 ? x0 : reflected;
+    V y = small == 1.0 ? y0 : zero;
+    V z = x * x;
+    V w = z * z;
+    V r = 1.33333333333201242699e-01 + w * (2.18694882948595424599e-02 +
+          w * (3.59207910759131235356e-03 + w * (5.88041240820264096874e-04 +
+          w * (7.81794442939557092300e-05 + w * -1.85586374855275456654e-05))));
+    V v = z * (5.39682539762260521377e-02 + w * (8.86323982359930005737e-03 +
+          w * (1.45620945432529025516e-03 + w * (2.46463134818469906812e-04 +
+          w * (7.14072491382608190305e-05 + w * 2.59073051863633712884e-05)))));
+    V s = z * x;
+    r = y + z * (s * (r + v) + y);
+    r += 3.33333333333334091986e-01 * s;
+    w = x + r;
+
+    // One division serves both branches: w * w / (w + iy) for big
+    // arguments, -1 / w for the others
+    V iy = odd == 1.0 ? zero - 1.0 : zero + 1.0;
+    V quotient = (small == 1.0 ? zero - 1.0 : w * w) / (small == 1.0 ? w : w + iy);
+    V bigResult = (iy - 2.0 * (x - (quotient - r))) * sign;
+    V high, t;
+    highPart(w, high);
+    V tail = r - (high - x);
+    highPart(quotient, t);
+    V e = 1.0 + t * high;
+    V oddResult = t + quotient * (e + t * tail);
+    result = small == 1.0 ? (odd == 1.0 ? oddResult : w) : bigResult;
+}
+
+// CalcKernels::reduceDegrees / reduceHalfPi.  valid is cleared for lanes
+// the scalar kernel has to redo; poles adds the tangent poles to those.
+template <typename V, typename I, typename M>
+CALC_ALWAYS_INLINE void vectorReduceTrig(const V& x, bool degrees, bool poles, V& r, V& tail, V& quadrant, V& odd,
+                                         M& valid) {
+    const double limit = degrees ? 0x1p37 : CalcKernels::reductionLimit;
+    V zero = {};
+    V magnitude = x < 0.0 ? -x : x;
+    valid = degrees ? magnitude < limit : magnitude <= limit;
+    tail = zero;
+    if (degrees) {
+        // CalcKernels::reduceDegrees; below 2^37 the quadrant count fits
+        // the 32-bit lanes
+        V reduced = valid ? x : zero;
+        V t = reduced * (1.0 / 90.0);
+        I n = __builtin_convertvector((t + 0x1.8p52) - 0x1.8p52, I);
+        r = reduced - 90.0 * __builtin_convertvector(n, V);
+        quadrant = __builtin_convertvector(n & 3, V);
+        odd = __builtin_convertvector(n & 1, V);
+
+        // Table angles and tangent poles take the scalar path.  The 0
+        // entry needs no fallback: the polynomials return its values once
+        // r = -0 is made +0, as the table has it.
+        V reducedMagnitude = r < 0.0 ? -r : r;
+        M special = {};
+        for (int k = 1; k < CalcKernels::specialAngleCount; k++) {
+            special |= reducedMagnitude == CalcKernels::specialAngles[k].degrees;
+        }
+        if (poles) {
+            special |= (r == 0.0 ? odd : zero) == 1.0;
+        }
+        valid &= ~special;
+        r = r == 0.0 ? zero : r * CalcKernels::degree;
+    } else {
+        // CalcKernels::reduceHalfPi, first part; lanes that cancel enough
+        // to need the second and third go to the scalar kernel
+        V a = valid ? x : zero;
+        V t = a * 6.36619772367581382433e-01;
+        V rounded = t < 0.0 ? t - 0.5 : t + 0.5;
+        I n = __builtin_convertvector(rounded, I);
+        V fn = __builtin_convertvector(n, V);
+        V partial = a - fn * CalcKernels::pio2Part1;
+        V w = fn * CalcKernels::pio2Tail1;
+        r = partial - w;
+        V reducedMagnitude = r < 0.0 ? -r : r;
+        V checked = reducedMagnitude >= magnitude * 0x1p-16 ? magnitude : zero + limit + limit;
+        valid = checked <= limit;
+        tail = (partial - r) - w;
+        quadrant = __builtin_convertvector(n & 3, V);
+        odd = __builtin_convertvector(n & 1, V);
+    }
+}
+
+// sin and cos of the reduced angle placed in its quadrant
+template <typename V>
+CALC_ALWAYS_INLINE void vectorQuadrantSineCosine(const V& r, const V& tail, const V& quadrant, bool degrees,
+                                                 V& sine, V& cosine) {
+    V zero = {};
+    V s, c;
+    sinPolynomial(r, tail, s);
+    cosPolynomial(r, tail, c);
+    // Degree results that are exactly zero are +0 (see sineDegrees)
+    V minusS = degrees ? zero - s : -s;
+    V minusC = degrees ? zero - c : -c;
+    sine = quadrant == 0.0 ? s : quadrant == 1.0 ? c : quadrant == 2.0 ? minusS : minusC;
+    cosine = quadrant == 0.0 ? c : quadrant == 1.0 ? minusS : quadrant == 2.0 ? minusC : s;
+}
+
+// The angle mode is a template argument so the loop has no branch on it:
+// GCC 12 otherwise carries the tangent kernel's AVX-512 masks through a
+// phi and scalarizes them.  E is double, or float for arrays that are
+// widened to V on load and rounded back on store.
+template <typename V, typename I, int Function, bool Degrees, typename E>
+CALC_ALWAYS_INLINE void vectorTrigBlocks(const E* values, E* out, size_t count) {
+    typedef decltype(V() < 0.0) M;
+    typedef E W __attribute__((vector_size(sizeof(V) / sizeof(double) * sizeof(E))));
+    const bool degrees = Degrees;
+    const size_t lanes = sizeof(V) / sizeof(double);
+    size_t i = 0;
+    for (; i + lanes <= count; i += lanes) {
+        W input;
+        V x, r, tail, quadrant, odd, result;
+        M valid;
+        loadVector(values + i, input);
+        x = __builtin_convertvector(input, V);
+        vectorReduceTrig<V, I>(x, degrees, Function == TangentFunction, r, tail, quadrant, odd, valid);
+        if (Function == TangentFunction) {
+            tanPolynomial(r, tail, odd, result);
+        } else {
+            V sine, cosine;
+            vectorQuadrantSineCosine(r, tail, quadrant, degrees, sine, cosine);
+            result = Function == SineFunction ? sine : cosine;
+        }
+        storeVector(out + i, __builtin_convertvector(result, W));
+
+        for (size_t lane = 0; lane < lanes; lane++) {
+            if (!valid[lane]) {
+                out[i + lane] = E(scalarTrig<Function>(values[i + lane], degrees));
+            }
+        }
+    }
+    for (; i < count; i++) {
+        out[i] = E(scalarTrig<Function>(values[i], degrees));
+    }
+}
+
+template <typename V, typename I, int Function, typename E>
+CALC_ALWAYS_INLINE void vectorTrig(const E* values, E* out, size_t count, bool degrees) {
+    if (degrees) {
+        vectorTrigBlocks<V, I, Function, true>(values, out, count);
+    } else {
+        vectorTrigBlocks<V, I, Function, false>(values, out, count);
+    }
+}
+
+// sincos, or with Rectangular (magnitude, angle) -> (x, y)
+template <typename V, typename I, bool Rectangular, bool Degrees>
+CALC_ALWAYS_INLINE void vectorSineCosineBlocks(const double* magnitudes, const double* angles,
+                                               double* first, double* second, size_t count) {
+    typedef decltype(V() < 0.0) M;
+    const bool degrees = Degrees;
+    const size_t lanes = sizeof(V) / sizeof(double);
+    size_t i = 0;
+    for (; i + lanes <= count; i += lanes) {
+        V x, r, tail, quadrant, odd, sine, cosine;
+        M valid;
+        loadVector(angles + i, x);
+        vectorReduceTrig<V, I>(x, degrees, false, r, tail, quadrant, odd, valid);
+        vectorQuadrantSineCosine(r, tail, quadrant, degrees, sine, cosine);
+        if (Rectangular) {
+            V magnitude;
+            loadVector(magnitudes + i, magnitude);
+            storeVector(first + i, magnitude * cosine);
+            storeVector(second + i, magnitude * sine);
+        } else {
+            storeVector(first + i, sine);
+            storeVector(second + i, cosine);
+        }
+
+        for (size_t lane = 0; lane < lanes; lane++) {
+            if (!valid[lane]) {
+                size_t k = i + lane;
+                if (Rectangular) {
+                    TrigCalculator::toRectangularKernel(magnitudes[k], angles[k], degrees, first[k], second[k]);
+                } else {
+                    TrigCalculator::sineCosineKernel(angles[k], degrees, first[k], second[k]);
+                }
+            }
+        }
+    }
+    if (Rectangular) {
+        scalarToRectangular(magnitudes + i, angles + i, first + i, second + i, count - i, degrees);
+    } else {
+        scalarSineCosine(angles + i, first + i, second + i, count - i, degrees);
+    }
+}
+
+template <typename V, typename I, bool Rectangular>
+CALC_ALWAYS_INLINE void vectorSineCosine(const double* magnitudes, const double* angles,
+                                         double* first, double* second, size_t count, bool degrees) {
+    if (degrees) {
+        vectorSineCosineBlocks<V, I, Rectangular, true>(magnitudes, angles, first, second, count);
+    } else {
+        vectorSineCosineBlocks<V, I, Rectangular, false>(magnitudes, angles, first, second, count);
+    }
+}
+
+// TrigCalculator::toPolarKernel: sqrt(x^2 + y^2) and CalcKernels::arctangent2
+// for finite nonzero x and y whose squares neither overflow nor underflow
+template <typename V, typename I>
+CALC_ALWAYS_INLINE void vectorToPolar(const double* xs, const double* ys, double* magnitudes, double* angles,
+                                      size_t count, bool degrees) {
+    const size_t lanes = sizeof(V) / sizeof(double);
+    const double piLo = 1.2246467991473531772e-16;
+    V zero = {};
+    size_t i = 0;
+    for (; i + lanes <= count; i += lanes) {
+        V x, y;
+        loadVector(xs + i, x);
+        loadVector(ys + i, y);
+        V sum = x * x + y * y;
+        V magnitude;
+        vectorSqrt(sum, magnitude);
+        storeVector(magnitudes + i, magnitude);
+
+        // Single comparisons only: GCC 12 scalarizes combined AVX-512 masks
+        V one = zero + 1.0;
+        V ax = x < 0.0 ? -x : x;
+        V ay = y < 0.0 ? -y : y;
+        V checked = sum + (sum - sum);      // NaN unless sum is finite
+        checked = ax * ay > 0.0 ? checked : zero;
+        V valid = checked >= 0x1p-968 ? one : zero;
+
+        // CalcKernels::arctangent2Radians: q = |y / x| > 0 and its tail (the
+        // squares bound |x| below 2^512), then arctangentParts with all
+        // five reductions computed and selected
+        V q = ay / ax;
+        V product = q * ax;
+        V productTail;
+        vectorProductError(q, ax, product, productTail);
+        V tail = ((ay - product) - productTail) / ax;
+        tail = q < 0x1p54 ? tail : zero;
+
+        V id = (q >= 0.4375 ? one : zero) + (q >= 0.6875 ? one : zero) +
+               (q >= 1.1875 ? one : zero) + (q >= 2.4375 ? one : zero);
+        V scaled = 1.5 * q;
+        V scaledTail;
+        vectorProductError(zero + 1.5, q, scaled, scaledTail);
+        V twoPlus = 2.0 + q, plusOne = q + 1.0, onePlus = 1.0 + scaled;
+        V num = id == 1.0 ? 2.0 * q - 1.0 : id == 2.0 ? q - 1.0 : id == 3.0 ? q - 1.5 : id == 4.0 ? zero - 1.0 : q;
+        V den = id == 1.0 ? twoPlus : id == 2.0 ? plusOne : id == 3.0 ? onePlus : id == 4.0 ? q : one;
+        V denTail = id == 1.0 ? (q - (twoPlus - 2.0)) + tail
+                  : id == 2.0 ? (1.0 - (plusOne - q)) + tail
+                  : id == 3.0 ? (1.0 - (onePlus - scaled)) + scaledTail + 1.5 * tail
+                  : id == 4.0 ? tail : zero;
+        V numTail = id == 1.0 ? tail * 2.0 : id == 4.0 ? zero : tail;
+        V hi = id == 1.0 ? zero + CalcKernels::atanHi[1] : id == 2.0 ? zero + CalcKernels::atanHi[2]
+             : id == 3.0 ? zero + CalcKernels::atanHi[3] : id == 4.0 ? zero + CalcKernels::atanHi[4] : zero;
+        V lo = id == 1.0 ? zero + CalcKernels::atanLo[1] : id == 2.0 ? zero + CalcKernels::atanLo[2]
+             : id == 3.0 ? zero + CalcKernels::atanLo[3] : id == 4.0 ? zero + CalcKernels::atanLo[4] : zero;
+
+        V t = num / den;
+        V reducedProduct = t * den;
+        V reducedTail;
+        vectorProductError(t, den, reducedProduct, reducedTail);
+        V tTail = den < 0x1p54 ? ((num - reducedProduct) - reducedTail + numTail - t * denTail) / den : zero;
+        tTail = id == 0.0 ? numTail : tTail;
+
+        V z = t * t;
+        V w = z * z;
+        V s1 = z * (3.33333333333329318027e-01 + w * (1.42857142725034663711e-01 +
+               w * (9.09088713343650656196e-02 + w * (6.66107313738753120669e-02 +
+               w * (4.97687799461593236017e-02 + w * 1.62858201153657823623e-02)))));
+        V s2 = w * (-1.99999999998764832476e-01 + w * (-1.11111104054623557880e-01 +
+               w * (-7.69187620504482999495e-02 + w * (-5.83357013379057348645e-02 +
+               w * -3.65315727442169155270e-02))));
+        V total = hi + t;
+        V rest = (t - (total - hi)) - ((t * (s1 + s2) - lo) - (tTail - tTail * z));
+        V high = total + rest;
+        V low = (total - high) + rest;
+
+        V difference = CalcKernels::pi - high;
+        V reflected = difference + (((CalcKernels::pi - difference) - high) + (piLo - low));
+        V angle = x < 0.0 ? reflected : high;
+        angle = y < 0.0 ? -angle : angle;
+        angle = degrees ? angle * 180.0 / CalcKernels::pi : angle;
+        storeVector(angles + i, angle);
+
+        for (size_t lane = 0; lane < lanes; lane++) {
+            if (valid[lane] == 0.0) {
+                TrigCalculator::toPolarKernel(xs[i + lane], ys[i + lane], degrees,
+                                              magnitudes[i + lane], angles[i + lane]);
+            }
+        }
+    }
+    scalarToPolar(xs + i, ys + i, magnitudes + i, angles + i, count - i, degrees);
+}
+
+// ScientificKernels on vectors, same operation order.  L is the 64-bit
+// integer vector a double comparison yields; bit tricks run on it.
+template <typename V>
+CALC_ALWAYS_INLINE void vectorAbs(const V& x, V& result) {
+    typedef decltype(x < 0.0) L;
+    result = (V)((L)x & 0x7fffffffffffffffLL);
+}
+
+// ScientificKernels::reduceExp, returning em1 and 2^k; |x| <= 708
+template <typename V, typename I>
+CALC_ALWAYS_INLINE void vectorReduceExp(const V& x, V& em1, V& scale) {
+    typedef decltype(x < 0.0) L;
+    V t = x * ScientificKernels::invLn2;
+    V rounded = t < 0.0 ? t - 0.5 : t + 0.5;
+    I k = __builtin_convertvector(rounded, I);
+    V dk = __builtin_convertvector(k, V);
+    V hi = x - dk * ScientificKernels::ln2Hi;
+    V lo = dk * ScientificKernels::ln2Lo;
+    V r = hi - lo;
+    V rr = r * r;
+    V c = r - rr * (ScientificKernels::expP1 + rr * (ScientificKernels::expP2 + rr * (ScientificKernels::expP3 +
+          rr * (ScientificKernels::expP4 + rr * ScientificKernels::expP5))));
+    em1 = hi - (lo - (r * c) / (2.0 - c));
+    scale = (V)((__builtin_convertvector(k, L) + 1023) << 52);
+}
+
+// ScientificKernels::logPositive for normal x > 0
+template <typename V, typename I>
+CALC_ALWAYS_INLINE void vectorLogPositive(const V& x, V& result) {
+    typedef decltype(x < 0.0) L;
+    L bits = (L)x;
+    L high = bits >> 32;
+    L k = (high >> 20) - 1023;
+    high &= 0x000fffff;
+    L i = (high + 0x95f64) & 0x100000;
+    V m = (V)(((high | (i ^ 0x3ff00000)) << 32) | (bits & 0xffffffffLL));
+    k += i >> 20;
+    V f = m - 1.0;
+    V dk = __builtin_convertvector(__builtin_convertvector(k, I), V);
+    V s = f / (2.0 + f);
+    V z = s * s;
+    V w = z * z;
+    V t1 = w * (ScientificKernels::logLg2 + w * (ScientificKernels::logLg4 + w * ScientificKernels::logLg6));
+    V t2 = z * (ScientificKernels::logLg1 + w * (ScientificKernels::logLg3 + w * (ScientificKernels::logLg5 +
+           w * ScientificKernels::logLg7)));
+    V r = t2 + t1;
+    V hfsq = 0.5 * f * f;
+    V withSquare = dk * ScientificKernels::ln2Hi - ((hfsq - (s * (hfsq + r) + dk * ScientificKernels::ln2Lo)) - f);
+    V withoutSquare = dk * ScientificKernels::ln2Hi - ((s * (f - r) - dk * ScientificKernels::ln2Lo) - f);
+    result = ((high - 0x6147a) | (0x6b851 - high)) > 0 ? withSquare : withoutSquare;
+}
+
+// log(u) plus the rounding error of u = 1 + v (ScientificKernels::log1pNonNegative)
+template <typename V, typename I>
+CALC_ALWAYS_INLINE void vectorLog1p(const V& v, const V& u, V& result) {
+    vectorLogPositive<V, I>(u, result);
+    result = result + (v - (u - 1.0)) / u;
+}
+
+template <typename V, typename I, int Function>
+CALC_ALWAYS_INLINE void vectorMath(const double* values, double* out, size_t count) {
+    typedef decltype(V{} < 0.0) L;
+    const size_t lanes = sizeof(V) / sizeof(double);
+    V zero = {};
+    V one = zero + 1.0;
+    size_t i = 0;
+    for (; i + lanes <= count; i += lanes) {
+        V x, ax, result;
+        loadVector(values + i, x);
+        vectorAbs(x, ax);
+        // Lanes the scalar kernel has to redo: out of range, inf, NaN
+        L valid;
+        switch (Function) {
+            case ExpFunction: {
+                valid = ax <= 708.0;
+                V em1, scale;
+                vectorReduceExp<V, I>(valid ? x : zero, em1, scale);
+                result = (1.0 + em1) * scale;
+                break;
+            }
+            case LogFunction: {
+                valid = x >= ScientificKernels::minNormal;
+                V logX;
+                vectorLogPositive<V, I>(valid ? x : one, logX);
+                result = x == ScientificKernels::infinity ? x : logX;
+                break;
+            }
+            case Log10Function: {
+                valid = x >= ScientificKernels::minNormal;
+                L bits = (L)(valid ? x : one);
+                L high = bits >> 32;
+                L k = (high >> 20) - 1023;
+                L negative = (k >> 63) & 1;
+                high = (high & 0x000fffff) | ((0x3ff - negative) << 20);
+                V y = __builtin_convertvector(__builtin_convertvector(k + negative, I), V);
+                V m = (V)((high << 32) | (bits & 0xffffffffLL));
+                V logM;
+                vectorLogPositive<V, I>(m, logM);
+                V z = y * ScientificKernels::log10Of2Lo + ScientificKernels::invLn10 * logM;
+                result = x == ScientificKernels::infinity ? x : z + y * ScientificKernels::log10Of2Hi;
+                break;
+            }
+            case SqrtFunction: {
+                valid = zero == zero;
+                V root;
+                vectorSqrt(x, root);
+                result = x < 0.0 ? zero : root;
+                break;
+            }
+            case SinhFunction: {
+                valid = ax < 708.0;
+                V a = valid ? ax : zero;
+                V em1, scale;
+                vectorReduceExp<V, I>(a, em1, scale);
+                V t = scale * em1 + (scale - 1.0);
+                V h = x < 0.0 ? zero - 0.5 : zero + 0.5;
+                V belowOne = h * (2.0 * t - t * t / (t + 1.0));
+                V belowLimit = h * (t + t / (t + 1.0));
+                V large = h * ((1.0 + em1) * scale);
+                result = a < 0x1p-28 ? x : a < 1.0 ? belowOne : a < 22.0 ? belowLimit : large;
+                break;
+            }
+            case CoshFunction: {
+                valid = ax < 708.0;
+                V a = valid ? ax : zero;
+                V em1, scale;
+                vectorReduceExp<V, I>(a, em1, scale);
+                V t = scale * em1 + (scale - 1.0);
+                V w = 1.0 + t;
+                V e = (1.0 + em1) * scale;
+                V small = 1.0 + (t * t) / (w + w);
+                V middle = 0.5 * e + 0.5 / e;
+                V large = 0.5 * e;
+                result = a < 0.5 * ScientificKernels::ln2 ? small : a < 22.0 ? middle : large;
+                break;
+            }
+            case TanhFunction: {
+                valid = x == x;
+                V a = ax < 22.0 ? (ax >= 1.0 ? 2.0 * ax : -2.0 * ax) : zero;
+                V em1, scale;
+                vectorReduceExp<V, I>(a, em1, scale);
+                V t = scale * em1 + (scale - 1.0);
+                V z = ax >= 1.0 ? 1.0 - 2.0 / (t + 2.0) : -t / (t + 2.0);
+                z = ax < 22.0 ? z : one;
+                result = ax < 0x1p-55 ? x : x < 0.0 ? -z : z;
+                break;
+            }
+            case AsinhFunction: {
+                valid = ax <= 0x1p28;
+                V a = valid ? ax : zero;
+                V root;
+                vectorSqrt(x * x + 1.0, root);
+                auto large = a > 2.0;
+                V v = a + x * x / (1.0 + root);
+                V u = large ? 2.0 * a + 1.0 / (root + a) : 1.0 + v;
+                V w;
+                vectorLogPositive<V, I>(u, w);
+                w = large ? w : w + (v - (u - 1.0)) / u;
+                result = a < 0x1p-28 ? x : x > 0.0 ? w : -w;
+                break;
+            }
+            case AcoshFunction: {
+                valid = x <= 0x1p28;
+                V a = valid ? x : one;
+                a = a >= 1.0 ? a : one;
+                auto large = a > 2.0;
+                V t = a - 1.0;
+                V root;
+                vectorSqrt(large ? a * a - 1.0 : 2.0 * t + t * t, root);
+                V v = t + root;
+                V u = large ? 2.0 * a - 1.0 / (a + root) : 1.0 + v;
+                V w;
+                vectorLogPositive<V, I>(u, w);
+                w = large ? w : w + (v - (u - 1.0)) / u;
+                result = x < 1.0 ? zero : w;
+                break;
+            }
+            default: {
+                valid = x == x;
+                V a = ax < 1.0 ? ax : zero;
+                V v = a < 0.5 ? 2.0 * a + 2.0 * a * a / (1.0 - a) : (a + a) / (1.0 - a);
+                V w;
+                vectorLog1p<V, I>(v, 1.0 + v, w);
+                V t = 0.5 * w;
+                result = ax >= 1.0 ? zero : ax < 0x1p-28 ? x : x < 0.0 ? -t : t;
+                break;
+            }
+        }
+        storeVector(out + i, result);
+
+        for (size_t lane = 0; lane < lanes; lane++) {
+            if (!valid[lane]) {
+                out[i + lane] = scalarMath<Function>(values[i + lane]);
+            }
+        }
+    }
+    scalarMathArray<Function>(values + i, out + i, count - i);
+}
+
+// ScientificKernels::pow: integer exponents up to 64 by squaring (seven
+// steps, multiplying by 1 where the scalar loop skips), the rest through
+// logExtended and expExtended with their table entries loaded lane by lane.
+// Other lanes go to the scalar kernel.
+template <typename V, typename I>
+CALC_ALWAYS_INLINE void vectorPower(const double* bases, const double* exponents, double* out, size_t count) {
+    typedef decltype(V{} < 0.0) L;
+    const size_t lanes = sizeof(V) / sizeof(double);
+    V zero = {};
+    V one = zero + 1.0;
+    V notANumber = zero + numeric_limits<double>::quiet_NaN();
+    size_t i = 0;
+    for (; i + lanes <= count; i += lanes) {
+        V x, y, ay;
+        loadVector(bases + i, x);
+        loadVector(exponents + i, y);
+        vectorAbs(y, ay);
+
+        // Integer exponents
+        I n = __builtin_convertvector(ay <= ScientificKernels::maxIntegerExponent ? y : zero, I);
+        V nearest = __builtin_convertvector(n, V);
+        nearest = ay <= ScientificKernels::maxIntegerExponent ? nearest : notANumber;
+        V integer = nearest == y ? one : zero;
+        bool anyInteger = false;
+        for (size_t lane = 0; lane < lanes; lane++) {
+            anyInteger |= integer[lane] != 0.0;
+        }
+        V integerResult = one;
+        if (anyInteger) {
+            L bitsLeft = __builtin_convertvector(n < 0 ? -n : n, L);
+            V square = x;
+            for (int step = 0; step < 7; step++) {
+                integerResult *= (bitsLeft & 1) != 0 ? square : one;
+                square *= square;
+                bitsLeft >>= 1;
+            }
+            V reciprocal = y < 0.0 ? 1.0 / integerResult : integerResult;
+            integerResult = (x == 0.0 ? y : zero) < 0.0 ? zero : reciprocal;
+        }
+
+        // logExtended
+        V base = x < ScientificKernels::infinity ? x : zero;
+        auto positive = base >= ScientificKernels::minNormal;
+        L bits = (L)(positive ? x : one);
+        L offset = bits - (long long)ScientificKernels::powLogOffset;
+        L index = (offset >> (52 - ScientificKernels::powTableBits)) & ((1 << ScientificKernels::powTableBits) - 1);
+        V k = __builtin_convertvector(__builtin_convertvector(offset >> 52, I), V);
+        L zBits = bits - (offset & (long long)0xfff0000000000000ULL);
+        V z = (V)zBits;
+        V invc, logc, logcTail;
+        index *= 3;
+        vectorGather(ScientificKernels::powLogTable, index, invc);
+        vectorGather(ScientificKernels::powLogTable + 1, index, logc);
+        vectorGather(ScientificKernels::powLogTable + 2, index, logcTail);
+
+        V zHi = (V)((zBits + 0x80000000LL) & (long long)0xffffffff00000000ULL);
+        V zLo = z - zHi;
+        V rHi = zHi * invc - 1.0;
+        V rLo = zLo * invc;
+        V r = rHi + rLo;
+
+        V t1 = k * ScientificKernels::powLn2Hi + logc;
+        V t2 = t1 + r;
+        V lo1 = k * ScientificKernels::powLn2Lo + logcTail;
+        V lo2 = t1 - t2 + r;
+        V ar = -0.5 * r;
+        V ar2 = r * ar;
+        V ar3 = r * ar2;
+        V arHi = -0.5 * rHi;
+        V arHi2 = rHi * arHi;
+        V head = t2 + arHi2;
+        V lo3 = rLo * (ar + arHi);
+        V lo4 = t2 - head + arHi2;
+        V p = ar3 * (ScientificKernels::powA1 + r * ScientificKernels::powA2 + ar2 * (ScientificKernels::powA3 +
+              r * ScientificKernels::powA4 + ar2 * (ScientificKernels::powA5 + r * ScientificKernels::powA6 +
+              ar2 * (ScientificKernels::powA7 + r * ScientificKernels::powA8))));
+        V tail = lo1 + lo2 + lo3 + lo4 + p;
+        V hi = head + tail;
+        V lo = head - hi + tail;
+
+        // y * log(x) with both split in two
+        V yPositive = positive ? y : zero;
+        V yHi = (V)((L)yPositive & (long long)0xfffffffff8000000ULL);
+        V lHi = (V)((L)hi & (long long)0xfffffffff8000000ULL);
+        V lLo = hi - lHi + lo;
+        V eHi = yHi * lHi;
+        V eLo = (yPositive - yHi) * lHi + yPositive * lLo;
+        V inRange = positive ? eHi : zero - 2048.0;
+        inRange = inRange < ScientificKernels::powExpMaximum ? inRange : zero - 2048.0;
+        V general = inRange > ScientificKernels::powExpMinimum ? one : zero;
+
+        // expExtended
+        eHi = general == 1.0 ? eHi : zero;
+        eLo = general == 1.0 ? eLo : zero;
+        V kd = eHi * ScientificKernels::powInvLn2N + ScientificKernels::powShift;
+        L ki = (L)kd;
+        kd -= ScientificKernels::powShift;
+        r = eHi - kd * ScientificKernels::powLn2HiN - kd * ScientificKernels::powLn2LoN;
+        r += eLo;
+        index = (ki & ((1 << ScientificKernels::powTableBits) - 1)) * 2;
+        V scale;
+        vectorGather(ScientificKernels::powExpTable, index, tail);
+        vectorGather(ScientificKernels::powExpTable + 1, index, scale);
+        scale = (V)((L)scale + (ki << (52 - ScientificKernels::powTableBits)));
+        V r2 = r * r;
+        V t = tail + r + r2 * (ScientificKernels::powC2 + r * ScientificKernels::powC3) +
+              r2 * r2 * (ScientificKernels::powC4 + r * ScientificKernels::powC5);
+        V generalResult = scale + scale * t;
+
+        V result = integer == 1.0 ? integerResult : generalResult;
+        storeVector(out + i, result);
+
+        for (size_t lane = 0; lane < lanes; lane++) {
+            if (integer[lane] == 0.0 && general[lane] == 0.0) {
+                out[i + lane] = ScientificCalculator::powerKernel(bases[i + lane], exponents[i + lane]);
+            }
+        }
+    }
+    scalarPower(bases + i, exponents + i, out + i, count - i);
+}
+
+// CalcKernels::polynomial on each lane.  Horner runs two vectors at a time
+// so their chains overlap; the four-chain form has that parallelism within.
+// c - zero broadcasts c exactly, -0 included (zero + c would not).
+template <typename V>
+CALC_ALWAYS_INLINE void vectorPolynomial(const double* c, size_t terms, const double* xs, double* out,
+                                         size_t count) {
+    const size_t lanes = sizeof(V) / sizeof(double);
+    V zero = {};
+    size_t i = 0;
+    if (terms == 0) {
+        // the scalar tail writes the zeros
+    } else if (terms < CalcKernels::estrinTerms) {
+        for (; i + 2 * lanes <= count; i += 2 * lanes) {
+            V x0, x1;
+            loadVector(xs + i, x0);
+            loadVector(xs + i + lanes, x1);
+            V r0 = c[terms - 1] - zero;
+            V r1 = r0;
+            for (size_t k = terms - 1; k > 0; k--) {
+                r0 = r0 * x0 + c[k - 1];
+                r1 = r1 * x1 + c[k - 1];
+            }
+            storeVector(out + i, r0);
+            storeVector(out + i + lanes, r1);
+        }
+    } else {
+        size_t rest = terms % 4;
+        size_t top = terms - rest - 4;
+        for (; i + lanes <= count; i += lanes) {
+            V x;
+            loadVector(xs + i, x);
+            V x2 = x * x;
+            V x4 = x2 * x2;
+            V h0 = c[top] - zero, h1 = c[top + 1] - zero, h2 = c[top + 2] - zero, h3 = c[top + 3] - zero;
+            if (rest > 0) h0 = c[top + 4] * x4 + h0;
+            if (rest > 1) h1 = c[top + 5] * x4 + h1;
+            if (rest > 2) h2 = c[top + 6] * x4 + h2;
+            for (size_t k = top; k > 0; k -= 4) {
+                h0 = h0 * x4 + c[k - 4];
+                h1 = h1 * x4 + c[k - 3];
+                h2 = h2 * x4 + c[k - 2];
+                h3 = h3 * x4 + c[k - 1];
+            }
+            storeVector(out + i, (h0 + x * h1) + x2 * (h2 + x * h3));
+        }
+    }
+    scalarPolynomial(c, terms, xs + i, out + i, count - i);
+}
+
+#endif // CALC_DISPATCH_VECTOR
+
+#ifdef CALC_DISPATCH_X86
+
+template <int Operation>
+CALC_VECTOR_TARGET("sse2")
+void sse2Basic(const double* a, const double* b, double* out, size_t count) {
+    vectorBasic<Double2, Operation>(a, b, out, count);
+}
+
+template <int Operation>
+CALC_VECTOR_TARGET("sse2")
+void sse2BasicFloat(const float* a, const float* b, float* out, size_t count) {
+    vectorBasic<Float4, Operation>(a, b, out, count);
+}
+
+template <int Function>
+CALC_VECTOR_TARGET("sse2")
+void sse2Trig(const double* values, double* out, size_t count, bool degrees) {
+    vectorTrig<Double2, Int2, Function>(values, out, count, degrees);
+}
+
+template <int Function>
+CALC_VECTOR_TARGET("sse2")
+void sse2TrigFloat(const float* values, float* out, size_t count, bool degrees) {
+    vectorTrig<Double2, Int2, Function>(values, out, count, degrees);
+}
+
+CALC_VECTOR_TARGET("sse2")
+void sse2SineCosine(const double* angles, double* sines, double* cosines, size_t count, bool degrees) {
+    vectorSineCosine<Double2, Int2, false>(nullptr, angles, sines, cosines, count, degrees);
+}
+
+CALC_VECTOR_TARGET("sse2")
+void sse2ToRectangular(const double* magnitudes, const double* angles, double* xs, double* ys,
+                       size_t count, bool degrees) {
+    vectorSineCosine<Double2, Int2, true>(magnitudes, angles, xs, ys, count, degrees);
+}
+
+CALC_VECTOR_TARGET("sse2")
+void sse2ToPolar(const double* xs, const double* ys, double* magnitudes, double* angles,
+                 size_t count, bool degrees) {
+    vectorToPolar<Double2, Int2>(xs, ys, magnitudes, angles, count, degrees);
+}
+
+template <int Function>
+CALC_VECTOR_TARGET("sse2")
+void sse2Math(const double* values, double* out, size_t count) {
+    vectorMath<Double2, Int2, Function>(values, out, count);
+}
+
+CALC_VECTOR_TARGET("sse2")
+void sse2Polynomial(const double* coefficients, size_t terms, const double* xs, double* out,
+                    size_t count) {
+    vectorPolynomial<Double2>(coefficients, terms, xs, out, count);
+}
+
+template <int Operation>
+CALC_VECTOR_TARGET("avx2")
+void avx2Basic(const double* a, const double* b, double* out, size_t count) {
+    vectorBasic<Double4, Operation>(a, b, out, count);
+}
+
+template <int Operation>
+CALC_VECTOR_TARGET("avx2")
+void avx2BasicFloat(const float* a, const float* b, float* out, size_t count) {
+    vectorBasic<Float8, Operation>(a, b, out, count);
+}
+
+template <int Function>
+CALC_VECTOR_TARGET("avx2")
+void avx2Trig(const double* values, double* out, size_t count, bool degrees) {
+    vectorTrig<Double4, Int4, Function>(values, out, count, degrees);
+}
+
+template <int Function>
+CALC_VECTOR_TARGET("avx2")
+void avx2TrigFloat(const float* values, float* out, size_t count, bool degrees) {
+    vectorTrig<Double4, Int4, Function>(values, out, count, degrees);
+}
+
+CALC_VECTOR_TARGET("avx2")
+void avx2SineCosine(const double* angles, double* sines, double* cosines, size_t count, bool degrees) {
+    vectorSineCosine<Double4, Int4, false>(nullptr, angles, sines, cosines, count, degrees);
+}
+
+CALC_VECTOR_TARGET("avx2")
+void avx2ToRectangular(const double* magnitudes, const double* angles, double* xs, double* ys,
+                       size_t count, bool degrees) {
+    vectorSineCosine<Double4, Int4, true>(magnitudes, angles, xs, ys, count, degrees);
+}
+
+CALC_VECTOR_TARGET("avx2")
+void avx2ToPolar(const double* xs, const double* ys, double* magnitudes, double* angles,
+                 size_t count, bool degrees) {
+    vectorToPolar<Double4, Int4>(xs, ys, magnitudes, angles, count, degrees);
+}
+
+template <int Function>
+CALC_VECTOR_TARGET("avx2")
+void avx2Math(const double* values, double* out, size_t count) {
+    vectorMath<Double4, Int4, Function>(values, out, count);
+}
+
+CALC_VECTOR_TARGET("avx2")
+void avx2Power(const double* bases, const double* exponents, double* out, size_t count) {
+    vectorPower<Double4, Int4>(bases, exponents, out, count);
+}
+
+CALC_VECTOR_TARGET("avx2")
+void avx2Polynomial(const double* coefficients, size_t terms, const double* xs, double* out,
+                    size_t count) {
+    vectorPolynomial<Double4>(coefficients, terms, xs, out, count);
+}
+
+template <int Operation>
+CALC_VECTOR_TARGET("avx512f")
+void avx512Basic(const double* a, const double* b, double* out, size_t count) {
+    vectorBasic<Double8, Operation>(a, b, out, count);
+}
+
+template <int Operation>
+CALC_VECTOR_TARGET("avx512f")
+void avx512BasicFloat(const float* a, const float* b, float* out, size_t count) {
+    vectorBasic<Float16, Operation>(a, b, out, count);
+}
+
+template <int Function>
+CALC_VECTOR_TARGET("avx512f")
+void avx512Trig(const double* values, double* out, size_t count, bool degrees) {
+    vectorTrig<Double8, Int8, Function>(values, out, count, degrees);
+}
+
+template <int Function>
+CALC_VECTOR_TARGET("avx512f")
+void avx512TrigFloat(const float* values, float* out, size_t count, bool degrees) {
+    vectorTrig<Double8, Int8, Function>(values, out, count, degrees);
+}
+
+CALC_VECTOR_TARGET("avx512f")
+void avx512SineCosine(const double* angles, double* sines, double* cosines, size_t count, bool degrees) {
+    vectorSineCosine<Double8, Int8, false>(nullptr, angles, sines, cosines, count, degrees);
+}
+
+CALC_VECTOR_TARGET("avx512f")
+void avx512ToRectangular(const double* magnitudes, const double* angles, double* xs, double* ys,
+                         size_t count, bool degrees) {
+    vectorSineCosine<Double8, Int8, true>(magnitudes, angles, xs, ys, count, degrees);
+}
+
+CALC_VECTOR_TARGET("avx512f")
+void avx512ToPolar(const double* xs, const double* ys, double* magnitudes, double* angles,
+                   size_t count, bool degrees) {
+    vectorToPolar<Double8, Int8>(xs, ys, magnitudes, angles, count, degrees);
+}
+
+template <int Function>
+CALC_VECTOR_TARGET("avx512f")
+void avx512Math(const double* values, double* out, size_t count) {
+    vectorMath<Double8, Int8, Function>(values, out, count);
+}
+
+CALC_VECTOR_TARGET("avx512f")
+void avx512Power(const double* bases, const double* exponents, double* out, size_t count) {
+    vectorPower<Double8, Int8>(bases, exponents, out, count);
+}
+
+CALC_VECTOR_TARGET("avx512f")
+void avx512Polynomial(const double* coefficients, size_t terms, const double* xs, double* out,
+                      size_t count) {
+    vectorPolynomial<Double8>(coefficients, terms, xs, out, count);
+}
+
+// Two lanes do not pay for the selects and the exponent handling of log
+// (ln, log10, acosh, atanh) and pow, so those stay on the scalar kernels
+const ArrayKernels sse2Kernels = {
+    CpuTier::SSE2,
+    sse2Basic<AddOperation>, sse2Basic<SubtractOperation>,
+    sse2Basic<MultiplyOperation>, sse2Basic<DivideOperation>,
+    sse2Trig<SineFunction>, sse2Trig<CosineFunction>, sse2Trig<TangentFunction>,
+    sse2SineCosine, sse2ToRectangular, sse2ToPolar,
+    sse2Math<ExpFunction>, scalarMathArray<LogFunction>, scalarMathArray<Log10Function>,
+    sse2Math<SqrtFunction>, sse2Math<SinhFunction>, sse2Math<CoshFunction>,
+    sse2Math<TanhFunction>, sse2Math<AsinhFunction>, scalarMathArray<AcoshFunction>,
+    scalarMathArray<AtanhFunction>, scalarPower, sse2Polynomial,
+    sse2BasicFloat<AddOperation>, sse2BasicFloat<SubtractOperation>,
+    sse2BasicFloat<MultiplyOperation>, sse2BasicFloat<DivideOperation>,
+    sse2TrigFloat<SineFunction>, sse2TrigFloat<CosineFunction>, sse2TrigFloat<TangentFunction>
+};
+
+const ArrayKernels avx2Kernels = {
+    CpuTier::AVX2,
+    avx2Basic<AddOperation>, avx2Basic<SubtractOperation>,
+    avx2Basic<MultiplyOperation>, avx2Basic<DivideOperation>,
+    avx2Trig<SineFunction>, avx2Trig<CosineFunction>, avx2Trig<TangentFunction>,
+    avx2SineCosine, avx2ToRectangular, avx2ToPolar,
+    avx2Math<ExpFunction>, avx2Math<LogFunction>, avx2Math<Log10Function>,
+    avx2Math<SqrtFunction>, avx2Math<SinhFunction>, avx2Math<CoshFunction>,
+    avx2Math<TanhFunction>, avx2Math<AsinhFunction>, avx2Math<AcoshFunction>,
+    avx2Math<AtanhFunction>, avx2Power, avx2Polynomial,
+    avx2BasicFloat<AddOperation>, avx2BasicFloat<SubtractOperation>,
+    avx2BasicFloat<MultiplyOperation>, avx2BasicFloat<DivideOperation>,
+    avx2TrigFloat<SineFunction>, avx2TrigFloat<CosineFunction>, avx2TrigFloat<TangentFunction>
+};
+
+const ArrayKernels avx512Kernels = {
+    CpuTier::AVX512,
+    avx512Basic<AddOperation>, avx512Basic<SubtractOperation>,
+    avx512Basic<MultiplyOperation>, avx512Basic<DivideOperation>,
+    avx512Trig<SineFunction>, avx512Trig<CosineFunction>, avx512Trig<TangentFunction>,
+    avx512SineCosine, avx512ToRectangular, avx512ToPolar,
+    avx512Math<ExpFunction>, avx512Math<LogFunction>, avx512Math<Log10Function>,
+    avx512Math<SqrtFunction>, avx512Math<SinhFunction>, avx512Math<CoshFunction>,
+    avx512Math<TanhFunction>, avx512Math<AsinhFunction>, avx512Math<AcoshFunction>,
+    avx512Math<AtanhFunction>, avx512Power, avx512Polynomial,
+    avx512BasicFloat<AddOperation>, avx512BasicFloat<SubtractOperation>,
+    avx512BasicFloat<MultiplyOperation>, avx512BasicFloat<DivideOperation>,
+    avx512TrigFloat<SineFunction>, avx512TrigFloat<CosineFunction>, avx512TrigFloat<TangentFunction>
+};
+
+#endif // CALC_DISPATCH_X86
+
+#ifdef CALC_DISPATCH_NEON
+
+template <int Operation>
+CALC_NO_FP_CONTRACT
+void neonBasic(const double* a, const double* b, double* out, size_t count) {
+    vectorBasic<Double2, Operation>(a, b, out, count);
+}
+
+template <int Operation>
+CALC_NO_FP_CONTRACT
+void neonBasicFloat(const float* a, const float* b, float* out, size_t count) {
+    vectorBasic<Float4, Operation>(a, b, out, count);
+}
+
+template <int Function>
+CALC_NO_FP_CONTRACT
+void neonTrig(const double* values, double* out, size_t count, bool degrees) {
+    vectorTrig<Double2, Int2, Function>(values, out, count, degrees);
+}
+
+template <int Function>
+CALC_NO_FP_CONTRACT
+void neonTrigFloat(const float* values, float* out, size_t count, bool degrees) {
+    vectorTrig<Double2, Int2, Function>(values, out, count, degrees);
+}
+
+CALC_NO_FP_CONTRACT
+void neonSineCosine(const double* angles, double* sines, double* cosines, size_t count, bool degrees) {
+    vectorSineCosine<Double2, Int2, false>(nullptr, angles, sines, cosines, count, degrees);
+}
+
+CALC_NO_FP_CONTRACT
+void neonToRectangular(const double* magnitudes, const double* angles, double* xs, double* ys,
+                       size_t count, bool degrees) {
+    vectorSineCosine<Double2, Int2, true>(magnitudes, angles, xs, ys, count, degrees);
+}
+
+CALC_NO_FP_CONTRACT
+void neonToPolar(const double* xs, const double* ys, double* magnitudes, double* angles,
+                 size_t count, bool degrees) {
+    vectorToPolar<Double2, Int2>(xs, ys, magnitudes, angles, count, degrees);
+}
+
+template <int Function>
+CALC_NO_FP_CONTRACT
+void neonMath(const double* values, double* out, size_t count) {
+    vectorMath<Double2, Int2, Function>(values, out, count);
+}
+
+CALC_NO_FP_CONTRACT
+void neonPower(const double* bases, const double* exponents, double* out, size_t count) {
+    vectorPower<Double2, Int2>(bases, exponents, out, count);
+}
+
+CALC_NO_FP_CONTRACT
+void neonPolynomial(const double* coefficients, size_t terms, const double* xs, double* out,
+                    size_t count) {
+    vectorPolynomial<Double2>(coefficients, terms, xs, out, count);
+}
+
+const ArrayKernels neonKernels = {
+    CpuTier::NEON,
+    neonBasic<AddOperation>, neonBasic<SubtractOperation>,
+    neonBasic<MultiplyOperation>, neonBasic<DivideOperation>,
+    neonTrig<SineFunction>, neonTrig<CosineFunction>, neonTrig<TangentFunction>,
+    neonSineCosine, neonToRectangular, neonToPolar,
+    neonMath<ExpFunction>, neonMath<LogFunction>, neonMath<Log10Function>,
+    neonMath<SqrtFunction>, neonMath<SinhFunction>, neonMath<CoshFunction>,
+    neonMath<TanhFunction>, neonMath<AsinhFunction>, neonMath<AcoshFunction>,
+    neonMath<AtanhFunction>, neonPower, neonPolynomial,
+    neonBasicFloat<AddOperation>, neonBasicFloat<SubtractOperation>,
+    neonBasicFloat<MultiplyOperation>, neonBasicFloat<DivideOperation>,
+    neonTrigFloat<SineFunction>, neonTrigFloat<CosineFunction>, neonTrigFloat<TangentFunction>
+};
+
+#endif // CALC_DISPATCH_NEON
+
+bool cpuSupports(CpuTier tier) {
+    switch (tier) {
+        case CpuTier::Scalar:
+            return true;
+#ifdef CALC_DISPATCH_X86
+        case CpuTier::SSE2:
+            return __builtin_cpu_supports("sse2");
+        case CpuTier::AVX2:
+            return __builtin_cpu_supports("avx2");
+        case CpuTier::AVX512:
+            return __builtin_cpu_supports("avx512f");
+#endif
+#ifdef CALC_DISPATCH_NEON
+        case CpuTier::NEON:
+#if defined(__linux__)
+            return (getauxval(AT_HWCAP) & HWCAP_ASIMD) != 0;
+#else
+            return true;   // Advanced SIMD is mandatory on arm64
+#endif
+#endif
+        default:
+            return false;
+    }
+}
+
+atomic<const ArrayKernels*> activeKernels(nullptr);
+
+const ArrayKernels* initialKernels() {
+    const ArrayKernels* kernels = CpuDispatch::kernelsFor(CpuDispatch::detectedTier());
+    const char* forced = getenv("CALC_CPU_TIER");
+    if (forced != nullptr && *forced != '\0') {
+        CpuTier tier;
+        if (!CpuDispatch::parseTier(forced, tier)) {
+            cout << "Unknown CALC_CPU_TIER '" << forced << "', using "
+                 << CpuDispatch::tierName(kernels->tier) << endl;
+        } else if (CpuDispatch::kernelsFor(tier) == nullptr) {
+            cout << "CPU tier " << CpuDispatch::tierName(tier) << " is not supported here, using "
+                 << CpuDispatch::tierName(kernels->tier) << endl;
+        } else {
+            kernels = CpuDispatch::kernelsFor(tier);
+        }
+    }
+    return kernels;
+}
+
+} // namespace
+
+ArrayKernels::BinaryKernel ArrayKernels::forOperation(char operation) const {
+    switch (operation) {
+        case '+': return add;
+        case '-': return subtract;
+        case '*': return multiply;
+        case '/': return divide;
+        default: return nullptr;
+    }
+}
+
+ArrayKernels::FloatBinaryKernel ArrayKernels::forFloatOperation(char operation) const {
+    switch (operation) {
+        case '+': return addFloat;
+        case '-': return subtractFloat;
+        case '*': return multiplyFloat;
+        case '/': return divideFloat;
+        default: return nullptr;
+    }
+}
+
+CpuTier CpuDispatch::detectedTier() {
+    static const CpuTier tier = [] {
+        const CpuTier order[] = { CpuTier::AVX512, CpuTier::AVX2, CpuTier::SSE2, CpuTier::NEON };
+        for (CpuTier candidate : order) {
+            if (kernelsFor(candidate) != nullptr) {
+                return candidate;
+            }
+        }
+        return CpuTier::Scalar;
+    }();
+    return tier;
+}
+
+const ArrayKernels* CpuDispatch::kernelsFor(CpuTier tier) {
+    if (!cpuSupports(tier)) {
+        return nullptr;
+    }
+    switch (tier) {
+        case CpuTier::Scalar: return &scalarKernels;
+#ifdef CALC_DISPATCH_X86
+        case CpuTier::SSE2: return &sse2Kernels;
+        case CpuTier::AVX2: return &avx2Kernels;
+        case CpuTier::AVX512: return &avx512Kernels;
+#endif
+#ifdef CALC_DISPATCH_NEON
+        case CpuTier::NEON: return &neonKernels;
+#endif
+        default: return nullptr;
+    }
+}
+
+const ArrayKernels& CpuDispatch::kernels() {
+    const ArrayKernels* current = activeKernels.load(memory_order_acquire);
+    if (current == nullptr) {
+        static const ArrayKernels* initial = initialKernels();
+        activeKernels.compare_exchange_strong(current, initial, memory_order_acq_rel);
+        current = activeKernels.load(memory_order_acquire);
+    }
+    return *current;
+}
+
+bool CpuDispatch::setTier(CpuTier tier) {
+    const ArrayKernels* requested = kernelsFor(tier);
+    if (requested == nullptr) {
+        return false;
+    }
+    activeKernels.store(requested, memory_order_release);
+    return true;
+}
+
+const char* CpuDispatch::tierName(CpuTier tier) {
+    switch (tier) {
+        case CpuTier::Scalar: return "scalar";
+        case CpuTier::SSE2: return "sse2";
+        case CpuTier::AVX2: return "avx2";
+        case CpuTier::AVX512: return "avx512";
+        case CpuTier::NEON: return "neon";
+    }
+    return "unknown";
+}
+
+bool CpuDispatch::parseTier(const string& name, CpuTier& tier) {
+    const CpuTier tiers[] = { CpuTier::Scalar, CpuTier::SSE2, CpuTier::AVX2, CpuTier::AVX512, CpuTier::NEON };
+    for (CpuTier candidate : tiers) {
+        if (name == tierName(candidate)) {
+            tier = candidate;
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,99 @@
+#ifndef CPUDISPATCH_H
+#define CPUDISPATCH_H
+
+#include <cstddef>
+#include <string>
+
+enum class CpuTier {
+    Scalar,
+    SSE2,
+    AVX2,
+    AVX512,
+    NEON
+};
+
+// Array kernels for double, one set per instruction-set tier.  Every tier
+// returns bit-identical results to the scalar CalcKernels path: the vector
+// trig kernels run the same reduction and polynomials lane by lane, and
+// lanes outside the fast range (|x| >= 2^37 degrees, |x| > reductionLimit
+// radians, inf, NaN, and radians so close to a multiple of pi/2 that the
+// reduction needs more of pi) are recomputed with the scalar kernel.
+// sincos and the polar conversions share that reduction.  The scientific
+// kernels mirror ScientificKernels the same way, with the scalar kernel
+// taking over for out-of-range lanes and for pow arguments its fast paths
+// do not cover.  The float kernels do their arithmetic on float vectors,
+// twice as many lanes per register; float trig widens to double, runs the
+// double kernel of the same tier and rounds once, which is also what the
+// single-value float kernels do.
+struct ArrayKernels {
+    typedef void (*BinaryKernel)(const double* a, const double* b, double* out, size_t count);
+    typedef void (*UnaryKernel)(const double* values, double* out, size_t count, bool degrees);
+    typedef void (*MathKernel)(const double* values, double* out, size_t count);
+    typedef void (*PairKernel)(const double* a, const double* b, double* outA, double* outB,
+                               size_t count, bool degrees);
+    typedef void (*SineCosineKernel)(const double* angles, double* sines, double* cosines,
+                                     size_t count, bool degrees);
+    typedef void (*PolynomialKernel)(const double* coefficients, size_t terms, const double* xs,
+                                     double* out, size_t count);
+    typedef void (*FloatBinaryKernel)(const float* a, const float* b, float* out, size_t count);
+    typedef void (*FloatUnaryKernel)(const float* values, float* out, size_t count, bool degrees);
+
+    CpuTier tier;
+    BinaryKernel add;
+    BinaryKernel subtract;
+    BinaryKernel multiply;
+    BinaryKernel divide;
+    UnaryKernel sine;
+    UnaryKernel cosine;
+    UnaryKernel tangent;
+    SineCosineKernel sineCosine;
+    PairKernel toRectangular;     // (magnitude, angle) -> (x, y)
+    PairKernel toPolar;           // (x, y) -> (magnitude, angle)
+    MathKernel exponential;
+    MathKernel logarithm;
+    MathKernel logarithm10;
+    MathKernel squareRoot;
+    MathKernel hyperbolicSine;
+    MathKernel hyperbolicCosine;
+    MathKernel hyperbolicTangent;
+    MathKernel inverseHyperbolicSine;
+    MathKernel inverseHyperbolicCosine;
+    MathKernel inverseHyperbolicTangent;
+    BinaryKernel power;
+    PolynomialKernel polynomial;  // CalcKernels::polynomial at each x
+    FloatBinaryKernel addFloat;
+    FloatBinaryKernel subtractFloat;
+    FloatBinaryKernel multiplyFloat;
+    FloatBinaryKernel divideFloat;
+    FloatUnaryKernel sineFloat;
+    FloatUnaryKernel cosineFloat;
+    FloatUnaryKernel tangentFloat;
+
+    // Kernel for '+', '-', '*' or '/', or nullptr
+    BinaryKernel forOperation(char operation) const;
+    FloatBinaryKernel forFloatOperation(char operation) const;
+};
+
+// Picks the widest tier the CPU supports the first time kernels() is
+// called (cpuid on x86, getauxval on Linux/arm64).  CALC_CPU_TIER=scalar,
+// sse2, avx2, avx512 or neon forces a tier; an unsupported choice falls
+// back to the detected one with a warning.  Compilers without GNU vector
+// extensions only get the scalar tier.
+class CpuDispatch {
+public:
+    static CpuTier detectedTier();
+    static CpuTier activeTier() { return kernels().tier; }
+    static const ArrayKernels& kernels();
+
+    // Kernels for a specific tier, or nullptr if this CPU or build lacks it
+    static const ArrayKernels* kernelsFor(CpuTier tier);
+
+    // Rebinds kernels(); call while no batch is running.  Returns false
+    // (and keeps the current tier) if tier is unsupported.
+    static bool setTier(CpuTier tier);
+
+    static const char* tierName(CpuTier tier);
+    static bool parseTier(const std::string& name, CpuTier& tier);
+};
+
+#endif // CPUDISPATCH_H
@@ -0,0 +1,56 @@
+#include "EngineState.h"
+#include <thread>
+
+using namespace std;
+
+EngineStateMirror::EngineStateMirror() {
+    block.sequence.store(0, memory_order_relaxed);
+    block.flags = 0;
+    block.errors = 0;
+    block.reserved = 0;
+    block.lastResult = 0.0;
+    block.memoryValue = 0.0;
+    block.updateCount = 0;
+}
+
+void EngineStateMirror::publish(double lastResult, double memoryValue, bool hasMemory, bool degrees, uint32_t errors) {
+    uint32_t sequence = block.sequence.load(memory_order_relaxed);
+    block.sequence.store(sequence + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+
+    uint32_t flags = 0;
+    if (hasMemory) flags |= StateHasMemory;
+    if (degrees) flags |= StateDegrees;
+    block.flags = flags;
+    block.errors = errors;
+    block.lastResult = lastResult;
+    block.memoryValue = memoryValue;
+    block.updateCount++;
+
+    block.sequence.store(sequence + 2, memory_order_release);
+}
+
+const EngineStateBlock* EngineStateMirror::get() const {
+    return &block;
+}
+
+EngineStateSnapshot EngineStateMirror::read() const {
+    EngineStateSnapshot snapshot;
+    for (;;) {
+        uint32_t before = block.sequence.load(memory_order_acquire);
+        if (before & 1) {
+            this_thread::yield();
+            continue;
+        }
+        snapshot.flags = block.flags;
+        snapshot.errors = block.errors;
+        snapshot.lastResult = block.lastResult;
+        snapshot.memoryValue = block.memoryValue;
+        snapshot.updateCount = block.updateCount;
+        atomic_thread_fence(memory_order_acquire);
+        if (block.sequence.load(memory_order_relaxed) == before) {
+            snapshot.sequence = before;
+            return snapshot;
+        }
+    }
+}
@@ -0,0 +1,73 @@
+#ifndef ENGINESTATE_H
+#define ENGINESTATE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Everything a UI shows after an action, kept by the engine in one block
+// with a fixed layout so FFI consumers can read it through a pointer
+// instead of calling a getter per field.
+//
+// Updates are guarded by a seqlock: sequence is odd while the engine is
+// writing and is bumped again when it is done.  A reader copies the block
+// and retries if the sequence was odd or changed in the meantime, which
+// only matters when the engine runs on another thread (AsyncCalculator).
+//
+// Layout (native endian, 40 bytes):
+//   0 uint32 sequence | 4 uint32 flags | 8 uint32 errors | 12 uint32 0 |
+//   16 double lastResult | 24 double memoryValue | 32 uint64 updateCount
+enum EngineStateFlags : uint32_t {
+    StateHasMemory = 1,
+    StateDegrees = 2
+};
+
+// Errors raised by the most recent operation
+enum EngineStateErrors : uint32_t {
+    StateDivisionByZero = 1,
+    StateInvalidOperation = 2,
+    StateDomainError = 4
+};
+
+struct EngineStateBlock {
+    std::atomic<uint32_t> sequence;
+    uint32_t flags;
+    uint32_t errors;
+    uint32_t reserved;
+    double lastResult;
+    double memoryValue;
+    uint64_t updateCount;
+};
+
+static_assert(sizeof(std::atomic<uint32_t>) == 4, "sequence must be a plain 32-bit word");
+static_assert(offsetof(EngineStateBlock, lastResult) == 16, "EngineStateBlock layout is shared with Dart");
+static_assert(sizeof(EngineStateBlock) == 40, "EngineStateBlock layout is shared with Dart");
+
+// A consistent copy of the block
+struct EngineStateSnapshot {
+    uint32_t sequence;
+    uint32_t flags;
+    uint32_t errors;
+    double lastResult;
+    double memoryValue;
+    uint64_t updateCount;
+
+    bool hasMemory() const { return (flags & StateHasMemory) != 0; }
+    bool isDegrees() const { return (flags & StateDegrees) != 0; }
+};
+
+class EngineStateMirror {
+private:
+    alignas(64) EngineStateBlock block;
+
+public:
+    EngineStateMirror();
+
+    // Single writer: the thread currently driving the engine
+    void publish(double lastResult, double memoryValue, bool hasMemory, bool degrees, uint32_t errors);
+
+    const EngineStateBlock* get() const;
+    EngineStateSnapshot read() const;
+};
+
+#endif // ENGINESTATE_H
@@ -0,0 +1,238 @@
+#include "EngineStats.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+const char* const operationNames[EngineStats::OperationCount] = {
+    "add", "subtract", "multiply", "divide",
+    "sin", "cos", "tan", "sincos", "asin", "acos", "atan",
+    "exp", "log", "log10", "sqrt", "pow",
+    "sinh", "cosh", "tanh", "asinh", "acosh", "atanh",
+    "batch basic", "batch trig", "batch polar", "batch scientific",
+    "polynomial", "fit", "prime test", "factorize", "prime count", "integer",
+    "factorial", "gamma", "nPr", "nCr",
+    "expression",
+    "memory store", "memory recall", "memory clear"
+};
+
+const char* const errorNames[EngineStats::ErrorCount] = {
+    "division by zero", "asin domain", "acos domain", "invalid operation",
+    "log domain", "sqrt domain", "pow domain", "inverse hyperbolic domain",
+    "integer range", "combinatorics domain"
+};
+
+#ifndef CALC_DISABLE_STATS
+
+void addSnapshot(EngineStats::Snapshot& total, const EngineStats::Snapshot& part, bool subtract) {
+    const uint64_t* from = reinterpret_cast<const uint64_t*>(&part);
+    uint64_t* to = reinterpret_cast<uint64_t*>(&total);
+    for (size_t i = 0; i < sizeof(EngineStats::Snapshot) / sizeof(uint64_t); i++) {
+        to[i] = subtract ? to[i] - from[i] : to[i] + from[i];
+    }
+}
+
+// One block per recording thread; only its owner writes to it
+struct ThreadCounters {
+    atomic<uint64_t> calls[EngineStats::OperationCount];
+    atomic<uint64_t> totalNanoseconds[EngineStats::OperationCount];
+    atomic<uint64_t> latency[EngineStats::OperationCount][EngineStats::latencyBuckets];
+    atomic<uint64_t> errors[EngineStats::ErrorCount];
+
+    ThreadCounters() {
+        for (auto& value : calls) value.store(0, memory_order_relaxed);
+        for (auto& value : totalNanoseconds) value.store(0, memory_order_relaxed);
+        for (auto& row : latency) {
+            for (auto& value : row) value.store(0, memory_order_relaxed);
+        }
+        for (auto& value : errors) value.store(0, memory_order_relaxed);
+    }
+
+    void readInto(EngineStats::Snapshot& out) const {
+        for (int op = 0; op < EngineStats::OperationCount; op++) {
+            out.calls[op] += calls[op].load(memory_order_relaxed);
+            out.totalNanoseconds[op] += totalNanoseconds[op].load(memory_order_relaxed);
+            for (int b = 0; b < EngineStats::latencyBuckets; b++) {
+                out.latency[op][b] += latency[op][b].load(memory_order_relaxed);
+            }
+        }
+        for (int e = 0; e < EngineStats::ErrorCount; e++) {
+            out.errors[e] += errors[e].load(memory_order_relaxed);
+        }
+    }
+};
+
+// Single writer, so a relaxed load/store pair needs no locked instruction
+inline void bump(atomic<uint64_t>& counter, uint64_t amount) {
+    counter.store(counter.load(memory_order_relaxed) + amount, memory_order_relaxed);
+}
+
+inline int latencyBucket(uint64_t nanoseconds) {
+#if defined(__GNUC__) || defined(__clang__)
+    int bucket = 63 - __builtin_clzll(nanoseconds | 1);
+#else
+    int bucket = 0;
+    while ((nanoseconds >> (bucket + 1)) != 0) {
+        bucket++;
+    }
+#endif
+    return min(bucket, EngineStats::latencyBuckets - 1);
+}
+
+// Live blocks plus the totals of threads that have exited.  Never
+// destroyed, so threads exiting during shutdown can still fold in.
+struct Registry {
+    mutex lock;
+    vector<ThreadCounters*> live;
+    EngineStats::Snapshot retired;
+    EngineStats::Snapshot baseline;
+
+    Registry() {
+        memset(&retired, 0, sizeof(retired));
+        memset(&baseline, 0, sizeof(baseline));
+    }
+};
+
+Registry& registry() {
+    static Registry* instance = new Registry();
+    return *instance;
+}
+
+struct ThreadSlot {
+    ThreadCounters* counters = nullptr;
+
+    ~ThreadSlot() {
+        if (counters == nullptr) {
+            return;
+        }
+        Registry& shared = registry();
+        lock_guard<mutex> guard(shared.lock);
+        counters->readInto(shared.retired);
+        shared.live.erase(find(shared.live.begin(), shared.live.end(), counters));
+        delete counters;
+    }
+};
+
+thread_local ThreadSlot threadSlot;
+
+ThreadCounters& localCounters() {
+    if (threadSlot.counters == nullptr) {
+        ThreadCounters* counters = new ThreadCounters();
+        Registry& shared = registry();
+        lock_guard<mutex> guard(shared.lock);
+        shared.live.push_back(counters);
+        threadSlot.counters = counters;
+    }
+    return *threadSlot.counters;
+}
+
+#endif
+
+} // namespace
+
+#ifndef CALC_DISABLE_STATS
+
+atomic<bool> EngineStats::enabled(false);
+
+void EngineStats::setEnabled(bool on) {
+    enabled.store(on, memory_order_relaxed);
+}
+
+void EngineStats::recordCall(Operation operation, uint64_t nanoseconds) {
+    ThreadCounters& counters = localCounters();
+    bump(counters.calls[operation], 1);
+    bump(counters.totalNanoseconds[operation], nanoseconds);
+    bump(counters.latency[operation][latencyBucket(nanoseconds)], 1);
+}
+
+void EngineStats::countError(Error error) {
+    bump(localCounters().errors[error], 1);
+}
+
+EngineStats::Snapshot EngineStats::snapshot() {
+    Snapshot result;
+    Registry& shared = registry();
+    lock_guard<mutex> guard(shared.lock);
+    result = shared.retired;
+    for (const ThreadCounters* counters : shared.live) {
+        counters->readInto(result);
+    }
+    addSnapshot(result, shared.baseline, true);
+    return result;
+}
+
+void EngineStats::reset() {
+    Snapshot current = snapshot();
+    Registry& shared = registry();
+    lock_guard<mutex> guard(shared.lock);
+    addSnapshot(shared.baseline, current, false);
+}
+
+#else
+
+EngineStats::Snapshot EngineStats::snapshot() {
+    Snapshot result;
+    memset(&result, 0, sizeof(result));
+    return result;
+}
+
+void EngineStats::reset() {
+}
+
+#endif
+
+const char* EngineStats::operationName(int operation) {
+    return operation >= 0 && operation < OperationCount ? operationNames[operation] : "unknown";
+}
+
+const char* EngineStats::errorName(int error) {
+    return error >= 0 && error < ErrorCount ? errorNames[error] : "unknown";
+}
+
+// Snapshot
+double EngineStats::Snapshot::meanNanoseconds(int operation) const {
+    return calls[operation] > 0 ? double(totalNanoseconds[operation]) / double(calls[operation]) : 0.0;
+}
+
+// Upper edge of the bucket holding the given percentile (0-100)
+double EngineStats::Snapshot::percentileNanoseconds(int operation, double percentile) const {
+    uint64_t count = calls[operation];
+    if (count == 0) {
+        return 0.0;
+    }
+    double target = percentile / 100.0 * double(count);
+    uint64_t seen = 0;
+    for (int b = 0; b < latencyBuckets; b++) {
+        seen += latency[operation][b];
+        if (double(seen) >= target) {
+            return double(uint64_t(1) << (b + 1));
+        }
+    }
+    return double(uint64_t(1) << latencyBuckets);
+}
+
+string EngineStats::Snapshot::toString() const {
+    string text = "operation          calls    mean ns   p50 ns   p99 ns\n";
+    char line[128];
+    for (int op = 0; op < OperationCount; op++) {
+        if (calls[op] == 0) {
+            continue;
+        }
+        snprintf(line, sizeof(line), "%-14s %9llu %10.1f %8.0f %8.0f\n", operationName(op),
+                 (unsigned long long)calls[op], meanNanoseconds(op),
+                 percentileNanoseconds(op, 50), percentileNanoseconds(op, 99));
+        text += line;
+    }
+    for (int e = 0; e < ErrorCount; e++) {
+        if (errors[e] != 0) {
+            snprintf(line, sizeof(line), "error: %-18s %llu\n", errorName(e), (unsigned long long)errors[e]);
+            text += line;
+        }
+    }
+    return text;
+}
@@ -0,0 +1,155 @@
+#ifndef ENGINESTATS_H
+#define ENGINESTATS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+// Opt-in instrumentation for the calculator engine: call counts, error
+// counts and log2-bucketed latency histograms per operation.
+//
+// Each thread writes to its own counter block (single writer, relaxed
+// atomics, no locks); snapshot() sums the blocks on read.  Recording is off
+// until setEnabled(true), and then costs one predictable branch per call
+// while off.  Building with -DCALC_DISABLE_STATS removes it entirely.
+class EngineStats {
+public:
+    enum Operation {
+        Add,
+        Subtract,
+        Multiply,
+        Divide,
+        Sine,
+        Cosine,
+        Tangent,
+        SineCosine,
+        Arcsine,
+        Arccosine,
+        Arctangent,
+        Exponential,
+        Logarithm,
+        Logarithm10,
+        SquareRoot,
+        Power,
+        HyperbolicSine,
+        HyperbolicCosine,
+        HyperbolicTangent,
+        InverseHyperbolicSine,
+        InverseHyperbolicCosine,
+        InverseHyperbolicTangent,
+        BatchBasic,
+        BatchTrig,
+        BatchPolar,
+        BatchScientific,
+        PolynomialEval,
+        PolynomialFit,
+        PrimeTest,
+        Factorize,
+        PrimeCount,
+        IntegerArithmetic,
+        Factorial,
+        Gamma,
+        Permutations,
+        Combinations,
+        ExpressionEval,
+        MemoryStore,
+        MemoryRecall,
+        MemoryClear,
+        OperationCount
+    };
+
+    enum Error {
+        DivisionByZero,
+        ArcsineDomain,
+        ArccosineDomain,
+        InvalidOperation,
+        LogarithmDomain,
+        SquareRootDomain,
+        PowerDomain,
+        InverseHyperbolicDomain,
+        IntegerRange,
+        CombinatoricsDomain,
+        ErrorCount
+    };
+
+    // Bucket b counts calls that took [2^b, 2^(b+1)) nanoseconds
+    static const int latencyBuckets = 32;
+
+    // Plain data so it can be copied across the FFI as is
+    struct Snapshot {
+        uint64_t calls[OperationCount];
+        uint64_t totalNanoseconds[OperationCount];
+        uint64_t latency[OperationCount][latencyBuckets];
+        uint64_t errors[ErrorCount];
+
+        double meanNanoseconds(int operation) const;
+        double percentileNanoseconds(int operation, double percentile) const;
+        std::string toString() const;
+    };
+
+    static const char* operationName(int operation);
+    static const char* errorName(int error);
+
+#ifdef CALC_DISABLE_STATS
+    static constexpr bool isEnabled() { return false; }
+    static void setEnabled(bool) {}
+    static void recordCall(Operation, uint64_t) {}
+    static void recordError(Error) {}
+#else
+    static bool isEnabled() { return enabled.load(std::memory_order_relaxed); }
+    static void setEnabled(bool on);
+    static void recordCall(Operation operation, uint64_t nanoseconds);
+    static void recordError(Error error) {
+        if (isEnabled()) {
+            countError(error);
+        }
+    }
+#endif
+
+    static Snapshot snapshot();
+    static void reset();   // later snapshots count from this point
+
+private:
+#ifndef CALC_DISABLE_STATS
+    static std::atomic<bool> enabled;
+    static void countError(Error error);
+#endif
+};
+
+// Times one engine call.  The operation can be set after construction so
+// the caller only works out which operation it is while stats are on.
+class StatsTimer {
+#ifdef CALC_DISABLE_STATS
+public:
+    explicit StatsTimer(EngineStats::Operation = EngineStats::OperationCount) {}
+    void setOperation(EngineStats::Operation) {}
+#else
+private:
+    EngineStats::Operation operation;
+    bool active;
+    std::chrono::steady_clock::time_point start;
+
+public:
+    explicit StatsTimer(EngineStats::Operation operation = EngineStats::OperationCount)
+        : operation(operation), active(EngineStats::isEnabled()) {
+        if (active) {
+            start = std::chrono::steady_clock::now();
+        }
+    }
+
+    ~StatsTimer() {
+        if (active && operation != EngineStats::OperationCount) {
+            auto elapsed = std::chrono::steady_clock::now() - start;
+            EngineStats::recordCall(operation, uint64_t(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+        }
+    }
+
+    void setOperation(EngineStats::Operation value) {
+        operation = value;
+    }
+#endif
+};
+
+#endif // ENGINESTATS_H
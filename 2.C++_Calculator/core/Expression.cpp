@@ -0,0 +1,460 @@
+#include "Expression.h"
+#include "JitCompiler.h"
+#include "TrigCalculator.h"
+#include "ScientificCalculator.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+
+using namespace std;
+
+namespace {
+
+// Plain double(double) entry points so that both tiers can call the
+// TrigCalculator kernels through the same function pointer.
+double sinDegrees(double x) { return TrigCalculator::sineKernel(x, true); }
+double cosDegrees(double x) { return TrigCalculator::cosineKernel(x, true); }
+double tanDegrees(double x) { return TrigCalculator::tangentKernel(x, true); }
+double asinDegrees(double x) { return TrigCalculator::arcsineKernel(x, true); }
+double acosDegrees(double x) { return TrigCalculator::arccosineKernel(x, true); }
+double atanDegrees(double x) { return TrigCalculator::arctangentKernel(x, true); }
+double sinRadians(double x) { return TrigCalculator::sineKernel(x, false); }
+double cosRadians(double x) { return TrigCalculator::cosineKernel(x, false); }
+double tanRadians(double x) { return TrigCalculator::tangentKernel(x, false); }
+double asinRadians(double x) { return TrigCalculator::arcsineKernel(x, false); }
+double acosRadians(double x) { return TrigCalculator::arccosineKernel(x, false); }
+double atanRadians(double x) { return TrigCalculator::arctangentKernel(x, false); }
+
+struct FunctionEntry {
+    const char* name;
+    const char* longName;
+    double (*degrees)(double);
+    double (*radians)(double);
+};
+
+const FunctionEntry functions[] = {
+    {"sin", "sine", sinDegrees, sinRadians},
+    {"cos", "cosine", cosDegrees, cosRadians},
+    {"tan", "tangent", tanDegrees, tanRadians},
+    {"asin", "arcsine", asinDegrees, asinRadians},
+    {"acos", "arccosine", acosDegrees, acosRadians},
+    {"atan", "arctangent", atanDegrees, atanRadians},
+    {"exp", "exp", ScientificCalculator::expKernel, ScientificCalculator::expKernel},
+    {"ln", "log", ScientificCalculator::logKernel, ScientificCalculator::logKernel},
+    {"log10", "log10", ScientificCalculator::log10Kernel, ScientificCalculator::log10Kernel},
+    {"sqrt", "sqrt", ScientificCalculator::sqrtKernel, ScientificCalculator::sqrtKernel},
+    {"sinh", "sinh", ScientificCalculator::sinhKernel, ScientificCalculator::sinhKernel},
+    {"cosh", "cosh", ScientificCalculator::coshKernel, ScientificCalculator::coshKernel},
+    {"tanh", "tanh", ScientificCalculator::tanhKernel, ScientificCalculator::tanhKernel},
+    {"asinh", "arsinh", ScientificCalculator::asinhKernel, ScientificCalculator::asinhKernel},
+    {"acosh", "arcosh", ScientificCalculator::acoshKernel, ScientificCalculator::acoshKernel},
+    {"atanh", "artanh", ScientificCalculator::atanhKernel, ScientificCalculator::atanhKernel},
+};
+
+const unsigned long long defaultJitThreshold = 1000;
+
+} // namespace
+
+Expression::Expression() {
+    maxStackDepth = 0;
+    usesOtherVariables = false;
+    angleDependent = false;
+    useDegrees = true;
+    evaluationCount = 0;
+    jitThreshold = defaultJitThreshold;
+    jitEnabled = true;
+    jitAttempted = false;
+    position = 0;
+}
+
+Expression::~Expression() {
+}
+
+bool Expression::compile(const string& expression, bool degrees) {
+    return compile(expression, degrees, vector<string>(1, "x"));
+}
+
+bool Expression::compile(const string& expression, bool degrees, const vector<string>& variableNames) {
+    text = expression;
+    variables = variableNames;
+    useDegrees = degrees;
+    angleDependent = false;
+    code.clear();
+    jit.reset();
+    jitAttempted = false;
+    evaluationCount = 0;
+    position = 0;
+
+    if (!parseExpression()) {
+        code.clear();
+        return false;
+    }
+    skipSpaces();
+    if (position != text.size()) {
+        cout << "Error: Unexpected '" << text[position] << "' in expression!" << endl;
+        code.clear();
+        return false;
+    }
+
+    size_t depth = 0;
+    maxStackDepth = 0;
+    usesOtherVariables = false;
+    for (const Instruction& instruction : code) {
+        switch (instruction.op) {
+            case OpCode::LoadVariable:
+                usesOtherVariables = true;
+                depth++;
+                break;
+            case OpCode::PushConstant:
+            case OpCode::LoadX:
+                depth++;
+                break;
+            case OpCode::Add:
+            case OpCode::Subtract:
+            case OpCode::Multiply:
+            case OpCode::Divide:
+                depth--;
+                break;
+            case OpCode::Negate:
+            case OpCode::Call:
+                break;
+        }
+        maxStackDepth = max(maxStackDepth, depth);
+    }
+    return true;
+}
+
+bool Expression::isCompiled() {
+    return !code.empty();
+}
+
+const string& Expression::getText() {
+    return text;
+}
+
+bool Expression::getAngleMode() {
+    return useDegrees;
+}
+
+bool Expression::usesAngleMode() {
+    return angleDependent;
+}
+
+// Parser
+void Expression::skipSpaces() {
+    while (position < text.size() && isspace(static_cast<unsigned char>(text[position]))) {
+        position++;
+    }
+}
+
+void Expression::emit(OpCode op, double value, double (*function)(double), size_t variable) {
+    code.push_back(Instruction{op, value, function, variable});
+}
+
+bool Expression::parseExpression() {
+    if (!parseTerm()) return false;
+    while (true) {
+        skipSpaces();
+        if (position >= text.size() || (text[position] != '+' && text[position] != '-')) {
+            return true;
+        }
+        char operation = text[position++];
+        if (!parseTerm()) return false;
+        emit(operation == '+' ? OpCode::Add : OpCode::Subtract);
+    }
+}
+
+bool Expression::parseTerm() {
+    if (!parseUnary()) return false;
+    while (true) {
+        skipSpaces();
+        if (position >= text.size() || (text[position] != '*' && text[position] != '/')) {
+            return true;
+        }
+        char operation = text[position++];
+        if (!parseUnary()) return false;
+        emit(operation == '*' ? OpCode::Multiply : OpCode::Divide);
+    }
+}
+
+bool Expression::parseUnary() {
+    skipSpaces();
+    if (position < text.size() && (text[position] == '-' || text[position] == '+')) {
+        bool negate = text[position++] == '-';
+        if (!parseUnary()) return false;
+        if (negate) {
+            emit(OpCode::Negate);
+        }
+        return true;
+    }
+    return parsePrimary();
+}
+
+bool Expression::parsePrimary() {
+    skipSpaces();
+    if (position >= text.size()) {
+        cout << "Error: Unexpected end of expression!" << endl;
+        return false;
+    }
+
+    char c = text[position];
+    if (isdigit(static_cast<unsigned char>(c)) || c == '.') {
+        const char* start = text.c_str() + position;
+        char* end = nullptr;
+        double value = strtod(start, &end);
+        if (end == start) {
+            cout << "Error: Invalid number in expression!" << endl;
+            return false;
+        }
+        position += end - start;
+        emit(OpCode::PushConstant, value);
+        return true;
+    }
+
+    if (c == '(') {
+        position++;
+        if (!parseExpression()) return false;
+        skipSpaces();
+        if (position >= text.size() || text[position] != ')') {
+            cout << "Error: Missing ')' in expression!" << endl;
+            return false;
+        }
+        position++;
+        return true;
+    }
+
+    if (isalpha(static_cast<unsigned char>(c)) || c == '_') {
+        size_t start = position;
+        while (position < text.size() &&
+               (isalnum(static_cast<unsigned char>(text[position])) || text[position] == '_')) {
+            position++;
+        }
+        string name = text.substr(start, position - start);
+        if (name == "pi") {
+            emit(OpCode::PushConstant, M_PI);
+            return true;
+        }
+        for (const FunctionEntry& entry : functions) {
+            if (name == entry.name || name == entry.longName) {
+                skipSpaces();
+                if (position >= text.size() || text[position] != '(') {
+                    cout << "Error: Expected '(' after " << name << "!" << endl;
+                    return false;
+                }
+                position++;
+                if (!parseExpression()) return false;
+                skipSpaces();
+                if (position >= text.size() || text[position] != ')') {
+                    cout << "Error: Missing ')' in expression!" << endl;
+                    return false;
+                }
+                position++;
+                emit(OpCode::Call, 0.0, useDegrees ? entry.degrees : entry.radians);
+                if (entry.degrees != entry.radians) {
+                    angleDependent = true;
+                }
+                return true;
+            }
+        }
+        for (size_t i = 0; i < variables.size(); i++) {
+            if (name == variables[i]) {
+                emit(i == 0 ? OpCode::LoadX : OpCode::LoadVariable, 0.0, nullptr, i);
+                return true;
+            }
+        }
+        cout << "Error: Unknown name '" << name << "' in expression!" << endl;
+        return false;
+    }
+
+    cout << "Error: Unexpected '" << c << "' in expression!" << endl;
+    return false;
+}
+
+// Evaluation
+void Expression::tierUp(unsigned long long evaluations) {
+    evaluationCount += evaluations;
+    if (jitEnabled && !jitAttempted && evaluationCount >= jitThreshold) {
+        jitAttempted = true;
+        jit = JitFunction::compile(code, maxStackDepth);
+    }
+}
+
+double Expression::evaluate(double x) {
+    if (jit) {
+        return jit->call(x);
+    }
+    tierUp(1);
+    return interpret(x);
+}
+
+void Expression::evaluateArray(const double* x, double* out, size_t count) {
+    if (!jit) {
+        tierUp(count);
+    }
+    if (!jit) {
+        for (size_t i = 0; i < count; i++) {
+            out[i] = interpret(x[i]);
+        }
+        return;
+    }
+
+    size_t done = 0;
+    if (jit->hasPackedPath()) {
+        jit->callPacked(x, out, count / 2);
+        done = count - count % 2;
+    }
+    for (size_t i = done; i < count; i++) {
+        out[i] = jit->call(x[i]);
+    }
+}
+
+double Expression::interpret(double x) {
+    if (usesOtherVariables) {
+        return 0;
+    }
+    return run(&x);
+}
+
+double Expression::evaluateRow(const double* values) {
+    return run(values);
+}
+
+double Expression::run(const double* values) {
+    if (code.empty()) {
+        return 0;
+    }
+
+    double local[32];
+    vector<double> heap;
+    double* stack = local;
+    if (maxStackDepth > 32) {
+        heap.resize(maxStackDepth);
+        stack = heap.data();
+    }
+
+    size_t sp = 0;
+    for (const Instruction& instruction : code) {
+        switch (instruction.op) {
+            case OpCode::PushConstant:
+                stack[sp++] = instruction.value;
+                break;
+            case OpCode::LoadX:
+                stack[sp++] = values[0];
+                break;
+            case OpCode::LoadVariable:
+                stack[sp++] = values[instruction.variable];
+                break;
+            case OpCode::Add:
+                sp--;
+                stack[sp - 1] = stack[sp - 1] + stack[sp];
+                break;
+            case OpCode::Subtract:
+                sp--;
+                stack[sp - 1] = stack[sp - 1] - stack[sp];
+                break;
+            case OpCode::Multiply:
+                sp--;
+                stack[sp - 1] = stack[sp - 1] * stack[sp];
+                break;
+            case OpCode::Divide:
+                sp--;
+                stack[sp - 1] = stack[sp] == 0 ? 0.0 : stack[sp - 1] / stack[sp];
+                break;
+            case OpCode::Negate:
+                stack[sp - 1] = -stack[sp - 1];
+                break;
+            case OpCode::Call:
+                stack[sp - 1] = instruction.function(stack[sp - 1]);
+                break;
+        }
+    }
+    return stack[0];
+}
+
+// Column-at-a-time evaluation: every instruction runs over a block of rows,
+// so the arithmetic loops vectorize and the block stack stays in cache.
+void Expression::evaluateColumns(const double* const* columns, double* out, size_t count) {
+    const size_t blockSize = 1024;
+    if (code.empty()) {
+        fill(out, out + count, 0.0);
+        return;
+    }
+
+    vector<double> scratch(maxStackDepth * blockSize);
+    for (size_t begin = 0; begin < count; begin += blockSize) {
+        size_t n = min(blockSize, count - begin);
+        size_t sp = 0;
+        for (const Instruction& instruction : code) {
+            double* top = sp > 0 ? &scratch[(sp - 1) * blockSize] : nullptr;
+            switch (instruction.op) {
+                case OpCode::PushConstant:
+                    fill(&scratch[sp * blockSize], &scratch[sp * blockSize] + n, instruction.value);
+                    sp++;
+                    break;
+                case OpCode::LoadX:
+                case OpCode::LoadVariable: {
+                    const double* column = columns[instruction.variable] + begin;
+                    copy(column, column + n, &scratch[sp * blockSize]);
+                    sp++;
+                    break;
+                }
+                case OpCode::Add:
+                case OpCode::Subtract:
+                case OpCode::Multiply:
+                case OpCode::Divide: {
+                    double* a = &scratch[(sp - 2) * blockSize];
+                    const double* b = top;
+                    if (instruction.op == OpCode::Add) {
+                        for (size_t i = 0; i < n; i++) a[i] = a[i] + b[i];
+                    } else if (instruction.op == OpCode::Subtract) {
+                        for (size_t i = 0; i < n; i++) a[i] = a[i] - b[i];
+                    } else if (instruction.op == OpCode::Multiply) {
+                        for (size_t i = 0; i < n; i++) a[i] = a[i] * b[i];
+                    } else {
+                        for (size_t i = 0; i < n; i++) a[i] = b[i] == 0 ? 0.0 : a[i] / b[i];
+                    }
+                    sp--;
+                    break;
+                }
+                case OpCode::Negate:
+                    for (size_t i = 0; i < n; i++) top[i] = -top[i];
+                    break;
+                case OpCode::Call:
+                    for (size_t i = 0; i < n; i++) top[i] = instruction.function(top[i]);
+                    break;
+            }
+        }
+        copy(&scratch[0], &scratch[0] + n, out + begin);
+    }
+}
+
+vector<size_t> Expression::getReferencedVariables() {
+    vector<size_t> referenced;
+    for (const Instruction& instruction : code) {
+        if ((instruction.op == OpCode::LoadX || instruction.op == OpCode::LoadVariable) &&
+            find(referenced.begin(), referenced.end(), instruction.variable) == referenced.end()) {
+            referenced.push_back(instruction.variable);
+        }
+    }
+    return referenced;
+}
+
+void Expression::setJitEnabled(bool enabled) {
+    jitEnabled = enabled;
+    if (!enabled) {
+        jit.reset();
+        jitAttempted = false;
+    }
+}
+
+void Expression::setJitThreshold(unsigned long long evaluations) {
+    jitThreshold = evaluations;
+}
+
+bool Expression::isJitCompiled() {
+    return jit != nullptr;
+}
+
+unsigned long long Expression::getEvaluationCount() {
+    return evaluationCount;
+}
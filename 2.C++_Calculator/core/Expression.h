@@ -0,0 +1,98 @@
+#ifndef EXPRESSION_H
+#define EXPRESSION_H
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+class JitFunction;
+
+// Bytecode for a compiled expression.  Programs run on a value stack;
+// division by zero yields 0 like CalculatorEngine::divide.  LoadX reads the
+// first variable, LoadVariable any other.
+enum class OpCode {
+    PushConstant,
+    LoadX,
+    LoadVariable,
+    Add,
+    Subtract,
+    Multiply,
+    Divide,
+    Negate,
+    Call
+};
+
+struct Instruction {
+    OpCode op;
+    double value;
+    double (*function)(double);
+    size_t variable;
+};
+
+// An expression such as "sin(x) * 2 + x / 3", compiled once and evaluated
+// many times.  Evaluation starts in the bytecode interpreter; after
+// jitThreshold evaluations the program is compiled to native code when the
+// platform supports it.  Both tiers produce bit-identical results.
+// Expressions over several named variables ("sin(a) * b + c") are evaluated
+// row by row or column-at-a-time; those stay in the interpreter.
+class Expression {
+private:
+    std::string text;
+    std::vector<Instruction> code;
+    std::vector<std::string> variables;
+    size_t maxStackDepth;
+    bool usesOtherVariables;
+    bool angleDependent;
+    bool useDegrees;
+
+    unsigned long long evaluationCount;
+    unsigned long long jitThreshold;
+    bool jitEnabled;
+    bool jitAttempted;
+    std::unique_ptr<JitFunction> jit;
+
+    // Recursive-descent parser state
+    size_t position;
+    bool parseExpression();
+    bool parseTerm();
+    bool parseUnary();
+    bool parsePrimary();
+    void skipSpaces();
+    void emit(OpCode op, double value = 0.0, double (*function)(double) = nullptr, size_t variable = 0);
+    double run(const double* values);
+
+    void tierUp(unsigned long long evaluations);
+
+public:
+    Expression();
+    ~Expression();
+
+    bool compile(const std::string& expression, bool degrees);
+    bool compile(const std::string& expression, bool degrees, const std::vector<std::string>& variableNames);
+    bool isCompiled();
+    const std::string& getText();
+    bool getAngleMode();
+    bool usesAngleMode();   // calls a function whose result depends on degrees/radians
+
+    // Tiered evaluation (interpreter, then native code once hot)
+    double evaluate(double x);
+    void evaluateArray(const double* x, double* out, size_t count);
+
+    // Reference evaluator; the JIT must match it bit for bit.  The x-only
+    // entry points return 0 for programs that read other variables.
+    double interpret(double x);
+    
+    // Multi-variable evaluation.  values/columns are indexed like the
+    // variable names given to compile(); unused columns may be nullptr.
+    double evaluateRow(const double* values);
+    void evaluateColumns(const double* const* columns, double* out, size_t count);
+    std::vector<size_t> getReferencedVariables();
+
+    void setJitEnabled(bool enabled);
+    void setJitThreshold(unsigned long long evaluations);
+    bool isJitCompiled();
+    unsigned long long getEvaluationCount();
+};
+
+#endif // EXPRESSION_H
@@ -0,0 +1,426 @@
+#include "FFT.h"
+#include "TrigCalculator.h"
+#include <algorithm>
+#include <list>
+#include <mutex>
+#include <thread>
+
+using namespace std;
+
+namespace {
+
+mutex twiddleMutex;
+
+inline complex<double> mul(complex<double> a, double wr, double wi) {
+    return complex<double>(a.real() * wr - a.imag() * wi, a.real() * wi + a.imag() * wr);
+}
+
+size_t smallestFactor(size_t n) {
+    if (n % 2 == 0) return 2;
+    for (size_t f = 3; f * f <= n; f += 2) {
+        if (n % f == 0) return f;
+    }
+    return n;
+}
+
+size_t largestFactor(size_t n) {
+    size_t largest = 1;
+    for (size_t f = 2; f * f <= n; f++) {
+        while (n % f == 0) {
+            largest = f;
+            n /= f;
+        }
+    }
+    return max(largest, n);
+}
+
+// Tables by size, most recently used first.  Past FFT::tableCacheBytes the
+// oldest are dropped (the newest always stays); callers still holding one
+// keep it alive through the shared_ptr.  Guarded by twiddleMutex.
+template <typename Table>
+class TableCache {
+private:
+    struct Entry {
+        size_t n;
+        size_t bytes;
+        shared_ptr<const Table> table;
+    };
+
+    list<Entry> entries;
+    size_t totalBytes = 0;
+
+public:
+    // orLarger accepts any table of at least n points
+    shared_ptr<const Table> find(size_t n, bool orLarger) {
+        for (auto it = entries.begin(); it != entries.end(); ++it) {
+            if (it->n == n || (orLarger && it->n > n)) {
+                entries.splice(entries.begin(), entries, it);
+                return entries.front().table;
+            }
+        }
+        return nullptr;
+    }
+
+    void insert(size_t n, shared_ptr<const Table> table, size_t bytes) {
+        entries.push_front(Entry{n, bytes, table});
+        totalBytes += bytes;
+        while (totalBytes > FFT::tableCacheBytes && entries.size() > 1) {
+            totalBytes -= entries.back().bytes;
+            entries.pop_back();
+        }
+    }
+};
+
+void bitReverse(double* re, double* im, size_t n) {
+    for (size_t i = 1, j = 0; i < n; i++) {
+        size_t bit = n >> 1;
+        for (; j & bit; bit >>= 1) {
+            j ^= bit;
+        }
+        j ^= bit;
+        if (i < j) {
+            swap(re[i], re[j]);
+            swap(im[i], im[j]);
+        }
+    }
+}
+
+} // namespace
+
+FFT::FFT() {
+    threadCount = thread::hardware_concurrency();
+    if (threadCount == 0) {
+        threadCount = 1;
+    }
+    parallelThreshold = size_t(1) << 16;
+}
+
+void FFT::setThreadCount(unsigned threads) {
+    threadCount = threads == 0 ? 1 : threads;
+}
+
+unsigned FFT::getThreadCount() {
+    return threadCount;
+}
+
+void FFT::setParallelThreshold(size_t minimumSize) {
+    parallelThreshold = minimumSize;
+}
+
+// Stage tables for the radix-2 transform: the stage with half-span h uses
+// exp(-i*pi*j/h) for j < h, stored contiguously at offset h - 1.  The table
+// for size n therefore also serves every smaller power of two.
+shared_ptr<const FFT::TwiddleTable> FFT::radix2Twiddles(size_t n) {
+    static TableCache<TwiddleTable> radix2Cache;
+    lock_guard<mutex> lock(twiddleMutex);
+    if (auto cached = radix2Cache.find(n, true)) {
+        return cached;
+    }
+    auto table = make_shared<TwiddleTable>();
+    table->re.resize(n > 1 ? n - 1 : 1);
+    table->im.resize(n > 1 ? n - 1 : 1);
+    for (size_t h = 1; h < n; h <<= 1) {
+        for (size_t j = 0; j < h; j++) {
+            double angle = -M_PI * double(j) / double(h);
+            table->re[h - 1 + j] = cos(angle);
+            table->im[h - 1 + j] = sin(angle);
+        }
+    }
+    radix2Cache.insert(n, table, table->re.size() * 2 * sizeof(double));
+    return table;
+}
+
+// Full table exp(-2*pi*i*j/n) for j < n, used by the mixed-radix path
+shared_ptr<const FFT::TwiddleTable> FFT::mixedRadixTwiddles(size_t n) {
+    static TableCache<TwiddleTable> mixedRadixCache;
+    lock_guard<mutex> lock(twiddleMutex);
+    if (auto cached = mixedRadixCache.find(n, false)) {
+        return cached;
+    }
+    auto table = make_shared<TwiddleTable>();
+    table->re.resize(n);
+    table->im.resize(n);
+    for (size_t j = 0; j < n; j++) {
+        double angle = -2.0 * M_PI * double(j) / double(n);
+        table->re[j] = cos(angle);
+        table->im[j] = sin(angle);
+    }
+    mixedRadixCache.insert(n, table, n * 2 * sizeof(double));
+    return table;
+}
+
+// Built outside the lock since the kernel needs a radix-2 transform; two
+// threads may both build a missing table, and the later insert wins.
+shared_ptr<const FFT::BluesteinTable> FFT::bluesteinTable(size_t n) {
+    static TableCache<BluesteinTable> bluesteinCache;
+    {
+        lock_guard<mutex> lock(twiddleMutex);
+        if (auto cached = bluesteinCache.find(n, false)) {
+            return cached;
+        }
+    }
+
+    auto table = make_shared<BluesteinTable>();
+    size_t m = 1;
+    while (m < 2 * n - 1) {
+        m <<= 1;
+    }
+    table->m = m;
+    table->chirpRe.resize(n);
+    table->chirpIm.resize(n);
+    table->kernelRe.assign(m, 0.0);
+    table->kernelIm.assign(m, 0.0);
+    // k^2 is kept mod 2n so the angle stays exact for large k
+    size_t square = 0;
+    for (size_t k = 0; k < n; k++) {
+        double angle = -M_PI * double(square) / double(n);
+        table->chirpRe[k] = cos(angle);
+        table->chirpIm[k] = sin(angle);
+        square += 2 * k + 1;
+        if (square >= 2 * n) {
+            square -= 2 * n;
+        }
+    }
+    double scale = 1.0 / double(m);
+    for (size_t k = 0; k < n; k++) {
+        table->kernelRe[k] = table->chirpRe[k] * scale;
+        table->kernelIm[k] = -table->chirpIm[k] * scale;
+        if (k > 0) {
+            table->kernelRe[m - k] = table->kernelRe[k];
+            table->kernelIm[m - k] = table->kernelIm[k];
+        }
+    }
+    radix2(table->kernelRe.data(), table->kernelIm.data(), m);
+
+    lock_guard<mutex> lock(twiddleMutex);
+    bluesteinCache.insert(n, table, (n + m) * 2 * sizeof(double));
+    return table;
+}
+
+// Runs every butterfly stage with half-span below lastSpan on an already
+// bit-reversed block of n points.
+void FFT::radix2Stages(double* re, double* im, size_t n, size_t lastSpan, const TwiddleTable& tw) {
+    for (size_t h = 1; h < lastSpan && h < n; h <<= 1) {
+        const double* wr = tw.re.data() + (h - 1);
+        const double* wi = tw.im.data() + (h - 1);
+        for (size_t base = 0; base < n; base += 2 * h) {
+            double* ar = re + base;
+            double* ai = im + base;
+            double* br = ar + h;
+            double* bi = ai + h;
+            for (size_t j = 0; j < h; j++) {
+                double tr = br[j] * wr[j] - bi[j] * wi[j];
+                double ti = br[j] * wi[j] + bi[j] * wr[j];
+                br[j] = ar[j] - tr;
+                bi[j] = ai[j] - ti;
+                ar[j] += tr;
+                ai[j] += ti;
+            }
+        }
+    }
+}
+
+void FFT::radix2(double* re, double* im, size_t n) {
+    auto tw = radix2Twiddles(n);
+    bitReverse(re, im, n);
+    if (threadCount > 1 && n >= parallelThreshold) {
+        radix2Parallel(re, im, n, *tw);
+    } else {
+        radix2Stages(re, im, n, n, *tw);
+    }
+}
+
+// Large transforms: the early stages work on independent contiguous chunks,
+// one chunk per thread.  The last log2(threads) stages span several chunks,
+// so their butterflies are split evenly across threads instead.
+void FFT::radix2Parallel(double* re, double* im, size_t n, const TwiddleTable& tw) {
+    size_t threads = 1;
+    while (threads * 2 <= threadCount && threads * 2 <= n / 2) {
+        threads *= 2;
+    }
+    size_t chunk = n / threads;
+
+    vector<thread> workers;
+    for (size_t t = 0; t < threads; t++) {
+        workers.emplace_back([=, &tw]() {
+            radix2Stages(re + t * chunk, im + t * chunk, chunk, chunk, tw);
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    size_t half = n / 2;
+    for (size_t h = chunk; h < n; h <<= 1) {
+        const double* wr = tw.re.data() + (h - 1);
+        const double* wi = tw.im.data() + (h - 1);
+        workers.clear();
+        for (size_t t = 0; t < threads; t++) {
+            size_t begin = half * t / threads;
+            size_t end = half * (t + 1) / threads;
+            workers.emplace_back([=]() {
+                size_t i = begin;
+                while (i < end) {
+                    size_t j = i % h;
+                    size_t base = (i / h) * 2 * h;
+                    size_t count = min(h - j, end - i);
+                    double* ar = re + base;
+                    double* ai = im + base;
+                    double* br = ar + h;
+                    double* bi = ai + h;
+                    for (size_t k = j; k < j + count; k++) {
+                        double tr = br[k] * wr[k] - bi[k] * wi[k];
+                        double ti = br[k] * wi[k] + bi[k] * wr[k];
+                        br[k] = ar[k] - tr;
+                        bi[k] = ai[k] - ti;
+                        ar[k] += tr;
+                        ai[k] += ti;
+                    }
+                    i += count;
+                }
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+}
+
+// Decimation in time: split n = p * m on the smallest prime p, transform the
+// p interleaved subsequences, then combine them with radix-p butterflies.
+void FFT::mixedRadix(const complex<double>* in, complex<double>* out, size_t n, size_t stride,
+                     const TwiddleTable& tw, size_t twStride) {
+    if (n == 1) {
+        out[0] = in[0];
+        return;
+    }
+    size_t p = smallestFactor(n);
+    size_t m = n / p;
+    for (size_t q = 0; q < p; q++) {
+        mixedRadix(in + q * stride, out + q * m, m, stride * p, tw, twStride * p);
+    }
+
+    size_t total = tw.re.size();
+    size_t rootStride = m * twStride;
+    vector<complex<double>> scratch(p);
+    for (size_t k = 0; k < m; k++) {
+        for (size_t q = 0; q < p; q++) {
+            size_t w = q * k * twStride;
+            scratch[q] = mul(out[q * m + k], tw.re[w], tw.im[w]);
+        }
+        for (size_t r = 0; r < p; r++) {
+            complex<double> sum = scratch[0];
+            for (size_t q = 1; q < p; q++) {
+                size_t w = ((q * r) % p) * rootStride % total;
+                sum += mul(scratch[q], tw.re[w], tw.im[w]);
+            }
+            out[r * m + k] = sum;
+        }
+    }
+}
+
+// X_k = c_k * sum_j (x_j c_j) conj(c_{k-j}) with the chirp c_k =
+// exp(-i*pi*k^2/n): the sum is a circular convolution of length m, done as
+// two radix-2 transforms against the cached kernel (the inverse by
+// conjugation).
+vector<complex<double>> FFT::bluestein(const vector<complex<double>>& input) {
+    size_t n = input.size();
+    auto table = bluesteinTable(n);
+    size_t m = table->m;
+    const double* cr = table->chirpRe.data();
+    const double* ci = table->chirpIm.data();
+
+    vector<double> re(m, 0.0), im(m, 0.0);
+    for (size_t k = 0; k < n; k++) {
+        re[k] = input[k].real() * cr[k] - input[k].imag() * ci[k];
+        im[k] = input[k].real() * ci[k] + input[k].imag() * cr[k];
+    }
+    radix2(re.data(), im.data(), m);
+    const double* kr = table->kernelRe.data();
+    const double* ki = table->kernelIm.data();
+    for (size_t k = 0; k < m; k++) {
+        double r = re[k] * kr[k] - im[k] * ki[k];
+        double i = re[k] * ki[k] + im[k] * kr[k];
+        re[k] = r;
+        im[k] = -i;
+    }
+    radix2(re.data(), im.data(), m);
+
+    vector<complex<double>> result(n);
+    for (size_t k = 0; k < n; k++) {
+        // conj(re, im) times the chirp
+        result[k] = complex<double>(re[k] * cr[k] + im[k] * ci[k], re[k] * ci[k] - im[k] * cr[k]);
+    }
+    return result;
+}
+
+vector<complex<double>> FFT::forward(const vector<complex<double>>& input) {
+    size_t n = input.size();
+    if (n <= 1) {
+        return input;
+    }
+
+    if (isPowerOfTwo(n)) {
+        vector<double> re(n), im(n);
+        for (size_t i = 0; i < n; i++) {
+            re[i] = input[i].real();
+            im[i] = input[i].imag();
+        }
+        radix2(re.data(), im.data(), n);
+        vector<complex<double>> result(n);
+        for (size_t i = 0; i < n; i++) {
+            result[i] = complex<double>(re[i], im[i]);
+        }
+        return result;
+    }
+
+    if (largestFactor(n) > maxDirectFactor) {
+        return bluestein(input);
+    }
+
+    auto tw = mixedRadixTwiddles(n);
+    vector<complex<double>> result(n);
+    mixedRadix(input.data(), result.data(), n, 1, *tw, 1);
+    return result;
+}
+
+vector<complex<double>> FFT::inverse(const vector<complex<double>>& input) {
+    size_t n = input.size();
+    vector<complex<double>> conjugated(n);
+    for (size_t i = 0; i < n; i++) {
+        conjugated[i] = conj(input[i]);
+    }
+    vector<complex<double>> result = forward(conjugated);
+    for (size_t i = 0; i < n; i++) {
+        result[i] = conj(result[i]) / double(n);
+    }
+    return result;
+}
+
+vector<double> FFT::magnitudeSpectrum(const vector<double>& samples) {
+    vector<complex<double>> input(samples.begin(), samples.end());
+    vector<complex<double>> spectrum = forward(input);
+    vector<double> magnitudes(spectrum.size() / 2 + (spectrum.empty() ? 0 : 1));
+    for (size_t i = 0; i < magnitudes.size(); i++) {
+        magnitudes[i] = abs(spectrum[i]);
+    }
+    return magnitudes;
+}
+
+vector<complex<double>> FFT::naiveDFT(const vector<complex<double>>& input) {
+    size_t n = input.size();
+    vector<complex<double>> result(n);
+    for (size_t k = 0; k < n; k++) {
+        complex<double> sum = 0;
+        for (size_t j = 0; j < n; j++) {
+            double angle = -2.0 * M_PI * double((k * j) % n) / double(n);
+            sum += mul(input[j], cos(angle), sin(angle));
+        }
+        result[k] = sum;
+    }
+    return result;
+}
+
+bool FFT::isPowerOfTwo(size_t n) {
+    return n != 0 && (n & (n - 1)) == 0;
+}
@@ -0,0 +1,67 @@
+#ifndef FFT_H
+#define FFT_H
+
+#include <complex>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+// Fast Fourier transform for any length.
+// Power-of-two sizes use an iterative radix-2 transform on split real/imag
+// arrays (so the butterfly loop vectorizes).  Sizes whose prime factors
+// are all at most maxDirectFactor use a recursive mixed-radix Cooley-Tukey;
+// the rest (primes among them) use Bluestein's chirp-z transform, a
+// convolution done with power-of-two transforms, so every length is
+// O(n log n).  Tables are shared between FFT objects in caches that keep
+// the most recently used ones within tableCacheBytes.
+class FFT {
+private:
+    struct TwiddleTable {
+        std::vector<double> re;
+        std::vector<double> im;
+    };
+
+    // Chirp exp(-i*pi*k^2/n) for k < n and the transform of its conjugate,
+    // wrapped around a power-of-two length m >= 2n - 1 and scaled by 1/m
+    struct BluesteinTable {
+        size_t m;
+        std::vector<double> chirpRe;
+        std::vector<double> chirpIm;
+        std::vector<double> kernelRe;
+        std::vector<double> kernelIm;
+    };
+
+    unsigned threadCount;
+    size_t parallelThreshold;
+
+    static std::shared_ptr<const TwiddleTable> radix2Twiddles(size_t n);
+    static std::shared_ptr<const TwiddleTable> mixedRadixTwiddles(size_t n);
+    std::shared_ptr<const BluesteinTable> bluesteinTable(size_t n);
+
+    void radix2(double* re, double* im, size_t n);
+    void radix2Parallel(double* re, double* im, size_t n, const TwiddleTable& tw);
+    static void radix2Stages(double* re, double* im, size_t n, size_t lastSpan,
+                             const TwiddleTable& tw);
+    static void mixedRadix(const std::complex<double>* in, std::complex<double>* out,
+                           size_t n, size_t stride, const TwiddleTable& tw, size_t twStride);
+    std::vector<std::complex<double>> bluestein(const std::vector<std::complex<double>>& input);
+
+public:
+    static const size_t maxDirectFactor = 5;
+    static const size_t tableCacheBytes = size_t(64) << 20;
+
+    FFT();
+    void setThreadCount(unsigned threads);
+    unsigned getThreadCount();
+    void setParallelThreshold(size_t minimumSize);
+
+    std::vector<std::complex<double>> forward(const std::vector<std::complex<double>>& input);
+    std::vector<std::complex<double>> inverse(const std::vector<std::complex<double>>& input);
+    std::vector<double> magnitudeSpectrum(const std::vector<double>& samples);
+
+    // O(n^2) reference transform used to validate the fast path
+    static std::vector<std::complex<double>> naiveDFT(const std::vector<std::complex<double>>& input);
+    static bool isPowerOfTwo(size_t n);
+};
+
+#endif // FFT_H
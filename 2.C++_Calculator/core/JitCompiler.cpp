@@ -0,0 +1,323 @@
+#include "JitCompiler.h"
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) && (defined(__linux__) || defined(__APPLE__))
+#define CALC_JIT_X86_64 1
+#include <sys/mman.h>
+#endif
+
+using namespace std;
+
+#ifdef CALC_JIT_X86_64
+
+namespace {
+
+const int maxRegisterStack = 14;   // xmm2..xmm15
+const int frameSize = 136;         // keeps rsp 16-byte aligned for calls
+const int xSlot = 0;               // [rsp + 0] holds x, spill slots follow
+
+const uint8_t prefixScalar = 0xF2; // movsd/addsd/...
+const uint8_t prefixPacked = 0x66; // movupd/addpd/...
+
+int stackRegister(size_t index) {
+    return 2 + int(index);
+}
+
+class Assembler {
+public:
+    vector<uint8_t> bytes;
+
+    void byte(uint8_t b) { bytes.push_back(b); }
+
+    void imm32(int32_t value) {
+        for (int i = 0; i < 4; i++) {
+            byte(uint8_t(uint32_t(value) >> (8 * i)));
+        }
+    }
+
+    void rex(bool wide, int reg, int rm) {
+        uint8_t prefix = 0x40 | (wide ? 8 : 0) | ((reg & 8) ? 4 : 0) | ((rm & 8) ? 1 : 0);
+        if (prefix != 0x40) {
+            byte(prefix);
+        }
+    }
+
+    // SSE op with register operands: prefix [REX] 0F op modrm
+    void sse(uint8_t prefix, uint8_t op, int reg, int rm) {
+        byte(prefix);
+        rex(false, reg, rm);
+        byte(0x0F);
+        byte(op);
+        byte(uint8_t(0xC0 | ((reg & 7) << 3) | (rm & 7)));
+    }
+
+    void sseCompareNotEqual(uint8_t prefix, int reg, int rm) {
+        sse(prefix, 0xC2, reg, rm);
+        byte(4); // NEQ_UQ: true for unordered, so NaN divisors pass through
+    }
+
+    // SSE op with a [rsp + disp8] operand
+    void sseStack(uint8_t prefix, uint8_t op, int reg, int disp) {
+        byte(prefix);
+        rex(false, reg, 0);
+        byte(0x0F);
+        byte(op);
+        byte(uint8_t(0x40 | ((reg & 7) << 3) | 4));
+        byte(0x24);
+        byte(uint8_t(disp));
+    }
+
+    // SSE op with a [base] operand, base being rdi or rsi
+    void sseIndirect(uint8_t prefix, uint8_t op, int reg, int base) {
+        byte(prefix);
+        rex(false, reg, base);
+        byte(0x0F);
+        byte(op);
+        byte(uint8_t(((reg & 7) << 3) | (base & 7)));
+    }
+
+    // mov rax, imm64; movq xmm, rax
+    void loadBits(int xmm, uint64_t bits) {
+        movRaxImm64(bits);
+        byte(0x66);
+        rex(true, xmm, 0);
+        byte(0x0F);
+        byte(0x6E);
+        byte(uint8_t(0xC0 | ((xmm & 7) << 3)));
+    }
+
+    void loadConstant(int xmm, double value) {
+        uint64_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        loadBits(xmm, bits);
+    }
+
+    void movRaxImm64(uint64_t value) {
+        byte(0x48);
+        byte(0xB8);
+        for (int i = 0; i < 8; i++) {
+            byte(uint8_t(value >> (8 * i)));
+        }
+    }
+
+    void callRax() { byte(0xFF); byte(0xD0); }
+    void subRsp(int32_t value) { byte(0x48); byte(0x81); byte(0xEC); imm32(value); }
+    void addRsp(int32_t value) { byte(0x48); byte(0x81); byte(0xC4); imm32(value); }
+    void ret() { byte(0xC3); }
+};
+
+uint8_t arithmeticOpcode(OpCode op) {
+    switch (op) {
+        case OpCode::Add: return 0x58;
+        case OpCode::Multiply: return 0x59;
+        case OpCode::Subtract: return 0x5C;
+        default: return 0x5E;
+    }
+}
+
+const uint64_t signMask = 0x8000000000000000ULL;
+
+// Register stack holding the value stack; xmm0 and xmm1 are scratch.
+// Division matches the interpreter: a / b, then masked to +0 when b == 0.
+void emitScalar(Assembler& a, const vector<Instruction>& code) {
+    a.subRsp(frameSize);
+    a.sseStack(prefixScalar, 0x11, 0, xSlot);
+
+    size_t depth = 0;
+    for (const Instruction& instruction : code) {
+        switch (instruction.op) {
+            case OpCode::PushConstant:
+                a.loadConstant(stackRegister(depth), instruction.value);
+                depth++;
+                break;
+            case OpCode::LoadX:
+                a.sseStack(prefixScalar, 0x10, stackRegister(depth), xSlot);
+                depth++;
+                break;
+            case OpCode::LoadVariable:
+                // Rejected by compile()
+                break;
+            case OpCode::Add:
+            case OpCode::Subtract:
+            case OpCode::Multiply:
+                a.sse(prefixScalar, arithmeticOpcode(instruction.op),
+                      stackRegister(depth - 2), stackRegister(depth - 1));
+                depth--;
+                break;
+            case OpCode::Divide:
+                a.sse(prefixScalar, 0x5E, stackRegister(depth - 2), stackRegister(depth - 1));
+                a.sse(prefixPacked, 0x57, 0, 0);
+                a.sseCompareNotEqual(prefixScalar, stackRegister(depth - 1), 0);
+                a.sse(prefixPacked, 0x54, stackRegister(depth - 2), stackRegister(depth - 1));
+                depth--;
+                break;
+            case OpCode::Negate:
+                a.loadBits(1, signMask);
+                a.sse(prefixPacked, 0x57, stackRegister(depth - 1), 1);
+                break;
+            case OpCode::Call:
+                // Every xmm register is caller-saved: spill the values below
+                // the argument, call the kernel, then reload them.
+                for (size_t i = 0; i + 1 < depth; i++) {
+                    a.sseStack(prefixScalar, 0x11, stackRegister(i), int(8 + 8 * i));
+                }
+                a.sse(prefixScalar, 0x10, 0, stackRegister(depth - 1));
+                a.movRaxImm64(reinterpret_cast<uint64_t>(instruction.function));
+                a.callRax();
+                a.sse(prefixScalar, 0x10, stackRegister(depth - 1), 0);
+                for (size_t i = 0; i + 1 < depth; i++) {
+                    a.sseStack(prefixScalar, 0x10, stackRegister(i), int(8 + 8 * i));
+                }
+                break;
+        }
+    }
+
+    a.sse(prefixScalar, 0x10, 0, stackRegister(0));
+    a.addRsp(frameSize);
+    a.ret();
+}
+
+// void f(const double* x /* rdi */, double* out /* rsi */, size_t pairs /* rdx */)
+bool emitPacked(Assembler& a, const vector<Instruction>& code) {
+    for (const Instruction& instruction : code) {
+        if (instruction.op == OpCode::Call) {
+            return false;
+        }
+    }
+
+    const int rdi = 7;
+    const int rsi = 6;
+
+    a.byte(0x48); a.byte(0x85); a.byte(0xD2);           // test rdx, rdx
+    a.byte(0x0F); a.byte(0x84);                         // jz end
+    size_t exitJump = a.bytes.size();
+    a.imm32(0);
+    size_t loopStart = a.bytes.size();
+
+    size_t depth = 0;
+    for (const Instruction& instruction : code) {
+        switch (instruction.op) {
+            case OpCode::PushConstant:
+                a.loadConstant(stackRegister(depth), instruction.value);
+                a.sse(prefixPacked, 0x14, stackRegister(depth), stackRegister(depth));
+                depth++;
+                break;
+            case OpCode::LoadX:
+                a.sseIndirect(prefixPacked, 0x10, stackRegister(depth), rdi);
+                depth++;
+                break;
+            case OpCode::LoadVariable:
+                // Rejected by compile()
+                break;
+            case OpCode::Add:
+            case OpCode::Subtract:
+            case OpCode::Multiply:
+                a.sse(prefixPacked, arithmeticOpcode(instruction.op),
+                      stackRegister(depth - 2), stackRegister(depth - 1));
+                depth--;
+                break;
+            case OpCode::Divide:
+                a.sse(prefixPacked, 0x5E, stackRegister(depth - 2), stackRegister(depth - 1));
+                a.sse(prefixPacked, 0x57, 0, 0);
+                a.sseCompareNotEqual(prefixPacked, stackRegister(depth - 1), 0);
+                a.sse(prefixPacked, 0x54, stackRegister(depth - 2), stackRegister(depth - 1));
+                depth--;
+                break;
+            case OpCode::Negate:
+                a.loadBits(1, signMask);
+                a.sse(prefixPacked, 0x14, 1, 1);
+                a.sse(prefixPacked, 0x57, stackRegister(depth - 1), 1);
+                break;
+            case OpCode::Call:
+                break;
+        }
+    }
+
+    a.sseIndirect(prefixPacked, 0x11, stackRegister(0), rsi);
+    a.byte(0x48); a.byte(0x83); a.byte(0xC7); a.byte(16); // add rdi, 16
+    a.byte(0x48); a.byte(0x83); a.byte(0xC6); a.byte(16); // add rsi, 16
+    a.byte(0x48); a.byte(0xFF); a.byte(0xCA);             // dec rdx
+    a.byte(0x0F); a.byte(0x85);                           // jnz loop
+    a.imm32(int32_t(loopStart) - int32_t(a.bytes.size() + 4));
+
+    int32_t exitOffset = int32_t(a.bytes.size()) - int32_t(exitJump + 4);
+    memcpy(&a.bytes[exitJump], &exitOffset, sizeof(exitOffset));
+    a.ret();
+    return true;
+}
+
+} // namespace
+
+#endif // CALC_JIT_X86_64
+
+JitFunction::JitFunction() {
+    memory = nullptr;
+    memorySize = 0;
+    scalarEntry = nullptr;
+    packedEntry = nullptr;
+}
+
+JitFunction::~JitFunction() {
+#ifdef CALC_JIT_X86_64
+    if (memory != nullptr) {
+        munmap(memory, memorySize);
+    }
+#endif
+}
+
+bool JitFunction::isSupported() {
+#ifdef CALC_JIT_X86_64
+    return true;
+#else
+    return false;
+#endif
+}
+
+unique_ptr<JitFunction> JitFunction::compile(const vector<Instruction>& code, size_t maxStackDepth) {
+#ifdef CALC_JIT_X86_64
+    if (code.empty() || maxStackDepth > size_t(maxRegisterStack)) {
+        return nullptr;
+    }
+    for (const Instruction& instruction : code) {
+        if (instruction.op == OpCode::LoadVariable) {
+            return nullptr;
+        }
+    }
+
+    Assembler scalar;
+    emitScalar(scalar, code);
+    Assembler packed;
+    bool hasPacked = emitPacked(packed, code);
+
+    size_t packedOffset = (scalar.bytes.size() + 15) & ~size_t(15);
+    size_t total = packedOffset + (hasPacked ? packed.bytes.size() : 0);
+
+    void* memory = mmap(nullptr, total, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED) {
+        return nullptr;
+    }
+    uint8_t* base = static_cast<uint8_t*>(memory);
+    memcpy(base, scalar.bytes.data(), scalar.bytes.size());
+    if (hasPacked) {
+        memcpy(base + packedOffset, packed.bytes.data(), packed.bytes.size());
+    }
+    if (mprotect(memory, total, PROT_READ | PROT_EXEC) != 0) {
+        munmap(memory, total);
+        return nullptr;
+    }
+
+    unique_ptr<JitFunction> function(new JitFunction());
+    function->memory = memory;
+    function->memorySize = total;
+    function->scalarEntry = reinterpret_cast<double (*)(double)>(base);
+    if (hasPacked) {
+        function->packedEntry = reinterpret_cast<void (*)(const double*, double*, size_t)>(base + packedOffset);
+    }
+    return function;
+#else
+    (void)code;
+    (void)maxStackDepth;
+    return nullptr;
+#endif
+}
@@ -0,0 +1,37 @@
+#ifndef JITCOMPILER_H
+#define JITCOMPILER_H
+
+#include "Expression.h"
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+// Native code for an Expression program.  On x86-64 System V platforms the
+// bytecode is translated to SSE2: a scalar double(double) entry point and,
+// for programs without function calls, a packed loop handling two values per
+// iteration.  The value stack lives in xmm2..xmm15, so programs deeper than
+// 14 entries (and every other architecture) stay in the interpreter.
+class JitFunction {
+private:
+    void* memory;
+    size_t memorySize;
+    double (*scalarEntry)(double);
+    void (*packedEntry)(const double*, double*, size_t);
+
+    JitFunction();
+
+public:
+    ~JitFunction();
+    JitFunction(const JitFunction&) = delete;
+    JitFunction& operator=(const JitFunction&) = delete;
+
+    // Returns nullptr when the program cannot be compiled on this platform
+    static std::unique_ptr<JitFunction> compile(const std::vector<Instruction>& code, size_t maxStackDepth);
+    static bool isSupported();
+
+    double call(double x) { return scalarEntry(x); }
+    bool hasPackedPath() { return packedEntry != nullptr; }
+    void callPacked(const double* x, double* out, size_t pairs) { packedEntry(x, out, pairs); }
+};
+
+#endif // JITCOMPILER_H
@@ -1,21 +1,131 @@
 #include "Memory.h"
+#include <algorithm>
+#include <cstring>
 
 using namespace std;
 
-Memory::Memory() {
+// Variable names
+VariableTable::VariableTable() : slots(16) {
+    for (Slot& slot : slots) {
+        slot.id = emptySlot;
+    }
+}
+
+bool VariableTable::isValidName(const string& name) {
+    if (name.empty() || name.size() > maxNameLength) {
+        return false;
+    }
+    for (size_t i = 0; i < name.size(); i++) {
+        char c = name[i];
+        bool letter = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+        if (!letter && !(i > 0 && c >= '0' && c <= '9')) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool VariableTable::makeKey(const string& name, Key& key) {
+    if (!isValidName(name)) {
+        return false;
+    }
+    key.words[0] = 0;
+    key.words[1] = 0;
+    memcpy(key.words, name.data(), name.size());
+    return true;
+}
+
+size_t VariableTable::hash(const Key& key) {
+    uint64_t h = key.words[0] * 0x9e3779b97f4a7c15ULL ^ key.words[1] * 0xc2b2ae3d27d4eb4fULL;
+    h ^= h >> 29;
+    h *= 0xbf58476d1ce4e5b9ULL;
+    return size_t(h ^ (h >> 32));
+}
+
+// Slot holding key, or the empty slot where it would go
+size_t VariableTable::probe(const Key& key) const {
+    size_t mask = slots.size() - 1;
+    size_t i = hash(key) & mask;
+    while (slots[i].id != emptySlot &&
+           (slots[i].key.words[0] != key.words[0] || slots[i].key.words[1] != key.words[1])) {
+        i = (i + 1) & mask;
+    }
+    return i;
+}
+
+void VariableTable::grow() {
+    vector<Slot> old;
+    old.swap(slots);
+    slots.resize(old.size() * 2);
+    for (Slot& slot : slots) {
+        slot.id = emptySlot;
+    }
+    for (const Slot& slot : old) {
+        if (slot.id != emptySlot) {
+            slots[probe(slot.key)] = slot;
+        }
+    }
+}
+
+size_t VariableTable::intern(const string& name) {
+    Key key;
+    if (!makeKey(name, key)) {
+        return npos;
+    }
+    size_t i = probe(key);
+    if (slots[i].id != emptySlot) {
+        return slots[i].id;
+    }
+    // Keep the load factor under 3/4 so probe sequences stay short
+    if ((keys.size() + 1) * 4 > slots.size() * 3) {
+        grow();
+        i = probe(key);
+    }
+    slots[i].key = key;
+    slots[i].id = uint32_t(keys.size());
+    keys.push_back(key);
+    return slots[i].id;
+}
+
+size_t VariableTable::find(const string& name) const {
+    Key key;
+    if (!makeKey(name, key)) {
+        return npos;
+    }
+    const Slot& slot = slots[probe(key)];
+    return slot.id == emptySlot ? npos : slot.id;
+}
+
+string VariableTable::name(size_t id) const {
+    if (id >= keys.size()) {
+        return string();
+    }
+    const char* bytes = reinterpret_cast<const char*>(keys[id].words);
+    return string(bytes, strnlen(bytes, maxNameLength));
+}
+
+size_t VariableTable::size() const {
+    return keys.size();
+}
+
+// Memory
+template <typename T>
+BasicMemory<T>::BasicMemory() {
     storedValue = 0.0;
     hasValue = false;
 }
 
-void Memory::store(double value) {
+template <typename T>
+void BasicMemory<T>::store(T value) {
     storedValue = value;
     hasValue = true;
-    cout << "Value " << value << " stored in memory." << endl;
+    cout << "Value " << PrecisionTraits<T>::toString(value) << " stored in memory." << endl;
 }
 
-double Memory::recall() {
+template <typename T>
+T BasicMemory<T>::recall() {
     if (hasValue) {
-        cout << "Recalled from memory: " << storedValue << endl;
+        cout << "Recalled from memory: " << PrecisionTraits<T>::toString(storedValue) << endl;
         return storedValue;
     } else {
         cout << "Memory is empty!" << endl;
@@ -23,20 +133,202 @@ double Memory::recall() {
     }
 }
 
-void Memory::clear() {
+template <typename T>
+T BasicMemory<T>::peek() {
+    return storedValue;
+}
+
+template <typename T>
+void BasicMemory<T>::clear() {
     storedValue = 0.0;
     hasValue = false;
     cout << "Memory cleared." << endl;
 }
 
-bool Memory::isEmpty() {
+template <typename T>
+bool BasicMemory<T>::isEmpty() {
     return !hasValue;
 }
 
-void Memory::displayStatus() {
+template <typename T>
+void BasicMemory<T>::displayStatus() {
     if (hasValue) {
-        cout << "Memory contains: " << storedValue << endl;
+        cout << "Memory contains: " << PrecisionTraits<T>::toString(storedValue) << endl;
     } else {
         cout << "Memory is empty." << endl;
     }
-}
\ No newline at end of file
+    for (size_t id = 0; id < values.size(); id++) {
+        if (defined[id]) {
+            cout << "  " << names.name(id) << " = " << PrecisionTraits<T>::toString(values[id]) << endl;
+        }
+    }
+    for (const auto& entry : coefficientSets) {
+        cout << "  " << entry.first << " = [";
+        for (size_t i = 0; i < entry.second.size(); i++) {
+            cout << (i > 0 ? ", " : "") << PrecisionTraits<T>::toString(entry.second[i]);
+        }
+        cout << "]" << endl;
+    }
+}
+
+// Named registers
+template <typename T>
+bool BasicMemory<T>::storeVariable(const string& name, T value) {
+    size_t id = intern(name);
+    if (id == VariableTable::npos) {
+        cout << "Error: Invalid variable name '" << name << "'!" << endl;
+        return false;
+    }
+    setVariable(id, value);
+    cout << "Value " << PrecisionTraits<T>::toString(value) << " stored in " << name << "." << endl;
+    return true;
+}
+
+template <typename T>
+T BasicMemory<T>::recallVariable(const string& name) {
+    size_t id = names.find(name);
+    if (id == VariableTable::npos || !defined[id]) {
+        cout << "Variable " << name << " is not defined!" << endl;
+        return 0.0;
+    }
+    cout << "Recalled " << name << ": " << PrecisionTraits<T>::toString(values[id]) << endl;
+    return values[id];
+}
+
+template <typename T>
+bool BasicMemory<T>::hasVariable(const string& name) {
+    size_t id = names.find(name);
+    return id != VariableTable::npos && defined[id];
+}
+
+template <typename T>
+void BasicMemory<T>::clearVariable(const string& name) {
+    size_t id = names.find(name);
+    if (id != VariableTable::npos) {
+        values[id] = 0.0;
+        defined[id] = 0;
+    }
+}
+
+template <typename T>
+void BasicMemory<T>::clearVariables() {
+    fill(values.begin(), values.end(), T(0.0));
+    fill(defined.begin(), defined.end(), 0);
+}
+
+template <typename T>
+vector<string> BasicMemory<T>::getVariableNames() {
+    vector<string> result;
+    for (size_t id = 0; id < values.size(); id++) {
+        if (defined[id]) {
+            result.push_back(names.name(id));
+        }
+    }
+    return result;
+}
+
+template <typename T>
+size_t BasicMemory<T>::intern(const string& name) {
+    size_t id = names.intern(name);
+    if (id != VariableTable::npos && id >= values.size()) {
+        values.resize(id + 1, T(0.0));
+        defined.resize(id + 1, 0);
+    }
+    return id;
+}
+
+template <typename T>
+size_t BasicMemory<T>::findVariable(const string& name) {
+    return names.find(name);
+}
+
+template <typename T>
+T BasicMemory<T>::getVariable(size_t id) {
+    return id < values.size() ? values[id] : T(0.0);
+}
+
+template <typename T>
+void BasicMemory<T>::setVariable(size_t id, T value) {
+    if (id < values.size()) {
+        values[id] = value;
+        defined[id] = 1;
+    }
+}
+
+template <typename T>
+bool BasicMemory<T>::isDefined(size_t id) {
+    return id < defined.size() && defined[id];
+}
+
+// Coefficient sets
+template <typename T>
+bool BasicMemory<T>::storeCoefficients(const string& name, const vector<T>& coefficients) {
+    if (!VariableTable::isValidName(name)) {
+        cout << "Error: Invalid variable name '" << name << "'!" << endl;
+        return false;
+    }
+    coefficientSets[name] = coefficients;
+    cout << coefficients.size() << " coefficients stored in " << name << "." << endl;
+    return true;
+}
+
+template <typename T>
+vector<T> BasicMemory<T>::recallCoefficients(const string& name) {
+    auto found = coefficientSets.find(name);
+    if (found == coefficientSets.end()) {
+        cout << "Coefficients " << name << " are not defined!" << endl;
+        return vector<T>();
+    }
+    return found->second;
+}
+
+template <typename T>
+bool BasicMemory<T>::hasCoefficients(const string& name) {
+    return coefficientSets.count(name) != 0;
+}
+
+template <typename T>
+void BasicMemory<T>::clearCoefficients(const string& name) {
+    coefficientSets.erase(name);
+}
+
+template <typename T>
+vector<string> BasicMemory<T>::getCoefficientNames() {
+    vector<string> result;
+    for (const auto& entry : coefficientSets) {
+        result.push_back(entry.first);
+    }
+    return result;
+}
+
+template <typename T>
+typename BasicMemory<T>::Snapshot BasicMemory<T>::snapshot() {
+    Snapshot state;
+    state.storedValue = storedValue;
+    state.hasValue = hasValue;
+    for (size_t id = 0; id < values.size(); id++) {
+        if (defined[id]) {
+            state.variables.push_back(make_pair(names.name(id), values[id]));
+        }
+    }
+    state.coefficientSets = coefficientSets;
+    return state;
+}
+
+template <typename T>
+void BasicMemory<T>::restore(const Snapshot& state) {
+    storedValue = state.storedValue;
+    hasValue = state.hasValue;
+    clearVariables();
+    for (const auto& variable : state.variables) {
+        setVariable(intern(variable.first), variable.second);
+    }
+    coefficientSets = state.coefficientSets;
+}
+
+template class BasicMemory<float>;
+template class BasicMemory<double>;
+template class BasicMemory<long double>;
+#ifdef CALC_HAVE_FLOAT128
+template class BasicMemory<__float128>;
+#endif
@@ -1,20 +1,119 @@
 #ifndef MEMORY_H
 #define MEMORY_H
 
+#include <cstddef>
+#include <cstdint>
 #include <iostream>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+#include "Precision.h"
 
-class Memory {
+// Interns variable names to dense ids.  Names are identifiers of up to 15
+// characters kept inline in an open-addressing table (linear probing,
+// power-of-two capacity), so a lookup is one hash and usually one probe with
+// no string allocation.  Ids are never reused and stay valid for the
+// table's lifetime.
+class VariableTable {
 private:
-    double storedValue;
+    struct Key {
+        uint64_t words[2];   // name bytes, zero padded
+    };
+    struct Slot {
+        Key key;
+        uint32_t id;         // emptySlot when unused
+    };
+    static const uint32_t emptySlot = 0xffffffffu;
+
+    std::vector<Slot> slots;
+    std::vector<Key> keys;   // indexed by id
+
+    static bool makeKey(const std::string& name, Key& key);
+    static size_t hash(const Key& key);
+    size_t probe(const Key& key) const;
+    void grow();
+
+public:
+    static const size_t npos = size_t(-1);
+    static const size_t maxNameLength = 15;
+
+    VariableTable();
+
+    static bool isValidName(const std::string& name);
+    size_t intern(const std::string& name);   // npos for invalid names
+    size_t find(const std::string& name) const;
+    std::string name(size_t id) const;
+    size_t size() const;
+};
+
+// The M register plus named registers ("x", "rate", "r1" ... "r100").
+// Named registers are addressed by name or, on hot paths, by the id from
+// intern().  The by-name calls report like store()/recall(); the by-id
+// calls are silent.  Coefficient sets (fitted polynomials, regressions)
+// live under their own names, separate from the registers.
+template <typename T>
+class BasicMemory {
+private:
+    T storedValue;
     bool hasValue;
+    VariableTable names;
+    std::vector<T> values;                 // indexed by variable id
+    std::vector<unsigned char> defined;
+    std::map<std::string, std::vector<T>> coefficientSets;
     
 public:
-    Memory();
-    void store(double value);
-    double recall();
+    // Everything in memory, for undo or saving a session.  Registers are kept
+    // by name, so a snapshot restores into any memory whatever order it
+    // interned names in; registers not in the snapshot are undefined again
+    // after restore().
+    struct Snapshot {
+        T storedValue;
+        bool hasValue;
+        std::vector<std::pair<std::string, T>> variables;   // defined ones
+        std::map<std::string, std::vector<T>> coefficientSets;
+    };
+    
+    BasicMemory();
+    void store(T value);
+    T recall();
+    T peek();   // stored value (0 when empty) without printing
     void clear();
     bool isEmpty();
     void displayStatus();
+    
+    // Named registers
+    bool storeVariable(const std::string& name, T value);
+    T recallVariable(const std::string& name);
+    bool hasVariable(const std::string& name);
+    void clearVariable(const std::string& name);
+    void clearVariables();
+    std::vector<std::string> getVariableNames();   // defined ones, in id order
+    
+    size_t intern(const std::string& name);
+    size_t findVariable(const std::string& name);
+    T getVariable(size_t id);
+    void setVariable(size_t id, T value);
+    bool isDefined(size_t id);
+    
+    // Coefficient sets, names as for registers
+    bool storeCoefficients(const std::string& name, const std::vector<T>& coefficients);
+    std::vector<T> recallCoefficients(const std::string& name);   // empty if undefined
+    bool hasCoefficients(const std::string& name);
+    void clearCoefficients(const std::string& name);
+    std::vector<std::string> getCoefficientNames();
+    
+    Snapshot snapshot();
+    void restore(const Snapshot& state);
 };
 
-#endif // MEMORY_H
\ No newline at end of file
+extern template class BasicMemory<float>;
+extern template class BasicMemory<double>;
+extern template class BasicMemory<long double>;
+#ifdef CALC_HAVE_FLOAT128
+extern template class BasicMemory<__float128>;
+#endif
+
+using Memory = BasicMemory<double>;
+
+#endif // MEMORY_H
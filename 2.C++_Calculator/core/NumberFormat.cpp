@@ -0,0 +1,347 @@
+#include "NumberFormat.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+#if defined(__has_include)
+#if __has_include(<charconv>)
+#include <charconv>
+#endif
+#endif
+
+#if defined(__cpp_lib_to_chars) && !defined(CALC_NO_CHARCONV)
+#define CALC_HAVE_CHARCONV 1
+#else
+#include <locale>
+#include <sstream>
+#endif
+
+using namespace std;
+
+namespace {
+
+// |value| = d.ddd x 10^exponent
+struct Decimal {
+    char digits[NumberFormat::maxDigits];
+    int count;
+    int exponent;
+};
+
+// Reads "d[.ddd]e[+-]x" as written by to_chars or printf's %e (whatever
+// the locale's decimal point)
+void readScientific(const char* text, const char* end, Decimal& decimal) {
+    decimal.count = 0;
+    const char* p = text;
+    for (; p < end && *p != 'e' && *p != 'E'; p++) {
+        if (*p >= '0' && *p <= '9' && decimal.count < NumberFormat::maxDigits) {
+            decimal.digits[decimal.count++] = *p;
+        }
+    }
+    bool negative = false;
+    int exponent = 0;
+    if (p < end) {
+        p++;
+    }
+    if (p < end && (*p == '+' || *p == '-')) {
+        negative = *p == '-';
+        p++;
+    }
+    for (; p < end; p++) {
+        exponent = exponent * 10 + (*p - '0');
+    }
+    decimal.exponent = negative ? -exponent : exponent;
+}
+
+// Decimal exponent of the leading digit of a number's text, for telling
+// overflow from underflow when the parser reports out of range
+long leadingExponent(const char* first, const char* last) {
+    long position = 0;
+    long exponent = 0;
+    bool seenPoint = false, seenDigit = false;
+    const char* p = first;
+    if (p < last && *p == '-') {
+        p++;
+    }
+    for (; p < last && *p != 'e' && *p != 'E'; p++) {
+        if (*p == '.') {
+            seenPoint = true;
+        } else if (!seenDigit && *p == '0') {
+            position -= seenPoint ? 1 : 0;
+        } else if (!seenDigit) {
+            seenDigit = true;
+        } else if (!seenPoint) {
+            position++;
+        }
+    }
+    if (p < last) {
+        p++;
+        bool negative = p < last && *p == '-';
+        if (p < last && (*p == '+' || *p == '-')) {
+            p++;
+        }
+        for (; p < last && exponent < 100000; p++) {
+            exponent = exponent * 10 + (*p - '0');
+        }
+        exponent = negative ? -exponent : exponent;
+    }
+    return position + exponent;
+}
+
+#ifndef CALC_HAVE_CHARCONV
+bool equalsIgnoringCase(const char* first, const char* last, const char* word) {
+    size_t length = strlen(word);
+    if (size_t(last - first) != length) {
+        return false;
+    }
+    for (size_t i = 0; i < length; i++) {
+        char c = first[i];
+        if ((c >= 'A' && c <= 'Z' ? c - 'A' + 'a' : c) != word[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// [-]digits[.digits][e[+-]digits] with a digit somewhere in the mantissa
+bool isDecimalSyntax(const char* p, const char* last) {
+    bool digits = false;
+    if (p < last && *p == '-') {
+        p++;
+    }
+    for (; p < last && *p >= '0' && *p <= '9'; p++) {
+        digits = true;
+    }
+    if (p < last && *p == '.') {
+        for (p++; p < last && *p >= '0' && *p <= '9'; p++) {
+            digits = true;
+        }
+    }
+    if (!digits) {
+        return false;
+    }
+    if (p < last && (*p == 'e' || *p == 'E')) {
+        p++;
+        if (p < last && (*p == '+' || *p == '-')) {
+            p++;
+        }
+        if (p == last) {
+            return false;
+        }
+        for (; p < last && *p >= '0' && *p <= '9'; p++) {
+        }
+    }
+    return p == last;
+}
+#endif
+
+// Parses a decimal or inf / nan; false for malformed text, and outOfRange
+// set (value unspecified) when the number does not fit in a double
+bool parseDecimal(const char* first, const char* last, double& value, bool& outOfRange) {
+    outOfRange = false;
+#ifdef CALC_HAVE_CHARCONV
+    from_chars_result result = from_chars(first, last, value);
+    if (result.ptr != last || result.ec == errc::invalid_argument) {
+        return false;
+    }
+    outOfRange = result.ec == errc::result_out_of_range;
+    return true;
+#else
+    bool negative = first < last && *first == '-';
+    const char* word = negative ? first + 1 : first;
+    if (equalsIgnoringCase(word, last, "inf") || equalsIgnoringCase(word, last, "infinity")) {
+        value = negative ? -HUGE_VAL : HUGE_VAL;
+        return true;
+    }
+    if (equalsIgnoringCase(word, last, "nan")) {
+        value = negative ? -NAN : NAN;
+        return true;
+    }
+    if (!isDecimalSyntax(first, last)) {
+        return false;
+    }
+    istringstream in(string(first, last));
+    in.imbue(locale::classic());
+    in >> value;
+    outOfRange = in.fail();
+    return true;
+#endif
+}
+
+// Digits of a positive finite value: shortest round trip for digits = 0
+void toDecimal(double value, int digits, Decimal& decimal) {
+    char text[48];
+#ifdef CALC_HAVE_CHARCONV
+    to_chars_result result = digits == 0
+        ? to_chars(text, text + sizeof(text), value, chars_format::scientific)
+        : to_chars(text, text + sizeof(text), value, chars_format::scientific, digits - 1);
+    readScientific(text, result.ptr, decimal);
+#else
+    if (digits > 0) {
+        int length = snprintf(text, sizeof(text), "%.*e", digits - 1, value);
+        readScientific(text, text + length, decimal);
+        return;
+    }
+    // Fewest digits that read back as the same double
+    for (int precision = 1; precision <= NumberFormat::maxDigits; precision++) {
+        int length = snprintf(text, sizeof(text), "%.*e", precision - 1, value);
+        readScientific(text, text + length, decimal);
+        length = snprintf(text, sizeof(text), "%.*se%d", decimal.count, decimal.digits,
+                          decimal.exponent - decimal.count + 1);
+        double back;
+        bool outOfRange;
+        if (parseDecimal(text, text + length, back, outOfRange) && !outOfRange && back == value) {
+            return;
+        }
+    }
+#endif
+}
+
+char* appendDigits(char* out, const char* digits, int count) {
+    memcpy(out, digits, size_t(count));
+    return out + count;
+}
+
+char* appendZeros(char* out, int count) {
+    memset(out, '0', size_t(count));
+    return out + count;
+}
+
+char* appendExponent(char* out, int exponent) {
+    *out++ = 'e';
+    *out++ = exponent < 0 ? '-' : '+';
+    int magnitude = exponent < 0 ? -exponent : exponent;   // at most 324
+    if (magnitude >= 100) {
+        *out++ = char('0' + magnitude / 100);
+    }
+    if (magnitude >= 10) {
+        *out++ = char('0' + magnitude / 10 % 10);
+    }
+    *out++ = char('0' + magnitude % 10);
+    return out;
+}
+
+// Writes the digits in the given notation; returns the end
+char* layout(const Decimal& decimal, Notation notation, char* out) {
+    const char* digits = decimal.digits;
+    int count = decimal.count;
+    if (notation == Notation::General) {
+        // ECMAScript Number::toString with n = exponent + 1 digits before
+        // the point
+        int n = decimal.exponent + 1;
+        if (count <= n && n <= 21) {
+            out = appendDigits(out, digits, count);
+            return appendZeros(out, n - count);
+        }
+        if (0 < n && n <= 21) {
+            out = appendDigits(out, digits, n);
+            *out++ = '.';
+            return appendDigits(out, digits + n, count - n);
+        }
+        if (-6 < n && n <= 0) {
+            *out++ = '0';
+            *out++ = '.';
+            out = appendZeros(out, -n);
+            return appendDigits(out, digits, count);
+        }
+        *out++ = digits[0];
+        if (count > 1) {
+            *out++ = '.';
+            out = appendDigits(out, digits + 1, count - 1);
+        }
+        return appendExponent(out, decimal.exponent);
+    }
+    // Scientific: one digit before the point; Engineering: one to three
+    int shift = notation == Notation::Engineering ? ((decimal.exponent % 3) + 3) % 3 : 0;
+    int whole = shift + 1;
+    if (count <= whole) {
+        out = appendDigits(out, digits, count);
+        out = appendZeros(out, whole - count);
+    } else {
+        out = appendDigits(out, digits, whole);
+        *out++ = '.';
+        out = appendDigits(out, digits + whole, count - whole);
+    }
+    return appendExponent(out, decimal.exponent - shift);
+}
+
+} // namespace
+
+size_t NumberFormat::format(double value, char* buffer, size_t size, int digits, Notation notation) {
+    char text[bufferSize];
+    char* end = text;
+    if (value != value) {
+        end = appendDigits(end, "nan", 3);
+    } else if (value - value != 0) {
+        end = value < 0 ? appendDigits(end, "-inf", 4) : appendDigits(end, "inf", 3);
+    } else {
+        digits = digits < 0 ? 0 : digits > maxDigits ? maxDigits : digits;
+        Decimal decimal;
+        if (value == 0) {
+            decimal.count = max(digits, 1);
+            memset(decimal.digits, '0', size_t(decimal.count));
+            decimal.exponent = 0;
+        } else {
+            toDecimal(fabs(value), digits, decimal);
+        }
+        // A digit count is a maximum in General notation, exact otherwise
+        if (notation == Notation::General || digits == 0) {
+            while (decimal.count > 1 && decimal.digits[decimal.count - 1] == '0') {
+                decimal.count--;
+            }
+        }
+        if (signbit(value)) {
+            *end++ = '-';
+        }
+        end = layout(decimal, notation, end);
+    }
+
+    size_t length = size_t(end - text);
+    if (buffer != nullptr && size > 0) {
+        size_t copied = min(length, size - 1);
+        memcpy(buffer, text, copied);
+        buffer[copied] = '\0';
+    }
+    return length;
+}
+
+string NumberFormat::toString(double value, int digits, Notation notation) {
+    char text[bufferSize];
+    size_t length = format(value, text, sizeof(text), digits, notation);
+    return string(text, length);
+}
+
+bool NumberFormat::parse(const char* text, size_t length, double& value) {
+    const char* first = text;
+    const char* last = text + length;
+    while (first < last && (*first == ' ' || *first == '\t')) {
+        first++;
+    }
+    while (last > first && (last[-1] == ' ' || last[-1] == '\t' || last[-1] == '\n' || last[-1] == '\r')) {
+        last--;
+    }
+    if (first < last && *first == '+') {
+        first++;
+        if (first < last && *first == '-') {
+            return false;
+        }
+    }
+    if (first == last) {
+        return false;
+    }
+    double result;
+    bool outOfRange;
+    if (!parseDecimal(first, last, result, outOfRange)) {
+        return false;
+    }
+    if (outOfRange) {
+        result = leadingExponent(first, last) > 0 ? HUGE_VAL : 0.0;
+        result = *first == '-' ? -result : result;
+    }
+    value = result;
+    return true;
+}
+
+bool NumberFormat::parse(const string& text, double& value) {
+    return parse(text.data(), text.size(), value);
+}
@@ -0,0 +1,44 @@
+#ifndef NUMBERFORMAT_H
+#define NUMBERFORMAT_H
+
+#include <cstddef>
+#include <string>
+
+enum class Notation { General, Scientific, Engineering };
+
+// Number <-> text for every front end, so a value reads the same on the
+// console, the desktop GUI, the web build and mobile.
+//
+// digits = 0 gives the shortest text that parses back to the same double
+// (std::to_chars, Ryu-based in libstdc++ and MSVC); 1..17 rounds to that
+// many significant digits.  General notation follows ECMAScript's
+// Number.prototype.toString: plain digits from 1e-6 up to 1e21, "1e-7" and
+// "1.5e+21" outside, which is also what JavaScript and Dart print.
+// Scientific has one digit before the point, Engineering an exponent
+// divisible by 3; both keep the trailing zeros of an explicit digit count.
+// Non-finite values are "nan", "inf" and "-inf"; -0 stays "-0".
+//
+// parse takes what format writes plus a leading '+', "infinity" and
+// surrounding spaces, always with '.' as the decimal point whatever the
+// locale, and fails on anything else (including trailing characters).
+// Values out of range give +-inf or +-0 like strtod.
+//
+// Where <charconv> lacks floating point (older libc++), or with
+// -DCALC_NO_CHARCONV, formatting falls back to snprintf and parsing to a
+// classic-locale stream: same text, slower.
+class NumberFormat {
+public:
+    static const int maxDigits = 17;
+    static const size_t bufferSize = 32;   // any result plus the terminator
+
+    // Writes at most size - 1 characters and a terminator; returns the
+    // full length
+    static size_t format(double value, char* buffer, size_t size, int digits = 0,
+                         Notation notation = Notation::General);
+    static std::string toString(double value, int digits = 0, Notation notation = Notation::General);
+
+    static bool parse(const char* text, size_t length, double& value);
+    static bool parse(const std::string& text, double& value);
+};
+
+#endif // NUMBERFORMAT_H
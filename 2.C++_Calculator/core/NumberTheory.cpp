@@ -0,0 +1,465 @@
+#include "NumberTheory.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+
+using namespace std;
+
+namespace {
+
+typedef unsigned __int128 uint128;
+
+const uint64_t smallPrimes[] = { 2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37 };
+
+// Miller-Rabin bases that are deterministic for all n < 2^64 (Sinclair)
+const uint64_t witnessBases[] = { 2, 325, 9375, 28178, 450775, 9780504, 1795265022 };
+
+const uint64_t largestPrime = 18446744073709551557ULL;   // 2^64 - 59
+
+// Sieve segments hold one byte per odd number: 32 KB stays in L1
+const size_t segmentBytes = size_t(1) << 15;
+
+// Odd numbers not divisible by 3, 5, 7, 11 or 13 repeat with period
+// 3 * 5 * 7 * 11 * 13; segments start as a copy of that pattern
+const size_t patternPeriod = 15015;
+const uint64_t patternPrimes[] = { 3, 5, 7, 11, 13 };
+
+// Arithmetic modulo an odd n on values kept as a * 2^64 mod n, so a
+// product reduces with two multiplications instead of a division
+class Montgomery {
+public:
+    uint64_t n;
+    uint64_t inverse;     // n^-1 mod 2^64
+    uint64_t one;         // 2^64 mod n
+    uint64_t rSquared;    // 2^128 mod n
+
+    explicit Montgomery(uint64_t modulus) : n(modulus) {
+        // Newton's iteration; n is its own inverse mod 8, then each step
+        // doubles the correct low bits (3, 6, 12, 24, 48, 96)
+        inverse = n;
+        for (int i = 0; i < 5; i++) {
+            inverse *= 2 - n * inverse;
+        }
+        one = (0 - n) % n;
+        rSquared = uint64_t((uint128(one) << 64) % n);
+    }
+
+    // t / 2^64 mod n for t < n * 2^64
+    uint64_t reduce(uint128 t) const {
+        uint64_t m = uint64_t(t) * inverse;
+        uint64_t high = uint64_t(t >> 64);
+        uint64_t subtract = uint64_t((uint128(m) * n) >> 64);
+        return high >= subtract ? high - subtract : high - subtract + n;
+    }
+
+    uint64_t multiply(uint64_t a, uint64_t b) const {
+        return reduce(uint128(a) * b);
+    }
+
+    uint64_t add(uint64_t a, uint64_t b) const {
+        uint64_t sum = a + b;
+        return sum < a || sum >= n ? sum - n : sum;
+    }
+
+    uint64_t toForm(uint64_t a) const {
+        return multiply(a % n, rSquared);
+    }
+
+    uint64_t fromForm(uint64_t a) const {
+        return reduce(a);
+    }
+
+    uint64_t power(uint64_t base, uint64_t exponent) const {
+        uint64_t result = one;
+        while (exponent > 0) {
+            if (exponent & 1) {
+                result = multiply(result, base);
+            }
+            base = multiply(base, base);
+            exponent >>= 1;
+        }
+        return result;
+    }
+};
+
+uint64_t difference(uint64_t a, uint64_t b) {
+    return a > b ? a - b : b - a;
+}
+
+// A nontrivial factor of an odd composite n (Brent's variant of Pollard's
+// rho: the gcd runs once per 128 steps on the product of the differences)
+uint64_t pollardBrent(uint64_t n) {
+    const Montgomery mont(n);
+    const uint64_t steps = 128;
+    for (uint64_t c = 1;; c++) {
+        const uint64_t increment = mont.toForm(c);
+        uint64_t y = mont.toForm(2);
+        uint64_t x = y, saved = y, product = mont.one, factor = 1;
+        for (uint64_t r = 1; factor == 1; r *= 2) {
+            x = y;
+            for (uint64_t i = 0; i < r; i++) {
+                y = mont.add(mont.multiply(y, y), increment);
+            }
+            for (uint64_t k = 0; k < r && factor == 1; k += steps) {
+                saved = y;
+                uint64_t batch = min(steps, r - k);
+                for (uint64_t i = 0; i < batch; i++) {
+                    y = mont.add(mont.multiply(y, y), increment);
+                    product = mont.multiply(product, difference(x, y));
+                }
+                factor = NumberTheory::gcd(product, n);
+            }
+        }
+        if (factor == n) {
+            // The batch overshot; redo it one step at a time
+            do {
+                saved = mont.add(mont.multiply(saved, saved), increment);
+                factor = NumberTheory::gcd(difference(x, saved), n);
+            } while (factor == 1);
+        }
+        if (factor != n) {
+            return factor;
+        }
+    }
+}
+
+const vector<uint8_t>& presievePattern() {
+    // One period plus a segment, so any segment is a single copy
+    static const vector<uint8_t> pattern = []() {
+        vector<uint8_t> bytes(patternPeriod + segmentBytes);
+        for (size_t i = 0; i < bytes.size(); i++) {
+            uint64_t value = 2 * i + 1;
+            bool coprime = true;
+            for (uint64_t p : patternPrimes) {
+                coprime = coprime && value % p != 0;
+            }
+            bytes[i] = coprime ? 1 : 0;
+        }
+        return bytes;
+    }();
+    return pattern;
+}
+
+// Odd primes above the pattern primes with p * p <= highest
+vector<uint64_t> sievingPrimes(uint64_t highest) {
+    uint64_t root = 1;
+    while ((root + 1) * (root + 1) <= highest) {
+        root++;
+    }
+    vector<uint8_t> composite(size_t(root) + 1, 0);
+    vector<uint64_t> primes;
+    for (uint64_t p = 3; p <= root; p += 2) {
+        if (composite[p]) {
+            continue;
+        }
+        if (p > patternPrimes[4]) {
+            primes.push_back(p);
+        }
+        for (uint64_t multiple = p * p; multiple <= root; multiple += 2 * p) {
+            composite[multiple] = 1;
+        }
+    }
+    return primes;
+}
+
+// Index of the first odd multiple of p that is at least p^2 and at least
+// the odd number at index low (index i stands for 2i + 1), relative to low
+uint64_t firstMultiple(uint64_t p, uint64_t low) {
+    uint64_t value = 2 * low + 1;
+    uint64_t multiple = (value + p - 1) / p * p;
+    if (multiple % 2 == 0) {
+        multiple += p;
+    }
+    multiple = max(multiple, p * p);
+    return (multiple - 1) / 2 - low;
+}
+
+// Sieves the odd numbers with indices [first, last) a segment at a time,
+// calling visit(segment, flags, lowIndex, length) with flags[k] = 1 when
+// 2 (lowIndex + k) + 1 has no prime factor other than 3..13 (so 1 and the
+// pattern primes need fixing up by the caller).  Consecutive segments run
+// on one thread, which carries each prime's next multiple across them.
+template <typename Visit>
+void sieveOdd(uint64_t first, uint64_t last, Visit visit) {
+    if (first >= last) {
+        return;
+    }
+    const vector<uint64_t> primes = sievingPrimes(2 * (last - 1) + 1);
+    const vector<uint8_t>& pattern = presievePattern();
+    size_t segments = size_t((last - first + segmentBytes - 1) / segmentBytes);
+    size_t participants = ThreadPool::global().getWorkerCount() + 1;
+    size_t grain = max(size_t(1), segments / (4 * participants));
+
+    ThreadPool::global().parallelFor(size_t(0), segments, [&](size_t begin, size_t end) {
+        vector<uint8_t> flags(segmentBytes);
+        vector<uint64_t> next(primes.size());
+        uint64_t low = first + uint64_t(begin) * segmentBytes;
+        for (size_t j = 0; j < primes.size(); j++) {
+            next[j] = firstMultiple(primes[j], low);
+        }
+        for (size_t segment = begin; segment < end; segment++, low += segmentBytes) {
+            size_t length = size_t(min(uint64_t(segmentBytes), last - low));
+            memcpy(flags.data(), pattern.data() + low % patternPeriod, length);
+            uint8_t* bytes = flags.data();
+            for (size_t j = 0; j < primes.size(); j++) {
+                uint64_t p = primes[j];
+                uint64_t k = next[j];
+                for (; k + 3 * p < length; k += 4 * p) {
+                    bytes[k] = 0;
+                    bytes[k + p] = 0;
+                    bytes[k + 2 * p] = 0;
+                    bytes[k + 3 * p] = 0;
+                }
+                for (; k < length; k += p) {
+                    bytes[k] = 0;
+                }
+                next[j] = k - length;
+            }
+            visit(segment, bytes, low, length);
+        }
+    }, grain);
+}
+
+} // namespace
+
+uint64_t NumberTheory::gcd(uint64_t a, uint64_t b) {
+    if (a == 0) return b;
+    if (b == 0) return a;
+    // Binary gcd: shifts and subtractions only
+    int shift = __builtin_ctzll(a | b);
+    a >>= __builtin_ctzll(a);
+    while (b != 0) {
+        b >>= __builtin_ctzll(b);
+        if (a > b) {
+            swap(a, b);
+        }
+        b -= a;
+    }
+    return a << shift;
+}
+
+uint64_t NumberTheory::lcm(uint64_t a, uint64_t b) {
+    if (a == 0 || b == 0) {
+        return 0;
+    }
+    uint64_t result;
+    if (__builtin_mul_overflow(a / gcd(a, b), b, &result)) {
+        return 0;
+    }
+    return result;
+}
+
+uint64_t NumberTheory::modPow(uint64_t base, uint64_t exponent, uint64_t modulus) {
+    if (modulus <= 1) {
+        return 0;
+    }
+    if (modulus % 2 == 1) {
+        Montgomery mont(modulus);
+        return mont.fromForm(mont.power(mont.toForm(base), exponent));
+    }
+    uint64_t result = 1;
+    base %= modulus;
+    while (exponent > 0) {
+        if (exponent & 1) {
+            result = uint64_t(uint128(result) * base % modulus);
+        }
+        base = uint64_t(uint128(base) * base % modulus);
+        exponent >>= 1;
+    }
+    return result;
+}
+
+bool NumberTheory::isPrime(uint64_t n) {
+    if (n < 2) {
+        return false;
+    }
+    for (uint64_t p : smallPrimes) {
+        if (n % p == 0) {
+            return n == p;
+        }
+    }
+    if (n < 41 * 41) {
+        return true;
+    }
+
+    const Montgomery mont(n);
+    uint64_t odd = n - 1;
+    int twos = __builtin_ctzll(odd);
+    odd >>= twos;
+    const uint64_t minusOne = n - mont.one;
+    for (uint64_t base : witnessBases) {
+        uint64_t a = base % n;
+        if (a == 0) {
+            continue;
+        }
+        uint64_t x = mont.power(mont.toForm(a), odd);
+        if (x == mont.one || x == minusOne) {
+            continue;
+        }
+        bool witness = true;
+        for (int i = 1; i < twos && witness; i++) {
+            x = mont.multiply(x, x);
+            witness = x != minusOne;
+        }
+        if (witness) {
+            return false;
+        }
+    }
+    return true;
+}
+
+uint64_t NumberTheory::nextPrime(uint64_t n) {
+    if (n < 2) {
+        return 2;
+    }
+    if (n >= largestPrime) {
+        return 0;
+    }
+    uint64_t candidate = n % 2 == 0 ? n + 1 : n + 2;
+    while (!isPrime(candidate)) {
+        candidate += 2;
+    }
+    return candidate;
+}
+
+vector<uint64_t> NumberTheory::factorize(uint64_t n) {
+    vector<uint64_t> factors;
+    if (n < 2) {
+        return factors;
+    }
+    int twos = __builtin_ctzll(n);
+    factors.insert(factors.end(), size_t(twos), 2);
+    n >>= twos;
+    // Trial division by odd numbers below 256 leaves either 1, a prime
+    // (anything below 256^2) or a product of larger primes for rho
+    for (uint64_t d = 3; d < 256 && d * d <= n; d += 2) {
+        while (n % d == 0) {
+            factors.push_back(d);
+            n /= d;
+        }
+    }
+    vector<uint64_t> pending;
+    if (n > 1) {
+        pending.push_back(n);
+    }
+    while (!pending.empty()) {
+        uint64_t m = pending.back();
+        pending.pop_back();
+        if (isPrime(m)) {
+            factors.push_back(m);
+            continue;
+        }
+        uint64_t factor = pollardBrent(m);
+        pending.push_back(factor);
+        pending.push_back(m / factor);
+    }
+    sort(factors.begin(), factors.end());
+    return factors;
+}
+
+uint64_t NumberTheory::countPrimes(uint64_t limit) {
+    if (limit < 2 || limit > maxSieveLimit) {
+        return 0;
+    }
+    // Odd numbers 1 .. limit, then fix up 1, 2 and the pattern primes
+    uint64_t last = (limit - 1) / 2 + 1;
+    atomic<uint64_t> sieved(0);
+    sieveOdd(0, last, [&](size_t, const uint8_t* flags, uint64_t, size_t length) {
+        uint64_t count = 0;
+        for (size_t k = 0; k < length; k++) {
+            count += flags[k];
+        }
+        sieved.fetch_add(count, memory_order_relaxed);
+    });
+    uint64_t total = sieved.load();   // counts 1 instead of 2
+    for (uint64_t p : patternPrimes) {
+        total += p <= limit ? 1 : 0;
+    }
+    return total;
+}
+
+vector<uint64_t> NumberTheory::primesBetween(uint64_t low, uint64_t high) {
+    vector<uint64_t> primes;
+    if (high < 2 || low > high || high > maxSieveLimit || high - low > maxPrimeRange) {
+        return primes;
+    }
+    if (low <= 2) {
+        primes.push_back(2);
+    }
+    for (uint64_t p : patternPrimes) {
+        if (p >= low && p <= high) {
+            primes.push_back(p);
+        }
+    }
+    // The pattern primes are marked composite, so the sieve adds 17 and up
+    uint64_t first = low / 2;
+    uint64_t last = (high - 1) / 2 + 1;
+    vector<vector<uint64_t>> found(size_t((last - min(first, last) + segmentBytes - 1) / segmentBytes));
+    sieveOdd(first, last, [&](size_t segment, const uint8_t* flags, uint64_t lowIndex, size_t length) {
+        vector<uint64_t>& out = found[segment];
+        for (size_t k = 0; k < length; k++) {
+            uint64_t value = 2 * (lowIndex + k) + 1;
+            if (flags[k] && value > 1) {
+                out.push_back(value);
+            }
+        }
+    });
+    for (const vector<uint64_t>& part : found) {
+        primes.insert(primes.end(), part.begin(), part.end());
+    }
+    return primes;
+}
+
+string NumberTheory::binomial(uint64_t n, uint64_t k) {
+    if (n > maxExactBinomial) {
+        return string();
+    }
+    if (k > n) {
+        return "0";
+    }
+    // Little-endian limbs of nine decimal digits; each multiplier stays
+    // below 2^32 so limb * multiplier + carry fits in 64 bits
+    const uint64_t limbBase = 1000000000;
+    vector<uint32_t> limbs(1, 1);
+    auto multiply = [&](uint64_t multiplier) {
+        uint64_t carry = 0;
+        for (uint32_t& limb : limbs) {
+            uint64_t product = limb * multiplier + carry;
+            limb = uint32_t(product % limbBase);
+            carry = product / limbBase;
+        }
+        while (carry > 0) {
+            limbs.push_back(uint32_t(carry % limbBase));
+            carry /= limbBase;
+        }
+    };
+
+    uint64_t multiplier = 1;
+    for (uint64_t p : primesBetween(2, n)) {
+        uint64_t exponent = 0;
+        for (uint64_t power = p; power <= n; power *= p) {
+            exponent += n / power - k / power - (n - k) / power;
+            if (power > n / p) {
+                break;
+            }
+        }
+        for (; exponent > 0; exponent--) {
+            if (multiplier > (uint64_t(1) << 32) / p) {
+                multiply(multiplier);
+                multiplier = 1;
+            }
+            multiplier *= p;
+        }
+    }
+    multiply(multiplier);
+
+    string digits = to_string(limbs.back());
+    char group[16];
+    for (size_t i = limbs.size() - 1; i-- > 0;) {
+        snprintf(group, sizeof(group), "%09u", limbs[i]);
+        digits += group;
+    }
+    return digits;
+}
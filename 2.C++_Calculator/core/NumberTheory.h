@@ -0,0 +1,53 @@
+#ifndef NUMBERTHEORY_H
+#define NUMBERTHEORY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Number theory on unsigned 64-bit integers.
+//
+// isPrime is Miller-Rabin with the seven bases that are deterministic for
+// every 64-bit n, in Montgomery arithmetic (no 128-bit division in the
+// loop).  factorize strips small primes by trial division and splits the
+// rest with Pollard-Brent rho.  countPrimes and primesBetween run a
+// segmented Sieve of Eratosthenes over odd numbers: each segment fits in
+// the L1 data cache, starts from a copy of the 3..13 pattern instead of
+// crossing those off, and segments are spread over ThreadPool::global().
+// The sieve goes up to maxSieveLimit; a call beyond it returns 0 / empty.
+// primesBetween also keeps its result in memory, so it spans at most
+// maxPrimeRange numbers (about 15 million primes) and is empty beyond that.
+//
+// The functions are silent; CalculatorEngine reports range errors.
+class NumberTheory {
+public:
+    static const uint64_t maxSieveLimit = uint64_t(1) << 42;
+    static const uint64_t maxPrimeRange = uint64_t(1) << 28;
+    static const uint64_t maxExactBinomial = 100000;
+
+    static uint64_t gcd(uint64_t a, uint64_t b);
+    // 0 when the result does not fit in 64 bits (or either argument is 0)
+    static uint64_t lcm(uint64_t a, uint64_t b);
+    // base^exponent mod modulus; 0 for modulus 0
+    static uint64_t modPow(uint64_t base, uint64_t exponent, uint64_t modulus);
+
+    static bool isPrime(uint64_t n);
+    // Smallest prime > n, or 0 past the largest 64-bit prime
+    static uint64_t nextPrime(uint64_t n);
+    // Prime factors in ascending order with multiplicity; empty for 0 and 1
+    static std::vector<uint64_t> factorize(uint64_t n);
+
+    // Number of primes <= limit
+    static uint64_t countPrimes(uint64_t limit);
+    // Primes p with low <= p <= high, ascending
+    static std::vector<uint64_t> primesBetween(uint64_t low, uint64_t high);
+
+    // C(n, k) exactly, in decimal.  The exponent of each prime p <= n in
+    // C(n, k) follows from Legendre's formula, so the digits come from
+    // multiplying prime powers instead of dividing big integers.  "0" for
+    // k > n; empty above maxExactBinomial.
+    static std::string binomial(uint64_t n, uint64_t k);
+};
+
+#endif // NUMBERTHEORY_H
@@ -0,0 +1,405 @@
+#include "Polynomial.h"
+#include "CalcKernels.h"
+#include "CpuDispatch.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <memory>
+#include <type_traits>
+
+using namespace std;
+
+namespace {
+
+// Fits feed this many rows to one accumulator; larger inputs get one per
+// chunk, accumulated on the thread pool and merged in chunk order so the
+// result does not depend on scheduling
+const size_t fitChunkRows = size_t(1) << 16;
+
+// About 128 KB of doubles per buffered block
+const size_t blockElements = 16384;
+
+template <typename T>
+T absolute(T x) {
+    return x < 0 ? -x : x;
+}
+
+template <typename T>
+void finishPart(BasicLeastSquares<T>& part) {
+    part.reduce();
+}
+
+template <typename T>
+void finishPart(BasicNormalEquations<T>&) {
+}
+
+// Adds rows 0 .. count - 1 to total; makeRow(i, row) fills row and returns y
+template <typename T, typename Accumulator, typename RowMaker>
+void accumulateRows(Accumulator& total, size_t unknowns, size_t count, RowMaker makeRow) {
+    size_t chunks = (count + fitChunkRows - 1) / fitChunkRows;
+    if (chunks <= 1) {
+        vector<T> row(unknowns);
+        for (size_t i = 0; i < count; i++) {
+            T y = makeRow(i, row.data());
+            total.addRow(row.data(), y);
+        }
+        return;
+    }
+    vector<unique_ptr<Accumulator>> parts(chunks);
+    ThreadPool::global().parallelFor(size_t(0), chunks, [&](size_t first, size_t last) {
+        vector<T> row(unknowns);
+        for (size_t chunk = first; chunk < last; chunk++) {
+            unique_ptr<Accumulator> part(new Accumulator(unknowns));
+            size_t end = min(count, (chunk + 1) * fitChunkRows);
+            for (size_t i = chunk * fitChunkRows; i < end; i++) {
+                T y = makeRow(i, row.data());
+                part->addRow(row.data(), y);
+            }
+            finishPart(*part);
+            parts[chunk] = move(part);
+        }
+    }, 1);
+    for (unique_ptr<Accumulator>& part : parts) {
+        total.merge(*part);
+    }
+}
+
+template <typename T, typename RowMaker>
+bool solveRows(size_t unknowns, size_t count, FitMethod method, RowMaker makeRow, vector<T>& solution) {
+    if (method == FitMethod::NormalEquations) {
+        BasicNormalEquations<T> equations(unknowns);
+        accumulateRows<T>(equations, unknowns, count, makeRow);
+        return equations.solve(solution);
+    }
+    BasicLeastSquares<T> squares(unknowns);
+    accumulateRows<T>(squares, unknowns, count, makeRow);
+    return squares.solve(solution);
+}
+
+} // namespace
+
+// Least squares by QR
+template <typename T>
+BasicLeastSquares<T>::BasicLeastSquares(size_t unknowns)
+    : unknowns(unknowns), factor(unknowns * (unknowns + 1), T(0)) {
+    blockRows = max(unknowns + 1, blockElements / (unknowns + 1));
+    pending = 0;
+    rows = 0;
+    residualSquares = 0;
+}
+
+template <typename T>
+void BasicLeastSquares<T>::addRow(const T* row, T y) {
+    if (block.empty()) {
+        block.resize(blockRows * (unknowns + 1));
+    }
+    for (size_t j = 0; j < unknowns; j++) {
+        block[j * blockRows + pending] = row[j];
+    }
+    block[unknowns * blockRows + pending] = y;
+    rows++;
+    if (++pending == blockRows) {
+        reduceBlock();
+    }
+}
+
+// One Householder reflector per column zeroes the block below R's
+// diagonal; the y column ends up as Q^T y with the residual left below
+template <typename T>
+void BasicLeastSquares<T>::reduceBlock() {
+    size_t width = unknowns + 1;
+    for (size_t j = 0; j < unknowns; j++) {
+        T* v = &block[j * blockRows];
+        T below = 0;
+        for (size_t i = 0; i < pending; i++) {
+            below += v[i] * v[i];
+        }
+        if (below == 0) {
+            continue;
+        }
+        T alpha = factor[j * width + j];
+        T norm = PrecisionTraits<T>::sqrt(alpha * alpha + below);
+        T beta = alpha >= 0 ? -norm : norm;
+        // Reflector (1, v / (alpha - beta)) with tau = (beta - alpha) / beta
+        T tau = (beta - alpha) / beta;
+        T scale = 1 / (alpha - beta);
+        for (size_t i = 0; i < pending; i++) {
+            v[i] *= scale;
+        }
+        factor[j * width + j] = beta;
+        for (size_t column = j + 1; column < width; column++) {
+            T* w = &block[column * blockRows];
+            T dot = factor[j * width + column];
+            for (size_t i = 0; i < pending; i++) {
+                dot += v[i] * w[i];
+            }
+            dot *= tau;
+            factor[j * width + column] -= dot;
+            for (size_t i = 0; i < pending; i++) {
+                w[i] -= dot * v[i];
+            }
+        }
+    }
+    const T* residuals = &block[unknowns * blockRows];
+    for (size_t i = 0; i < pending; i++) {
+        residualSquares += residuals[i] * residuals[i];
+    }
+    pending = 0;
+}
+
+template <typename T>
+void BasicLeastSquares<T>::reduce() {
+    if (pending > 0) {
+        reduceBlock();
+    }
+    vector<T>().swap(block);
+}
+
+// The rows of the other R stacked under this one have the same
+// least-squares solution as both sets of original rows
+template <typename T>
+void BasicLeastSquares<T>::merge(BasicLeastSquares& other) {
+    if (other.unknowns != unknowns) {
+        return;
+    }
+    other.reduce();
+    size_t total = rows + other.rows;
+    size_t width = unknowns + 1;
+    for (size_t j = 0; j < unknowns; j++) {
+        addRow(&other.factor[j * width], other.factor[j * width + unknowns]);
+    }
+    rows = total;
+    residualSquares += other.residualSquares;
+}
+
+template <typename T>
+bool BasicLeastSquares<T>::solve(vector<T>& solution) {
+    reduce();
+    if (unknowns == 0 || rows < unknowns) {
+        return false;
+    }
+    size_t width = unknowns + 1;
+    T largest = 0;
+    for (size_t j = 0; j < unknowns; j++) {
+        largest = max(largest, absolute(factor[j * width + j]));
+    }
+    // A diagonal this small against the largest means dependent columns
+    T tolerance = largest * PrecisionTraits<T>::epsilon * T(unknowns);
+    if (!(largest > 0)) {
+        return false;
+    }
+    vector<T> x(unknowns);
+    for (size_t j = unknowns; j-- > 0;) {
+        T diagonal = factor[j * width + j];
+        if (!(absolute(diagonal) > tolerance)) {
+            return false;
+        }
+        T sum = factor[j * width + unknowns];
+        for (size_t k = j + 1; k < unknowns; k++) {
+            sum -= factor[j * width + k] * x[k];
+        }
+        x[j] = sum / diagonal;
+    }
+    solution.swap(x);
+    return true;
+}
+
+template <typename T>
+T BasicLeastSquares<T>::residualNorm() {
+    reduce();
+    return PrecisionTraits<T>::sqrt(residualSquares);
+}
+
+template <typename T>
+size_t BasicLeastSquares<T>::getRowCount() {
+    return rows;
+}
+
+// Normal equations
+template <typename T>
+BasicNormalEquations<T>::BasicNormalEquations(size_t unknowns)
+    : unknowns(unknowns), gram(unknowns * unknowns, T(0)), moments(unknowns, T(0)) {
+    rows = 0;
+}
+
+template <typename T>
+void BasicNormalEquations<T>::addRow(const T* row, T y) {
+    for (size_t j = 0; j < unknowns; j++) {
+        T* line = &gram[j * unknowns];
+        T value = row[j];
+        for (size_t k = j; k < unknowns; k++) {
+            line[k] += value * row[k];
+        }
+        moments[j] += value * y;
+    }
+    rows++;
+}
+
+template <typename T>
+void BasicNormalEquations<T>::merge(const BasicNormalEquations& other) {
+    if (other.unknowns != unknowns) {
+        return;
+    }
+    for (size_t i = 0; i < gram.size(); i++) {
+        gram[i] += other.gram[i];
+    }
+    for (size_t j = 0; j < unknowns; j++) {
+        moments[j] += other.moments[j];
+    }
+    rows += other.rows;
+}
+
+// Cholesky A^T A = U^T U, then two triangular solves
+template <typename T>
+bool BasicNormalEquations<T>::solve(vector<T>& solution) {
+    if (unknowns == 0 || rows < unknowns) {
+        return false;
+    }
+    vector<T> u(gram);
+    T largest = 0;
+    for (size_t j = 0; j < unknowns; j++) {
+        largest = max(largest, u[j * unknowns + j]);
+    }
+    T tolerance = largest * PrecisionTraits<T>::epsilon * T(unknowns);
+    for (size_t j = 0; j < unknowns; j++) {
+        T pivot = u[j * unknowns + j];
+        for (size_t k = 0; k < j; k++) {
+            pivot -= u[k * unknowns + j] * u[k * unknowns + j];
+        }
+        if (!(pivot > tolerance)) {
+            return false;
+        }
+        pivot = PrecisionTraits<T>::sqrt(pivot);
+        u[j * unknowns + j] = pivot;
+        for (size_t column = j + 1; column < unknowns; column++) {
+            T sum = u[j * unknowns + column];
+            for (size_t k = 0; k < j; k++) {
+                sum -= u[k * unknowns + j] * u[k * unknowns + column];
+            }
+            u[j * unknowns + column] = sum / pivot;
+        }
+    }
+    vector<T> x(moments);
+    for (size_t j = 0; j < unknowns; j++) {
+        for (size_t k = 0; k < j; k++) {
+            x[j] -= u[k * unknowns + j] * x[k];
+        }
+        x[j] /= u[j * unknowns + j];
+    }
+    for (size_t j = unknowns; j-- > 0;) {
+        for (size_t k = j + 1; k < unknowns; k++) {
+            x[j] -= u[j * unknowns + k] * x[k];
+        }
+        x[j] /= u[j * unknowns + j];
+    }
+    solution.swap(x);
+    return true;
+}
+
+template <typename T>
+size_t BasicNormalEquations<T>::getRowCount() {
+    return rows;
+}
+
+// Polynomials
+template <typename T>
+T BasicPolynomial<T>::evaluate(const vector<T>& coefficients, T x) {
+    return CalcKernels::polynomial(coefficients.data(), coefficients.size(), x);
+}
+
+template <typename T>
+void BasicPolynomial<T>::evaluate(const vector<T>& coefficients, const T* xs, T* out, size_t count) {
+    if constexpr (is_same<T, double>::value) {
+        CpuDispatch::kernels().polynomial(coefficients.data(), coefficients.size(), xs, out, count);
+    } else {
+        for (size_t i = 0; i < count; i++) {
+            out[i] = CalcKernels::polynomial(coefficients.data(), coefficients.size(), xs[i]);
+        }
+    }
+}
+
+template <typename T>
+bool BasicPolynomial<T>::fit(const T* xs, const T* ys, size_t count, size_t degree, vector<T>& coefficients,
+                             FitMethod method) {
+    size_t terms = degree + 1;
+    if (count < terms) {
+        return false;
+    }
+    T low = xs[0], high = xs[0];
+    for (size_t i = 1; i < count; i++) {
+        low = min(low, xs[i]);
+        high = max(high, xs[i]);
+    }
+    T center = (low + high) / 2;
+    T halfRange = (high - low) / 2;
+    if (!(halfRange > 0)) {
+        if (degree > 0) {
+            return false;
+        }
+        halfRange = 1;
+    }
+    T inverse = 1 / halfRange;
+
+    vector<T> scaled;
+    bool solved = solveRows<T>(terms, count, method, [=](size_t i, T* row) {
+        T t = (xs[i] - center) * inverse;
+        T power = 1;
+        for (size_t k = 0; k < terms; k++) {
+            row[k] = power;
+            power *= t;
+        }
+        return ys[i];
+    }, scaled);
+    if (!solved) {
+        return false;
+    }
+
+    // sum a[k] ((x - center) / halfRange)^k expanded by Horner's rule on
+    // polynomials: result = result * (x - center) + a[k] / halfRange^k
+    vector<T> result(terms, T(0));
+    T scale = 1;
+    vector<T> divided(terms);
+    for (size_t k = 0; k < terms; k++) {
+        divided[k] = scaled[k] * scale;
+        scale *= inverse;
+    }
+    for (size_t k = terms; k-- > 0;) {
+        for (size_t m = terms - 1; m > 0; m--) {
+            result[m] = result[m - 1] - center * result[m];
+        }
+        result[0] = divided[k] - center * result[0];
+    }
+    coefficients.swap(result);
+    return true;
+}
+
+template <typename T>
+bool BasicPolynomial<T>::fitLinear(const T* features, size_t featureCount, const T* ys, size_t count,
+                                   vector<T>& coefficients, FitMethod method) {
+    size_t unknowns = featureCount + 1;
+    if (count < unknowns) {
+        return false;
+    }
+    return solveRows<T>(unknowns, count, method, [=](size_t i, T* row) {
+        row[0] = 1;
+        const T* values = features + i * featureCount;
+        for (size_t k = 0; k < featureCount; k++) {
+            row[k + 1] = values[k];
+        }
+        return ys[i];
+    }, coefficients);
+}
+
+template class BasicLeastSquares<float>;
+template class BasicLeastSquares<double>;
+template class BasicLeastSquares<long double>;
+template class BasicNormalEquations<float>;
+template class BasicNormalEquations<double>;
+template class BasicNormalEquations<long double>;
+template class BasicPolynomial<float>;
+template class BasicPolynomial<double>;
+template class BasicPolynomial<long double>;
+#ifdef CALC_HAVE_FLOAT128
+template class BasicLeastSquares<__float128>;
+template class BasicNormalEquations<__float128>;
+template class BasicPolynomial<__float128>;
+#endif
@@ -0,0 +1,106 @@
+#ifndef POLYNOMIAL_H
+#define POLYNOMIAL_H
+
+#include <cstddef>
+#include <vector>
+#include "Precision.h"
+
+// Least squares by Householder QR, fed a row at a time.  Rows collect in a
+// column-major block of about 128 KB; when it fills, the block is reduced
+// against the running R factor (R | Q^T y), one reflector per column, each
+// running down contiguous memory.  Memory stays at R plus one block however
+// many rows arrive.  Accumulators over disjoint rows merge into the factor
+// of their union, which is how large fits are split across threads.
+template <typename T>
+class BasicLeastSquares {
+private:
+    size_t unknowns;
+    size_t blockRows;
+    std::vector<T> factor;     // unknowns x (unknowns + 1), row-major
+    std::vector<T> block;      // unknowns + 1 columns of blockRows
+    size_t pending;
+    size_t rows;
+    T residualSquares;         // squared residuals of the reduced blocks
+
+    void reduceBlock();
+
+public:
+    explicit BasicLeastSquares(size_t unknowns);
+
+    void addRow(const T* row, T y);
+    void merge(BasicLeastSquares& other);
+    // Folds buffered rows into R and frees the buffer until more rows come
+    void reduce();
+
+    // Minimizes |A x - y|.  False with fewer rows than unknowns or when the
+    // columns are (numerically) dependent.
+    bool solve(std::vector<T>& solution);
+    T residualNorm();
+    size_t getRowCount();
+};
+
+// Running A^T A and A^T y.  One pass and no block to reduce, so cheaper per
+// row than QR, but it squares the condition number: fine for regression on
+// a few well-scaled features, not for high polynomial degrees.  Solved by
+// Cholesky.
+template <typename T>
+class BasicNormalEquations {
+private:
+    size_t unknowns;
+    std::vector<T> gram;       // upper triangle of A^T A, row-major square
+    std::vector<T> moments;    // A^T y
+    size_t rows;
+
+public:
+    explicit BasicNormalEquations(size_t unknowns);
+
+    void addRow(const T* row, T y);
+    void merge(const BasicNormalEquations& other);
+    bool solve(std::vector<T>& solution);
+    size_t getRowCount();
+};
+
+enum class FitMethod { QR, NormalEquations };
+
+// Polynomials as coefficient vectors, lowest degree first: {1, 0, 2} is
+// 1 + 2x^2.  Evaluation is CalcKernels::polynomial (CpuDispatch for double
+// arrays).  Fits return false without changing coefficients when there are
+// fewer distinct points than unknowns.
+template <typename T>
+class BasicPolynomial {
+public:
+    static T evaluate(const std::vector<T>& coefficients, T x);
+    static void evaluate(const std::vector<T>& coefficients, const T* xs, T* out, size_t count);
+
+    // Least-squares polynomial of the given degree through (xs, ys).  The
+    // fit runs on x mapped to [-1, 1] and converts back, which keeps the
+    // columns well conditioned.
+    static bool fit(const T* xs, const T* ys, size_t count, size_t degree, std::vector<T>& coefficients,
+                    FitMethod method = FitMethod::QR);
+
+    // y = c[0] + c[1] f0 + c[2] f1 + ... over count rows of featureCount
+    // features (row-major)
+    static bool fitLinear(const T* features, size_t featureCount, const T* ys, size_t count,
+                          std::vector<T>& coefficients, FitMethod method = FitMethod::QR);
+};
+
+extern template class BasicLeastSquares<float>;
+extern template class BasicLeastSquares<double>;
+extern template class BasicLeastSquares<long double>;
+extern template class BasicNormalEquations<float>;
+extern template class BasicNormalEquations<double>;
+extern template class BasicNormalEquations<long double>;
+extern template class BasicPolynomial<float>;
+extern template class BasicPolynomial<double>;
+extern template class BasicPolynomial<long double>;
+#ifdef CALC_HAVE_FLOAT128
+extern template class BasicLeastSquares<__float128>;
+extern template class BasicNormalEquations<__float128>;
+extern template class BasicPolynomial<__float128>;
+#endif
+
+using LeastSquares = BasicLeastSquares<double>;
+using NormalEquations = BasicNormalEquations<double>;
+using Polynomial = BasicPolynomial<double>;
+
+#endif // POLYNOMIAL_H
@@ -0,0 +1,120 @@
+#ifndef PRECISION_H
+#define PRECISION_H
+
+#include <cmath>
+#include <limits>
+#include <sstream>
+#include <string>
+#include "NumberFormat.h"
+
+// Math functions and formatting for each floating-point type the core is
+// instantiated for.  __float128 needs libquadmath, so it is only available
+// when building with -DCALC_ENABLE_FLOAT128 and linking -lquadmath.
+
+#if defined(CALC_ENABLE_FLOAT128) && defined(__SIZEOF_FLOAT128__)
+#include <quadmath.h>
+#define CALC_HAVE_FLOAT128 1
+#endif
+
+template <typename T>
+struct StandardPrecisionTraits {
+    static T sin(T x) { return std::sin(x); }
+    static T cos(T x) { return std::cos(x); }
+    static T tan(T x) { return std::tan(x); }
+    static T asin(T x) { return std::asin(x); }
+    static T acos(T x) { return std::acos(x); }
+    static T atan(T x) { return std::atan(x); }
+    static T atan2(T y, T x) { return std::atan2(y, x); }
+    static T hypot(T x, T y) { return std::hypot(x, y); }
+    static T fmod(T x, T y) { return std::fmod(x, y); }
+    static T floor(T x) { return std::floor(x); }
+    static T fma(T x, T y, T z) { return std::fma(x, y, z); }
+    static T exp(T x) { return std::exp(x); }
+    static T log(T x) { return std::log(x); }
+    static T log10(T x) { return std::log10(x); }
+    static T pow(T x, T y) { return std::pow(x, y); }
+    static T sqrt(T x) { return std::sqrt(x); }
+    static T sinh(T x) { return std::sinh(x); }
+    static T cosh(T x) { return std::cosh(x); }
+    static T tanh(T x) { return std::tanh(x); }
+    static T asinh(T x) { return std::asinh(x); }
+    static T acosh(T x) { return std::acosh(x); }
+    static T atanh(T x) { return std::atanh(x); }
+    static T lgamma(T x) { return std::lgamma(x); }
+
+    static std::string toString(T value) {
+        std::ostringstream out;
+        out << value;
+        return out.str();
+    }
+};
+
+template <typename T>
+struct PrecisionTraits;
+
+template <>
+struct PrecisionTraits<float> : StandardPrecisionTraits<float> {
+    static const char* name() { return "float32"; }
+    static constexpr float pi = 3.14159265358979323846f;
+    static constexpr float epsilon = 0x1p-23f;
+};
+
+template <>
+struct PrecisionTraits<double> : StandardPrecisionTraits<double> {
+    static const char* name() { return "float64"; }
+    static constexpr double pi = 3.14159265358979323846;
+    static constexpr double epsilon = 0x1p-52;
+
+    // Shortest round-trip text rather than the stream's six digits
+    static std::string toString(double value) { return NumberFormat::toString(value); }
+};
+
+template <>
+struct PrecisionTraits<long double> : StandardPrecisionTraits<long double> {
+    static const char* name() { return "long double"; }
+    static constexpr long double pi = 3.141592653589793238462643383279502884L;
+    static constexpr long double epsilon = std::numeric_limits<long double>::epsilon();
+};
+
+#ifdef CALC_HAVE_FLOAT128
+template <>
+struct PrecisionTraits<__float128> {
+    static const char* name() { return "float128"; }
+    // pi as a double-double sum (~107 bits) so it stays a constant expression
+    // without the Q literal suffix
+    static constexpr __float128 pi = __float128(3.141592653589793116) + __float128(1.2246467991473532e-16);
+    static constexpr __float128 epsilon = __float128(0x1p-112);
+
+    static __float128 sin(__float128 x) { return sinq(x); }
+    static __float128 cos(__float128 x) { return cosq(x); }
+    static __float128 tan(__float128 x) { return tanq(x); }
+    static __float128 asin(__float128 x) { return asinq(x); }
+    static __float128 acos(__float128 x) { return acosq(x); }
+    static __float128 atan(__float128 x) { return atanq(x); }
+    static __float128 atan2(__float128 y, __float128 x) { return atan2q(y, x); }
+    static __float128 hypot(__float128 x, __float128 y) { return hypotq(x, y); }
+    static __float128 fmod(__float128 x, __float128 y) { return fmodq(x, y); }
+    static __float128 floor(__float128 x) { return floorq(x); }
+    static __float128 fma(__float128 x, __float128 y, __float128 z) { return fmaq(x, y, z); }
+    static __float128 exp(__float128 x) { return expq(x); }
+    static __float128 log(__float128 x) { return logq(x); }
+    static __float128 log10(__float128 x) { return log10q(x); }
+    static __float128 pow(__float128 x, __float128 y) { return powq(x, y); }
+    static __float128 sqrt(__float128 x) { return sqrtq(x); }
+    static __float128 sinh(__float128 x) { return sinhq(x); }
+    static __float128 cosh(__float128 x) { return coshq(x); }
+    static __float128 tanh(__float128 x) { return tanhq(x); }
+    static __float128 asinh(__float128 x) { return asinhq(x); }
+    static __float128 acosh(__float128 x) { return acoshq(x); }
+    static __float128 atanh(__float128 x) { return atanhq(x); }
+    static __float128 lgamma(__float128 x) { return lgammaq(x); }
+
+    static std::string toString(__float128 value) {
+        char buffer[64];
+        quadmath_snprintf(buffer, sizeof(buffer), "%Qg", value);
+        return buffer;
+    }
+};
+#endif
+
+#endif // PRECISION_H
@@ -0,0 +1,287 @@
+#include "ScientificCalculator.h"
+#include "ScientificKernels.h"
+#include "CpuDispatch.h"
+#include "EngineStats.h"
+#include <type_traits>
+
+using namespace std;
+
+template <typename T>
+T BasicScientificCalculator<T>::exponential(T value) {
+    return expKernel(value);
+}
+
+template <typename T>
+T BasicScientificCalculator<T>::logarithm(T value) {
+    if (value <= 0) {
+        EngineStats::recordError(EngineStats::LogarithmDomain);
+        cout << "Error: Domain error for log! Input must be positive." << endl;
+        return 0;
+    }
+    return logKernel(value);
+}
+
+template <typename T>
+T BasicScientificCalculator<T>::logarithm10(T value) {
+    if (value <= 0) {
+        EngineStats::recordError(EngineStats::LogarithmDomain);
+        cout << "Error: Domain error for log10! Input must be positive." << endl;
+        return 0;
+    }
+    return log10Kernel(value);
+}
+
+template <typename T>
+T BasicScientificCalculator<T>::squareRoot(T value) {
+    if (value < 0) {
+        EngineStats::recordError(EngineStats::SquareRootDomain);
+        cout << "Error: Square root of a negative number!" << endl;
+        return 0;
+    }
+    return sqrtKernel(value);
+}
+
+template <typename T>
+T BasicScientificCalculator<T>::power(T base, T exponent) {
+    if (isPowerDomainError(base, exponent)) {
+        EngineStats::recordError(EngineStats::PowerDomain);
+        cout << (base == 0 ? "Error: Zero raised to a negative power!"
+                           : "Error: Negative base needs an integer exponent!") << endl;
+        return 0;
+    }
+    return powerKernel(base, exponent);
+}
+
+template <typename T>
+T BasicScientificCalculator<T>::hyperbolicSine(T value) {
+    return sinhKernel(value);
+}
+
+template <typename T>
+T BasicScientificCalculator<T>::hyperbolicCosine(T value) {
+    return coshKernel(value);
+}
+
+template <typename T>
+T BasicScientificCalculator<T>::hyperbolicTangent(T value) {
+    return tanhKernel(value);
+}
+
+template <typename T>
+T BasicScientificCalculator<T>::inverseHyperbolicSine(T value) {
+    return asinhKernel(value);
+}
+
+template <typename T>
+T BasicScientificCalculator<T>::inverseHyperbolicCosine(T value) {
+    if (value < 1) {
+        EngineStats::recordError(EngineStats::InverseHyperbolicDomain);
+        cout << "Error: Domain error for acosh! Input must be at least 1." << endl;
+        return 0;
+    }
+    return acoshKernel(value);
+}
+
+template <typename T>
+T BasicScientificCalculator<T>::inverseHyperbolicTangent(T value) {
+    if (value <= -1 || value >= 1) {
+        EngineStats::recordError(EngineStats::InverseHyperbolicDomain);
+        cout << "Error: Domain error for atanh! Input must be between -1 and 1 (exclusive)." << endl;
+        return 0;
+    }
+    return atanhKernel(value);
+}
+
+// Kernels
+template <typename T>
+T BasicScientificCalculator<T>::expKernel(T value) {
+    if constexpr (is_same<T, double>::value) {
+        return ScientificKernels::exp(value);
+    } else {
+        return PrecisionTraits<T>::exp(value);
+    }
+}
+
+template <typename T>
+T BasicScientificCalculator<T>::logKernel(T value) {
+    if constexpr (is_same<T, double>::value) {
+        return ScientificKernels::log(value);
+    } else {
+        return value <= 0 ? T(0) : PrecisionTraits<T>::log(value);
+    }
+}
+
+template <typename T>
+T BasicScientificCalculator<T>::log10Kernel(T value) {
+    if constexpr (is_same<T, double>::value) {
+        return ScientificKernels::log10(value);
+    } else {
+        return value <= 0 ? T(0) : PrecisionTraits<T>::log10(value);
+    }
+}
+
+template <typename T>
+T BasicScientificCalculator<T>::sqrtKernel(T value) {
+    if constexpr (is_same<T, double>::value) {
+        return ScientificKernels::sqrt(value);
+    } else {
+        return value < 0 ? T(0) : PrecisionTraits<T>::sqrt(value);
+    }
+}
+
+template <typename T>
+T BasicScientificCalculator<T>::sinhKernel(T value) {
+    if constexpr (is_same<T, double>::value) {
+        return ScientificKernels::sinh(value);
+    } else {
+        return PrecisionTraits<T>::sinh(value);
+    }
+}
+
+template <typename T>
+T BasicScientificCalculator<T>::coshKernel(T value) {
+    if constexpr (is_same<T, double>::value) {
+        return ScientificKernels::cosh(value);
+    } else {
+        return PrecisionTraits<T>::cosh(value);
+    }
+}
+
+template <typename T>
+T BasicScientificCalculator<T>::tanhKernel(T value) {
+    if constexpr (is_same<T, double>::value) {
+        return ScientificKernels::tanh(value);
+    } else {
+        return PrecisionTraits<T>::tanh(value);
+    }
+}
+
+template <typename T>
+T BasicScientificCalculator<T>::asinhKernel(T value) {
+    if constexpr (is_same<T, double>::value) {
+        return ScientificKernels::asinh(value);
+    } else {
+        return PrecisionTraits<T>::asinh(value);
+    }
+}
+
+template <typename T>
+T BasicScientificCalculator<T>::acoshKernel(T value) {
+    if constexpr (is_same<T, double>::value) {
+        return ScientificKernels::acosh(value);
+    } else {
+        return value < 1 ? T(0) : PrecisionTraits<T>::acosh(value);
+    }
+}
+
+template <typename T>
+T BasicScientificCalculator<T>::atanhKernel(T value) {
+    if constexpr (is_same<T, double>::value) {
+        return ScientificKernels::atanh(value);
+    } else {
+        return value <= -1 || value >= 1 ? T(0) : PrecisionTraits<T>::atanh(value);
+    }
+}
+
+template <typename T>
+T BasicScientificCalculator<T>::powerKernel(T base, T exponent) {
+    if constexpr (is_same<T, double>::value) {
+        return ScientificKernels::pow(base, exponent);
+    } else {
+        return isPowerDomainError(base, exponent) ? T(0) : PrecisionTraits<T>::pow(base, exponent);
+    }
+}
+
+template <typename T>
+bool BasicScientificCalculator<T>::isDomainError(Kernel kernel, T value) {
+    if (kernel == logKernel || kernel == log10Kernel) {
+        return value <= 0;
+    } else if (kernel == sqrtKernel) {
+        return value < 0;
+    } else if (kernel == acoshKernel) {
+        return value < 1;
+    } else if (kernel == atanhKernel) {
+        return value <= -1 || value >= 1;
+    }
+    return false;
+}
+
+template <typename T>
+bool BasicScientificCalculator<T>::isPowerDomainError(T base, T exponent) {
+    if constexpr (is_same<T, double>::value) {
+        return ScientificKernels::isPowerDomainError(base, exponent);
+    } else {
+        // exponent - exponent is 0 only for finite exponents
+        return (base == 0 && exponent < 0) ||
+               (base < 0 && exponent - exponent == 0 && PrecisionTraits<T>::fmod(exponent, T(1)) != 0);
+    }
+}
+
+template <typename T>
+typename BasicScientificCalculator<T>::Kernel BasicScientificCalculator<T>::kernelFor(const string& function) {
+    if (function == "exp") {
+        return expKernel;
+    } else if (function == "ln" || function == "log") {
+        return logKernel;
+    } else if (function == "log10") {
+        return log10Kernel;
+    } else if (function == "sqrt") {
+        return sqrtKernel;
+    } else if (function == "sinh") {
+        return sinhKernel;
+    } else if (function == "cosh") {
+        return coshKernel;
+    } else if (function == "tanh") {
+        return tanhKernel;
+    } else if (function == "asinh" || function == "arsinh") {
+        return asinhKernel;
+    } else if (function == "acosh" || function == "arcosh") {
+        return acoshKernel;
+    } else if (function == "atanh" || function == "artanh") {
+        return atanhKernel;
+    }
+    return nullptr;
+}
+
+template <typename T>
+void BasicScientificCalculator<T>::applyArray(Kernel kernel, const T* values, T* out, size_t count) {
+    if constexpr (is_same<T, double>::value) {
+        const ArrayKernels& kernels = CpuDispatch::kernels();
+        ArrayKernels::MathKernel arrayKernel = kernel == expKernel ? kernels.exponential
+                                             : kernel == logKernel ? kernels.logarithm
+                                             : kernel == log10Kernel ? kernels.logarithm10
+                                             : kernel == sqrtKernel ? kernels.squareRoot
+                                             : kernel == sinhKernel ? kernels.hyperbolicSine
+                                             : kernel == coshKernel ? kernels.hyperbolicCosine
+                                             : kernel == tanhKernel ? kernels.hyperbolicTangent
+                                             : kernel == asinhKernel ? kernels.inverseHyperbolicSine
+                                             : kernel == acoshKernel ? kernels.inverseHyperbolicCosine
+                                             : kernel == atanhKernel ? kernels.inverseHyperbolicTangent
+                                             : nullptr;
+        if (arrayKernel != nullptr) {
+            arrayKernel(values, out, count);
+            return;
+        }
+    }
+    for (size_t i = 0; i < count; i++) {
+        out[i] = kernel(values[i]);
+    }
+}
+
+template <typename T>
+void BasicScientificCalculator<T>::applyPower(const T* bases, const T* exponents, T* out, size_t count) {
+    if constexpr (is_same<T, double>::value) {
+        CpuDispatch::kernels().power(bases, exponents, out, count);
+    } else {
+        for (size_t i = 0; i < count; i++) {
+            out[i] = powerKernel(bases[i], exponents[i]);
+        }
+    }
+}
+
+template class BasicScientificCalculator<float>;
+template class BasicScientificCalculator<double>;
+template class BasicScientificCalculator<long double>;
+#ifdef CALC_HAVE_FLOAT128
+template class BasicScientificCalculator<__float128>;
+#endif
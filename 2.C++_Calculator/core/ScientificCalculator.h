@@ -0,0 +1,64 @@
+#ifndef SCIENTIFICCALCULATOR_H
+#define SCIENTIFICCALCULATOR_H
+
+#include <iostream>
+#include <cmath>
+#include <cstddef>
+#include <string>
+#include "Precision.h"
+
+// Exponential, logarithmic, power and hyperbolic functions.  double runs on
+// ScientificKernels (and CpuDispatch for arrays); the other precisions use
+// their own libm through PrecisionTraits.
+template <typename T>
+class BasicScientificCalculator {
+public:
+    typedef T (*Kernel)(T);
+
+    T exponential(T value);
+    T logarithm(T value);
+    T logarithm10(T value);
+    T squareRoot(T value);
+    T power(T base, T exponent);
+    T hyperbolicSine(T value);
+    T hyperbolicCosine(T value);
+    T hyperbolicTangent(T value);
+    T inverseHyperbolicSine(T value);
+    T inverseHyperbolicCosine(T value);
+    T inverseHyperbolicTangent(T value);
+
+    // Silent kernels shared by the member functions, batches and compiled
+    // expressions.  Domain errors return 0, like the members do: log and
+    // log10 of x <= 0, sqrt of x < 0, acosh of x < 1, atanh of |x| >= 1,
+    // pow(0, y < 0) and a negative base with a non-integer exponent.
+    static T expKernel(T value);
+    static T logKernel(T value);
+    static T log10Kernel(T value);
+    static T sqrtKernel(T value);
+    static T sinhKernel(T value);
+    static T coshKernel(T value);
+    static T tanhKernel(T value);
+    static T asinhKernel(T value);
+    static T acoshKernel(T value);
+    static T atanhKernel(T value);
+    static T powerKernel(T base, T exponent);
+
+    static bool isDomainError(Kernel kernel, T value);
+    static bool isPowerDomainError(T base, T exponent);
+
+    // Kernel for a function name ("exp", "ln", "log", "sinh", ...), or nullptr
+    static Kernel kernelFor(const std::string& function);
+    static void applyArray(Kernel kernel, const T* values, T* out, size_t count);
+    static void applyPower(const T* bases, const T* exponents, T* out, size_t count);
+};
+
+extern template class BasicScientificCalculator<float>;
+extern template class BasicScientificCalculator<double>;
+extern template class BasicScientificCalculator<long double>;
+#ifdef CALC_HAVE_FLOAT128
+extern template class BasicScientificCalculator<__float128>;
+#endif
+
+using ScientificCalculator = BasicScientificCalculator<double>;
+
+#endif // SCIENTIFICCALCULATOR_H
@@ -0,0 +1,656 @@
+#ifndef SCIENTIFICKERNELS_H
+#define SCIENTIFICKERNELS_H
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+// Exponential, logarithmic and hyperbolic kernels for double, after
+// fdlibm.  All of the exp family goes through one range reduction,
+// e^x = 2^k (1 + em1) with em1 = e^r - 1 kept to full precision, so exp,
+// sinh, cosh and tanh share it (and its coefficients) instead of calling
+// each other.  The log family shares logPositive the same way.  pow has its
+// own table-driven log and exp, which carry the extra bits y log x needs
+// without fdlibm's divisions.
+//
+// The code is branch-light on purpose: CpuDispatch runs the same operation
+// sequence on whole vectors, and both must produce the same bits.
+// Domain errors return 0 like ScientificCalculator: log/log10 of x <= 0,
+// sqrt of x < 0, acosh of x < 1, atanh of |x| >= 1, pow of a negative base
+// with a non-integer exponent and pow(0, y < 0).
+
+namespace ScientificKernels {
+
+constexpr double ln2 = 6.93147180559945286227e-01;
+constexpr double ln2Hi = 6.93147180369123816490e-01;      // trailing zeros: k * ln2Hi is exact
+constexpr double ln2Lo = 1.90821492927058770002e-10;
+constexpr double invLn2 = 1.44269504088896338700e+00;
+constexpr double expP1 = 1.66666666666666019037e-01;
+constexpr double expP2 = -2.77777777770155933842e-03;
+constexpr double expP3 = 6.61375632143793436117e-05;
+constexpr double expP4 = -1.65339022054652515390e-06;
+constexpr double expP5 = 4.13813679705723846039e-08;
+constexpr double expOverflow = 7.09782712893383973096e+02;
+constexpr double expUnderflow = -7.45133219101941108420e+02;
+constexpr double sinhOverflow = 7.10475860073943863426e+02;
+constexpr double logLg1 = 6.666666666666735130e-01;
+constexpr double logLg2 = 3.999999999940941908e-01;
+constexpr double logLg3 = 2.857142874366239149e-01;
+constexpr double logLg4 = 2.222219843214978396e-01;
+constexpr double logLg5 = 1.818357216161805012e-01;
+constexpr double logLg6 = 1.531383769920937332e-01;
+constexpr double logLg7 = 1.479819860511658591e-01;
+constexpr double invLn10 = 4.34294481903251816668e-01;
+constexpr double log10Of2Hi = 3.01029995663611771306e-01;
+constexpr double log10Of2Lo = 3.69423907715893078616e-13;
+constexpr double minNormal = 2.2250738585072014e-308;
+constexpr double two54 = 1.80143985094819840000e+16;
+constexpr double infinity = std::numeric_limits<double>::infinity();
+
+// pow runs integer exponents up to this size by repeated squaring
+constexpr int maxIntegerExponent = 64;
+
+inline uint64_t toBits(double x) {
+    uint64_t bits;
+    std::memcpy(&bits, &x, sizeof(bits));
+    return bits;
+}
+
+inline double fromBits(uint64_t bits) {
+    double x;
+    std::memcpy(&x, &bits, sizeof(x));
+    return x;
+}
+
+// 2^k for -1022 <= k <= 1023
+inline double twoPower(int k) {
+    return fromBits(uint64_t(k + 1023) << 52);
+}
+
+// e^x = 2^k (1 + em1), |r| <= ln2/2 after reducing x by k * ln2 in two parts
+struct ExpReduced {
+    double em1;
+    int k;
+};
+
+inline ExpReduced reduceExp(double x) {
+    double t = x * invLn2;
+    int k = static_cast<int>(t < 0 ? t - 0.5 : t + 0.5);
+    double dk = k;
+    double hi = x - dk * ln2Hi;
+    double lo = dk * ln2Lo;
+    double r = hi - lo;
+    double rr = r * r;
+    double c = r - rr * (expP1 + rr * (expP2 + rr * (expP3 + rr * (expP4 + rr * expP5))));
+    return ExpReduced{hi - (lo - (r * c) / (2.0 - c)), k};
+}
+
+inline double exp(double x) {
+    if (x != x) return x;
+    if (x > expOverflow) return infinity;
+    if (x < expUnderflow) return 0.0;
+    ExpReduced e = reduceExp(x);
+    double y = 1.0 + e.em1;
+    if (e.k > 1023) return y * 2.0 * twoPower(e.k - 1);
+    if (e.k < -1021) return y * twoPower(e.k + 1000) * twoPower(-1000);
+    return y * twoPower(e.k);
+}
+
+// e^x - 1 for |x| <= 44 (what the hyperbolic functions need)
+inline double expm1Reduced(const ExpReduced& e) {
+    double scale = twoPower(e.k);
+    return scale * e.em1 + (scale - 1.0);
+}
+
+// log(x) for finite x > 0: x = 2^k * m with m in [sqrt(2)/2, sqrt(2))
+inline double logPositive(double x) {
+    int k = 0;
+    if (x < minNormal) {
+        x *= two54;
+        k = -54;
+    }
+    uint64_t bits = toBits(x);
+    int32_t high = int32_t(bits >> 32);
+    k += (high >> 20) - 1023;
+    high &= 0x000fffff;
+    int32_t i = (high + 0x95f64) & 0x100000;
+    double m = fromBits((uint64_t(uint32_t(high | (i ^ 0x3ff00000))) << 32) | (bits & 0xffffffffu));
+    k += i >> 20;
+    double f = m - 1.0;
+    double dk = k;
+    double s = f / (2.0 + f);
+    double z = s * s;
+    double w = z * z;
+    double t1 = w * (logLg2 + w * (logLg4 + w * logLg6));
+    double t2 = z * (logLg1 + w * (logLg3 + w * (logLg5 + w * logLg7)));
+    double r = t2 + t1;
+    if (((high - 0x6147a) | (0x6b851 - high)) > 0) {
+        double hfsq = 0.5 * f * f;
+        return dk * ln2Hi - ((hfsq - (s * (hfsq + r) + dk * ln2Lo)) - f);
+    }
+    return dk * ln2Hi - ((s * (f - r) - dk * ln2Lo) - f);
+}
+
+// log(1 + x) for finite x >= 0; the second term is the rounding error of
+// 1 + x, scaled
+inline double log1pNonNegative(double x) {
+    double u = 1.0 + x;
+    return logPositive(u) + (x - (u - 1.0)) / u;
+}
+
+inline double log(double x) {
+    if (x != x || x == infinity) return x;
+    if (x <= 0) return 0.0;
+    return logPositive(x);
+}
+
+// k * log10(2) + log10(m) with m in [1, 2) or [1/2, 1)
+inline double log10(double x) {
+    if (x != x || x == infinity) return x;
+    if (x <= 0) return 0.0;
+    int k = 0;
+    if (x < minNormal) {
+        x *= two54;
+        k = -54;
+    }
+    uint64_t bits = toBits(x);
+    int32_t high = int32_t(bits >> 32);
+    k += (high >> 20) - 1023;
+    int32_t negative = k < 0 ? 1 : 0;
+    high = (high & 0x000fffff) | ((0x3ff - negative) << 20);
+    double y = k + negative;
+    double m = fromBits((uint64_t(uint32_t(high)) << 32) | (bits & 0xffffffffu));
+    double z = y * log10Of2Lo + invLn10 * logPositive(m);
+    return z + y * log10Of2Hi;
+}
+
+inline double sqrt(double x) {
+    return x < 0 ? 0.0 : std::sqrt(x);
+}
+
+inline double sinh(double x) {
+    double h = x < 0 ? -0.5 : 0.5;
+    double ax = std::fabs(x);
+    if (!(ax < 22.0)) {
+        if (x != x) return x;
+        if (ax < expOverflow) return h * exp(ax);
+        if (ax <= sinhOverflow) {
+            double w = exp(0.5 * ax);
+            return h * w * w;
+        }
+        return h * infinity;
+    }
+    if (ax < 0x1p-28) return x;
+    double t = expm1Reduced(reduceExp(ax));
+    if (ax < 1.0) return h * (2.0 * t - t * t / (t + 1.0));
+    return h * (t + t / (t + 1.0));
+}
+
+inline double cosh(double x) {
+    if (x != x) return x;
+    double ax = std::fabs(x);
+    if (ax < 0.5 * ln2) {
+        double t = expm1Reduced(reduceExp(ax));
+        double w = 1.0 + t;
+        return 1.0 + (t * t) / (w + w);
+    }
+    if (ax < 22.0) {
+        double t = exp(ax);
+        return 0.5 * t + 0.5 / t;
+    }
+    if (ax < expOverflow) return 0.5 * exp(ax);
+    if (ax <= sinhOverflow) {
+        double w = exp(0.5 * ax);
+        return 0.5 * w * w;
+    }
+    return infinity;
+}
+
+inline double tanh(double x) {
+    if (x != x) return x;
+    double ax = std::fabs(x);
+    if (ax < 0x1p-55) return x;
+    double z = 1.0;
+    if (ax < 22.0) {
+        double t = expm1Reduced(reduceExp(ax >= 1.0 ? 2.0 * ax : -2.0 * ax));
+        z = ax >= 1.0 ? 1.0 - 2.0 / (t + 2.0) : -t / (t + 2.0);
+    }
+    return x < 0 ? -z : z;
+}
+
+// One log per call: the three ranges only differ in the argument
+inline double asinh(double x) {
+    double ax = std::fabs(x);
+    if (!(ax < infinity)) return x + x;
+    if (ax < 0x1p-28) return x;
+    double w;
+    if (ax > 0x1p28) {
+        w = logPositive(ax) + ln2;
+    } else if (ax > 2.0) {
+        w = logPositive(2.0 * ax + 1.0 / (std::sqrt(x * x + 1.0) + ax));
+    } else {
+        w = log1pNonNegative(ax + x * x / (1.0 + std::sqrt(x * x + 1.0)));
+    }
+    return x > 0 ? w : -w;
+}
+
+inline double acosh(double x) {
+    if (x != x) return x;
+    if (x < 1.0) return 0.0;
+    if (x > 0x1p28) return x == infinity ? x : logPositive(x) + ln2;
+    if (x > 2.0) return logPositive(2.0 * x - 1.0 / (x + std::sqrt(x * x - 1.0)));
+    double t = x - 1.0;
+    return log1pNonNegative(t + std::sqrt(2.0 * t + t * t));
+}
+
+inline double atanh(double x) {
+    if (x != x) return x;
+    double ax = std::fabs(x);
+    if (ax >= 1.0) return 0.0;
+    if (ax < 0x1p-28) return x;
+    double t = ax < 0.5 ? 0.5 * log1pNonNegative(2.0 * ax + 2.0 * ax * ax / (1.0 - ax))
+                        : 0.5 * log1pNonNegative((ax + ax) / (1.0 - ax));
+    return x < 0 ? -t : t;
+}
+
+// x^n by repeated squaring: exact whenever every partial product is
+// representable (2^10, 1.5^3, -3^5)
+inline double powInteger(double x, int n) {
+    unsigned m = n < 0 ? unsigned(-n) : unsigned(n);
+    double result = 1.0;
+    double base = x;
+    while (m != 0) {
+        if (m & 1) result *= base;
+        base *= base;
+        m >>= 1;
+    }
+    return n < 0 ? 1.0 / result : result;
+}
+
+inline bool isPowerDomainError(double x, double y) {
+    return (x == 0 && y < 0) || (x < 0 && std::fabs(y) < infinity && y != std::trunc(y));
+}
+
+// pow's tables, after ARM's optimized-routines.  The log table covers
+// z in [0x1.6955p-1, 0x1.6955p+0) in 128 steps of the top significand bits,
+// with rows {invc, logc, logcTail}: invc is 1/c for a c inside the step with
+// at most 8 significant bits (1 on the steps around 1), and logc + logcTail
+// = -log(invc) to about 100 bits with logc a multiple of 2^-43, so
+// k * powLn2Hi + logc is exact.
+constexpr int powTableBits = 7;
+constexpr uint64_t powLogOffset = 0x3fe6955500000000ull;
+constexpr double powLn2Hi = 0x1.62e42fefa38p-1;
+constexpr double powLn2Lo = 0x1.ef35793c7673p-45;
+
+constexpr double powLogTable[3 << powTableBits] = {
+    0x1.6ap+0, -0x1.62c82f2b9c8p-2, 0x1.ab4242837568p-48,
+    0x1.68p+0, -0x1.5d1bdbf5808p-2, -0x1.ca508d8e0f72p-46,
+    0x1.66p+0, -0x1.57677174558p-2, -0x1.362a4d5b6506dp-45,
+    0x1.64p+0, -0x1.51aad872df8p-2, -0x1.684e49eb067d5p-49,
+    0x1.62p+0, -0x1.4be5f957778p-2, -0x1.41b6993293eep-47,
+    0x1.6p+0, -0x1.4618bc21c6p-2, 0x1.3d82f484c84ccp-46,
+    0x1.5ep+0, -0x1.404308686a8p-2, 0x1.c42f3ed820b3ap-50,
+    0x1.5cp+0, -0x1.3a64c556948p-2, 0x1.0b1c68651946p-45,
+    0x1.5ap+0, -0x1.347dd9a988p-2, 0x1.5594dd4c58092p-45,
+    0x1.58p+0, -0x1.2e8e2bae12p-2, 0x1.67b1e99b72bd8p-45,
+    0x1.56p+0, -0x1.2895a13de88p-2, 0x1.5ca14b6cfb03fp-46,
+    0x1.56p+0, -0x1.2895a13de88p-2, 0x1.5ca14b6cfb03fp-46,
+    0x1.54p+0, -0x1.22941fbcf78p-2, -0x1.65a242853da76p-46,
+    0x1.52p+0, -0x1.1c898c16998p-2, -0x1.fafbc68e75404p-46,
+    0x1.5p+0, -0x1.1675cababa8p-2, 0x1.f1fc63382a8fp-46,
+    0x1.4ep+0, -0x1.1058bf9ae48p-2, -0x1.6a8c4fd055a66p-45,
+    0x1.4cp+0, -0x1.0a324e2739p-2, -0x1.c6bee7ef4030ep-47,
+    0x1.4ap+0, -0x1.0402594b4dp-2, -0x1.036b89ef42d7fp-48,
+    0x1.4ap+0, -0x1.0402594b4dp-2, -0x1.036b89ef42d7fp-48,
+    0x1.48p+0, -0x1.fb9186d5e4p-3, 0x1.d572aab993c87p-47,
+    0x1.46p+0, -0x1.ef0adcbdc6p-3, 0x1.b26b79c86af24p-45,
+    0x1.44p+0, -0x1.e27076e2afp-3, -0x1.72f4f543fff1p-46,
+    0x1.42p+0, -0x1.d5c216b4fcp-3, 0x1.1ba91bbca681bp-45,
+    0x1.4p+0, -0x1.c8ff7c79aap-3, 0x1.7794f689f8434p-45,
+    0x1.4p+0, -0x1.c8ff7c79aap-3, 0x1.7794f689f8434p-45,
+    0x1.3ep+0, -0x1.bc286742d9p-3, 0x1.94eb0318bb78fp-46,
+    0x1.3cp+0, -0x1.af3c94e80cp-3, 0x1.a4e633fcd9066p-52,
+    0x1.3ap+0, -0x1.a23bc1fe2bp-3, -0x1.58c64dc46c1eap-45,
+    0x1.3ap+0, -0x1.a23bc1fe2bp-3, -0x1.58c64dc46c1eap-45,
+    0x1.38p+0, -0x1.9525a9cf45p-3, -0x1.ad1d904c1d4e3p-45,
+    0x1.36p+0, -0x1.87fa06520dp-3, 0x1.bbdbf7fdbfa09p-45,
+    0x1.34p+0, -0x1.7ab890210ep-3, 0x1.bdb9072534a58p-45,
+    0x1.34p+0, -0x1.7ab890210ep-3, 0x1.bdb9072534a58p-45,
+    0x1.32p+0, -0x1.6d60fe719dp-3, -0x1.0e46aa3b2e266p-46,
+    0x1.3p+0, -0x1.5ff3070a79p-3, -0x1.e9e439f105039p-46,
+    0x1.3p+0, -0x1.5ff3070a79p-3, -0x1.e9e439f105039p-46,
+    0x1.2ep+0, -0x1.526e5e3a1bp-3, -0x1.0de8b90075b8fp-45,
+    0x1.2cp+0, -0x1.44d2b6ccb8p-3, 0x1.70cc16135783cp-46,
+    0x1.2cp+0, -0x1.44d2b6ccb8p-3, 0x1.70cc16135783cp-46,
+    0x1.2ap+0, -0x1.371fc201e9p-3, 0x1.178864d27543ap-48,
+    0x1.28p+0, -0x1.29552f81ffp-3, -0x1.48d301771c408p-45,
+    0x1.26p+0, -0x1.1b72ad52f6p-3, -0x1.e80a41811a396p-45,
+    0x1.26p+0, -0x1.1b72ad52f6p-3, -0x1.e80a41811a396p-45,
+    0x1.24p+0, -0x1.0d77e7cd09p-3, 0x1.a699688e85bf4p-47,
+    0x1.24p+0, -0x1.0d77e7cd09p-3, 0x1.a699688e85bf4p-47,
+    0x1.22p+0, -0x1.fec9131dbep-4, -0x1.575545ca333f2p-45,
+    0x1.2p+0, -0x1.e27076e2bp-4, 0x1.a342c2af0003cp-45,
+    0x1.2p+0, -0x1.e27076e2bp-4, 0x1.a342c2af0003cp-45,
+    0x1.1ep+0, -0x1.c5e548f5bcp-4, -0x1.d0c57585fbe06p-46,
+    0x1.1cp+0, -0x1.a926d3a4aep-4, 0x1.53935e85baac8p-45,
+    0x1.1cp+0, -0x1.a926d3a4aep-4, 0x1.53935e85baac8p-45,
+    0x1.1ap+0, -0x1.8c345d631ap-4, 0x1.37c294d2f5668p-46,
+    0x1.1ap+0, -0x1.8c345d631ap-4, 0x1.37c294d2f5668p-46,
+    0x1.18p+0, -0x1.6f0d28ae56p-4, -0x1.69737c93373dap-45,
+    0x1.16p+0, -0x1.51b073f062p-4, 0x1.f025b61c65e57p-46,
+    0x1.16p+0, -0x1.51b073f062p-4, 0x1.f025b61c65e57p-46,
+    0x1.14p+0, -0x1.341d7961bep-4, 0x1.c5edaccf913dfp-45,
+    0x1.14p+0, -0x1.341d7961bep-4, 0x1.c5edaccf913dfp-45,
+    0x1.12p+0, -0x1.16536eea38p-4, 0x1.47c5e768fa309p-46,
+    0x1.1p+0, -0x1.f0a30c0118p-5, 0x1.d599e83368e91p-45,
+    0x1.1p+0, -0x1.f0a30c0118p-5, 0x1.d599e83368e91p-45,
+    0x1.0ep+0, -0x1.b42dd71198p-5, 0x1.c827ae5d6704cp-46,
+    0x1.0ep+0, -0x1.b42dd71198p-5, 0x1.c827ae5d6704cp-46,
+    0x1.0cp+0, -0x1.77458f632cp-5, -0x1.cfc4634f2a1eep-45,
+    0x1.0cp+0, -0x1.77458f632cp-5, -0x1.cfc4634f2a1eep-45,
+    0x1.0ap+0, -0x1.39e87b9fecp-5, 0x1.502b7f526feaap-48,
+    0x1.0ap+0, -0x1.39e87b9fecp-5, 0x1.502b7f526feaap-48,
+    0x1.08p+0, -0x1.f829b0e78p-6, -0x1.980267c7e09e4p-45,
+    0x1.08p+0, -0x1.f829b0e78p-6, -0x1.980267c7e09e4p-45,
+    0x1.06p+0, -0x1.7b91b07d58p-6, -0x1.88d5493faa639p-45,
+    0x1.04p+0, -0x1.fc0a8b0fcp-7, -0x1.f1e7cf6d3a69cp-50,
+    0x1.04p+0, -0x1.fc0a8b0fcp-7, -0x1.f1e7cf6d3a69cp-50,
+    0x1.02p+0, -0x1.fe02a6b1p-8, -0x1.9e23f0dda40e4p-46,
+    0x1.02p+0, -0x1.fe02a6b1p-8, -0x1.9e23f0dda40e4p-46,
+    0x1p+0, 0x0p+0, 0x0p+0,
+    0x1p+0, 0x0p+0, 0x0p+0,
+    0x1.fcp-1, 0x1.010157589p-7, -0x1.0c76b999d2be8p-46,
+    0x1.f8p-1, 0x1.0205658938p-6, -0x1.3dc5b06e2f7d2p-45,
+    0x1.f4p-1, 0x1.8492528c9p-6, -0x1.aa0ba325a0c34p-45,
+    0x1.fp-1, 0x1.0415d89e74p-5, 0x1.111c05cf1d753p-47,
+    0x1.ecp-1, 0x1.466aed42ep-5, -0x1.c167375bdfd28p-45,
+    0x1.e8p-1, 0x1.894aa149fcp-5, -0x1.97995d05a267dp-46,
+    0x1.e4p-1, 0x1.ccb73cdddcp-5, -0x1.a68f247d82807p-46,
+    0x1.e2p-1, 0x1.eea31c006cp-5, -0x1.e113e4fc93b7bp-47,
+    0x1.dep-1, 0x1.1973bd1466p-4, -0x1.5325d560d9e9bp-45,
+    0x1.dap-1, 0x1.3bdf5a7d1ep-4, 0x1.cc85ea5db4ed7p-45,
+    0x1.d6p-1, 0x1.5e95a4d97ap-4, -0x1.c69063c5d1d1ep-45,
+    0x1.d4p-1, 0x1.700d30aeacp-4, 0x1.c1e8da99ded32p-49,
+    0x1.dp-1, 0x1.9335e5d594p-4, 0x1.3115c3abd47dap-45,
+    0x1.ccp-1, 0x1.b6ac88dad6p-4, -0x1.390802bf768e5p-46,
+    0x1.cap-1, 0x1.c885801bc4p-4, 0x1.646d1c65aacd3p-45,
+    0x1.c6p-1, 0x1.ec739830a2p-4, -0x1.dc068afe645ep-45,
+    0x1.c4p-1, 0x1.fe89139dbep-4, -0x1.534d64fa10afdp-45,
+    0x1.cp-1, 0x1.1178e8227ep-3, 0x1.1ef78ce2d07f2p-45,
+    0x1.bep-1, 0x1.1aa2b7e23fp-3, 0x1.ca78e44389934p-45,
+    0x1.bap-1, 0x1.2d1610c868p-3, 0x1.39d6ccb81b4a1p-47,
+    0x1.b8p-1, 0x1.365fcb0159p-3, 0x1.62fa8234b7289p-51,
+    0x1.b4p-1, 0x1.4913d8333bp-3, 0x1.5837954fdb678p-45,
+    0x1.b2p-1, 0x1.527e5e4a1bp-3, 0x1.633e8e5697dc7p-45,
+    0x1.aep-1, 0x1.6574ebe8c1p-3, 0x1.9cf8b2c3c2e78p-46,
+    0x1.acp-1, 0x1.6f0128b757p-3, -0x1.5118de59c21e1p-45,
+    0x1.aap-1, 0x1.7898d85445p-3, -0x1.c661070914305p-46,
+    0x1.a6p-1, 0x1.8beafeb39p-3, -0x1.73d54aae92cd1p-47,
+    0x1.a4p-1, 0x1.95a5adcf7p-3, 0x1.7f22858a0ff6fp-47,
+    0x1.ap-1, 0x1.a93ed3c8aep-3, -0x1.8724350562169p-45,
+    0x1.9ep-1, 0x1.b31d8575bdp-3, -0x1.c358d4eace1aap-47,
+    0x1.9cp-1, 0x1.bd087383bep-3, -0x1.d4bc4595412b6p-45,
+    0x1.9ap-1, 0x1.c6ffbc6f01p-3, -0x1.1ec72c5962bd2p-48,
+    0x1.96p-1, 0x1.db13db0d49p-3, -0x1.aff2af715b035p-45,
+    0x1.94p-1, 0x1.e530effe71p-3, 0x1.212276041f43p-51,
+    0x1.92p-1, 0x1.ef5ade4ddp-3, -0x1.a211565bb8e11p-51,
+    0x1.9p-1, 0x1.f991c6cb3bp-3, 0x1.bcbecca0cdf3p-46,
+    0x1.8cp-1, 0x1.07138604d58p-2, 0x1.89cdb16ed4e91p-48,
+    0x1.8ap-1, 0x1.0c42d67616p-2, 0x1.7188b163ceae9p-45,
+    0x1.88p-1, 0x1.1178e8227e8p-2, -0x1.c210e63a5f01cp-45,
+    0x1.86p-1, 0x1.16b5ccbacf8p-2, 0x1.b9acdf7a51681p-45,
+    0x1.84p-1, 0x1.1bf99635a68p-2, 0x1.ca6ed5147bdb7p-45,
+    0x1.82p-1, 0x1.214456d0eb8p-2, 0x1.a87deba46baeap-47,
+    0x1.7ep-1, 0x1.2bef07cdc9p-2, 0x1.a9cfa4a5004f4p-45,
+    0x1.7cp-1, 0x1.314f1e1d36p-2, -0x1.8e27ad3213cb8p-45,
+    0x1.7ap-1, 0x1.36b6776be1p-2, 0x1.16ecdb0f177c8p-46,
+    0x1.78p-1, 0x1.3c25277333p-2, 0x1.83b54b606bd5cp-46,
+    0x1.76p-1, 0x1.419b423d5e8p-2, 0x1.8e436ec90e09dp-47,
+    0x1.74p-1, 0x1.4718dc271c8p-2, -0x1.f27ce0967d675p-45,
+    0x1.72p-1, 0x1.4c9e09e173p-2, -0x1.e20891b0ad8a4p-45,
+    0x1.7p-1, 0x1.522ae0738ap-2, 0x1.ebe708164c759p-45,
+    0x1.6ep-1, 0x1.57bf753c8dp-2, 0x1.fadedee5d40efp-46,
+    0x1.6cp-1, 0x1.5d5bddf596p-2, -0x1.a0b2a08a465dcp-47,
+};
+
+// log(1 + r) - r + r^2/2 = -r^2/2 * r * (powA1 + r powA2 + ...), Taylor
+// terms through r^10 for |r| < 0.008
+constexpr double powA1 = -2.0 / 3.0;
+constexpr double powA2 = 0.5;
+constexpr double powA3 = 0.8;
+constexpr double powA4 = -2.0 / 3.0;
+constexpr double powA5 = -8.0 / 7.0;
+constexpr double powA6 = 1.0;
+constexpr double powA7 = 16.0 / 9.0;
+constexpr double powA8 = -1.6;
+
+// 2^(j/128) = s (1 + tail) as pairs {tail, s with j << 45 taken off its
+// bits}, so adding k << 45 to the second for k = 128 n + j gives 2^n s
+constexpr double powExpTable[2 << powTableBits] = {
+    0x0p+0, 0x1p+0,
+    0x1.b3b4f1a88bf6ep-54, 0x1.ff63da9fb3335p-1,
+    -0x1.160139cd8dc5cp-56, 0x1.fec9a3e778061p-1,
+    -0x1.05e7a108766d1p-54, 0x1.fe315e86e7f85p-1,
+    0x1.cd2523567f613p-55, 0x1.fd9b0d3158574p-1,
+    -0x1.bce8023f98efap-55, 0x1.fd06b29ddf6dep-1,
+    0x1.0f74e61e6c861p-57, 0x1.fc74518759bc8p-1,
+    0x1.0a3e45b33d399p-54, 0x1.fbe3ecac6f383p-1,
+    0x1.79aa65d837b6dp-54, 0x1.fb5586cf9890fp-1,
+    0x1.eb51a92fdeffcp-55, 0x1.fac922b7247f7p-1,
+    0x1.ebe3d702f9cd1p-60, 0x1.fa3ec32d3d1a2p-1,
+    -0x1.a033489906e0bp-57, 0x1.f9b66affed31bp-1,
+    -0x1.556522a2fbd0ep-54, 0x1.f9301d0125b51p-1,
+    -0x1.080ef8c4eea55p-58, 0x1.f8abdc06c31ccp-1,
+    -0x1.1c923b9d5f416p-54, 0x1.f829aaea92dep-1,
+    0x1.0d3e3e95c55afp-55, 0x1.f7a98c8a58e51p-1,
+    -0x1.01b15eaa59348p-55, 0x1.f72b83c7d517bp-1,
+    -0x1.f1ff055de323dp-55, 0x1.f6af9388c8deap-1,
+    0x1.b898c3f1353bfp-55, 0x1.f635beb6fcb75p-1,
+    -0x1.6d99c7611eb26p-54, 0x1.f5be084045cd4p-1,
+    0x1.aecf73e3a2f6p-54, 0x1.f54873168b9aap-1,
+    -0x1.fe782cb86389dp-55, 0x1.f4d5022fcd91dp-1,
+    0x1.a6f4144a6c38dp-55, 0x1.f463b88628cd6p-1,
+    0x1.07a05b0e4047dp-55, 0x1.f3f49917ddc96p-1,
+    0x1.68efde3a8a894p-54, 0x1.f387a6e756238p-1,
+    0x1.75e18f274487dp-55, 0x1.f31ce4fb2a63fp-1,
+    0x1.0472b981fe7f2p-55, 0x1.f2b4565e27cddp-1,
+    -0x1.6b87b3f71085ep-54, 0x1.f24dfe1f56381p-1,
+    0x1.2f7e16d09ab31p-55, 0x1.f1e9df51fdee1p-1,
+    -0x1.d219b1a6fbffbp-60, 0x1.f187fd0dad99p-1,
+    0x1.b3782720c0ab4p-55, 0x1.f1285a6e4030bp-1,
+    0x1.e149289cecb8fp-57, 0x1.f0cafa93e2f56p-1,
+    0x1.34d754db0abb6p-55, 0x1.f06fe0a31b715p-1,
+    0x1.64201e2ac744cp-55, 0x1.f0170fc4cd831p-1,
+    0x1.fdd395dd3f84ap-55, 0x1.efc08b26416ffp-1,
+    -0x1.6a3803b8e5b04p-55, 0x1.ef6c55f929ff1p-1,
+    -0x1.24aedcc4b5068p-54, 0x1.ef1a7373aa9cbp-1,
+    -0x1.907f81b512d8ep-54, 0x1.eecae6d05d866p-1,
+    -0x1.1d1e83e9436d2p-56, 0x1.ee7db34e59ff7p-1,
+    -0x1.91919b3ce1b15p-54, 0x1.ee32dc313a8e5p-1,
+    0x1.59f48a72a4c6dp-55, 0x1.edea64c123422p-1,
+    -0x1.312607a28698ap-54, 0x1.eda4504ac801cp-1,
+    -0x1.8a78f4817895bp-58, 0x1.ed60a21f72e2ap-1,
+    -0x1.c2c9b67499a1bp-56, 0x1.ed1f5d950a897p-1,
+    0x1.363ed60c2ac12p-59, 0x1.ece086061892dp-1,
+    0x1.666093b0664efp-54, 0x1.eca41ed1d0057p-1,
+    0x1.ecce1daa10379p-57, 0x1.ec6a2b5c13cdp-1,
+    0x1.3ff8e3f0f123p-54, 0x1.ec32af0d7d3dep-1,
+    0x1.690cebb7aafbp-56, 0x1.ebfdad5362a27p-1,
+    0x1.31dbdeb54e077p-54, 0x1.ebcb299fddd0dp-1,
+    -0x1.f94340071a38ep-55, 0x1.eb9b2769d2ca7p-1,
+    -0x1.7deccdc93a349p-55, 0x1.eb6daa2cf6642p-1,
+    -0x1.8dec6bd0f385fp-56, 0x1.eb42b569d4f82p-1,
+    -0x1.61246ec7b5cf6p-55, 0x1.eb1a4ca5d920fp-1,
+    0x1.3350518fdd78ep-54, 0x1.eaf4736b527dap-1,
+    0x1.b98b72f8a9b05p-56, 0x1.ead12d497c7fdp-1,
+    0x1.063e1e21c5409p-54, 0x1.eab07dd485429p-1,
+    0x1.4c7855019c6eap-60, 0x1.ea9268a5946b7p-1,
+    0x1.432e62b64c035p-54, 0x1.ea76f15ad2148p-1,
+    -0x1.ce44a6199769fp-55, 0x1.ea5e1b976dc09p-1,
+    -0x1.c33c53bef4da8p-55, 0x1.ea47eb03a5585p-1,
+    -0x1.45378892be9aep-55, 0x1.ea34634ccc32p-1,
+    -0x1.3cedd78565858p-54, 0x1.ea23882552225p-1,
+    0x1.710aa807e1964p-58, 0x1.ea155d44ca973p-1,
+    -0x1.3b3efbf5e2228p-54, 0x1.ea09e667f3bcdp-1,
+    -0x1.a12ad8734b982p-57, 0x1.ea012750bdabfp-1,
+    -0x1.367efb86da9eep-57, 0x1.e9fb23c651a2fp-1,
+    -0x1.0dc3d54e08851p-55, 0x1.e9f7df9519484p-1,
+    -0x1.81f647e5a3ecfp-56, 0x1.e9f75e8ec5f74p-1,
+    -0x1.6ee4ac08b7dbp-55, 0x1.e9f9a48a58174p-1,
+    -0x1.619321e55e68ap-55, 0x1.e9feb564267c9p-1,
+    0x1.09ccb5e09d4d3p-54, 0x1.ea0694fde5d3fp-1,
+    -0x1.b32dcb94da51dp-56, 0x1.ea11473eb0187p-1,
+    0x1.4ecfd5467c06bp-54, 0x1.ea1ed0130c132p-1,
+    0x1.5ebe1abd66c55p-57, 0x1.ea2f336cf4e62p-1,
+    -0x1.8a1c52fb3cf42p-55, 0x1.ea427543e1a12p-1,
+    -0x1.369b6f13b3734p-54, 0x1.ea589994cce13p-1,
+    -0x1.05e843a19ff1ep-55, 0x1.ea71a4623c7adp-1,
+    -0x1.4d450d872576ep-54, 0x1.ea8d99b4492edp-1,
+    0x1.0ad675b0e8ap-54, 0x1.eaac7d98a6699p-1,
+    0x1.db72fc1f0eab4p-55, 0x1.eace5422aa0dbp-1,
+    -0x1.5b6609cc5e7ffp-57, 0x1.eaf3216b5448cp-1,
+    0x1.bf68359f35f44p-56, 0x1.eb1ae99157736p-1,
+    -0x1.3091fa71e3d83p-54, 0x1.eb45b0b91ffc6p-1,
+    -0x1.da9b88b6c1e29p-58, 0x1.eb737b0cdc5e5p-1,
+    -0x1.c23f97c90b959p-57, 0x1.eba44cbc8520fp-1,
+    -0x1.2434322f4f9aap-54, 0x1.ebd829fde4e5p-1,
+    -0x1.5ca6cd7668e4bp-55, 0x1.ec0f170ca07bap-1,
+    0x1.1affc2b91ce27p-56, 0x1.ec49182a3f09p-1,
+    0x1.dd235e10a73bbp-57, 0x1.ec86319e32323p-1,
+    -0x1.7c50422622263p-55, 0x1.ecc667b5de565p-1,
+    0x1.b1c86e3e231d5p-55, 0x1.ed09bec4a2d33p-1,
+    -0x1.1bbd1d3bcbb15p-54, 0x1.ed503b23e255dp-1,
+    0x1.0cc319cee31d2p-54, 0x1.ed99e1330b358p-1,
+    0x1.469846e735ab3p-55, 0x1.ede6b5579fdbfp-1,
+    -0x1.2dfcd978e9db4p-55, 0x1.ee36bbfd3f37ap-1,
+    0x1.c1a7792cb3387p-55, 0x1.ee89f995ad3adp-1,
+    -0x1.07b8f4ad1d9fap-54, 0x1.eee07298db666p-1,
+    -0x1.5c3d956dcaebap-58, 0x1.ef3a2b84f15fbp-1,
+    -0x1.0a40e3da6f64p-54, 0x1.ef9728de5593ap-1,
+    -0x1.8d6f438ad9334p-57, 0x1.eff76f2fb5e47p-1,
+    -0x1.1eee26b588a35p-54, 0x1.f05b030a1064ap-1,
+    0x1.4ffd70a5fddcdp-56, 0x1.f0c1e904bc1d2p-1,
+    -0x1.1bdfbfa9298acp-54, 0x1.f12c25bd71e09p-1,
+    0x1.36eae30af0cb3p-56, 0x1.f199bdd85529cp-1,
+    0x1.ee3325c9ffd94p-55, 0x1.f20ab5fffd07ap-1,
+    0x1.4e08fd10959acp-55, 0x1.f27f12e57d14bp-1,
+    0x1.3cdaf384e1a67p-57, 0x1.f2f6d9406e7b5p-1,
+    0x1.76b2c6c921968p-57, 0x1.f3720dcef9069p-1,
+    -0x1.08a1883ccb5d2p-55, 0x1.f3f0b555dc3fap-1,
+    -0x1.fad5d3ffffa6fp-55, 0x1.f472d4a07897cp-1,
+    -0x1.00dae3875a949p-54, 0x1.f4f87080d89f2p-1,
+    0x1.4a385a63d07a7p-56, 0x1.f5818dcfba487p-1,
+    -0x1.2919e2040220fp-55, 0x1.f60e316c98398p-1,
+    0x1.e5a50d5c192acp-55, 0x1.f69e603db3285p-1,
+    0x1.43a59ac016b4bp-55, 0x1.f7321f301b46p-1,
+    -0x1.2d52107b43e1fp-55, 0x1.f7c97337b9b5fp-1,
+    -0x1.92ab93b470dc9p-55, 0x1.f864614f5a129p-1,
+    0x1.4b604603a88d3p-56, 0x1.f902ee78b3ff6p-1,
+    0x1.3c5ec519d7271p-55, 0x1.f9a51fbc74c83p-1,
+    -0x1.ff7128fd391fp-55, 0x1.fa4afa2a490dap-1,
+    -0x1.dae98e223747dp-55, 0x1.faf482d8e67f1p-1,
+    0x1.ec3bc41aa2008p-55, 0x1.fba1bee615a27p-1,
+    0x1.42b94c3a9eb32p-55, 0x1.fc52b376bba97p-1,
+    0x1.a64a931d185eep-55, 0x1.fd0765b6e454p-1,
+    -0x1.e37bae43be3edp-55, 0x1.fdbfdad9cbe14p-1,
+    0x1.7893b4d91cd9dp-56, 0x1.fe7c1819e90d8p-1,
+    0x1.305c14160cc89p-58, 0x1.ff3c22b8f71f1p-1,
+};
+
+constexpr double powInvLn2N = 0x1.71547652b82fep+7;      // 128 / ln2
+constexpr double powLn2HiN = 0x1.62e42fefap-8;           // ln2 / 128, k * powLn2HiN exact
+constexpr double powLn2LoN = 0x1.cf79abc9e3b3ap-47;
+constexpr double powShift = 0x1.8p52;
+constexpr double powC2 = 0.5;
+constexpr double powC3 = 1.0 / 6.0;
+constexpr double powC4 = 1.0 / 24.0;
+constexpr double powC5 = 1.0 / 120.0;
+
+// e^(y log x) stays normal for exponents in this range
+constexpr double powExpMinimum = -707.0;
+constexpr double powExpMaximum = 709.0;
+
+// log(x) = hi + lo to about 68 bits for normal x > 0: x = 2^k z, and
+// log(z) = log(c) + log1p(z/c - 1) with r = z/c - 1 split so that
+// zHi * invc - 1 and the r^2/2 head are exact
+inline void logExtended(double x, double& hi, double& lo) {
+    uint64_t bits = toBits(x);
+    uint64_t offset = bits - powLogOffset;
+    int i = int((offset >> (52 - powTableBits)) & ((1 << powTableBits) - 1));
+    double k = double(int64_t(offset) >> 52);
+    uint64_t zBits = bits - (offset & 0xfff0000000000000ull);
+    double z = fromBits(zBits);
+    double invc = powLogTable[3 * i];
+    double logc = powLogTable[3 * i + 1];
+    double logcTail = powLogTable[3 * i + 2];
+
+    double zHi = fromBits((zBits + 0x80000000ull) & 0xffffffff00000000ull);
+    double zLo = z - zHi;
+    double rHi = zHi * invc - 1.0;
+    double rLo = zLo * invc;
+    double r = rHi + rLo;
+
+    double t1 = k * powLn2Hi + logc;
+    double t2 = t1 + r;
+    double lo1 = k * powLn2Lo + logcTail;
+    double lo2 = t1 - t2 + r;
+    double ar = -0.5 * r;
+    double ar2 = r * ar;
+    double ar3 = r * ar2;
+    double arHi = -0.5 * rHi;
+    double arHi2 = rHi * arHi;
+    double head = t2 + arHi2;
+    double lo3 = rLo * (ar + arHi);
+    double lo4 = t2 - head + arHi2;
+    double p = ar3 * (powA1 + r * powA2 + ar2 * (powA3 + r * powA4 + ar2 * (powA5 + r * powA6 +
+               ar2 * (powA7 + r * powA8))));
+    double tail = lo1 + lo2 + lo3 + lo4 + p;
+    hi = head + tail;
+    lo = head - hi + tail;
+}
+
+// e^(hi + lo) for powExpMinimum < hi < powExpMaximum: hi + lo = k ln2/128 + r
+// with |r| <= ln2/256, 2^(k/128) from the table and e^r - 1 by Taylor
+inline double expExtended(double hi, double lo) {
+    double kd = hi * powInvLn2N + powShift;
+    uint64_t ki = toBits(kd);
+    kd -= powShift;
+    double r = hi - kd * powLn2HiN - kd * powLn2LoN;
+    r += lo;
+    unsigned j = unsigned(ki & ((1 << powTableBits) - 1));
+    double tail = powExpTable[2 * j];
+    double scale = fromBits(toBits(powExpTable[2 * j + 1]) + (ki << (52 - powTableBits)));
+    double r2 = r * r;
+    double t = tail + r + r2 * (powC2 + r * powC3) + r2 * r2 * (powC4 + r * powC5);
+    return scale + scale * t;
+}
+
+// Integer exponents up to 64 by squaring; otherwise e^(y log x) with y and
+// log x split in two so the product keeps its low bits.  Positive normal
+// bases with other exponents are the common case and are tested first;
+// subnormal bases and results that overflow or leave the normal range go
+// to libm.
+inline double pow(double x, double y) {
+    bool integer = std::fabs(y) <= maxIntegerExponent && y == static_cast<double>(static_cast<int>(y));
+    if (!integer && x >= minNormal && x < infinity) {
+        double hi, lo;
+        logExtended(x, hi, lo);
+        double yHi = fromBits(toBits(y) & 0xfffffffff8000000ull);
+        double lHi = fromBits(toBits(hi) & 0xfffffffff8000000ull);
+        double lLo = hi - lHi + lo;
+        double eHi = yHi * lHi;
+        double eLo = (y - yHi) * lHi + y * lLo;
+        if (eHi > powExpMinimum && eHi < powExpMaximum) {
+            return expExtended(eHi, eLo);
+        }
+        return std::pow(x, y);
+    }
+    if (isPowerDomainError(x, y)) return 0.0;
+    if (integer) return powInteger(x, static_cast<int>(y));
+    return std::pow(x, y);
+}
+
+} // namespace ScientificKernels
+
+#endif // SCIENTIFICKERNELS_H
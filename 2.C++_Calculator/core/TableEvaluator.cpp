@@ -0,0 +1,506 @@
+#include "TableEvaluator.h"
+#include "Expression.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <thread>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define CALC_HAVE_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace {
+
+const char binaryMagic[8] = {'C', 'A', 'L', 'C', 'T', 'B', 'L', '1'};
+const size_t columnAlignment = 64;
+const size_t evaluationBlock = 1024;       // rows per thread work unit
+const size_t outputChunk = size_t(1) << 20; // rows per write to disk
+
+size_t alignUp(size_t value, size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+string trim(const string& text) {
+    size_t begin = text.find_first_not_of(" \t\r\"");
+    if (begin == string::npos) {
+        return "";
+    }
+    size_t end = text.find_last_not_of(" \t\r\"");
+    return text.substr(begin, end - begin + 1);
+}
+
+// Runs body(begin, end) over [0, count) split across threads
+template <typename Body>
+void parallelRanges(size_t count, unsigned threads, size_t granularity, Body body) {
+    size_t units = (count + granularity - 1) / granularity;
+    size_t workers = min<size_t>(threads, max<size_t>(units, 1));
+    if (workers <= 1) {
+        body(size_t(0), count);
+        return;
+    }
+    vector<thread> pool;
+    for (size_t t = 0; t < workers; t++) {
+        size_t begin = min(count, units * t / workers * granularity);
+        size_t end = min(count, units * (t + 1) / workers * granularity);
+        pool.emplace_back(body, begin, end);
+    }
+    for (auto& worker : pool) {
+        worker.join();
+    }
+}
+
+} // namespace
+
+// Read-only view of a whole file: mmap where available, a buffer otherwise
+struct TableEvaluator::MappedFile {
+    const char* data = nullptr;
+    size_t size = 0;
+    void* mapping = nullptr;
+    vector<char> buffer;
+
+    bool open(const string& path) {
+#ifdef CALC_HAVE_MMAP
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return false;
+        }
+        struct stat info;
+        if (fstat(fd, &info) != 0) {
+            ::close(fd);
+            return false;
+        }
+        size = size_t(info.st_size);
+        if (size > 0) {
+            mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapping == MAP_FAILED) {
+                mapping = nullptr;
+                ::close(fd);
+                return false;
+            }
+            madvise(mapping, size, MADV_SEQUENTIAL);
+            data = static_cast<const char*>(mapping);
+        }
+        ::close(fd);
+        return true;
+#else
+        ifstream in(path, ios::binary);
+        if (!in) {
+            return false;
+        }
+        buffer.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+        data = buffer.data();
+        size = buffer.size();
+        return true;
+#endif
+    }
+
+    ~MappedFile() {
+#ifdef CALC_HAVE_MMAP
+        if (mapping != nullptr) {
+            munmap(mapping, size);
+        }
+#endif
+    }
+};
+
+struct TableEvaluator::AlignedColumn {
+    double* data;
+
+    explicit AlignedColumn(size_t rows) {
+        data = static_cast<double*>(::operator new[](max<size_t>(rows, 1) * sizeof(double),
+                                                     align_val_t(columnAlignment)));
+    }
+
+    ~AlignedColumn() {
+        ::operator delete[](data, align_val_t(columnAlignment));
+    }
+};
+
+TableEvaluator::TableEvaluator() {
+    binaryData = nullptr;
+    rowCount = 0;
+    threadCount = thread::hardware_concurrency();
+    if (threadCount == 0) {
+        threadCount = 1;
+    }
+    useDegrees = true;
+}
+
+TableEvaluator::~TableEvaluator() {
+}
+
+bool TableEvaluator::open(const string& path) {
+    close();
+    file.reset(new MappedFile());
+    if (!file->open(path)) {
+        cout << "Error: Cannot open table file '" << path << "'!" << endl;
+        file.reset();
+        return false;
+    }
+
+    bool opened;
+    if (file->size >= sizeof(binaryMagic) && memcmp(file->data, binaryMagic, sizeof(binaryMagic)) == 0) {
+        opened = openBinary();
+    } else {
+        opened = openCsv();
+    }
+    if (!opened) {
+        close();
+    }
+    return opened;
+}
+
+void TableEvaluator::close() {
+    parsedColumns.clear();
+    rowOffsets.clear();
+    columnNames.clear();
+    binaryData = nullptr;
+    rowCount = 0;
+    file.reset();
+}
+
+bool TableEvaluator::isOpen() {
+    return file != nullptr;
+}
+
+bool TableEvaluator::openBinary() {
+    const char* data = file->data;
+    size_t size = file->size;
+    size_t position = sizeof(binaryMagic);
+    uint32_t columns = 0;
+    uint64_t rows = 0;
+    if (size < position + 16) {
+        cout << "Error: Truncated binary table!" << endl;
+        return false;
+    }
+    memcpy(&columns, data + position, sizeof(columns));
+    memcpy(&rows, data + position + 8, sizeof(rows));
+    position += 16;
+
+    for (uint32_t c = 0; c < columns; c++) {
+        uint32_t length = 0;
+        if (size < position + sizeof(length)) {
+            cout << "Error: Truncated binary table!" << endl;
+            return false;
+        }
+        memcpy(&length, data + position, sizeof(length));
+        position += sizeof(length);
+        if (size < position + length) {
+            cout << "Error: Truncated binary table!" << endl;
+            return false;
+        }
+        columnNames.push_back(string(data + position, length));
+        position += length;
+    }
+
+    position = alignUp(position, columnAlignment);
+    if (rows > 0 && (size < position || (size - position) / sizeof(double) / rows < columns)) {
+        cout << "Error: Truncated binary table!" << endl;
+        return false;
+    }
+    binaryData = reinterpret_cast<const double*>(data + position);
+    rowCount = size_t(rows);
+    return true;
+}
+
+bool TableEvaluator::openCsv() {
+    const char* data = file->data;
+    size_t size = file->size;
+    const char* headerEnd = static_cast<const char*>(memchr(data, '\n', size));
+    size_t headerLength = headerEnd ? size_t(headerEnd - data) : size;
+
+    string header(data, headerLength);
+    size_t start = 0;
+    while (start <= header.size()) {
+        size_t comma = header.find(',', start);
+        if (comma == string::npos) {
+            comma = header.size();
+        }
+        // An empty name stays as a placeholder so later columns keep their
+        // positions; no expression can refer to it
+        columnNames.push_back(trim(header.substr(start, comma - start)));
+        start = comma + 1;
+    }
+    if (all_of(columnNames.begin(), columnNames.end(), [](const string& name) { return name.empty(); })) {
+        cout << "Error: CSV table has no header row!" << endl;
+        return false;
+    }
+
+    indexCsvRows(headerEnd ? headerLength + 1 : size);
+    return true;
+}
+
+// Finds the start of every non-empty data row, scanning slices in parallel
+void TableEvaluator::indexCsvRows(size_t dataStart) {
+    const char* data = file->data;
+    size_t size = file->size;
+    size_t length = size > dataStart ? size - dataStart : 0;
+    unsigned threads = length < (size_t(1) << 20) ? 1 : threadCount;
+
+    vector<vector<size_t>> found(threads);
+    vector<thread> pool;
+    for (unsigned t = 0; t < threads; t++) {
+        pool.emplace_back([&, t]() {
+            size_t begin = dataStart + length * t / threads;
+            size_t end = dataStart + length * (t + 1) / threads;
+            vector<size_t>& starts = found[t];
+            for (size_t i = begin; i < end; i++) {
+                // A row starts at dataStart and after every newline
+                bool rowStart = (i == dataStart) || data[i - 1] == '\n';
+                if (rowStart && data[i] != '\n' && data[i] != '\r') {
+                    starts.push_back(i);
+                }
+            }
+        });
+    }
+    for (auto& worker : pool) {
+        worker.join();
+    }
+
+    rowOffsets.clear();
+    for (auto& starts : found) {
+        rowOffsets.insert(rowOffsets.end(), starts.begin(), starts.end());
+    }
+    rowCount = rowOffsets.size();
+}
+
+// Parses the requested CSV columns that are not loaded yet in one pass
+bool TableEvaluator::loadColumns(const vector<size_t>& columns) {
+    if (binaryData != nullptr) {
+        return true;
+    }
+
+    vector<pair<size_t, double*>> targets;
+    for (size_t column : columns) {
+        if (column < columnNames.size() && parsedColumns.find(column) == parsedColumns.end()) {
+            parsedColumns[column].reset(new AlignedColumn(rowCount));
+            targets.push_back(make_pair(column, parsedColumns[column]->data));
+        }
+    }
+    if (targets.empty()) {
+        return true;
+    }
+    sort(targets.begin(), targets.end());
+    size_t lastColumn = targets.back().first;
+
+    const char* data = file->data;
+    size_t size = file->size;
+    parallelRanges(rowCount, threadCount, 4096, [&](size_t begin, size_t end) {
+        char field[128];
+        for (size_t row = begin; row < end; row++) {
+            size_t position = rowOffsets[row];
+            size_t target = 0;
+            for (size_t column = 0; column <= lastColumn; column++) {
+                size_t fieldEnd = position;
+                while (fieldEnd < size && data[fieldEnd] != ',' && data[fieldEnd] != '\n' && data[fieldEnd] != '\r') {
+                    fieldEnd++;
+                }
+                if (column == targets[target].first) {
+                    double value = NAN;
+                    size_t length = min(fieldEnd - position, sizeof(field) - 1);
+                    if (length > 0) {
+                        memcpy(field, data + position, length);
+                        field[length] = '\0';
+                        char* parsedEnd = nullptr;
+                        double parsed = strtod(field, &parsedEnd);
+                        if (parsedEnd != field) {
+                            value = parsed;
+                        }
+                    }
+                    targets[target].second[row] = value;
+                    target++;
+                }
+                bool lineDone = fieldEnd >= size || data[fieldEnd] != ',';
+                position = fieldEnd + 1;
+                if (lineDone) {
+                    // Missing trailing fields read as NaN
+                    for (; target < targets.size(); target++) {
+                        targets[target].second[row] = NAN;
+                    }
+                    break;
+                }
+            }
+        }
+    });
+    return true;
+}
+
+size_t TableEvaluator::getRowCount() {
+    return rowCount;
+}
+
+const vector<string>& TableEvaluator::getColumnNames() {
+    return columnNames;
+}
+
+const double* TableEvaluator::getColumn(const string& name) {
+    auto it = find(columnNames.begin(), columnNames.end(), name);
+    if (it == columnNames.end()) {
+        cout << "Error: No column named '" << name << "'!" << endl;
+        return nullptr;
+    }
+    size_t index = size_t(it - columnNames.begin());
+    if (binaryData != nullptr) {
+        return binaryData + index * rowCount;
+    }
+    loadColumns(vector<size_t>(1, index));
+    return parsedColumns[index]->data;
+}
+
+void TableEvaluator::setThreadCount(unsigned threads) {
+    threadCount = threads == 0 ? 1 : threads;
+}
+
+void TableEvaluator::setAngleMode(bool degrees) {
+    useDegrees = degrees;
+}
+
+bool TableEvaluator::compileStatement(const string& statement, string& outputName, Expression& expression) {
+    if (!isOpen()) {
+        cout << "Error: No table is open!" << endl;
+        return false;
+    }
+    string body = statement;
+    outputName = "result";
+    size_t equals = statement.find('=');
+    if (equals != string::npos) {
+        outputName = trim(statement.substr(0, equals));
+        body = statement.substr(equals + 1);
+    }
+    return expression.compile(body, useDegrees, columnNames);
+}
+
+void TableEvaluator::evaluateRange(Expression& expression, const vector<const double*>& columns,
+                                   double* out, size_t begin, size_t count) {
+    parallelRanges(count, threadCount, evaluationBlock, [&](size_t from, size_t to) {
+        vector<const double*> offset(columns.size(), nullptr);
+        for (size_t c = 0; c < columns.size(); c++) {
+            if (columns[c] != nullptr) {
+                offset[c] = columns[c] + begin + from;
+            }
+        }
+        expression.evaluateColumns(offset.data(), out + from, to - from);
+    });
+}
+
+vector<double> TableEvaluator::evaluate(const string& statement) {
+    Expression expression;
+    string outputName;
+    if (!compileStatement(statement, outputName, expression)) {
+        return vector<double>();
+    }
+
+    vector<size_t> referenced = expression.getReferencedVariables();
+    loadColumns(referenced);
+    vector<const double*> columns(columnNames.size(), nullptr);
+    for (size_t column : referenced) {
+        columns[column] = getColumn(columnNames[column]);
+    }
+
+    vector<double> result(rowCount);
+    evaluateRange(expression, columns, result.data(), 0, rowCount);
+    return result;
+}
+
+size_t TableEvaluator::evaluateToFile(const string& statement, const string& outputPath, bool binaryOutput) {
+    Expression expression;
+    string outputName;
+    if (!compileStatement(statement, outputName, expression)) {
+        return 0;
+    }
+
+    vector<size_t> referenced = expression.getReferencedVariables();
+    loadColumns(referenced);
+    vector<const double*> columns(columnNames.size(), nullptr);
+    for (size_t column : referenced) {
+        columns[column] = getColumn(columnNames[column]);
+    }
+
+    FILE* out = fopen(outputPath.c_str(), "wb");
+    if (out == nullptr) {
+        cout << "Error: Cannot write '" << outputPath << "'!" << endl;
+        return 0;
+    }
+
+    if (binaryOutput) {
+        uint32_t count = 1;
+        uint32_t reserved = 0;
+        uint64_t rows = rowCount;
+        uint32_t length = uint32_t(outputName.size());
+        fwrite(binaryMagic, 1, sizeof(binaryMagic), out);
+        fwrite(&count, sizeof(count), 1, out);
+        fwrite(&reserved, sizeof(reserved), 1, out);
+        fwrite(&rows, sizeof(rows), 1, out);
+        fwrite(&length, sizeof(length), 1, out);
+        fwrite(outputName.data(), 1, outputName.size(), out);
+        size_t written = sizeof(binaryMagic) + 16 + sizeof(length) + outputName.size();
+        vector<char> padding(alignUp(written, columnAlignment) - written, 0);
+        fwrite(padding.data(), 1, padding.size(), out);
+    } else {
+        fprintf(out, "%s\n", outputName.c_str());
+    }
+
+    vector<double> chunk(min(outputChunk, max<size_t>(rowCount, 1)));
+    vector<char> text;
+    bool ok = true;
+    for (size_t begin = 0; begin < rowCount && ok; begin += chunk.size()) {
+        size_t count = min(chunk.size(), rowCount - begin);
+        evaluateRange(expression, columns, chunk.data(), begin, count);
+        if (binaryOutput) {
+            ok = fwrite(chunk.data(), sizeof(double), count, out) == count;
+        } else {
+            text.resize(count * 26);
+            size_t used = 0;
+            for (size_t i = 0; i < count; i++) {
+                used += snprintf(&text[used], 26, "%.17g\n", chunk[i]);
+            }
+            ok = fwrite(text.data(), 1, used, out) == used;
+        }
+    }
+    if (fclose(out) != 0 || !ok) {
+        cout << "Error: Failed writing '" << outputPath << "'!" << endl;
+        return 0;
+    }
+    return rowCount;
+}
+
+bool TableEvaluator::writeBinaryTable(const string& path, const vector<string>& names,
+                                      const vector<const double*>& columns, size_t rows) {
+    ofstream out(path, ios::binary);
+    if (!out || names.size() != columns.size()) {
+        cout << "Error: Cannot write '" << path << "'!" << endl;
+        return false;
+    }
+    uint32_t count = uint32_t(names.size());
+    uint32_t reserved = 0;
+    uint64_t rowTotal = rows;
+    out.write(binaryMagic, sizeof(binaryMagic));
+    out.write(reinterpret_cast<const char*>(&count), sizeof(count));
+    out.write(reinterpret_cast<const char*>(&reserved), sizeof(reserved));
+    out.write(reinterpret_cast<const char*>(&rowTotal), sizeof(rowTotal));
+    size_t written = sizeof(binaryMagic) + 16;
+    for (const string& name : names) {
+        uint32_t length = uint32_t(name.size());
+        out.write(reinterpret_cast<const char*>(&length), sizeof(length));
+        out.write(name.data(), name.size());
+        written += sizeof(length) + name.size();
+    }
+    vector<char> padding(alignUp(written, columnAlignment) - written, 0);
+    out.write(padding.data(), padding.size());
+    for (const double* column : columns) {
+        out.write(reinterpret_cast<const char*>(column), rows * sizeof(double));
+    }
+    return bool(out);
+}
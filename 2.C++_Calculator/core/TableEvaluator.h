@@ -0,0 +1,71 @@
+#ifndef TABLEEVALUATOR_H
+#define TABLEEVALUATOR_H
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+class Expression;
+
+// Evaluates a statement such as "out = sin(a) * b + c" over whole columns of
+// a table file.  The file is memory-mapped; CSV columns are parsed lazily
+// (only the ones the expression reads) and in parallel into 64-byte aligned
+// arrays.  Binary tables are used in place without parsing.  Evaluation runs
+// column-at-a-time in cache-sized blocks across threads, and the output is
+// streamed to disk in chunks.
+//
+// Binary table layout (little-endian):
+//   "CALCTBL1" | uint32 columns | uint32 0 | uint64 rows |
+//   per column: uint32 name length + name bytes |
+//   zero padding to a multiple of 64 bytes | column-major double data
+class TableEvaluator {
+private:
+    struct MappedFile;
+    struct AlignedColumn;
+
+    std::unique_ptr<MappedFile> file;
+    std::vector<std::string> columnNames;
+    std::map<size_t, std::unique_ptr<AlignedColumn>> parsedColumns;
+    std::vector<size_t> rowOffsets;       // CSV: start of each data row
+    const double* binaryData;             // binary: first column
+    size_t rowCount;
+    unsigned threadCount;
+    bool useDegrees;
+
+    bool openBinary();
+    bool openCsv();
+    void indexCsvRows(size_t dataStart);
+    bool loadColumns(const std::vector<size_t>& columns);
+    bool compileStatement(const std::string& statement, std::string& outputName, Expression& expression);
+    void evaluateRange(Expression& expression, const std::vector<const double*>& columns,
+                       double* out, size_t begin, size_t count);
+
+public:
+    TableEvaluator();
+    ~TableEvaluator();
+
+    bool open(const std::string& path);
+    void close();
+    bool isOpen();
+
+    size_t getRowCount();
+    const std::vector<std::string>& getColumnNames();
+    const double* getColumn(const std::string& name);
+
+    void setThreadCount(unsigned threads);
+    void setAngleMode(bool degrees);
+
+    // "name = expression" or just an expression.  Returns the result column.
+    std::vector<double> evaluate(const std::string& statement);
+
+    // Streams the result to outputPath as CSV, or as a one-column binary
+    // table when binaryOutput is set.  Returns the number of rows written.
+    size_t evaluateToFile(const std::string& statement, const std::string& outputPath, bool binaryOutput);
+
+    static bool writeBinaryTable(const std::string& path, const std::vector<std::string>& names,
+                                 const std::vector<const double*>& columns, size_t rows);
+};
+
+#endif // TABLEEVALUATOR_H
@@ -0,0 +1,273 @@
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cstdlib>
+
+using namespace std;
+
+namespace {
+
+// Which pool and worker the current thread belongs to, if any
+thread_local const ThreadPool* currentPool = nullptr;
+thread_local unsigned currentWorker = 0;
+
+// Failed rounds of looking for work before a worker goes to sleep
+const int spinRounds = 64;
+
+mutex globalLock;
+unique_ptr<ThreadPool> globalPool;
+
+} // namespace
+
+// Work deque
+ThreadPool::WorkDeque::WorkDeque() : top(0), bottom(0) {
+    for (int64_t i = 0; i < capacity; i++) {
+        slots[i].store(nullptr, memory_order_relaxed);
+    }
+}
+
+bool ThreadPool::WorkDeque::push(Task* task) {
+    int64_t b = bottom.load(memory_order_relaxed);
+    int64_t t = top.load(memory_order_acquire);
+    if (b - t >= capacity) {
+        return false;
+    }
+    slots[b & (capacity - 1)].store(task, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    bottom.store(b + 1, memory_order_relaxed);
+    return true;
+}
+
+ThreadPool::Task* ThreadPool::WorkDeque::pop() {
+    int64_t b = bottom.load(memory_order_relaxed) - 1;
+    bottom.store(b, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    int64_t t = top.load(memory_order_relaxed);
+    if (t > b) {
+        bottom.store(b + 1, memory_order_relaxed);
+        return nullptr;
+    }
+    Task* task = slots[b & (capacity - 1)].load(memory_order_relaxed);
+    if (t == b) {
+        // Last task: race the thieves for it
+        if (!top.compare_exchange_strong(t, t + 1, memory_order_seq_cst, memory_order_relaxed)) {
+            task = nullptr;
+        }
+        bottom.store(b + 1, memory_order_relaxed);
+    }
+    return task;
+}
+
+ThreadPool::Task* ThreadPool::WorkDeque::steal() {
+    int64_t t = top.load(memory_order_acquire);
+    atomic_thread_fence(memory_order_seq_cst);
+    int64_t b = bottom.load(memory_order_acquire);
+    if (t >= b) {
+        return nullptr;
+    }
+    Task* task = slots[t & (capacity - 1)].load(memory_order_relaxed);
+    if (!top.compare_exchange_strong(t, t + 1, memory_order_seq_cst, memory_order_relaxed)) {
+        return nullptr;
+    }
+    return task;
+}
+
+bool ThreadPool::WorkDeque::empty() {
+    return bottom.load(memory_order_relaxed) <= top.load(memory_order_relaxed);
+}
+
+// Pool
+ThreadPool::ThreadPool(unsigned workerCount) : sleepers(0), epoch(0), stopping(false) {
+    for (unsigned i = 0; i < workerCount; i++) {
+        workers.emplace_back(new Worker());
+        workers.back()->mailboxSize.store(0);
+    }
+    for (unsigned i = 0; i < workerCount; i++) {
+        workers[i]->thread = thread(&ThreadPool::run, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    stopping.store(true);
+    {
+        lock_guard<mutex> guard(sleepLock);
+        wake.notify_all();
+    }
+    for (auto& worker : workers) {
+        worker->thread.join();
+    }
+}
+
+unsigned ThreadPool::getWorkerCount() {
+    return unsigned(workers.size());
+}
+
+void ThreadPool::execute(Task* task) {
+    task->function(task->context, task->begin, task->end);
+    task->remaining->fetch_sub(1, memory_order_acq_rel);
+}
+
+ThreadPool::Task* ThreadPool::takeMail(Worker& worker) {
+    if (worker.mailboxSize.load(memory_order_acquire) == 0) {
+        return nullptr;
+    }
+    lock_guard<mutex> guard(worker.mailboxLock);
+    if (worker.mailbox.empty()) {
+        return nullptr;
+    }
+    Task* task = worker.mailbox.back();
+    worker.mailbox.pop_back();
+    worker.mailboxSize.store(worker.mailbox.size(), memory_order_release);
+    return task;
+}
+
+// Own deque, own mailbox, then other workers' deques and mailboxes
+ThreadPool::Task* ThreadPool::findTask(Worker* self, unsigned start) {
+    if (self != nullptr) {
+        Task* task = self->deque.pop();
+        if (task == nullptr) {
+            task = takeMail(*self);
+        }
+        if (task != nullptr) {
+            return task;
+        }
+    }
+    size_t count = workers.size();
+    for (size_t i = 0; i < count; i++) {
+        Worker& victim = *workers[(start + i) % count];
+        if (&victim != self) {
+            Task* task = victim.deque.steal();
+            if (task != nullptr) {
+                return task;
+            }
+        }
+    }
+    for (size_t i = 0; i < count; i++) {
+        Task* task = takeMail(*workers[(start + i) % count]);
+        if (task != nullptr) {
+            return task;
+        }
+    }
+    return nullptr;
+}
+
+bool ThreadPool::hasWork() {
+    for (auto& worker : workers) {
+        if (!worker->deque.empty() || worker->mailboxSize.load(memory_order_acquire) != 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::notifyWorkers() {
+    epoch.fetch_add(1, memory_order_seq_cst);
+    if (sleepers.load(memory_order_seq_cst) != 0) {
+        lock_guard<mutex> guard(sleepLock);
+        wake.notify_all();
+    }
+}
+
+void ThreadPool::run(unsigned index) {
+    currentPool = this;
+    currentWorker = index;
+    Worker* self = workers[index].get();
+    unsigned start = index + 1;
+    int idle = 0;
+    while (!stopping.load(memory_order_relaxed)) {
+        Task* task = findTask(self, start++);
+        if (task != nullptr) {
+            execute(task);
+            idle = 0;
+            continue;
+        }
+        if (++idle < spinRounds) {
+            this_thread::yield();
+            continue;
+        }
+
+        // Either hasWork() sees a task pushed before we registered as a
+        // sleeper, or the pusher sees us and bumps the epoch under the lock
+        unique_lock<mutex> lock(sleepLock);
+        sleepers.fetch_add(1, memory_order_seq_cst);
+        uint64_t seen = epoch.load(memory_order_seq_cst);
+        if (!hasWork()) {
+            wake.wait(lock, [&]() { return stopping.load() || epoch.load() != seen; });
+        }
+        sleepers.fetch_sub(1, memory_order_relaxed);
+        idle = 0;
+    }
+}
+
+void ThreadPool::parallelFor(size_t begin, size_t end, size_t grain, RangeFunction function, void* context) {
+    if (end <= begin) {
+        return;
+    }
+    size_t count = end - begin;
+    size_t participants = workers.size() + 1;
+    if (grain == 0) {
+        grain = max(size_t(minimumGrain), (count + participants * 4 - 1) / (participants * 4));
+    }
+    if (workers.empty() || count <= grain) {
+        function(context, begin, end);
+        return;
+    }
+
+    size_t chunks = (count + grain - 1) / grain;
+    vector<Task> tasks(chunks);
+    atomic<size_t> remaining(chunks);
+    for (size_t i = 0; i < chunks; i++) {
+        tasks[i].function = function;
+        tasks[i].context = context;
+        tasks[i].begin = begin + i * grain;
+        tasks[i].end = min(end, begin + (i + 1) * grain);
+        tasks[i].remaining = &remaining;
+    }
+
+    // Workers push onto their own deque for others to steal; outside
+    // threads post chunk i to worker i % workers.  Chunk 0 stays here.
+    Worker* self = currentPool == this ? workers[currentWorker].get() : nullptr;
+    for (size_t i = chunks - 1; i >= 1; i--) {
+        if (self != nullptr) {
+            if (!self->deque.push(&tasks[i])) {
+                execute(&tasks[i]);
+            }
+        } else {
+            Worker& worker = *workers[i % workers.size()];
+            lock_guard<mutex> guard(worker.mailboxLock);
+            worker.mailbox.push_back(&tasks[i]);
+            worker.mailboxSize.store(worker.mailbox.size(), memory_order_release);
+        }
+    }
+    notifyWorkers();
+
+    execute(&tasks[0]);
+    unsigned start = self != nullptr ? currentWorker + 1 : 0;
+    while (remaining.load(memory_order_acquire) != 0) {
+        Task* task = findTask(self, start++);
+        if (task != nullptr) {
+            execute(task);
+        } else {
+            this_thread::yield();
+        }
+    }
+}
+
+// Global pool
+ThreadPool& ThreadPool::global() {
+    lock_guard<mutex> guard(globalLock);
+    if (!globalPool) {
+        unsigned threads = thread::hardware_concurrency();
+        const char* setting = getenv("CALC_THREADS");
+        if (setting != nullptr && atoi(setting) > 0) {
+            threads = unsigned(atoi(setting));
+        }
+        globalPool.reset(new ThreadPool(threads > 1 ? threads - 1 : 0));
+    }
+    return *globalPool;
+}
+
+void ThreadPool::setGlobalWorkers(unsigned workers) {
+    lock_guard<mutex> guard(globalLock);
+    globalPool.reset();
+    globalPool.reset(new ThreadPool(workers));
+}
@@ -0,0 +1,107 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Work-stealing pool for the core's batch workloads.
+//
+// Each worker owns a Chase-Lev deque: it pushes and pops at the bottom, and
+// idle workers steal from the top of other workers' deques.  Work submitted
+// from outside the pool lands in per-worker mailboxes; parallelFor sends
+// chunk i to worker i % workers, so repeated sweeps over the same array
+// keep hitting the same caches unless the work has to be rebalanced.
+// The calling thread always takes part and helps until its loop finishes,
+// which also makes nested parallelFor calls from inside tasks safe.
+//
+// A pool with zero workers runs everything inline on the calling thread,
+// for embedded and mobile builds that must not start threads.
+class ThreadPool {
+public:
+    typedef void (*RangeFunction)(void* context, size_t begin, size_t end);
+
+    // Automatic grain: about four chunks per participant, never smaller
+    // than this many iterations
+    static const size_t minimumGrain = 2048;
+
+    explicit ThreadPool(unsigned workers);
+    ~ThreadPool();
+
+    unsigned getWorkerCount();
+
+    // Calls body(begin, end) over disjoint subranges of [begin, end) and
+    // returns when all of them are done.  grain 0 picks a grain size.
+    template <typename Body>
+    void parallelFor(size_t begin, size_t end, Body body, size_t grain = 0) {
+        parallelFor(begin, end, grain, &invokeBody<Body>, &body);
+    }
+    void parallelFor(size_t begin, size_t end, size_t grain, RangeFunction function, void* context);
+
+    // Process-wide pool used by CalculatorEngine.  It starts with
+    // hardware_concurrency() - 1 workers, or CALC_THREADS - 1 when that
+    // environment variable is set (CALC_THREADS=1 means no threads).
+    static ThreadPool& global();
+    // Replaces the global pool; must not race with work running on it
+    static void setGlobalWorkers(unsigned workers);
+
+private:
+    struct Task {
+        RangeFunction function;
+        void* context;
+        size_t begin;
+        size_t end;
+        std::atomic<size_t>* remaining;
+    };
+
+    // Chase-Lev work-stealing deque with a fixed ring (Le et al., "Correct
+    // and Efficient Work-Stealing for Weak Memory Models", 2013)
+    class WorkDeque {
+    private:
+        static const int64_t capacity = 4096;
+        alignas(64) std::atomic<int64_t> top;
+        alignas(64) std::atomic<int64_t> bottom;
+        std::atomic<Task*> slots[capacity];
+
+    public:
+        WorkDeque();
+        bool push(Task* task);   // owner only; false when full
+        Task* pop();             // owner only
+        Task* steal();           // any thread
+        bool empty();
+    };
+
+    struct Worker {
+        WorkDeque deque;
+        std::mutex mailboxLock;
+        std::vector<Task*> mailbox;
+        std::atomic<size_t> mailboxSize;
+        std::thread thread;
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::mutex sleepLock;
+    std::condition_variable wake;
+    std::atomic<unsigned> sleepers;
+    std::atomic<uint64_t> epoch;
+    std::atomic<bool> stopping;
+
+    template <typename Body>
+    static void invokeBody(void* context, size_t begin, size_t end) {
+        (*static_cast<Body*>(context))(begin, end);
+    }
+
+    void run(unsigned index);
+    Task* findTask(Worker* self, unsigned start);
+    Task* takeMail(Worker& worker);
+    bool hasWork();
+    void notifyWorkers();
+    static void execute(Task* task);
+};
+
+#endif // THREADPOOL_H
@@ -0,0 +1,190 @@
+#include "Tracer.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <mutex>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+struct TraceEvent {
+    const char* name;
+    uint64_t ticks;
+    bool begin;
+};
+
+// Only the owning thread advances written.  clear() does not reset it, as
+// the thread may be recording at that moment; it moves clearedAt (guarded
+// by the registry lock) and the dump starts there.
+struct ThreadBuffer {
+    uint32_t threadId;
+    atomic<uint64_t> written;
+    uint64_t clearedAt;
+    TraceEvent events[Tracer::bufferCapacity];
+
+    explicit ThreadBuffer(uint32_t id) : threadId(id), written(0), clearedAt(0) {
+    }
+};
+
+// Buffers stay registered after their thread exits so its events still
+// appear in the dump; clear() drops them.
+struct Registry {
+    mutex lock;
+    vector<ThreadBuffer*> buffers;
+    vector<ThreadBuffer*> exited;
+    uint32_t nextThreadId = 1;
+    // Reference point for converting ticks to nanoseconds
+    uint64_t startTicks = 0;
+    chrono::steady_clock::time_point startTime;
+};
+
+Registry& registry() {
+    static Registry* instance = new Registry();
+    return *instance;
+}
+
+#ifndef CALC_DISABLE_TRACING
+
+struct ThreadSlot {
+    ThreadBuffer* buffer = nullptr;
+
+    ~ThreadSlot() {
+        if (buffer != nullptr) {
+            Registry& shared = registry();
+            lock_guard<mutex> guard(shared.lock);
+            shared.exited.push_back(buffer);
+        }
+    }
+};
+
+thread_local ThreadSlot threadSlot;
+
+ThreadBuffer& localBuffer() {
+    if (threadSlot.buffer == nullptr) {
+        Registry& shared = registry();
+        lock_guard<mutex> guard(shared.lock);
+        threadSlot.buffer = new ThreadBuffer(shared.nextThreadId++);
+        shared.buffers.push_back(threadSlot.buffer);
+    }
+    return *threadSlot.buffer;
+}
+
+#endif
+
+void appendEscaped(string& out, const char* text) {
+    for (; *text != '\0'; text++) {
+        char c = *text;
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            out += ' ';
+        } else {
+            out += c;
+        }
+    }
+}
+
+} // namespace
+
+#ifndef CALC_DISABLE_TRACING
+
+atomic<bool> Tracer::enabled(false);
+
+void Tracer::setEnabled(bool on) {
+    if (on) {
+        Registry& shared = registry();
+        lock_guard<mutex> guard(shared.lock);
+        if (shared.startTicks == 0) {
+            shared.startTicks = ticks();
+            shared.startTime = chrono::steady_clock::now();
+        }
+    }
+    enabled.store(on, memory_order_relaxed);
+}
+
+void Tracer::record(const char* name, bool begin) {
+    ThreadBuffer& buffer = localBuffer();
+    uint64_t index = buffer.written.load(memory_order_relaxed);
+    TraceEvent& event = buffer.events[index & (bufferCapacity - 1)];
+    event.name = name;
+    event.ticks = ticks();
+    event.begin = begin;
+    buffer.written.store(index + 1, memory_order_release);
+}
+
+#endif
+
+string Tracer::chromeTraceJson() {
+    Registry& shared = registry();
+    lock_guard<mutex> guard(shared.lock);
+
+    // Nanoseconds per tick, measured since tracing was first enabled
+    double nanosecondsPerTick = 1.0;
+#ifdef CALC_TRACE_TSC
+    uint64_t elapsedTicks = ticks() - shared.startTicks;
+    double elapsedNanoseconds = chrono::duration<double, nano>(chrono::steady_clock::now() - shared.startTime).count();
+    if (shared.startTicks != 0 && elapsedTicks > 0) {
+        nanosecondsPerTick = elapsedNanoseconds / double(elapsedTicks);
+    }
+#endif
+
+    string json = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    bool first = true;
+    char number[64];
+    for (const ThreadBuffer* buffer : shared.buffers) {
+        uint64_t written = buffer->written.load(memory_order_acquire);
+        uint64_t start = written > bufferCapacity ? written - bufferCapacity : 0;
+        start = max(start, buffer->clearedAt);
+        int depth = 0;
+        for (uint64_t i = start; i < written; i++) {
+            const TraceEvent& event = buffer->events[i & (bufferCapacity - 1)];
+            // The ring may have dropped the begin of the oldest scopes
+            if (!event.begin && depth == 0) {
+                continue;
+            }
+            depth += event.begin ? 1 : -1;
+
+            double microseconds = double(event.ticks - shared.startTicks) * nanosecondsPerTick / 1000.0;
+            json += first ? "\n" : ",\n";
+            first = false;
+            json += "{\"name\":\"";
+            appendEscaped(json, event.name);
+            snprintf(number, sizeof(number), "\",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":1,\"tid\":%u}",
+                     event.begin ? 'B' : 'E', microseconds, buffer->threadId);
+            json += number;
+        }
+    }
+    json += "\n]}\n";
+    return json;
+}
+
+bool Tracer::writeChromeTrace(const string& path) {
+    ofstream out(path);
+    if (!out) {
+        return false;
+    }
+    out << chromeTraceJson();
+    return bool(out);
+}
+
+void Tracer::clear() {
+    Registry& shared = registry();
+    lock_guard<mutex> guard(shared.lock);
+    for (ThreadBuffer* buffer : shared.exited) {
+        for (size_t i = 0; i < shared.buffers.size(); i++) {
+            if (shared.buffers[i] == buffer) {
+                shared.buffers.erase(shared.buffers.begin() + i);
+                break;
+            }
+        }
+        delete buffer;
+    }
+    shared.exited.clear();
+    for (ThreadBuffer* buffer : shared.buffers) {
+        buffer->clearedAt = buffer->written.load(memory_order_acquire);
+    }
+}
@@ -0,0 +1,88 @@
+#ifndef TRACER_H
+#define TRACER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define CALC_TRACE_TSC 1
+#elif defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>
+#define CALC_TRACE_TSC 1
+#else
+#include <chrono>
+#endif
+
+// Begin/end event tracing in Chrome trace-event format (load the dump in
+// chrome://tracing or Perfetto).  Each thread appends to its own ring
+// buffer of bufferCapacity events, so recording takes no lock: a
+// timestamp read (rdtsc where available) and three stores.  Event names
+// must be string literals; only the pointer is stored.  Ticks are
+// converted to nanoseconds when the trace is dumped.  Off until
+// setEnabled(true); -DCALC_DISABLE_TRACING compiles it out.
+class Tracer {
+public:
+    static const size_t bufferCapacity = size_t(1) << 15;
+
+#ifdef CALC_DISABLE_TRACING
+    static constexpr bool isEnabled() { return false; }
+    static void setEnabled(bool) {}
+    static void record(const char*, bool) {}
+#else
+    static bool isEnabled() { return enabled.load(std::memory_order_relaxed); }
+    static void setEnabled(bool on);
+    static void record(const char* name, bool begin);
+#endif
+
+    static uint64_t ticks() {
+#ifdef CALC_TRACE_TSC
+        return __rdtsc();
+#else
+        return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+    }
+
+    // {"traceEvents": [...]} for every thread's buffered events
+    static std::string chromeTraceJson();
+    static bool writeChromeTrace(const std::string& path);
+    // Drops the buffered events and the buffers of exited threads; safe
+    // while other threads record
+    static void clear();
+
+private:
+#ifndef CALC_DISABLE_TRACING
+    static std::atomic<bool> enabled;
+#endif
+};
+
+// Records a begin event now and the matching end event when it goes out
+// of scope
+class TraceScope {
+#ifdef CALC_DISABLE_TRACING
+public:
+    explicit TraceScope(const char*) {}
+#else
+private:
+    const char* name;
+    bool active;
+
+public:
+    explicit TraceScope(const char* name) : name(name), active(Tracer::isEnabled()) {
+        if (active) {
+            Tracer::record(name, true);
+        }
+    }
+
+    ~TraceScope() {
+        if (active) {
+            Tracer::record(name, false);
+        }
+    }
+#endif
+};
+
+#endif // TRACER_H
@@ -1,72 +1,344 @@
 #include "TrigCalculator.h"
+#include "CalcKernels.h"
+#include "CpuDispatch.h"
+#include "EngineStats.h"
+#include <type_traits>
 
 using namespace std;
 
-TrigCalculator::TrigCalculator() {
+// Compile-time checks on the kernels the runtime paths below share
+static_assert(CalcKernels::sine(90.0, true) == 1.0, "sin(90 deg) must be exactly 1");
+static_assert(CalcKernels::cosine(0.0, true) == 1.0, "cos(0) must be exactly 1");
+static_assert(CalcKernels::sine(390.0, true) == CalcKernels::sine(30.0, true), "degrees reduce modulo 360 exactly");
+static_assert(CalcKernels::sine(30.0, true) == 0.5, "sin(30 deg) must be exactly 1/2");
+static_assert(CalcKernels::cosine(90.0, true) == 0.0, "cos(90 deg) must be exactly 0");
+static_assert(CalcKernels::tangent(-225.0, true) == -1.0, "tan(-225 deg) must be exactly -1");
+static_assert(CalcKernels::arctangent(1.0, true) == 45.0, "atan(1) must be 45 deg");
+static_assert(CalcKernels::arcsine(2.0, true) == 0.0, "arcsin domain errors return 0");
+static_assert(CalcKernels::sineCosine(150.0, true).sine == 0.5, "sincos shares the exact degree table");
+static_assert(CalcKernels::arctangent2(1.0, -1.0, true) == 135.0, "atan2(1, -1) must be 135 deg");
+
+namespace {
+
+// Exact reduction of a degree angle into [-180, 180] for the non-double
+// precisions; double uses CalcKernels::reduceDegrees.
+template <typename T>
+T reduceDegrees(T degrees) {
+    T reduced = PrecisionTraits<T>::fmod(degrees, T(360));
+    if (reduced > T(180)) reduced -= T(360);
+    if (reduced < T(-180)) reduced += T(360);
+    return reduced;
+}
+
+} // namespace
+
+template <typename T>
+BasicTrigCalculator<T>::BasicTrigCalculator() {
     useDegrees = true;
 }
 
-double TrigCalculator::degreesToRadians(double degrees) {
-    return degrees * M_PI / 180.0;
+template <typename T>
+T BasicTrigCalculator<T>::degreesToRadians(T degrees) {
+    if constexpr (is_same<T, double>::value) {
+        return CalcKernels::degreesToRadians(degrees);
+    } else {
+        return degrees * PrecisionTraits<T>::pi / T(180);
+    }
 }
 
-double TrigCalculator::radiansToDegrees(double radians) {
-    return radians * 180.0 / M_PI;
+template <typename T>
+T BasicTrigCalculator<T>::radiansToDegrees(T radians) {
+    if constexpr (is_same<T, double>::value) {
+        return CalcKernels::radiansToDegrees(radians);
+    } else {
+        return radians * T(180) / PrecisionTraits<T>::pi;
+    }
 }
 
-void TrigCalculator::setAngleMode(bool degrees) {
+template <typename T>
+void BasicTrigCalculator<T>::setAngleMode(bool degrees, bool announce) {
     useDegrees = degrees;
-    cout << "Angle mode set to: " << (degrees ? "Degrees" : "Radians") << endl;
+    if (announce) {
+        cout << "Angle mode set to: " << (degrees ? "Degrees" : "Radians") << endl;
+    }
 }
 
-bool TrigCalculator::getAngleMode() {
+template <typename T>
+bool BasicTrigCalculator<T>::getAngleMode() {
     return useDegrees;
 }
 
-double TrigCalculator::sine(double angle) {
-    if (useDegrees) {
-        angle = degreesToRadians(angle);
-    }
-    return sin(angle);
+template <typename T>
+T BasicTrigCalculator<T>::sine(T angle) {
+    return sineKernel(angle, useDegrees);
 }
 
-double TrigCalculator::cosine(double angle) {
-    if (useDegrees) {
-        angle = degreesToRadians(angle);
-    }
-    return cos(angle);
+template <typename T>
+T BasicTrigCalculator<T>::cosine(T angle) {
+    return cosineKernel(angle, useDegrees);
 }
 
-double TrigCalculator::tangent(double angle) {
-    if (useDegrees) {
-        angle = degreesToRadians(angle);
-    }
-    return tan(angle);
+template <typename T>
+T BasicTrigCalculator<T>::tangent(T angle) {
+    return tangentKernel(angle, useDegrees);
 }
 
-double TrigCalculator::arcsine(double value) {
+template <typename T>
+T BasicTrigCalculator<T>::arcsine(T value) {
     if (value < -1 || value > 1) {
+        EngineStats::recordError(EngineStats::ArcsineDomain);
         cout << "Error: Domain error for arcsin! Input must be between -1 and 1." << endl;
         return 0;
     }
-    double result = asin(value);
-    return useDegrees ? radiansToDegrees(result) : result;
+    return arcsineKernel(value, useDegrees);
 }
 
-double TrigCalculator::arccosine(double value) {
+template <typename T>
+T BasicTrigCalculator<T>::arccosine(T value) {
     if (value < -1 || value > 1) {
+        EngineStats::recordError(EngineStats::ArccosineDomain);
         cout << "Error: Domain error for arccos! Input must be between -1 and 1." << endl;
         return 0;
     }
-    double result = acos(value);
-    return useDegrees ? radiansToDegrees(result) : result;
+    return arccosineKernel(value, useDegrees);
+}
+
+template <typename T>
+T BasicTrigCalculator<T>::arctangent(T value) {
+    return arctangentKernel(value, useDegrees);
 }
 
-double TrigCalculator::arctangent(double value) {
-    double result = atan(value);
-    return useDegrees ? radiansToDegrees(result) : result;
+template <typename T>
+void BasicTrigCalculator<T>::sineCosine(T angle, T& sine, T& cosine) {
+    sineCosineKernel(angle, useDegrees, sine, cosine);
 }
 
-void TrigCalculator::displayAngleMode() {
+template <typename T>
+void BasicTrigCalculator<T>::displayAngleMode() {
     cout << "Current angle mode: " << (useDegrees ? "Degrees" : "Radians") << endl;
-}
\ No newline at end of file
+}
+
+// Kernels
+// double runs on the constexpr CalcKernels layer.  Radian arguments beyond
+// its reduction range go to libm; degree arguments are reduced modulo 360
+// first and never need to.  float rounds the double kernel's result, so it
+// keeps the exact degree values and matches the float array kernels; the
+// wider precisions use their own libm.
+template <typename T>
+T BasicTrigCalculator<T>::sineKernel(T angle, bool degrees) {
+    if constexpr (is_same<T, double>::value) {
+        if (!degrees && fabs(angle) > CalcKernels::reductionLimit) {
+            return sin(angle);
+        }
+        return CalcKernels::sine(angle, degrees);
+    } else if constexpr (is_same<T, float>::value) {
+        return float(BasicTrigCalculator<double>::sineKernel(angle, degrees));
+    } else {
+        return PrecisionTraits<T>::sin(degrees ? degreesToRadians(reduceDegrees(angle)) : angle);
+    }
+}
+
+template <typename T>
+T BasicTrigCalculator<T>::cosineKernel(T angle, bool degrees) {
+    if constexpr (is_same<T, double>::value) {
+        if (!degrees && fabs(angle) > CalcKernels::reductionLimit) {
+            return cos(angle);
+        }
+        return CalcKernels::cosine(angle, degrees);
+    } else if constexpr (is_same<T, float>::value) {
+        return float(BasicTrigCalculator<double>::cosineKernel(angle, degrees));
+    } else {
+        return PrecisionTraits<T>::cos(degrees ? degreesToRadians(reduceDegrees(angle)) : angle);
+    }
+}
+
+template <typename T>
+T BasicTrigCalculator<T>::tangentKernel(T angle, bool degrees) {
+    if constexpr (is_same<T, double>::value) {
+        if (!degrees && fabs(angle) > CalcKernels::reductionLimit) {
+            return tan(angle);
+        }
+        return CalcKernels::tangent(angle, degrees);
+    } else if constexpr (is_same<T, float>::value) {
+        return float(BasicTrigCalculator<double>::tangentKernel(angle, degrees));
+    } else {
+        return PrecisionTraits<T>::tan(degrees ? degreesToRadians(reduceDegrees(angle)) : angle);
+    }
+}
+
+template <typename T>
+T BasicTrigCalculator<T>::arcsineKernel(T value, bool degrees) {
+    if constexpr (is_same<T, double>::value) {
+        return CalcKernels::arcsine(value, degrees);
+    } else {
+        if (value < -1 || value > 1) {
+            return 0;
+        }
+        T result = PrecisionTraits<T>::asin(value);
+        return degrees ? radiansToDegrees(result) : result;
+    }
+}
+
+template <typename T>
+T BasicTrigCalculator<T>::arccosineKernel(T value, bool degrees) {
+    if constexpr (is_same<T, double>::value) {
+        return CalcKernels::arccosine(value, degrees);
+    } else {
+        if (value < -1 || value > 1) {
+            return 0;
+        }
+        T result = PrecisionTraits<T>::acos(value);
+        return degrees ? radiansToDegrees(result) : result;
+    }
+}
+
+template <typename T>
+T BasicTrigCalculator<T>::arctangentKernel(T value, bool degrees) {
+    if constexpr (is_same<T, double>::value) {
+        return CalcKernels::arctangent(value, degrees);
+    } else {
+        T result = PrecisionTraits<T>::atan(value);
+        return degrees ? radiansToDegrees(result) : result;
+    }
+}
+
+template <typename T>
+void BasicTrigCalculator<T>::sineCosineKernel(T angle, bool degrees, T& sine, T& cosine) {
+    if constexpr (is_same<T, double>::value) {
+        if (!degrees && fabs(angle) > CalcKernels::reductionLimit) {
+            sine = sin(angle);
+            cosine = cos(angle);
+            return;
+        }
+        CalcKernels::SineCosine result = CalcKernels::sineCosine(angle, degrees);
+        sine = result.sine;
+        cosine = result.cosine;
+    } else if constexpr (is_same<T, float>::value) {
+        double doubleSine, doubleCosine;
+        BasicTrigCalculator<double>::sineCosineKernel(angle, degrees, doubleSine, doubleCosine);
+        sine = float(doubleSine);
+        cosine = float(doubleCosine);
+    } else {
+        T radians = degrees ? degreesToRadians(reduceDegrees(angle)) : angle;
+        sine = PrecisionTraits<T>::sin(radians);
+        cosine = PrecisionTraits<T>::cos(radians);
+    }
+}
+
+template <typename T>
+T BasicTrigCalculator<T>::arctangent2Kernel(T y, T x, bool degrees) {
+    if constexpr (is_same<T, double>::value) {
+        return CalcKernels::arctangent2(y, x, degrees);
+    } else {
+        T result = PrecisionTraits<T>::atan2(y, x);
+        return degrees ? radiansToDegrees(result) : result;
+    }
+}
+
+template <typename T>
+void BasicTrigCalculator<T>::toRectangularKernel(T magnitude, T angle, bool degrees, T& x, T& y) {
+    T sine, cosine;
+    sineCosineKernel(angle, degrees, sine, cosine);
+    x = magnitude * cosine;
+    y = magnitude * sine;
+}
+
+template <typename T>
+void BasicTrigCalculator<T>::toPolarKernel(T x, T y, bool degrees, T& magnitude, T& angle) {
+    if constexpr (is_same<T, double>::value) {
+        // sqrt(x^2 + y^2) unless the squares overflow or lose bits to
+        // underflow; the vector kernels take the same branch
+        double sum = x * x + y * y;
+        magnitude = sum >= 0x1p-968 && sum < HUGE_VAL ? sqrt(sum) : hypot(x, y);
+    } else {
+        magnitude = PrecisionTraits<T>::hypot(x, y);
+    }
+    angle = arctangent2Kernel(y, x, degrees);
+}
+
+template <typename T>
+typename BasicTrigCalculator<T>::Kernel BasicTrigCalculator<T>::kernelFor(const string& function) {
+    if (function == "sin" || function == "sine") {
+        return sineKernel;
+    } else if (function == "cos" || function == "cosine") {
+        return cosineKernel;
+    } else if (function == "tan" || function == "tangent") {
+        return tangentKernel;
+    } else if (function == "asin" || function == "arcsine") {
+        return arcsineKernel;
+    } else if (function == "acos" || function == "arccosine") {
+        return arccosineKernel;
+    } else if (function == "atan" || function == "arctangent") {
+        return arctangentKernel;
+    }
+    return nullptr;
+}
+
+template <typename T>
+void BasicTrigCalculator<T>::applyArray(Kernel kernel, const T* values, T* out, size_t count) {
+    if constexpr (is_same<T, double>::value) {
+        const ArrayKernels& kernels = CpuDispatch::kernels();
+        ArrayKernels::UnaryKernel arrayKernel = kernel == sineKernel ? kernels.sine
+                                              : kernel == cosineKernel ? kernels.cosine
+                                              : kernel == tangentKernel ? kernels.tangent
+                                              : nullptr;
+        if (arrayKernel != nullptr) {
+            arrayKernel(values, out, count, useDegrees);
+            return;
+        }
+    }
+    if constexpr (is_same<T, float>::value) {
+        const ArrayKernels& kernels = CpuDispatch::kernels();
+        ArrayKernels::FloatUnaryKernel arrayKernel = kernel == sineKernel ? kernels.sineFloat
+                                                   : kernel == cosineKernel ? kernels.cosineFloat
+                                                   : kernel == tangentKernel ? kernels.tangentFloat
+                                                   : nullptr;
+        if (arrayKernel != nullptr) {
+            arrayKernel(values, out, count, useDegrees);
+            return;
+        }
+    }
+    for (size_t i = 0; i < count; i++) {
+        out[i] = kernel(values[i], useDegrees);
+    }
+}
+
+template <typename T>
+void BasicTrigCalculator<T>::applySineCosine(const T* angles, T* sines, T* cosines, size_t count) {
+    if constexpr (is_same<T, double>::value) {
+        CpuDispatch::kernels().sineCosine(angles, sines, cosines, count, useDegrees);
+    } else {
+        for (size_t i = 0; i < count; i++) {
+            sineCosineKernel(angles[i], useDegrees, sines[i], cosines[i]);
+        }
+    }
+}
+
+template <typename T>
+void BasicTrigCalculator<T>::applyToRectangular(const T* magnitudes, const T* angles, T* xs, T* ys, size_t count) {
+    if constexpr (is_same<T, double>::value) {
+        CpuDispatch::kernels().toRectangular(magnitudes, angles, xs, ys, count, useDegrees);
+    } else {
+        for (size_t i = 0; i < count; i++) {
+            toRectangularKernel(magnitudes[i], angles[i], useDegrees, xs[i], ys[i]);
+        }
+    }
+}
+
+template <typename T>
+void BasicTrigCalculator<T>::applyToPolar(const T* xs, const T* ys, T* magnitudes, T* angles, size_t count) {
+    if constexpr (is_same<T, double>::value) {
+        CpuDispatch::kernels().toPolar(xs, ys, magnitudes, angles, count, useDegrees);
+    } else {
+        for (size_t i = 0; i < count; i++) {
+            toPolarKernel(xs[i], ys[i], useDegrees, magnitudes[i], angles[i]);
+        }
+    }
+}
+
+template class BasicTrigCalculator<float>;
+template class BasicTrigCalculator<double>;
+template class BasicTrigCalculator<long double>;
+#ifdef CALC_HAVE_FLOAT128
+template class BasicTrigCalculator<__float128>;
+#endif
@@ -3,29 +3,70 @@
 
 #include <iostream>
 #include <cmath>
+#include <cstddef>
+#include <string>
+#include "Precision.h"
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
 #endif
 
-class TrigCalculator {
+template <typename T>
+class BasicTrigCalculator {
 private:
     bool useDegrees;
     
-    double degreesToRadians(double degrees);
-    double radiansToDegrees(double radians);
+    static T degreesToRadians(T degrees);
+    static T radiansToDegrees(T radians);
     
 public:
-    TrigCalculator();
-    void setAngleMode(bool degrees);
+    typedef T (*Kernel)(T, bool);
+    
+    BasicTrigCalculator();
+    void setAngleMode(bool degrees, bool announce = true);
     bool getAngleMode();
-    double sine(double angle);
-    double cosine(double angle);
-    double tangent(double angle);
-    double arcsine(double value);
-    double arccosine(double value);
-    double arctangent(double value);
+    T sine(T angle);
+    T cosine(T angle);
+    T tangent(T angle);
+    T arcsine(T value);
+    T arccosine(T value);
+    T arctangent(T value);
+    void sineCosine(T angle, T& sine, T& cosine);
     void displayAngleMode();
+    
+    // Silent kernels shared by the member functions and compiled expressions.
+    // Inverse functions return 0 outside their domain, like the members do.
+    static T sineKernel(T angle, bool degrees);
+    static T cosineKernel(T angle, bool degrees);
+    static T tangentKernel(T angle, bool degrees);
+    static T arcsineKernel(T value, bool degrees);
+    static T arccosineKernel(T value, bool degrees);
+    static T arctangentKernel(T value, bool degrees);
+    
+    // sin and cos from one range reduction, bit for bit what sineKernel and
+    // cosineKernel return in every precision (float rounds the double
+    // kernel, like they do).  Polar angles follow the angle mode; toPolar
+    // gives angles in (-180, 180] or (-pi, pi] like atan2.
+    static void sineCosineKernel(T angle, bool degrees, T& sine, T& cosine);
+    static T arctangent2Kernel(T y, T x, bool degrees);
+    static void toRectangularKernel(T magnitude, T angle, bool degrees, T& x, T& y);
+    static void toPolarKernel(T x, T y, bool degrees, T& magnitude, T& angle);
+    
+    // Kernel for a function name ("sin", "sine", ...), or nullptr
+    static Kernel kernelFor(const std::string& function);
+    void applyArray(Kernel kernel, const T* values, T* out, size_t count);
+    void applySineCosine(const T* angles, T* sines, T* cosines, size_t count);
+    void applyToRectangular(const T* magnitudes, const T* angles, T* xs, T* ys, size_t count);
+    void applyToPolar(const T* xs, const T* ys, T* magnitudes, T* angles, size_t count);
 };
 
-#endif // TRIGCALCULATOR_H
\ No newline at end of file
+extern template class BasicTrigCalculator<float>;
+extern template class BasicTrigCalculator<double>;
+extern template class BasicTrigCalculator<long double>;
+#ifdef CALC_HAVE_FLOAT128
+extern template class BasicTrigCalculator<__float128>;
+#endif
+
+using TrigCalculator = BasicTrigCalculator<double>;
+
+#endif // TRIGCALCULATOR_H
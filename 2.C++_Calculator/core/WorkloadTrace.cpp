@@ -0,0 +1,196 @@
+#include "WorkloadTrace.h"
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+using namespace std;
+
+namespace {
+
+const char traceMagic[8] = {'C', 'A', 'L', 'C', 'W', 'K', 'L', '1'};
+const size_t flushThreshold = 64 * 1024;
+
+} // namespace
+
+// WorkloadTrace
+const char* const WorkloadTrace::trigFunctions[6] = {"sin", "cos", "tan", "asin", "acos", "atan"};
+
+int WorkloadTrace::trigCode(const string& function) {
+    static const char* const longNames[6] = {"sine", "cosine", "tangent", "arcsine", "arccosine", "arctangent"};
+    for (int i = 0; i < 6; i++) {
+        if (function == trigFunctions[i] || function == longNames[i]) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+int WorkloadTrace::operandCount(WorkloadKind kind) {
+    switch (kind) {
+        case WorkloadKind::Basic:
+            return 2;
+        case WorkloadKind::Trig:
+        case WorkloadKind::MemoryStore:
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+bool WorkloadTrace::hasResult(WorkloadKind kind) {
+    return kind == WorkloadKind::Basic || kind == WorkloadKind::Trig || kind == WorkloadKind::MemoryRecall;
+}
+
+bool WorkloadTrace::load(const string& path, vector<WorkloadEvent>& events) {
+    ifstream in(path, ios::binary);
+    if (!in) {
+        cout << "Error: Cannot open trace '" << path << "'!" << endl;
+        return false;
+    }
+    vector<unsigned char> data((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+    if (data.size() < sizeof(traceMagic) || memcmp(data.data(), traceMagic, sizeof(traceMagic)) != 0) {
+        cout << "Error: '" << path << "' is not a workload trace!" << endl;
+        return false;
+    }
+
+    events.clear();
+    size_t position = sizeof(traceMagic);
+    uint64_t time = 0;
+    while (position < data.size()) {
+        WorkloadEvent event = WorkloadEvent();
+        if (position + 2 > data.size() || data[position] > uint8_t(WorkloadKind::SetAngleMode)) {
+            cout << "Error: Corrupt workload trace!" << endl;
+            return false;
+        }
+        event.kind = WorkloadKind(data[position]);
+        event.code = data[position + 1];
+        position += 2;
+
+        uint64_t delta = 0;
+        int shift = 0;
+        while (position < data.size() && shift < 64) {
+            unsigned char byte = data[position++];
+            delta |= uint64_t(byte & 0x7f) << shift;
+            shift += 7;
+            if ((byte & 0x80) == 0) {
+                break;
+            }
+        }
+        time += delta;
+        event.timeNanoseconds = time;
+
+        int doubles = operandCount(event.kind) + (hasResult(event.kind) ? 1 : 0);
+        if (position + doubles * sizeof(double) > data.size()) {
+            cout << "Error: Truncated workload trace!" << endl;
+            return false;
+        }
+        double values[3] = {0, 0, 0};
+        memcpy(values, &data[position], doubles * sizeof(double));
+        position += doubles * sizeof(double);
+
+        int operands = operandCount(event.kind);
+        event.a = operands > 0 ? values[0] : 0;
+        event.b = operands > 1 ? values[1] : 0;
+        event.result = hasResult(event.kind) ? values[operands] : 0;
+        events.push_back(event);
+    }
+    return true;
+}
+
+// WorkloadRecorder
+WorkloadRecorder::WorkloadRecorder() {
+    file = nullptr;
+}
+
+WorkloadRecorder::~WorkloadRecorder() {
+    close();
+}
+
+bool WorkloadRecorder::open(const string& path) {
+    close();
+    file = fopen(path.c_str(), "wb");
+    if (file == nullptr) {
+        cout << "Error: Cannot write trace '" << path << "'!" << endl;
+        return false;
+    }
+    buffer.reserve(flushThreshold + 64);
+    buffer.assign(traceMagic, traceMagic + sizeof(traceMagic));
+    lastTime = chrono::steady_clock::now();
+    return true;
+}
+
+void WorkloadRecorder::close() {
+    if (file != nullptr) {
+        flush();
+        fclose(file);
+        file = nullptr;
+    }
+}
+
+bool WorkloadRecorder::isOpen() {
+    return file != nullptr;
+}
+
+void WorkloadRecorder::flush() {
+    if (file != nullptr && !buffer.empty()) {
+        fwrite(buffer.data(), 1, buffer.size(), file);
+        buffer.clear();
+    }
+}
+
+void WorkloadRecorder::write(WorkloadKind kind, uint8_t code, const double* values, int count) {
+    if (file == nullptr) {
+        return;
+    }
+    auto now = chrono::steady_clock::now();
+    uint64_t delta = uint64_t(chrono::duration_cast<chrono::nanoseconds>(now - lastTime).count());
+    lastTime = now;
+
+    buffer.push_back(uint8_t(kind));
+    buffer.push_back(code);
+    do {
+        unsigned char byte = delta & 0x7f;
+        delta >>= 7;
+        buffer.push_back(delta != 0 ? (byte | 0x80) : byte);
+    } while (delta != 0);
+
+    if (count > 0) {
+        size_t offset = buffer.size();
+        buffer.resize(offset + count * sizeof(double));
+        memcpy(&buffer[offset], values, count * sizeof(double));
+    }
+
+    if (buffer.size() >= flushThreshold) {
+        flush();
+    }
+}
+
+void WorkloadRecorder::recordBasic(double a, double b, char operation, double result) {
+    double values[3] = {a, b, result};
+    write(WorkloadKind::Basic, uint8_t(operation), values, 3);
+}
+
+void WorkloadRecorder::recordTrig(const string& function, double value, double result) {
+    int code = WorkloadTrace::trigCode(function);
+    if (code >= 0) {
+        double values[2] = {value, result};
+        write(WorkloadKind::Trig, uint8_t(code), values, 2);
+    }
+}
+
+void WorkloadRecorder::recordMemoryStore(double value) {
+    write(WorkloadKind::MemoryStore, 0, &value, 1);
+}
+
+void WorkloadRecorder::recordMemoryRecall(double result) {
+    write(WorkloadKind::MemoryRecall, 0, &result, 1);
+}
+
+void WorkloadRecorder::recordMemoryClear() {
+    write(WorkloadKind::MemoryClear, 0, nullptr, 0);
+}
+
+void WorkloadRecorder::recordAngleMode(bool degrees) {
+    write(WorkloadKind::SetAngleMode, degrees ? 1 : 0, nullptr, 0);
+}
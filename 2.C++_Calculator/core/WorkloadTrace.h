@@ -0,0 +1,74 @@
+#ifndef WORKLOADTRACE_H
+#define WORKLOADTRACE_H
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Compact binary log of engine calls for record/replay benchmarks.
+//
+// File layout (little-endian): "CALCWKL1" then one record per call:
+//   uint8 kind | uint8 code | varint nanoseconds since previous record |
+//   operands (0-2 doubles, by kind) | result double (by kind)
+// The first two records are the engine state when recording started: a
+// SetAngleMode, then a MemoryStore of the M register or a MemoryClear if it
+// was empty.  Replaying them in order restores that state.
+enum class WorkloadKind : uint8_t {
+    Basic,          // code = operator char; a, b -> result
+    Trig,           // code = WorkloadTrace::trigCode; a -> result
+    MemoryStore,    // a
+    MemoryRecall,   // -> result
+    MemoryClear,
+    SetAngleMode    // code = 1 for degrees
+};
+
+struct WorkloadEvent {
+    WorkloadKind kind;
+    uint8_t code;
+    uint64_t timeNanoseconds;   // since recording started
+    double a;
+    double b;
+    double result;
+};
+
+class WorkloadTrace {
+public:
+    static const char* const trigFunctions[6];
+
+    static int trigCode(const std::string& function);   // -1 if unknown
+    static int operandCount(WorkloadKind kind);
+    static bool hasResult(WorkloadKind kind);
+
+    static bool load(const std::string& path, std::vector<WorkloadEvent>& events);
+};
+
+// Appends events to a trace file through a 64 KB buffer.  One recorder
+// belongs to one engine and is not thread-safe.
+class WorkloadRecorder {
+private:
+    FILE* file;
+    std::vector<unsigned char> buffer;
+    std::chrono::steady_clock::time_point lastTime;
+
+    void write(WorkloadKind kind, uint8_t code, const double* values, int count);
+    void flush();
+
+public:
+    WorkloadRecorder();
+    ~WorkloadRecorder();
+
+    bool open(const std::string& path);
+    void close();
+    bool isOpen();
+
+    void recordBasic(double a, double b, char operation, double result);
+    void recordTrig(const std::string& function, double value, double result);
+    void recordMemoryStore(double value);
+    void recordMemoryRecall(double result);
+    void recordMemoryClear();
+    void recordAngleMode(bool degrees);
+};
+
+#endif // WORKLOADTRACE_H
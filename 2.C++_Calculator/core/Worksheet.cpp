@@ -0,0 +1,515 @@
+#include "Worksheet.h"
+#include "Expression.h"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <iostream>
+#include <thread>
+#include <unordered_set>
+
+using namespace std;
+
+namespace {
+
+// Waves smaller than this are evaluated on the calling thread
+const size_t parallelWave = 8192;
+
+bool isNameStart(char c) {
+    return isalpha(static_cast<unsigned char>(c)) || c == '_';
+}
+
+bool isNameChar(char c) {
+    return isalnum(static_cast<unsigned char>(c)) || c == '_';
+}
+
+// Rewrites cell references as positional slots ("A1 * sin(B) + A1" becomes
+// "_0 * sin(_1) + _0") so formulas of the same shape share a program.
+// Function names and pi are left alone.
+string normalizeFormula(const string& formula, vector<string>& references) {
+    string normalized;
+    size_t i = 0;
+    while (i < formula.size()) {
+        char c = formula[i];
+        if (isdigit(static_cast<unsigned char>(c)) || c == '.') {
+            size_t start = i;
+            while (i < formula.size() && (isdigit(static_cast<unsigned char>(formula[i])) || formula[i] == '.')) {
+                i++;
+            }
+            if (i < formula.size() && (formula[i] == 'e' || formula[i] == 'E')) {
+                size_t exponent = i + 1;
+                if (exponent < formula.size() && (formula[exponent] == '+' || formula[exponent] == '-')) {
+                    exponent++;
+                }
+                if (exponent < formula.size() && isdigit(static_cast<unsigned char>(formula[exponent]))) {
+                    i = exponent;
+                    while (i < formula.size() && isdigit(static_cast<unsigned char>(formula[i]))) {
+                        i++;
+                    }
+                }
+            }
+            normalized.append(formula, start, i - start);
+        } else if (isNameStart(c)) {
+            size_t start = i;
+            while (i < formula.size() && isNameChar(formula[i])) {
+                i++;
+            }
+            string name = formula.substr(start, i - start);
+            size_t next = i;
+            while (next < formula.size() && isspace(static_cast<unsigned char>(formula[next]))) {
+                next++;
+            }
+            if (name == "pi" || (next < formula.size() && formula[next] == '(')) {
+                normalized += name;
+                continue;
+            }
+            size_t slot = find(references.begin(), references.end(), name) - references.begin();
+            if (slot == references.size()) {
+                references.push_back(name);
+            }
+            normalized += "_" + to_string(slot);
+        } else {
+            if (!isspace(static_cast<unsigned char>(c))) {
+                normalized += c;
+            }
+            i++;
+        }
+    }
+    return normalized;
+}
+
+} // namespace
+
+struct Worksheet::Program {
+    Expression expression;
+    string normalized;
+    size_t slots;
+};
+
+Worksheet::Worksheet() {
+    threadCount = thread::hardware_concurrency();
+    if (threadCount == 0) {
+        threadCount = 1;
+    }
+    useDegrees = true;
+}
+
+Worksheet::~Worksheet() {
+}
+
+uint32_t Worksheet::cellFor(const string& name) {
+    size_t id = names.intern(name);
+    if (id == VariableTable::npos) {
+        return noProgram;
+    }
+    if (id >= cells.size()) {
+        Cell cell = {0.0, noProgram, 0, 0, 0, 0, false, false};
+        cells.resize(id + 1, cell);
+        dependents.resize(id + 1);
+    }
+    return uint32_t(id);
+}
+
+uint32_t Worksheet::compileProgram(const string& normalized, size_t slotCount) {
+    auto it = programIndex.find(normalized);
+    if (it != programIndex.end()) {
+        return it->second;
+    }
+    unique_ptr<Program> program(new Program());
+    program->normalized = normalized;
+    program->slots = slotCount;
+    vector<string> slots;
+    for (size_t slot = 0; slot < program->slots; slot++) {
+        slots.push_back("_" + to_string(slot));
+    }
+    if (!program->expression.compile(normalized, useDegrees, slots)) {
+        return noProgram;
+    }
+    uint32_t index = uint32_t(programs.size());
+    programs.push_back(move(program));
+    programIndex[normalized] = index;
+    return index;
+}
+
+// Whether any of targets is downstream of from
+bool Worksheet::reaches(uint32_t from, const vector<uint32_t>& targets) {
+    if (dependents[from].empty()) {
+        return false;
+    }
+    unordered_set<uint32_t> visited;
+    vector<uint32_t> stack(1, from);
+    while (!stack.empty()) {
+        uint32_t cell = stack.back();
+        stack.pop_back();
+        for (uint32_t next : dependents[cell]) {
+            if (find(targets.begin(), targets.end(), next) != targets.end()) {
+                return true;
+            }
+            if (visited.insert(next).second) {
+                stack.push_back(next);
+            }
+        }
+    }
+    return false;
+}
+
+void Worksheet::markChanged(uint32_t cell) {
+    if (!cells[cell].changed) {
+        cells[cell].changed = true;
+        changedCells.push_back(cell);
+    }
+}
+
+bool Worksheet::setValue(const string& cell, double value) {
+    uint32_t id = cellFor(cell);
+    if (id == noProgram) {
+        cout << "Error: Invalid cell name '" << cell << "'!" << endl;
+        return false;
+    }
+    setValue(size_t(id), value);
+    return true;
+}
+
+bool Worksheet::setFormula(const string& cell, const string& formula) {
+    uint32_t id = cellFor(cell);
+    if (id == noProgram) {
+        cout << "Error: Invalid cell name '" << cell << "'!" << endl;
+        return false;
+    }
+
+    vector<string> references;
+    string normalized = normalizeFormula(formula, references);
+    vector<uint32_t> inputs;
+    for (const string& reference : references) {
+        uint32_t input = cellFor(reference);
+        if (input == noProgram) {
+            cout << "Error: Invalid cell name '" << reference << "'!" << endl;
+            return false;
+        }
+        inputs.push_back(input);
+    }
+    if (find(inputs.begin(), inputs.end(), id) != inputs.end() || reaches(id, inputs)) {
+        cout << "Error: Circular reference in " << cell << "!" << endl;
+        return false;
+    }
+    uint32_t program = compileProgram(normalized, references.size());
+    if (program == noProgram) {
+        return false;
+    }
+
+    detach(id);
+    Cell& target = cells[id];
+    target.program = program;
+    target.inputBegin = uint32_t(inputPool.size());
+    target.inputCount = uint32_t(inputs.size());
+    // Replaced formulas leave their old slots behind; the pool only grows
+    inputPool.insert(inputPool.end(), inputs.begin(), inputs.end());
+    for (uint32_t input : inputs) {
+        dependents[input].push_back(id);
+    }
+    markChanged(id);
+    return true;
+}
+
+void Worksheet::clearFormula(const string& cell) {
+    size_t id = names.find(cell);
+    if (id != VariableTable::npos && id < cells.size()) {
+        detach(uint32_t(id));
+    }
+}
+
+// Turns a formula cell back into a plain number
+void Worksheet::detach(uint32_t id) {
+    Cell& target = cells[id];
+    for (uint32_t i = 0; i < target.inputCount; i++) {
+        vector<uint32_t>& users = dependents[inputPool[target.inputBegin + i]];
+        users.erase(find(users.begin(), users.end(), id));
+    }
+    target.program = noProgram;
+    target.inputCount = 0;
+}
+
+double Worksheet::getValue(const string& cell) {
+    size_t id = names.find(cell);
+    if (id == VariableTable::npos || id >= cells.size()) {
+        return 0.0;
+    }
+    return getValue(id);
+}
+
+bool Worksheet::hasCell(const string& cell) {
+    size_t id = names.find(cell);
+    return id != VariableTable::npos && id < cells.size();
+}
+
+string Worksheet::getFormula(const string& cell) {
+    size_t id = names.find(cell);
+    if (id == VariableTable::npos || id >= cells.size() || cells[id].program == noProgram) {
+        return "";
+    }
+    const Cell& target = cells[id];
+    const string& normalized = programs[target.program]->normalized;
+    string formula;
+    for (size_t i = 0; i < normalized.size(); i++) {
+        if (normalized[i] == '_' && (i == 0 || !isNameChar(normalized[i - 1]))) {
+            size_t slot = size_t(atoi(normalized.c_str() + i + 1));
+            formula += names.name(inputPool[target.inputBegin + slot]);
+            while (i + 1 < normalized.size() && isdigit(static_cast<unsigned char>(normalized[i + 1]))) {
+                i++;
+            }
+        } else {
+            formula += normalized[i];
+        }
+    }
+    return formula;
+}
+
+size_t Worksheet::getCellId(const string& cell) {
+    uint32_t id = cellFor(cell);
+    return id == noProgram ? VariableTable::npos : size_t(id);
+}
+
+void Worksheet::setValue(size_t id, double value) {
+    if (id >= cells.size()) {
+        return;
+    }
+    detach(uint32_t(id));
+    cells[id].value = value;
+    markChanged(uint32_t(id));
+}
+
+double Worksheet::getValue(size_t id) {
+    if (id >= cells.size()) {
+        return 0.0;
+    }
+    if (!changedCells.empty()) {
+        recalculate();
+    }
+    return cells[id].value;
+}
+
+size_t Worksheet::getCellCount() {
+    return cells.size();
+}
+
+void Worksheet::setAngleMode(bool degrees) {
+    if (degrees == useDegrees) {
+        return;
+    }
+    useDegrees = degrees;
+    vector<char> affected(programs.size(), 0);
+    for (size_t p = 0; p < programs.size(); p++) {
+        Program& program = *programs[p];
+        if (program.expression.usesAngleMode()) {
+            vector<string> slots;
+            for (size_t slot = 0; slot < program.slots; slot++) {
+                slots.push_back("_" + to_string(slot));
+            }
+            program.expression.compile(program.normalized, useDegrees, slots);
+            affected[p] = 1;
+        }
+    }
+    for (size_t id = 0; id < cells.size(); id++) {
+        if (cells[id].program != noProgram && affected[cells[id].program]) {
+            markChanged(uint32_t(id));
+        }
+    }
+}
+
+bool Worksheet::getAngleMode() {
+    return useDegrees;
+}
+
+void Worksheet::setThreadCount(unsigned threads) {
+    threadCount = max(1u, threads);
+}
+
+double Worksheet::evaluateCell(uint32_t id) {
+    const Cell& cell = cells[id];
+    double local[16];
+    vector<double> heap;
+    double* values = local;
+    if (cell.inputCount > 16) {
+        heap.resize(cell.inputCount);
+        values = heap.data();
+    }
+    for (uint32_t i = 0; i < cell.inputCount; i++) {
+        values[i] = cells[inputPool[cell.inputBegin + i]].value;
+    }
+    return programs[cell.program]->expression.evaluateRow(values);
+}
+
+void Worksheet::evaluateRange(const uint32_t* order, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        cells[order[i]].value = evaluateCell(order[i]);
+    }
+}
+
+// Cells in a wave only read cells from earlier waves
+void Worksheet::evaluateWave(const uint32_t* wave, size_t count) {
+    size_t workers = min<size_t>(threadCount, count / parallelWave);
+    if (workers <= 1) {
+        evaluateRange(wave, count);
+        return;
+    }
+    vector<thread> pool;
+    for (size_t t = 1; t < workers; t++) {
+        size_t begin = count * t / workers;
+        size_t end = count * (t + 1) / workers;
+        pool.emplace_back(&Worksheet::evaluateRange, this, wave + begin, end - begin);
+    }
+    evaluateRange(wave, count / workers);
+    for (auto& worker : pool) {
+        worker.join();
+    }
+}
+
+// Splits the dirty cells into weakly connected groups and evaluates each
+// group on one thread, in the group's slice of the topological order.
+// Returns false without evaluating when one group dominates.
+bool Worksheet::evaluateComponents(const vector<uint32_t>& dirtyCells, const vector<uint32_t>& order) {
+    size_t count = dirtyCells.size();
+    vector<uint32_t> parent(count);
+    for (size_t i = 0; i < count; i++) {
+        parent[i] = uint32_t(i);
+    }
+    auto root = [&parent](uint32_t i) {
+        while (parent[i] != i) {
+            parent[i] = parent[parent[i]];
+            i = parent[i];
+        }
+        return i;
+    };
+    for (size_t i = 0; i < count; i++) {
+        const Cell& cell = cells[dirtyCells[i]];
+        for (uint32_t k = 0; k < cell.inputCount; k++) {
+            const Cell& input = cells[inputPool[cell.inputBegin + k]];
+            if (input.dirty) {
+                uint32_t a = root(uint32_t(i));
+                uint32_t b = root(input.slot);
+                if (a != b) {
+                    parent[max(a, b)] = min(a, b);
+                }
+            }
+        }
+    }
+
+    // Counting sort of the topological order by group keeps each group's
+    // cells in dependency order
+    vector<uint32_t> groupStart(count + 1, 0);
+    size_t largest = 0;
+    for (size_t i = 0; i < count; i++) {
+        parent[i] = root(uint32_t(i));
+        largest = max<size_t>(largest, ++groupStart[parent[i] + 1]);
+    }
+    if (largest * 2 > count) {
+        return false;
+    }
+    vector<pair<uint32_t, uint32_t>> groups;
+    for (size_t g = 0; g < count; g++) {
+        if (groupStart[g + 1] > 0) {
+            groups.push_back(make_pair(groupStart[g], groupStart[g + 1]));
+        }
+        groupStart[g + 1] += groupStart[g];
+    }
+    vector<uint32_t> grouped(count);
+    vector<uint32_t> fill(groupStart.begin(), groupStart.end() - 1);
+    for (uint32_t id : order) {
+        grouped[fill[parent[cells[id].slot]]++] = id;
+    }
+    for (auto& group : groups) {
+        group.second += group.first;
+    }
+
+    // Largest groups first so one late straggler does not hold everyone up
+    sort(groups.begin(), groups.end(), [](const pair<uint32_t, uint32_t>& a, const pair<uint32_t, uint32_t>& b) {
+        return a.second - a.first > b.second - b.first;
+    });
+    atomic<size_t> nextGroup(0);
+    auto worker = [&]() {
+        for (size_t g = nextGroup.fetch_add(1); g < groups.size(); g = nextGroup.fetch_add(1)) {
+            evaluateRange(grouped.data() + groups[g].first, groups[g].second - groups[g].first);
+        }
+    };
+    size_t workers = min<size_t>(threadCount, groups.size());
+    vector<thread> pool;
+    for (size_t t = 1; t < workers; t++) {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : pool) {
+        thread.join();
+    }
+    return true;
+}
+
+size_t Worksheet::recalculate() {
+    if (changedCells.empty()) {
+        return 0;
+    }
+
+    // Everything downstream of a change, plus changed formulas themselves
+    vector<uint32_t> dirtyCells;
+    vector<uint32_t> stack;
+    for (uint32_t id : changedCells) {
+        cells[id].changed = false;
+        if (cells[id].program != noProgram && !cells[id].dirty) {
+            cells[id].dirty = true;
+            dirtyCells.push_back(id);
+        }
+        stack.push_back(id);
+    }
+    changedCells.clear();
+    while (!stack.empty()) {
+        uint32_t id = stack.back();
+        stack.pop_back();
+        for (uint32_t next : dependents[id]) {
+            if (!cells[next].dirty) {
+                cells[next].dirty = true;
+                dirtyCells.push_back(next);
+                stack.push_back(next);
+            }
+        }
+    }
+
+    // Kahn's algorithm: order holds the dirty cells wave after wave
+    vector<uint32_t> order;
+    vector<size_t> waveStarts(1, 0);
+    order.reserve(dirtyCells.size());
+    for (size_t i = 0; i < dirtyCells.size(); i++) {
+        Cell& cell = cells[dirtyCells[i]];
+        cell.slot = uint32_t(i);
+        cell.pending = 0;
+        for (uint32_t k = 0; k < cell.inputCount; k++) {
+            if (cells[inputPool[cell.inputBegin + k]].dirty) {
+                cell.pending++;
+            }
+        }
+        if (cell.pending == 0) {
+            order.push_back(dirtyCells[i]);
+        }
+    }
+    for (size_t begin = 0; begin < order.size(); ) {
+        size_t end = order.size();
+        waveStarts.push_back(end);
+        for (size_t i = begin; i < end; i++) {
+            for (uint32_t user : dependents[order[i]]) {
+                if (--cells[user].pending == 0) {
+                    order.push_back(user);
+                }
+            }
+        }
+        begin = end;
+    }
+
+    if (threadCount <= 1 || order.size() < parallelWave) {
+        evaluateRange(order.data(), order.size());
+    } else if (!evaluateComponents(dirtyCells, order)) {
+        for (size_t w = 0; w + 1 < waveStarts.size(); w++) {
+            evaluateWave(order.data() + waveStarts[w], waveStarts[w + 1] - waveStarts[w]);
+        }
+    }
+    for (uint32_t id : dirtyCells) {
+        cells[id].dirty = false;
+    }
+    return order.size();
+}
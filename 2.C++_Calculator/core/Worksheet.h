@@ -0,0 +1,91 @@
+#ifndef WORKSHEET_H
+#define WORKSHEET_H
+
+#include "Memory.h"
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+class Expression;
+
+// Cells of dependent calculations ("C = A * sin(B)", "D = C / 2").  A cell
+// holds either a number or a formula over other cells, written in the
+// Expression language, so it computes exactly what CalculatorEngine does.
+//
+// Changing a cell only marks it; recalculate() then re-evaluates the cells
+// downstream of the changes in topological order.  Independent groups of
+// dirty cells are handed to different threads; a single large group is
+// evaluated wave by wave instead, splitting wide waves across threads.  Formulas that differ only in the cells they reference share one
+// compiled program, so big sheets of similar formulas stay cheap.
+// Changing the angle mode only dirties cells whose formula calls a trig
+// function.
+//
+// Cell names follow the register rules in Memory.h (identifiers of up to 15
+// characters).  Formulas that would create a cycle are rejected.
+class Worksheet {
+private:
+    struct Cell {
+        double value;
+        uint32_t program;       // noProgram for plain numbers
+        uint32_t inputBegin;    // into inputPool
+        uint32_t inputCount;
+        uint32_t pending;       // dirty inputs not yet recomputed
+        uint32_t slot;          // index in the dirty list while recalculating
+        bool dirty;
+        bool changed;
+    };
+    struct Program;
+
+    VariableTable names;
+    std::vector<Cell> cells;
+    std::vector<std::vector<uint32_t>> dependents;
+    std::vector<uint32_t> inputPool;
+    std::vector<std::unique_ptr<Program>> programs;
+    std::map<std::string, uint32_t> programIndex;   // by normalized formula
+    std::vector<uint32_t> changedCells;
+    unsigned threadCount;
+    bool useDegrees;
+
+    uint32_t cellFor(const std::string& name);
+    uint32_t compileProgram(const std::string& normalized, size_t slotCount);
+    void detach(uint32_t cell);
+    bool reaches(uint32_t from, const std::vector<uint32_t>& targets);
+    void markChanged(uint32_t cell);
+    double evaluateCell(uint32_t cell);
+    void evaluateRange(const uint32_t* order, size_t count);
+    void evaluateWave(const uint32_t* wave, size_t count);
+    bool evaluateComponents(const std::vector<uint32_t>& dirtyCells, const std::vector<uint32_t>& order);
+
+public:
+    static const uint32_t noProgram = 0xffffffffu;
+
+    Worksheet();
+    ~Worksheet();
+
+    bool setValue(const std::string& cell, double value);
+    bool setFormula(const std::string& cell, const std::string& formula);
+    void clearFormula(const std::string& cell);   // keeps the current value
+
+    // Up to date: recalculates first if anything changed
+    double getValue(const std::string& cell);
+    bool hasCell(const std::string& cell);
+    std::string getFormula(const std::string& cell);
+
+    // By id, for sheets driven from code
+    size_t getCellId(const std::string& cell);   // creates the cell; npos if invalid
+    void setValue(size_t id, double value);
+    double getValue(size_t id);
+    size_t getCellCount();
+
+    void setAngleMode(bool degrees);
+    bool getAngleMode();
+    void setThreadCount(unsigned threads);
+
+    // Returns the number of formula cells evaluated
+    size_t recalculate();
+};
+
+#endif // WORKSHEET_H
@@ -1,4 +1,6 @@
 #include "CalculatorWindow.h"
+#include "../core/NumberFormat.h"
+#include "../core/Tracer.h"
 #include <QApplication>
 #include <QMessageBox>
 #include <QKeySequence>
@@ -79,13 +81,17 @@ void CalculatorWindow::setupUI() {
     // Create layouts for buttons
     buttonLayout = new QGridLayout();
     memoryButtonLayout = new QHBoxLayout();
+    registerLayout = new QHBoxLayout();
     trigButtonLayout = new QHBoxLayout();
+    scientificButtonLayout = new QHBoxLayout();
     
     // Add components to main layout
     mainLayout->addWidget(display);
     mainLayout->addWidget(statusLabel);
     mainLayout->addLayout(memoryButtonLayout);
+    mainLayout->addLayout(registerLayout);
     mainLayout->addLayout(trigButtonLayout);
+    mainLayout->addLayout(scientificButtonLayout);
     mainLayout->addLayout(buttonLayout);
 }
 
@@ -96,10 +102,18 @@ void CalculatorWindow::setupMenus() {
     showTrigAction->setCheckable(true);
     showTrigAction->setChecked(true);
     
+    showScientificAction = viewMenu->addAction("Show &Scientific Functions");
+    showScientificAction->setCheckable(true);
+    showScientificAction->setChecked(true);
+    
     showMemoryAction = viewMenu->addAction("Show &Memory Functions");
     showMemoryAction->setCheckable(true);
     showMemoryAction->setChecked(true);
     
+    // Only offered when tracing was switched on at startup (CALC_TRACE)
+    saveTraceAction = viewMenu->addAction("Save &Trace");
+    saveTraceAction->setVisible(Tracer::isEnabled());
+    
     // Help menu
     helpMenu = menuBar()->addMenu("&Help");
     aboutAction = helpMenu->addAction("&About Calculator");
@@ -193,6 +207,21 @@ void CalculatorWindow::setupButtons() {
     memoryClearButton->setStyleSheet(memoryStyle);
     memoryStatusButton->setStyleSheet(memoryStyle);
     
+    // Create named register controls
+    registerSelector = new QComboBox();
+    registerSelector->setEditable(true);
+    registerSelector->setInsertPolicy(QComboBox::NoInsert);
+    registerSelector->lineEdit()->setPlaceholderText("register");
+    registerSelector->lineEdit()->setMaxLength(int(VariableTable::maxNameLength));
+    registerSelector->setMinimumWidth(120);
+    registerStoreButton = new QPushButton("STO");
+    registerRecallButton = new QPushButton("RCL");
+    registerClearButton = new QPushButton("CLR");
+    
+    registerStoreButton->setStyleSheet(memoryStyle);
+    registerRecallButton->setStyleSheet(memoryStyle);
+    registerClearButton->setStyleSheet(memoryStyle);
+    
     // Create trigonometric buttons
     sinButton = new QPushButton("sin");
     cosButton = new QPushButton("cos");
@@ -219,6 +248,27 @@ void CalculatorWindow::setupButtons() {
     acosButton->setStyleSheet(trigStyle);
     atanButton->setStyleSheet(trigStyle);
     
+    // Create exponential, logarithmic and hyperbolic buttons
+    const char* scientificNames[scientificButtonCount] = {
+        "exp", "ln", "log10", "sqrt", "sinh", "cosh", "tanh", "asinh", "acosh", "atanh"
+    };
+    QString scientificStyle = 
+        "QPushButton {"
+        "    background-color: #673AB7;"
+        "    color: white;"
+        "    border: 1px solid #512DA8;"
+        "    border-radius: 4px;"
+        "    font-size: 11px;"
+        "    min-width: 45px;"
+        "    min-height: 30px;"
+        "}";
+    for (int i = 0; i < scientificButtonCount; ++i) {
+        scientificButtons[i] = new QPushButton(scientificNames[i]);
+        scientificButtons[i]->setStyleSheet(scientificStyle);
+    }
+    powerButton = new QPushButton("xʸ");
+    powerButton->setStyleSheet(scientificStyle);
+    
     // Create mode toggle button
     degreeRadianToggle = new QPushButton("DEG");
     degreeRadianToggle->setStyleSheet(
@@ -242,6 +292,13 @@ void CalculatorWindow::setupLayouts() {
     memoryButtonLayout->addWidget(memoryStatusButton);
     memoryButtonLayout->addStretch();
     
+    // Named register layout
+    registerLayout->addWidget(registerSelector);
+    registerLayout->addWidget(registerStoreButton);
+    registerLayout->addWidget(registerRecallButton);
+    registerLayout->addWidget(registerClearButton);
+    registerLayout->addStretch();
+    
     // Trigonometric buttons layout
     trigButtonLayout->addWidget(sinButton);
     trigButtonLayout->addWidget(cosButton);
@@ -252,6 +309,13 @@ void CalculatorWindow::setupLayouts() {
     trigButtonLayout->addWidget(degreeRadianToggle);
     trigButtonLayout->addStretch();
     
+    // Scientific buttons layout
+    for (int i = 0; i < scientificButtonCount; ++i) {
+        scientificButtonLayout->addWidget(scientificButtons[i]);
+    }
+    scientificButtonLayout->addWidget(powerButton);
+    scientificButtonLayout->addStretch();
+    
     // Main calculator grid
     // Row 0: Clear buttons
     buttonLayout->addWidget(clearEntryButton, 0, 0);
@@ -303,6 +367,9 @@ void CalculatorWindow::connectSignals() {
     connect(memoryRecallButton, &QPushButton::clicked, this, &CalculatorWindow::onMemoryRecallClicked);
     connect(memoryClearButton, &QPushButton::clicked, this, &CalculatorWindow::onMemoryClearClicked);
     connect(memoryStatusButton, &QPushButton::clicked, this, &CalculatorWindow::onMemoryStatusClicked);
+    connect(registerStoreButton, &QPushButton::clicked, this, &CalculatorWindow::onRegisterStoreClicked);
+    connect(registerRecallButton, &QPushButton::clicked, this, &CalculatorWindow::onRegisterRecallClicked);
+    connect(registerClearButton, &QPushButton::clicked, this, &CalculatorWindow::onRegisterClearClicked);
     
     // Trigonometric buttons
     connect(sinButton, &QPushButton::clicked, this, &CalculatorWindow::onTrigButtonClicked);
@@ -312,27 +379,63 @@ void CalculatorWindow::connectSignals() {
     connect(acosButton, &QPushButton::clicked, this, &CalculatorWindow::onTrigButtonClicked);
     connect(atanButton, &QPushButton::clicked, this, &CalculatorWindow::onTrigButtonClicked);
     
+    // Scientific buttons
+    for (int i = 0; i < scientificButtonCount; ++i) {
+        connect(scientificButtons[i], &QPushButton::clicked, this, &CalculatorWindow::onScientificButtonClicked);
+    }
+    connect(powerButton, &QPushButton::clicked, this, &CalculatorWindow::onOperatorButtonClicked);
+    
     // Mode toggle
     connect(degreeRadianToggle, &QPushButton::clicked, this, &CalculatorWindow::onDegreeRadianToggleClicked);
     
     // Menu actions
     connect(showTrigAction, &QAction::toggled, this, &CalculatorWindow::onShowTrigToggled);
+    connect(showScientificAction, &QAction::toggled, this, &CalculatorWindow::onShowScientificToggled);
     connect(showMemoryAction, &QAction::toggled, this, &CalculatorWindow::onShowMemoryToggled);
+    connect(saveTraceAction, &QAction::triggered, this, &CalculatorWindow::onSaveTraceClicked);
     connect(aboutAction, &QAction::triggered, this, &CalculatorWindow::onAboutClicked);
 }
 
 void CalculatorWindow::updateDisplay() {
+    TraceScope trace("CalculatorWindow::updateDisplay");
     display->setText(currentInput);
 }
 
 void CalculatorWindow::updateStatusLabel() {
+    TraceScope trace("CalculatorWindow::updateStatusLabel");
     QString memStatus = engine->hasMemoryValue() ? "Has Value" : "Empty";
     QString angleMode = QString::fromStdString(engine->getAngleModeString());
     statusLabel->setText(QString("Ready | Memory: %1 | Mode: %2").arg(memStatus, angleMode));
 }
 
+void CalculatorWindow::refreshRegisterList() {
+    QString current = registerSelector->currentText();
+    registerSelector->clear();
+    for (const std::string& name : engine->getVariableNames()) {
+        registerSelector->addItem(QString::fromStdString(name));
+    }
+    registerSelector->setEditText(current);
+}
+
+double CalculatorWindow::applyOperator(double left, double right) {
+    if (pendingOperator == "^") {
+        return engine->power(left, right);
+    }
+    return engine->performBasicOperation(left, right, pendingOperator.at(0).toLatin1());
+}
+
+QString CalculatorWindow::formatNumber(double value) {
+    return QString::fromStdString(NumberFormat::toString(value));
+}
+
+double CalculatorWindow::parseNumber(const QString& text) {
+    double value;
+    return NumberFormat::parse(text.toStdString(), value) ? value : 0.0;
+}
+
 // Slot implementations
 void CalculatorWindow::onNumberButtonClicked() {
+    TraceScope trace("CalculatorWindow::onNumberButtonClicked");
     QPushButton *button = qobject_cast<QPushButton*>(sender());
     QString digit = button->text();
     
@@ -350,18 +453,20 @@ void CalculatorWindow::onNumberButtonClicked() {
 }
 
 void CalculatorWindow::onOperatorButtonClicked() {
+    TraceScope trace("CalculatorWindow::onOperatorButtonClicked");
     QPushButton *button = qobject_cast<QPushButton*>(sender());
     QString op = button->text();
     
     // Convert display symbols to internal operators
     if (op == "×") op = "*";
     if (op == "÷") op = "/";
+    if (op == "xʸ") op = "^";
     
-    double inputValue = currentInput.toDouble();
+    double inputValue = parseNumber(currentInput);
     
     if (!pendingOperator.isEmpty()) {
-        double result = engine->performBasicOperation(operand, inputValue, pendingOperator.at(0).toLatin1());
-        currentInput = QString::number(result);
+        double result = applyOperator(operand, inputValue);
+        currentInput = formatNumber(result);
         updateDisplay();
         operand = result;
     } else {
@@ -373,10 +478,11 @@ void CalculatorWindow::onOperatorButtonClicked() {
 }
 
 void CalculatorWindow::onEqualsButtonClicked() {
+    TraceScope trace("CalculatorWindow::onEqualsButtonClicked");
     if (!pendingOperator.isEmpty()) {
-        double inputValue = currentInput.toDouble();
-        double result = engine->performBasicOperation(operand, inputValue, pendingOperator.at(0).toLatin1());
-        currentInput = QString::number(result);
+        double inputValue = parseNumber(currentInput);
+        double result = applyOperator(operand, inputValue);
+        currentInput = formatNumber(result);
         updateDisplay();
         pendingOperator.clear();
         waitingForOperand = true;
@@ -384,6 +490,7 @@ void CalculatorWindow::onEqualsButtonClicked() {
 }
 
 void CalculatorWindow::onClearButtonClicked() {
+    TraceScope trace("CalculatorWindow::onClearButtonClicked");
     currentInput = "0";
     pendingOperator.clear();
     operand = 0.0;
@@ -392,12 +499,14 @@ void CalculatorWindow::onClearButtonClicked() {
 }
 
 void CalculatorWindow::onClearEntryButtonClicked() {
+    TraceScope trace("CalculatorWindow::onClearEntryButtonClicked");
     currentInput = "0";
     waitingForOperand = true;
     updateDisplay();
 }
 
 void CalculatorWindow::onDecimalButtonClicked() {
+    TraceScope trace("CalculatorWindow::onDecimalButtonClicked");
     if (waitingForOperand) {
         currentInput = "0.";
         waitingForOperand = false;
@@ -408,41 +517,88 @@ void CalculatorWindow::onDecimalButtonClicked() {
 }
 
 void CalculatorWindow::onMemoryStoreClicked() {
-    double value = currentInput.toDouble();
+    TraceScope trace("CalculatorWindow::onMemoryStoreClicked");
+    double value = parseNumber(currentInput);
     engine->storeInMemory(value);
     updateStatusLabel();
 }
 
 void CalculatorWindow::onMemoryRecallClicked() {
+    TraceScope trace("CalculatorWindow::onMemoryRecallClicked");
     if (engine->hasMemoryValue()) {
         double value = engine->recallFromMemory();
-        currentInput = QString::number(value);
+        currentInput = formatNumber(value);
         waitingForOperand = true;
         updateDisplay();
     }
 }
 
 void CalculatorWindow::onMemoryClearClicked() {
+    TraceScope trace("CalculatorWindow::onMemoryClearClicked");
     engine->clearMemory();
     updateStatusLabel();
 }
 
 void CalculatorWindow::onMemoryStatusClicked() {
+    TraceScope trace("CalculatorWindow::onMemoryStatusClicked");
     engine->showMemoryStatus();
 }
 
+void CalculatorWindow::onRegisterStoreClicked() {
+    TraceScope trace("CalculatorWindow::onRegisterStoreClicked");
+    QString name = registerSelector->currentText().trimmed();
+    if (engine->storeVariable(name.toStdString(), parseNumber(currentInput))) {
+        refreshRegisterList();
+        statusLabel->setText(QString("Stored in %1").arg(name));
+    } else {
+        statusLabel->setText(QString("Invalid register name '%1'").arg(name));
+    }
+}
+
+void CalculatorWindow::onRegisterRecallClicked() {
+    TraceScope trace("CalculatorWindow::onRegisterRecallClicked");
+    std::string name = registerSelector->currentText().trimmed().toStdString();
+    if (engine->hasVariable(name)) {
+        double value = engine->recallVariable(name);
+        currentInput = formatNumber(value);
+        waitingForOperand = true;
+        updateDisplay();
+    }
+}
+
+void CalculatorWindow::onRegisterClearClicked() {
+    TraceScope trace("CalculatorWindow::onRegisterClearClicked");
+    engine->clearVariable(registerSelector->currentText().trimmed().toStdString());
+    registerSelector->setEditText("");
+    refreshRegisterList();
+}
+
 void CalculatorWindow::onTrigButtonClicked() {
+    TraceScope trace("CalculatorWindow::onTrigButtonClicked");
     QPushButton *button = qobject_cast<QPushButton*>(sender());
     QString function = button->text();
     
-    double inputValue = currentInput.toDouble();
+    double inputValue = parseNumber(currentInput);
     double result = engine->performTrigOperation(function.toStdString(), inputValue);
-    currentInput = QString::number(result);
+    currentInput = formatNumber(result);
+    waitingForOperand = true;
+    updateDisplay();
+}
+
+void CalculatorWindow::onScientificButtonClicked() {
+    TraceScope trace("CalculatorWindow::onScientificButtonClicked");
+    QPushButton *button = qobject_cast<QPushButton*>(sender());
+    QString function = button->text();
+    
+    double inputValue = parseNumber(currentInput);
+    double result = engine->performScientificOperation(function.toStdString(), inputValue);
+    currentInput = formatNumber(result);
     waitingForOperand = true;
     updateDisplay();
 }
 
 void CalculatorWindow::onDegreeRadianToggleClicked() {
+    TraceScope trace("CalculatorWindow::onDegreeRadianToggleClicked");
     bool currentMode = engine->getAngleMode();
     engine->setAngleMode(!currentMode);
     degreeRadianToggle->setText(engine->getAngleMode() ? "DEG" : "RAD");
@@ -460,12 +616,33 @@ void CalculatorWindow::onShowTrigToggled(bool show) {
     degreeRadianToggle->setVisible(show);
 }
 
+void CalculatorWindow::onShowScientificToggled(bool show) {
+    // Show/hide exponential, logarithmic and hyperbolic buttons
+    for (int i = 0; i < scientificButtonCount; ++i) {
+        scientificButtons[i]->setVisible(show);
+    }
+    powerButton->setVisible(show);
+}
+
 void CalculatorWindow::onShowMemoryToggled(bool show) {
     // Show/hide memory buttons
     memoryStoreButton->setVisible(show);
     memoryRecallButton->setVisible(show);
     memoryClearButton->setVisible(show);
     memoryStatusButton->setVisible(show);
+    registerSelector->setVisible(show);
+    registerStoreButton->setVisible(show);
+    registerRecallButton->setVisible(show);
+    registerClearButton->setVisible(show);
+}
+
+void CalculatorWindow::onSaveTraceClicked() {
+    QString path = qEnvironmentVariable("CALC_TRACE", "calculator_trace.json");
+    if (Tracer::writeChromeTrace(path.toStdString())) {
+        statusLabel->setText(QString("Trace saved to %1").arg(path));
+    } else {
+        statusLabel->setText(QString("Could not write %1").arg(path));
+    }
 }
 
 void CalculatorWindow::onAboutClicked() {
@@ -474,7 +651,9 @@ void CalculatorWindow::onAboutClicked() {
         "Features:\n"
         "• Basic arithmetic operations\n"
         "• Memory functions (Store, Recall, Clear)\n"
+        "• Named registers (STO/RCL/CLR)\n"
         "• Trigonometric functions\n"
+        "• Exponential, logarithmic and hyperbolic functions\n"
         "• Degree/Radian mode switching\n\n"
         "Built with Qt and C++\n"
         "Architecture: Multi-platform core engine\n\n"
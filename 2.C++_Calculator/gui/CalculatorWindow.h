@@ -12,6 +12,7 @@
 #include <QMenu>
 #include <QAction>
 #include <QButtonGroup>
+#include <QComboBox>
 #include "../core/CalculatorEngine.h"
 
 class CalculatorWindow : public QMainWindow {
@@ -30,7 +31,9 @@ private:
     // Button layouts
     QGridLayout* buttonLayout;
     QHBoxLayout* memoryButtonLayout;
+    QHBoxLayout* registerLayout;
     QHBoxLayout* trigButtonLayout;
+    QHBoxLayout* scientificButtonLayout;
     
     // Number buttons (0-9)
     QPushButton* numberButtons[10];
@@ -51,6 +54,12 @@ private:
     QPushButton* memoryClearButton;
     QPushButton* memoryStatusButton;
     
+    // Named registers: pick or type a name, then STO/RCL/CLR
+    QComboBox* registerSelector;
+    QPushButton* registerStoreButton;
+    QPushButton* registerRecallButton;
+    QPushButton* registerClearButton;
+    
     // Trigonometric buttons
     QPushButton* sinButton;
     QPushButton* cosButton;
@@ -59,6 +68,12 @@ private:
     QPushButton* acosButton;
     QPushButton* atanButton;
     
+    // Exponential, logarithmic and hyperbolic buttons; the labels are the
+    // engine's function names.  xʸ is a binary operator like +.
+    static const int scientificButtonCount = 10;
+    QPushButton* scientificButtons[scientificButtonCount];
+    QPushButton* powerButton;
+    
     // Mode buttons
     QPushButton* degreeRadianToggle;
     
@@ -66,7 +81,9 @@ private:
     QMenu* viewMenu;
     QMenu* helpMenu;
     QAction* showTrigAction;
+    QAction* showScientificAction;
     QAction* showMemoryAction;
+    QAction* saveTraceAction;
     QAction* aboutAction;
     
     // Calculator state
@@ -82,6 +99,13 @@ private:
     void connectSignals();
     void updateDisplay();
     void updateStatusLabel();
+    void refreshRegisterList();
+    double applyOperator(double left, double right);
+    
+    // Display text through the core formatter: shortest round trip, so a
+    // chained result keeps every digit (QString::number kept six)
+    static QString formatNumber(double value);
+    static double parseNumber(const QString& text);
     
 public:
     explicit CalculatorWindow(QWidget *parent = nullptr);
@@ -100,11 +124,18 @@ private slots:
     void onMemoryClearClicked();
     void onMemoryStatusClicked();
     
+    void onRegisterStoreClicked();
+    void onRegisterRecallClicked();
+    void onRegisterClearClicked();
+    
     void onTrigButtonClicked();
+    void onScientificButtonClicked();
     void onDegreeRadianToggleClicked();
     
     void onShowTrigToggled(bool show);
+    void onShowScientificToggled(bool show);
     void onShowMemoryToggled(bool show);
+    void onSaveTraceClicked();
     void onAboutClicked();
 };
 
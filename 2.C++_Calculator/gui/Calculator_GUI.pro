@@ -12,14 +12,51 @@ SOURCES += \
     CalculatorWindow.cpp \
     ../core/CalculatorEngine.cpp \
     ../core/Memory.cpp \
-    ../core/TrigCalculator.cpp
+    ../core/TrigCalculator.cpp \
+    ../core/ComplexCalculator.cpp \
+    ../core/FFT.cpp \
+    ../core/Expression.cpp \
+    ../core/JitCompiler.cpp \
+    ../core/TableEvaluator.cpp \
+    ../core/EngineStats.cpp \
+    ../core/Tracer.cpp \
+    ../core/WorkloadTrace.cpp \
+    ../core/EngineState.cpp \
+    ../core/Worksheet.cpp \
+    ../core/ThreadPool.cpp \
+    ../core/CpuDispatch.cpp \
+    ../core/ScientificCalculator.cpp \
+    ../core/Polynomial.cpp \
+    ../core/NumberTheory.cpp \
+    ../core/Combinatorics.cpp \
+    ../core/NumberFormat.cpp
 
 # Header files
 HEADERS += \
     CalculatorWindow.h \
     ../core/CalculatorEngine.h \
     ../core/Memory.h \
-    ../core/TrigCalculator.h
+    ../core/TrigCalculator.h \
+    ../core/ComplexCalculator.h \
+    ../core/FFT.h \
+    ../core/Expression.h \
+    ../core/JitCompiler.h \
+    ../core/CalcKernels.h \
+    ../core/Precision.h \
+    ../core/TableEvaluator.h \
+    ../core/EngineStats.h \
+    ../core/Tracer.h \
+    ../core/WorkloadTrace.h \
+    ../core/EngineState.h \
+    ../core/Worksheet.h \
+    ../core/ThreadPool.h \
+    ../core/CpuDispatch.h \
+    ../core/ScientificCalculator.h \
+    ../core/ScientificKernels.h \
+    ../core/Polynomial.h \
+    ../core/NumberTheory.h \
+    ../core/Combinatorics.h \
+    ../core/NumberFormat.h
 
 # Include paths
 INCLUDEPATH += ../core
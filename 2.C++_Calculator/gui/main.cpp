@@ -2,6 +2,7 @@
 #include <QStyleFactory>
 #include <QDir>
 #include "CalculatorWindow.h"
+#include "../core/Tracer.h"
 
 int main(int argc, char *argv[]) {
     QApplication app(argc, argv);
@@ -32,9 +33,19 @@ int main(int argc, char *argv[]) {
     darkPalette.setColor(QPalette::HighlightedText, Qt::black);
     app.setPalette(darkPalette);
     
+    // CALC_TRACE=<file.json> records a Chrome trace, written on exit
+    QByteArray tracePath = qgetenv("CALC_TRACE");
+    if (!tracePath.isEmpty()) {
+        Tracer::setEnabled(true);
+    }
+    
     // Create and show the calculator window
     CalculatorWindow calculator;
     calculator.show();
     
-    return app.exec();
+    int result = app.exec();
+    if (!tracePath.isEmpty()) {
+        Tracer::writeChromeTrace(tracePath.toStdString());
+    }
+    return result;
 }
\ No newline at end of file
@@ -0,0 +1,220 @@
+#include "AsyncCalculator.h"
+#include <cmath>
+
+using namespace std;
+
+namespace {
+
+// Mirror of Dart_CObject from dart_native_api.h (the type field, then the
+// value union at offset 8); only the variants posted here are declared.
+struct DartCObject {
+    int32_t type;
+    union {
+        int64_t asInt64;
+        double asDouble;
+        struct {
+            intptr_t length;
+            DartCObject** values;
+        } asArray;
+    } value;
+};
+
+const int32_t dartInt64 = 3;    // Dart_CObject_kInt64
+const int32_t dartDouble = 4;   // Dart_CObject_kDouble
+const int32_t dartArray = 6;    // Dart_CObject_kArray
+
+const char* const trigNames[6] = {"sin", "cos", "tan", "asin", "acos", "atan"};
+
+} // namespace
+
+atomic<AsyncCalculator::PostCObjectFunction> AsyncCalculator::postCObject(nullptr);
+
+AsyncCalculator::AsyncCalculator(CalculatorEngine* engine)
+    : engine(engine), queue(queueCapacity), sleeping(false), stopping(false),
+      callback(nullptr), userData(nullptr), dartPort(0), batches(0), processed(0) {
+    worker = thread(&AsyncCalculator::run, this);
+}
+
+AsyncCalculator::~AsyncCalculator() {
+    stopping.store(true);
+    {
+        lock_guard<mutex> guard(wakeLock);
+        wake.notify_one();
+    }
+    worker.join();
+}
+
+void AsyncCalculator::setCallback(CalculatorCompletionCallback function, void* data) {
+    lock_guard<mutex> guard(deliveryLock);
+    callback = function;
+    userData = data;
+}
+
+void AsyncCalculator::setDartPort(int64_t port) {
+    lock_guard<mutex> guard(deliveryLock);
+    dartPort = port;
+}
+
+void AsyncCalculator::setPostCObject(PostCObjectFunction function) {
+    postCObject.store(function);
+}
+
+void AsyncCalculator::notifyWorker() {
+    // Pairs with the fence in run(): either the worker sees the new request
+    // before sleeping or we see it asleep and wake it
+    atomic_thread_fence(memory_order_seq_cst);
+    if (sleeping.load(memory_order_relaxed)) {
+        lock_guard<mutex> guard(wakeLock);
+        wake.notify_one();
+    }
+}
+
+bool AsyncCalculator::submit(const CalculatorRequest& request) {
+    if (!queue.push(request)) {
+        return false;
+    }
+    notifyWorker();
+    return true;
+}
+
+size_t AsyncCalculator::submit(const CalculatorRequest* requests, size_t count) {
+    size_t accepted = 0;
+    while (accepted < count && queue.push(requests[accepted])) {
+        accepted++;
+    }
+    if (accepted > 0) {
+        notifyWorker();
+    }
+    return accepted;
+}
+
+uint64_t AsyncCalculator::getBatches() {
+    return batches.load(memory_order_relaxed);
+}
+
+uint64_t AsyncCalculator::getProcessed() {
+    return processed.load(memory_order_relaxed);
+}
+
+void AsyncCalculator::run() {
+    vector<CalculatorCompletion> completions;
+    completions.reserve(maxBatch);
+    CalculatorRequest request;
+
+    for (;;) {
+        completions.clear();
+        while (completions.size() < maxBatch && queue.pop(request)) {
+            completions.push_back(execute(request));
+        }
+        if (!completions.empty()) {
+            deliver(completions);
+            processed.fetch_add(completions.size(), memory_order_relaxed);
+            batches.fetch_add(1, memory_order_relaxed);
+            continue;
+        }
+        if (stopping.load()) {
+            break;
+        }
+
+        unique_lock<mutex> lock(wakeLock);
+        sleeping.store(true, memory_order_relaxed);
+        atomic_thread_fence(memory_order_seq_cst);
+        wake.wait(lock, [this]() { return !queue.empty() || stopping.load(); });
+        sleeping.store(false, memory_order_relaxed);
+    }
+}
+
+CalculatorCompletion AsyncCalculator::execute(const CalculatorRequest& request) {
+    CalculatorCompletion completion;
+    completion.id = request.id;
+    completion.operation = request.operation;
+    completion.status = AsyncOk;
+    completion.result = 0.0;
+
+    static const char operators[4] = {'+', '-', '*', '/'};
+    switch (request.operation) {
+        case AsyncAdd:
+        case AsyncSubtract:
+        case AsyncMultiply:
+        case AsyncDivide:
+            if (request.operation == AsyncDivide && request.b == 0) {
+                completion.status = AsyncMathError;
+            }
+            completion.result = engine->performBasicOperation(request.a, request.b, operators[request.operation]);
+            break;
+        case AsyncSine:
+        case AsyncCosine:
+        case AsyncTangent:
+        case AsyncArcsine:
+        case AsyncArccosine:
+        case AsyncArctangent:
+            if ((request.operation == AsyncArcsine || request.operation == AsyncArccosine) &&
+                (request.a < -1 || request.a > 1)) {
+                completion.status = AsyncMathError;
+            }
+            completion.result = engine->performTrigOperation(trigNames[request.operation - AsyncSine], request.a);
+            break;
+        case AsyncStoreMemory:
+            engine->storeInMemory(request.a);
+            completion.result = request.a;
+            break;
+        case AsyncRecallMemory:
+            completion.result = engine->recallFromMemory();
+            break;
+        case AsyncClearMemory:
+            engine->clearMemory();
+            break;
+        case AsyncSetAngleMode:
+            engine->setAngleMode(request.a != 0);
+            completion.result = request.a;
+            break;
+        default:
+            completion.status = AsyncInvalidRequest;
+            break;
+    }
+    return completion;
+}
+
+void AsyncCalculator::deliver(const vector<CalculatorCompletion>& completions) {
+    CalculatorCompletionCallback function;
+    void* data;
+    int64_t port;
+    {
+        lock_guard<mutex> guard(deliveryLock);
+        function = callback;
+        data = userData;
+        port = dartPort;
+    }
+    if (function != nullptr) {
+        function(completions.data(), int32_t(completions.size()), data);
+    }
+    if (port != 0) {
+        postToDart(port, completions);
+    }
+}
+
+// One message per batch: [id, result, status, id, result, status, ...]
+void AsyncCalculator::postToDart(int64_t port, const vector<CalculatorCompletion>& completions) {
+    PostCObjectFunction post = postCObject.load();
+    if (post == nullptr) {
+        return;
+    }
+    vector<DartCObject> values(completions.size() * 3);
+    vector<DartCObject*> pointers(values.size());
+    for (size_t i = 0; i < completions.size(); i++) {
+        values[3 * i].type = dartInt64;
+        values[3 * i].value.asInt64 = int64_t(completions[i].id);
+        values[3 * i + 1].type = dartDouble;
+        values[3 * i + 1].value.asDouble = completions[i].result;
+        values[3 * i + 2].type = dartInt64;
+        values[3 * i + 2].value.asInt64 = completions[i].status;
+    }
+    for (size_t i = 0; i < values.size(); i++) {
+        pointers[i] = &values[i];
+    }
+    DartCObject message;
+    message.type = dartArray;
+    message.value.asArray.length = intptr_t(pointers.size());
+    message.value.asArray.values = pointers.data();
+    post(port, &message);
+}
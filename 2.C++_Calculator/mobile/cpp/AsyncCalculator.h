@@ -0,0 +1,177 @@
+#ifndef ASYNCCALCULATOR_H
+#define ASYNCCALCULATOR_H
+
+#include "../core/CalculatorEngine.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Plain C layouts shared with Dart (see calculator_ffi.cpp)
+extern "C" {
+typedef struct {
+    uint64_t id;
+    int32_t operation;   // CalculatorAsyncOperation
+    int32_t reserved;
+    double a;
+    double b;
+} CalculatorRequest;
+
+typedef struct {
+    uint64_t id;
+    double result;
+    int32_t operation;
+    int32_t status;      // CalculatorAsyncStatus
+} CalculatorCompletion;
+
+typedef void (*CalculatorCompletionCallback)(const CalculatorCompletion* completions, int32_t count, void* userData);
+}
+
+enum CalculatorAsyncOperation {
+    AsyncAdd,
+    AsyncSubtract,
+    AsyncMultiply,
+    AsyncDivide,
+    AsyncSine,
+    AsyncCosine,
+    AsyncTangent,
+    AsyncArcsine,
+    AsyncArccosine,
+    AsyncArctangent,
+    AsyncStoreMemory,
+    AsyncRecallMemory,
+    AsyncClearMemory,
+    AsyncSetAngleMode    // a != 0 selects degrees
+};
+
+enum CalculatorAsyncStatus {
+    AsyncOk,
+    AsyncMathError,      // division by zero, asin/acos domain
+    AsyncInvalidRequest
+};
+
+// Bounded lock-free queue for many producers and one consumer (Vyukov's
+// sequence-numbered ring).  push() fails instead of blocking when full.
+template <typename T>
+class MpscQueue {
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T data;
+    };
+
+    std::unique_ptr<Cell[]> cells;
+    size_t mask;
+    alignas(64) std::atomic<size_t> enqueuePosition;
+    alignas(64) size_t dequeuePosition;   // consumer only
+
+public:
+    explicit MpscQueue(size_t capacity) : enqueuePosition(0), dequeuePosition(0) {
+        size_t size = 1;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        cells.reset(new Cell[size]);
+        mask = size - 1;
+        for (size_t i = 0; i < size; i++) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    bool push(const T& value) {
+        size_t position = enqueuePosition.load(std::memory_order_relaxed);
+        Cell* cell;
+        for (;;) {
+            cell = &cells[position & mask];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            intptr_t difference = intptr_t(sequence) - intptr_t(position);
+            if (difference == 0) {
+                if (enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (difference < 0) {
+                return false;
+            } else {
+                position = enqueuePosition.load(std::memory_order_relaxed);
+            }
+        }
+        cell->data = value;
+        cell->sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(T& value) {
+        Cell* cell = &cells[dequeuePosition & mask];
+        if (cell->sequence.load(std::memory_order_acquire) != dequeuePosition + 1) {
+            return false;
+        }
+        value = cell->data;
+        cell->sequence.store(dequeuePosition + mask + 1, std::memory_order_release);
+        dequeuePosition++;
+        return true;
+    }
+
+    bool empty() const {
+        return cells[dequeuePosition & mask].sequence.load(std::memory_order_acquire) != dequeuePosition + 1;
+    }
+};
+
+// Runs engine requests on a native worker thread so the Dart UI isolate
+// never blocks.  Producers push into the lock-free queue from any thread;
+// the worker drains up to maxBatch requests per wakeup and hands all of
+// their completions over at once, through a C callback or by posting one
+// message to a Dart native port.  While a worker is attached, the engine
+// must only be used through it.
+class AsyncCalculator {
+public:
+    static const size_t queueCapacity = 4096;
+    static const size_t maxBatch = 256;
+
+    // Dart_PostCObject, as exposed to Dart by NativeApi.postCObject
+    typedef bool (*PostCObjectFunction)(int64_t port, void* message);
+
+private:
+    CalculatorEngine* engine;
+    MpscQueue<CalculatorRequest> queue;
+    std::thread worker;
+
+    std::mutex wakeLock;
+    std::condition_variable wake;
+    std::atomic<bool> sleeping;
+    std::atomic<bool> stopping;
+
+    std::mutex deliveryLock;
+    CalculatorCompletionCallback callback;
+    void* userData;
+    int64_t dartPort;
+    static std::atomic<PostCObjectFunction> postCObject;
+
+    std::atomic<uint64_t> batches;
+    std::atomic<uint64_t> processed;
+
+    void run();
+    CalculatorCompletion execute(const CalculatorRequest& request);
+    void deliver(const std::vector<CalculatorCompletion>& completions);
+    void postToDart(int64_t port, const std::vector<CalculatorCompletion>& completions);
+    void notifyWorker();
+
+public:
+    explicit AsyncCalculator(CalculatorEngine* engine);
+    ~AsyncCalculator();   // finishes queued requests, then stops
+
+    void setCallback(CalculatorCompletionCallback callback, void* userData);
+    void setDartPort(int64_t port);
+    static void setPostCObject(PostCObjectFunction function);
+
+    bool submit(const CalculatorRequest& request);
+    size_t submit(const CalculatorRequest* requests, size_t count);
+
+    uint64_t getBatches();   // deliveries so far (one per drained batch)
+    uint64_t getProcessed();
+};
+
+#endif // ASYNCCALCULATOR_H
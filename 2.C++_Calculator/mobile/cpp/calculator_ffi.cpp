@@ -1,6 +1,10 @@
 #include "../core/CalculatorEngine.h"
+#include "../core/EngineStats.h"
 #include "../core/Memory.h" 
+#include "../core/NumberFormat.h"
 #include "../core/TrigCalculator.h"
+#include "AsyncCalculator.h"
+#include <cstring>
 
 // FFI exports for Flutter integration
 // These functions provide a C-style interface to our C++ calculator classes
@@ -67,6 +71,151 @@ extern "C" {
         return engine->performTrigOperation("atan", value);
     }
     
+    // Writes sine and cosine of one angle, reducing it only once
+    bool calculator_sincos(CalculatorEngine* engine, double angle, double* sine, double* cosine) {
+        if (engine == nullptr || sine == nullptr || cosine == nullptr) return false;
+        engine->performSineCosine(angle, *sine, *cosine);
+        return true;
+    }
+    
+    // Exponential, logarithmic and hyperbolic operations
+    double calculator_exp(CalculatorEngine* engine, double value) {
+        if (engine == nullptr) return 0.0;
+        return engine->performScientificOperation("exp", value);
+    }
+    
+    double calculator_ln(CalculatorEngine* engine, double value) {
+        if (engine == nullptr) return 0.0;
+        return engine->performScientificOperation("ln", value);
+    }
+    
+    double calculator_log10(CalculatorEngine* engine, double value) {
+        if (engine == nullptr) return 0.0;
+        return engine->performScientificOperation("log10", value);
+    }
+    
+    double calculator_sqrt(CalculatorEngine* engine, double value) {
+        if (engine == nullptr) return 0.0;
+        return engine->performScientificOperation("sqrt", value);
+    }
+    
+    double calculator_power(CalculatorEngine* engine, double base, double exponent) {
+        if (engine == nullptr) return 0.0;
+        return engine->power(base, exponent);
+    }
+    
+    double calculator_sinh(CalculatorEngine* engine, double value) {
+        if (engine == nullptr) return 0.0;
+        return engine->performScientificOperation("sinh", value);
+    }
+    
+    double calculator_cosh(CalculatorEngine* engine, double value) {
+        if (engine == nullptr) return 0.0;
+        return engine->performScientificOperation("cosh", value);
+    }
+    
+    double calculator_tanh(CalculatorEngine* engine, double value) {
+        if (engine == nullptr) return 0.0;
+        return engine->performScientificOperation("tanh", value);
+    }
+    
+    double calculator_asinh(CalculatorEngine* engine, double value) {
+        if (engine == nullptr) return 0.0;
+        return engine->performScientificOperation("asinh", value);
+    }
+    
+    double calculator_acosh(CalculatorEngine* engine, double value) {
+        if (engine == nullptr) return 0.0;
+        return engine->performScientificOperation("acosh", value);
+    }
+    
+    double calculator_atanh(CalculatorEngine* engine, double value) {
+        if (engine == nullptr) return 0.0;
+        return engine->performScientificOperation("atanh", value);
+    }
+    
+    // Combinatorics
+    double calculator_factorial(CalculatorEngine* engine, double n) {
+        if (engine == nullptr) return 0.0;
+        return engine->factorial(n);
+    }
+    
+    double calculator_gamma(CalculatorEngine* engine, double x) {
+        if (engine == nullptr) return 0.0;
+        return engine->gamma(x);
+    }
+    
+    double calculator_permutations(CalculatorEngine* engine, double n, double k) {
+        if (engine == nullptr) return 0.0;
+        return engine->permutations(n, k);
+    }
+    
+    double calculator_combinations(CalculatorEngine* engine, double n, double k) {
+        if (engine == nullptr) return 0.0;
+        return engine->combinations(n, k);
+    }
+    
+    // Decimal digits of C(n, k) into buffer; returns the full length needed,
+    // 0 when n is above the exact limit
+    int calculator_combinations_exact(CalculatorEngine* engine, uint64_t n, uint64_t k, char* buffer, int size) {
+        if (engine == nullptr) return 0;
+        std::string digits = engine->exactCombinations(n, k);
+        if (buffer != nullptr && size > 0) {
+            size_t length = std::min(digits.size(), size_t(size - 1));
+            std::memcpy(buffer, digits.data(), length);
+            buffer[length] = '\0';
+        }
+        return int(digits.size());
+    }
+    
+    // Batches over caller-owned arrays, e.g. function = "exp".  Silent:
+    // domain errors give 0.  Returns false for an unknown function.
+    bool calculator_scientific_array(CalculatorEngine* engine, const char* function,
+                                     const double* values, double* out, int32_t count) {
+        if (engine == nullptr || function == nullptr || !engine->isValidScientificFunction(function)) return false;
+        if (count <= 0) return true;
+        if (values == nullptr || out == nullptr) return false;
+        engine->performScientificOperation(function, values, out, size_t(count));
+        return true;
+    }
+    
+    bool calculator_power_array(CalculatorEngine* engine, const double* bases, const double* exponents,
+                                double* out, int32_t count) {
+        if (engine == nullptr) return false;
+        if (count <= 0) return true;
+        if (bases == nullptr || exponents == nullptr || out == nullptr) return false;
+        engine->performPowerOperation(bases, exponents, out, size_t(count));
+        return true;
+    }
+    
+    bool calculator_sincos_array(CalculatorEngine* engine, const double* angles,
+                                 double* sines, double* cosines, int32_t count) {
+        if (engine == nullptr) return false;
+        if (count <= 0) return true;
+        if (angles == nullptr || sines == nullptr || cosines == nullptr) return false;
+        engine->performSineCosine(angles, sines, cosines, size_t(count));
+        return true;
+    }
+    
+    // Angles in the engine's angle mode
+    bool calculator_polar_to_rectangular_array(CalculatorEngine* engine, const double* magnitudes,
+                                               const double* angles, double* xs, double* ys, int32_t count) {
+        if (engine == nullptr) return false;
+        if (count <= 0) return true;
+        if (magnitudes == nullptr || angles == nullptr || xs == nullptr || ys == nullptr) return false;
+        engine->polarToRectangular(magnitudes, angles, xs, ys, size_t(count));
+        return true;
+    }
+    
+    bool calculator_rectangular_to_polar_array(CalculatorEngine* engine, const double* xs, const double* ys,
+                                               double* magnitudes, double* angles, int32_t count) {
+        if (engine == nullptr) return false;
+        if (count <= 0) return true;
+        if (xs == nullptr || ys == nullptr || magnitudes == nullptr || angles == nullptr) return false;
+        engine->rectangularToPolar(xs, ys, magnitudes, angles, size_t(count));
+        return true;
+    }
+    
     // Memory operations
     void calculator_store_memory(CalculatorEngine* engine, double value) {
         if (engine != nullptr) {
@@ -90,6 +239,81 @@ extern "C" {
         return engine->hasMemoryValue();
     }
     
+    // Named registers.  Names are identifiers of up to 15 characters.
+    bool calculator_variable_store(CalculatorEngine* engine, const char* name, double value) {
+        if (engine == nullptr || name == nullptr) return false;
+        return engine->storeVariable(name, value);
+    }
+    
+    double calculator_variable_recall(CalculatorEngine* engine, const char* name) {
+        if (engine == nullptr || name == nullptr) return 0.0;
+        return engine->recallVariable(name);
+    }
+    
+    bool calculator_variable_has(CalculatorEngine* engine, const char* name) {
+        if (engine == nullptr || name == nullptr) return false;
+        return engine->hasVariable(name);
+    }
+    
+    void calculator_variable_clear(CalculatorEngine* engine, const char* name) {
+        if (engine == nullptr || name == nullptr) return;
+        engine->clearVariable(name);
+    }
+    
+    void calculator_variables_clear(CalculatorEngine* engine) {
+        if (engine == nullptr) return;
+        engine->clearVariables();
+    }
+    
+    // Stable id for name (-1 if the name is invalid), for the by-id calls
+    int32_t calculator_variable_id(CalculatorEngine* engine, const char* name) {
+        if (engine == nullptr || name == nullptr) return -1;
+        size_t id = engine->getVariableId(name);
+        return id == VariableTable::npos ? -1 : int32_t(id);
+    }
+    
+    double calculator_variable_get(CalculatorEngine* engine, int32_t id) {
+        if (engine == nullptr || id < 0) return 0.0;
+        return engine->getVariable(size_t(id));
+    }
+    
+    void calculator_variable_set(CalculatorEngine* engine, int32_t id, double value) {
+        if (engine == nullptr || id < 0) return;
+        engine->setVariable(size_t(id), value);
+    }
+    
+    // Defined names, newline separated; returns the full length needed
+    int calculator_variable_names(CalculatorEngine* engine, char* buffer, int size) {
+        if (engine == nullptr) return 0;
+        std::string names;
+        for (const std::string& name : engine->getVariableNames()) {
+            names += name;
+            names += '\n';
+        }
+        if (buffer != nullptr && size > 0) {
+            size_t length = std::min(names.size(), size_t(size - 1));
+            std::memcpy(buffer, names.data(), length);
+            buffer[length] = '\0';
+        }
+        return int(names.size());
+    }
+    
+    // Whole-memory snapshots (M register and named registers, kept by name,
+    // so a snapshot from one engine restores into any other)
+    Memory::Snapshot* calculator_memory_save(CalculatorEngine* engine) {
+        if (engine == nullptr) return nullptr;
+        return new Memory::Snapshot(engine->saveMemory());
+    }
+    
+    void calculator_memory_restore(CalculatorEngine* engine, const Memory::Snapshot* snapshot) {
+        if (engine == nullptr || snapshot == nullptr) return;
+        engine->restoreMemory(*snapshot);
+    }
+    
+    void calculator_memory_snapshot_free(Memory::Snapshot* snapshot) {
+        delete snapshot;
+    }
+    
     // Mode operations
     void calculator_set_angle_mode(CalculatorEngine* engine, bool degrees) {
         if (engine != nullptr) {
@@ -106,4 +330,110 @@ extern "C" {
         if (engine == nullptr) return 0.0;
         return engine->getLastResult();
     }
+    
+    // Engine state block (see EngineState.h for the layout and the seqlock
+    // protocol).  Valid until destroy_calculator_engine.
+    const EngineStateBlock* calculator_get_state(CalculatorEngine* engine) {
+        if (engine == nullptr) return nullptr;
+        return engine->getStateBlock();
+    }
+    
+    // Consistent copy of the state for callers that cannot run the seqlock
+    // loop themselves
+    bool calculator_read_state(CalculatorEngine* engine, EngineStateSnapshot* out) {
+        if (engine == nullptr || out == nullptr) return false;
+        *out = engine->getState();
+        return true;
+    }
+    
+    // Instrumentation (process-wide, off by default)
+    void calculator_stats_set_enabled(bool enabled) {
+        EngineStats::setEnabled(enabled);
+    }
+    
+    void calculator_stats_reset() {
+        EngineStats::reset();
+    }
+    
+    // Copies the counters into a caller-allocated EngineStats::Snapshot
+    // (plain uint64 arrays, see EngineStats.h for the layout)
+    void calculator_stats_snapshot(EngineStats::Snapshot* out) {
+        if (out != nullptr) {
+            *out = EngineStats::snapshot();
+        }
+    }
+    
+    // Text report into buffer; returns the full length needed
+    int calculator_stats_report(char* buffer, int size) {
+        std::string report = EngineStats::snapshot().toString();
+        if (buffer != nullptr && size > 0) {
+            size_t length = std::min(report.size(), size_t(size - 1));
+            std::memcpy(buffer, report.data(), length);
+            buffer[length] = '\0';
+        }
+        return int(report.size());
+    }
+    
+    // Number text shared with the other front ends (see NumberFormat.h).
+    // digits 0 = shortest round trip; notation 0 general, 1 scientific,
+    // 2 engineering.  Returns the full length; NumberFormat::bufferSize
+    // (32) always fits.
+    int calculator_format_number(double value, int32_t digits, int32_t notation, char* buffer, int size) {
+        if (notation < 0 || notation > 2) notation = 0;
+        return int(NumberFormat::format(value, buffer, buffer != nullptr && size > 0 ? size_t(size) : 0,
+                                        digits, Notation(notation)));
+    }
+    
+    // NUL-terminated text; false (value untouched) when it is not a number
+    bool calculator_parse_number(const char* text, double* value) {
+        if (text == nullptr || value == nullptr) return false;
+        return NumberFormat::parse(text, std::strlen(text), *value);
+    }
+    
+    // Asynchronous worker.  While attached, the engine must only be used
+    // through the worker; destroy it before destroy_calculator_engine.
+    AsyncCalculator* calculator_async_create(CalculatorEngine* engine) {
+        if (engine == nullptr) return nullptr;
+        return new AsyncCalculator(engine);
+    }
+    
+    // Finishes queued requests, then stops the worker thread
+    void calculator_async_destroy(AsyncCalculator* async) {
+        delete async;
+    }
+    
+    // Called on the worker thread with each batch of completions
+    void calculator_async_set_callback(AsyncCalculator* async, CalculatorCompletionCallback callback, void* userData) {
+        if (async == nullptr) return;
+        async->setCallback(callback, userData);
+    }
+    
+    // Pass NativeApi.postCObject from Dart once per process
+    void calculator_async_init_dart_api(void* postCObject) {
+        AsyncCalculator::setPostCObject(reinterpret_cast<AsyncCalculator::PostCObjectFunction>(postCObject));
+    }
+    
+    // Completions are posted to this port as [id, result, status, ...]; 0 disables
+    void calculator_async_set_dart_port(AsyncCalculator* async, int64_t port) {
+        if (async == nullptr) return;
+        async->setDartPort(port);
+    }
+    
+    // Returns false when the queue is full
+    bool calculator_async_submit(AsyncCalculator* async, uint64_t id, int32_t operation, double a, double b) {
+        if (async == nullptr) return false;
+        CalculatorRequest request;
+        request.id = id;
+        request.operation = operation;
+        request.reserved = 0;
+        request.a = a;
+        request.b = b;
+        return async->submit(request);
+    }
+    
+    // Returns how many requests were queued (a prefix of the array)
+    int32_t calculator_async_submit_batch(AsyncCalculator* async, const CalculatorRequest* requests, int32_t count) {
+        if (async == nullptr || requests == nullptr || count <= 0) return 0;
+        return int32_t(async->submit(requests, size_t(count)));
+    }
 }
\ No newline at end of file
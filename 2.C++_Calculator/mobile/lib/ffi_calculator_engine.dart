@@ -1,6 +1,8 @@
 import 'dart:ffi';
 import 'dart:io';
 
+import 'package:ffi/ffi.dart';
+
 // FFI integration with C++ calculator engine
 // This provides the bridge between Dart and our C++ calculator classes
 
@@ -32,6 +34,60 @@ typedef CalculatorBoolGet = bool Function(Pointer);
 typedef CalculatorMemoryClearC = Void Function(Pointer);
 typedef CalculatorMemoryClear = void Function(Pointer);
 
+typedef CalculatorGetStateC = Pointer<CalculatorStateBlock> Function(Pointer);
+typedef CalculatorGetState = Pointer<CalculatorStateBlock> Function(Pointer);
+
+typedef CalculatorFormatNumberC = Int32 Function(Double, Int32, Int32, Pointer<Utf8>, Int32);
+typedef CalculatorFormatNumber = int Function(double, int, int, Pointer<Utf8>, int);
+
+typedef CalculatorParseNumberC = Bool Function(Pointer<Utf8>, Pointer<Double>);
+typedef CalculatorParseNumber = bool Function(Pointer<Utf8>, Pointer<Double>);
+
+// Mirrors EngineStateBlock in core/EngineState.h.  The engine updates it in
+// place; sequence is odd while an update is in progress.
+class CalculatorStateBlock extends Struct {
+  @Uint32()
+  external int sequence;
+
+  @Uint32()
+  external int flags;
+
+  @Uint32()
+  external int errors;
+
+  @Uint32()
+  external int reserved;
+
+  @Double()
+  external double lastResult;
+
+  @Double()
+  external double memoryValue;
+
+  @Uint64()
+  external int updateCount;
+}
+
+class CalculatorState {
+  static const int hasMemoryFlag = 1;
+  static const int degreesFlag = 2;
+
+  static const int divisionByZeroError = 1;
+  static const int invalidOperationError = 2;
+  static const int domainError = 4;
+
+  final int flags;
+  final int errors;
+  final double lastResult;
+  final double memoryValue;
+  final int updateCount;
+
+  const CalculatorState(this.flags, this.errors, this.lastResult, this.memoryValue, this.updateCount);
+
+  bool get hasMemory => (flags & hasMemoryFlag) != 0;
+  bool get isDegrees => (flags & degreesFlag) != 0;
+}
+
 class FFICalculatorEngine {
   static DynamicLibrary? _library;
   Pointer? _engine;
@@ -49,6 +105,21 @@ class FFICalculatorEngine {
   late final CalculatorUnaryOperation _arcsine;
   late final CalculatorUnaryOperation _arccosine;
   late final CalculatorUnaryOperation _arctangent;
+  late final CalculatorUnaryOperation _exp;
+  late final CalculatorUnaryOperation _ln;
+  late final CalculatorUnaryOperation _log10;
+  late final CalculatorUnaryOperation _sqrt;
+  late final CalculatorUnaryOperation _sinh;
+  late final CalculatorUnaryOperation _cosh;
+  late final CalculatorUnaryOperation _tanh;
+  late final CalculatorUnaryOperation _asinh;
+  late final CalculatorUnaryOperation _acosh;
+  late final CalculatorUnaryOperation _atanh;
+  late final CalculatorOperation _power;
+  late final CalculatorUnaryOperation _factorial;
+  late final CalculatorUnaryOperation _gamma;
+  late final CalculatorOperation _permutations;
+  late final CalculatorOperation _combinations;
   late final CalculatorMemorySet _storeMemory;
   late final CalculatorMemoryGet _recallMemory;
   late final CalculatorMemoryClear _clearMemory;
@@ -56,12 +127,17 @@ class FFICalculatorEngine {
   late final CalculatorBoolSet _setAngleMode;
   late final CalculatorBoolGet _getAngleMode;
   late final CalculatorMemoryGet _getLastResult;
+  late final CalculatorGetState _getState;
+  late final CalculatorFormatNumber _formatNumber;
+  late final CalculatorParseNumber _parseNumber;
+  Pointer<CalculatorStateBlock>? _state;
 
   FFICalculatorEngine() {
     _loadLibrary();
     if (_library != null) {
       _bindFunctions();
       _engine = _createEngine();
+      _state = _getState(_engine!);
     }
   }
 
@@ -135,6 +211,66 @@ class FFICalculatorEngine {
         .lookup<NativeFunction<CalculatorUnaryOperationC>>('calculator_arctangent')
         .asFunction();
 
+    _exp = _library!
+        .lookup<NativeFunction<CalculatorUnaryOperationC>>('calculator_exp')
+        .asFunction();
+
+    _ln = _library!
+        .lookup<NativeFunction<CalculatorUnaryOperationC>>('calculator_ln')
+        .asFunction();
+
+    _log10 = _library!
+        .lookup<NativeFunction<CalculatorUnaryOperationC>>('calculator_log10')
+        .asFunction();
+
+    _sqrt = _library!
+        .lookup<NativeFunction<CalculatorUnaryOperationC>>('calculator_sqrt')
+        .asFunction();
+
+    _sinh = _library!
+        .lookup<NativeFunction<CalculatorUnaryOperationC>>('calculator_sinh')
+        .asFunction();
+
+    _cosh = _library!
+        .lookup<NativeFunction<CalculatorUnaryOperationC>>('calculator_cosh')
+        .asFunction();
+
+    _tanh = _library!
+        .lookup<NativeFunction<CalculatorUnaryOperationC>>('calculator_tanh')
+        .asFunction();
+
+    _asinh = _library!
+        .lookup<NativeFunction<CalculatorUnaryOperationC>>('calculator_asinh')
+        .asFunction();
+
+    _acosh = _library!
+        .lookup<NativeFunction<CalculatorUnaryOperationC>>('calculator_acosh')
+        .asFunction();
+
+    _atanh = _library!
+        .lookup<NativeFunction<CalculatorUnaryOperationC>>('calculator_atanh')
+        .asFunction();
+
+    _power = _library!
+        .lookup<NativeFunction<CalculatorOperationC>>('calculator_power')
+        .asFunction();
+
+    _factorial = _library!
+        .lookup<NativeFunction<CalculatorUnaryOperationC>>('calculator_factorial')
+        .asFunction();
+
+    _gamma = _library!
+        .lookup<NativeFunction<CalculatorUnaryOperationC>>('calculator_gamma')
+        .asFunction();
+
+    _permutations = _library!
+        .lookup<NativeFunction<CalculatorOperationC>>('calculator_permutations')
+        .asFunction();
+
+    _combinations = _library!
+        .lookup<NativeFunction<CalculatorOperationC>>('calculator_combinations')
+        .asFunction();
+
     _storeMemory = _library!
         .lookup<NativeFunction<CalculatorMemorySetC>>('calculator_store_memory')
         .asFunction();
@@ -162,6 +298,18 @@ class FFICalculatorEngine {
     _getLastResult = _library!
         .lookup<NativeFunction<CalculatorMemoryGetC>>('calculator_get_last_result')
         .asFunction();
+
+    _getState = _library!
+        .lookup<NativeFunction<CalculatorGetStateC>>('calculator_get_state')
+        .asFunction();
+
+    _formatNumber = _library!
+        .lookup<NativeFunction<CalculatorFormatNumberC>>('calculator_format_number')
+        .asFunction();
+
+    _parseNumber = _library!
+        .lookup<NativeFunction<CalculatorParseNumberC>>('calculator_parse_number')
+        .asFunction();
   }
 
   bool get isAvailable => _library != null && _engine != null;
@@ -251,6 +399,145 @@ class FFICalculatorEngine {
     return _arctangent(_engine!, value);
   }
 
+  // Exponential, logarithmic and hyperbolic operations
+  double exp(double value) {
+    if (!isAvailable) return math.exp(value); // Fallback
+    return _exp(_engine!, value);
+  }
+
+  double ln(double value) {
+    if (!isAvailable) {
+      if (value <= 0) throw ArgumentError('Domain error: Input must be positive');
+      return math.log(value); // Fallback
+    }
+    return _ln(_engine!, value);
+  }
+
+  double log10(double value) {
+    if (!isAvailable) {
+      if (value <= 0) throw ArgumentError('Domain error: Input must be positive');
+      return math.log(value) / math.ln10; // Fallback
+    }
+    return _log10(_engine!, value);
+  }
+
+  double sqrt(double value) {
+    if (!isAvailable) {
+      if (value < 0) throw ArgumentError('Square root of a negative number');
+      return math.sqrt(value); // Fallback
+    }
+    return _sqrt(_engine!, value);
+  }
+
+  double power(double base, double exponent) {
+    if (!isAvailable) return math.pow(base, exponent).toDouble(); // Fallback
+    return _power(_engine!, base, exponent);
+  }
+
+  double sinh(double value) {
+    if (!isAvailable) return (math.exp(value) - math.exp(-value)) / 2; // Fallback
+    return _sinh(_engine!, value);
+  }
+
+  double cosh(double value) {
+    if (!isAvailable) return (math.exp(value) + math.exp(-value)) / 2; // Fallback
+    return _cosh(_engine!, value);
+  }
+
+  double tanh(double value) {
+    if (!isAvailable) {
+      // Fallback implementation
+      final e = math.exp(-2 * value.abs());
+      final result = (1 - e) / (1 + e);
+      return value < 0 ? -result : result;
+    }
+    return _tanh(_engine!, value);
+  }
+
+  double asinh(double value) {
+    if (!isAvailable) {
+      // Fallback implementation
+      final result = math.log(value.abs() + math.sqrt(value * value + 1));
+      return value < 0 ? -result : result;
+    }
+    return _asinh(_engine!, value);
+  }
+
+  double acosh(double value) {
+    if (!isAvailable) {
+      // Fallback implementation
+      if (value < 1) throw ArgumentError('Domain error: Input must be at least 1');
+      return math.log(value + math.sqrt(value * value - 1));
+    }
+    return _acosh(_engine!, value);
+  }
+
+  double atanh(double value) {
+    if (!isAvailable) {
+      // Fallback implementation
+      if (value <= -1 || value >= 1) {
+        throw ArgumentError('Domain error: Input must be between -1 and 1 (exclusive)');
+      }
+      return 0.5 * math.log((1 + value) / (1 - value));
+    }
+    return _atanh(_engine!, value);
+  }
+
+  // Combinatorics
+  double factorial(double n) {
+    if (!isAvailable) {
+      // Fallback implementation (non-negative integers only)
+      if (n < 0 || n != n.roundToDouble()) {
+        throw ArgumentError('Domain error: Fallback factorial needs a non-negative integer');
+      }
+      double result = 1;
+      for (int i = 2; i <= n && result.isFinite; i++) {
+        result *= i;
+      }
+      return result;
+    }
+    return _factorial(_engine!, n);
+  }
+
+  double gamma(double x) {
+    if (!isAvailable) {
+      throw UnsupportedError('Gamma requires the native library');
+    }
+    return _gamma(_engine!, x);
+  }
+
+  double permutations(double n, double k) {
+    if (!isAvailable) {
+      // Fallback implementation
+      if (n < 0 || k < 0 || n != n.roundToDouble() || k != k.roundToDouble()) {
+        throw ArgumentError('Domain error: nPr needs non-negative integers');
+      }
+      double result = k > n ? 0 : 1;
+      for (int i = 0; i < k && k <= n && result.isFinite; i++) {
+        result *= n - i;
+      }
+      return result;
+    }
+    return _permutations(_engine!, n, k);
+  }
+
+  double combinations(double n, double k) {
+    if (!isAvailable) {
+      // Fallback implementation
+      if (n < 0 || k < 0 || n != n.roundToDouble() || k != k.roundToDouble()) {
+        throw ArgumentError('Domain error: nCr needs non-negative integers');
+      }
+      if (k > n) return 0;
+      final terms = math.min(k, n - k);
+      double result = 1;
+      for (int i = 1; i <= terms && result.isFinite; i++) {
+        result = result * (n - terms + i) / i;
+      }
+      return result;
+    }
+    return _combinations(_engine!, n, k);
+  }
+
   // Memory operations
   void storeInMemory(double value) {
     if (!isAvailable) return;
@@ -288,7 +575,58 @@ class FFICalculatorEngine {
     return _getLastResult(_engine!);
   }
 
+  // Number text from the core formatter, the same as the console and the
+  // desktop GUI print.  digits 0 = shortest round trip; notation 0 general,
+  // 1 scientific, 2 engineering.
+  String formatNumber(double value, {int digits = 0, int notation = 0}) {
+    if (_library == null) {
+      // Fallback implementation
+      return digits > 0 ? value.toStringAsPrecision(math.min(digits, 17)) : value.toString();
+    }
+    const size = 32; // NumberFormat::bufferSize
+    final buffer = malloc<Uint8>(size).cast<Utf8>();
+    try {
+      final length = _formatNumber(value, digits, notation, buffer, size);
+      return buffer.toDartString(length: math.min(length, size - 1));
+    } finally {
+      malloc.free(buffer);
+    }
+  }
+
+  // null when the text is not a number
+  double? parseNumber(String text) {
+    if (_library == null) {
+      // Fallback implementation
+      return double.tryParse(text.trim());
+    }
+    final native = text.toNativeUtf8();
+    final value = malloc<Double>();
+    try {
+      return _parseNumber(native, value) ? value.value : null;
+    } finally {
+      malloc.free(native);
+      malloc.free(value);
+    }
+  }
+
+  // All UI state without crossing the FFI boundary: copy the mirrored block
+  // and retry while the engine is mid-update (seqlock read side)
+  CalculatorState readState() {
+    if (!isAvailable || _state == null) {
+      return const CalculatorState(CalculatorState.degreesFlag, 0, 0.0, 0.0, 0);
+    }
+    final block = _state!.ref;
+    while (true) {
+      final before = block.sequence;
+      if (before.isOdd) continue;
+      final state = CalculatorState(
+          block.flags, block.errors, block.lastResult, block.memoryValue, block.updateCount);
+      if (block.sequence == before) return state;
+    }
+  }
+
   void dispose() {
+    _state = null;
     if (_engine != null) {
       _destroyEngine(_engine!);
       _engine = null;
@@ -0,0 +1,217 @@
+// Stand-in for the Flutter side of the asynchronous FFI: producer threads
+// submit requests through the C ABI the way Dart isolates would, and the
+// completions arrive both through the C callback and through a fake
+// NativeApi.postCObject that decodes the Dart_CObject message.  Every
+// result is checked against a synchronous engine, then throughput, batch
+// sizes and completion latency are reported.
+// Build: g++ -O2 -std=c++17 -pthread -I./core tools/async_ffi_stub.cpp mobile/cpp/calculator_ffi.cpp mobile/cpp/AsyncCalculator.cpp core/*.cpp -o async_ffi_stub
+// Usage: async_ffi_stub [--producers N] [--requests N] [--batch N]
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../mobile/cpp/AsyncCalculator.h"
+
+using namespace std;
+
+extern "C" {
+    CalculatorEngine* create_calculator_engine();
+    void destroy_calculator_engine(CalculatorEngine* engine);
+    AsyncCalculator* calculator_async_create(CalculatorEngine* engine);
+    void calculator_async_destroy(AsyncCalculator* async);
+    void calculator_async_set_callback(AsyncCalculator* async, CalculatorCompletionCallback callback, void* userData);
+    void calculator_async_init_dart_api(void* postCObject);
+    void calculator_async_set_dart_port(AsyncCalculator* async, int64_t port);
+    bool calculator_async_submit(AsyncCalculator* async, uint64_t id, int32_t operation, double a, double b);
+    int32_t calculator_async_submit_batch(AsyncCalculator* async, const CalculatorRequest* requests, int32_t count);
+}
+
+// Only the Dart_CObject variants AsyncCalculator posts
+struct StubCObject {
+    int32_t type;
+    union {
+        int64_t asInt64;
+        double asDouble;
+        struct {
+            intptr_t length;
+            StubCObject** values;
+        } asArray;
+    } value;
+};
+
+const int64_t stubPort = 42;
+const int operations[] = {AsyncAdd, AsyncSubtract, AsyncMultiply, AsyncDivide,
+                          AsyncSine, AsyncCosine, AsyncArctangent};
+const int operationCount = sizeof(operations) / sizeof(operations[0]);
+
+struct Collector {
+    vector<CalculatorCompletion> completions;   // indexed by request id
+    vector<int64_t> submitTimes;                // ns since start
+    vector<int64_t> completeTimes;
+    vector<uint32_t> batchSizes;
+    atomic<uint64_t> received;
+    atomic<uint64_t> portReceived;
+    atomic<bool> portValid;
+    chrono::steady_clock::time_point start;
+    mutex portLock;
+};
+
+Collector* collector = nullptr;
+
+int64_t nowNs() {
+    return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - collector->start).count();
+}
+
+void onCompletions(const CalculatorCompletion* completions, int32_t count, void* userData) {
+    Collector* c = static_cast<Collector*>(userData);
+    int64_t now = nowNs();
+    for (int32_t i = 0; i < count; i++) {
+        c->completions[completions[i].id] = completions[i];
+        c->completeTimes[completions[i].id] = now;
+    }
+    c->batchSizes.push_back(uint32_t(count));
+    c->received.fetch_add(count, memory_order_release);
+}
+
+// Checks the message shape a Dart ReceivePort would see
+bool fakePostCObject(int64_t port, void* message) {
+    StubCObject* array = static_cast<StubCObject*>(message);
+    bool valid = port == stubPort && array->type == 6 && array->value.asArray.length % 3 == 0;
+    intptr_t items = valid ? array->value.asArray.length / 3 : 0;
+    for (intptr_t i = 0; valid && i < items; i++) {
+        StubCObject** values = array->value.asArray.values + 3 * i;
+        uint64_t id = uint64_t(values[0]->value.asInt64);
+        valid = values[0]->type == 3 && values[1]->type == 4 && values[2]->type == 3 &&
+                id < collector->completions.size() &&
+                memcmp(&values[1]->value.asDouble, &collector->completions[id].result, sizeof(double)) == 0;
+    }
+    if (!valid) {
+        collector->portValid.store(false);
+    }
+    collector->portReceived.fetch_add(items, memory_order_relaxed);
+    return true;
+}
+
+void produce(AsyncCalculator* async, int producer, int producers, size_t total, size_t batch) {
+    vector<CalculatorRequest> pending;
+    for (size_t id = producer; id < total; id += producers) {
+        CalculatorRequest request;
+        request.id = id;
+        request.operation = operations[id % operationCount];
+        request.reserved = 0;
+        request.a = double(id % 1000) * 0.37 + 1;
+        request.b = double(id % 97) + 1;
+        pending.push_back(request);
+        if (pending.size() < batch && id + producers < total) {
+            continue;
+        }
+        int64_t now = nowNs();
+        for (const CalculatorRequest& r : pending) {
+            collector->submitTimes[r.id] = now;
+        }
+        size_t sent = 0;
+        while (sent < pending.size()) {
+            if (batch == 1) {
+                const CalculatorRequest& r = pending[sent];
+                sent += calculator_async_submit(async, r.id, r.operation, r.a, r.b) ? 1 : 0;
+            } else {
+                sent += calculator_async_submit_batch(async, pending.data() + sent, int32_t(pending.size() - sent));
+            }
+            if (sent < pending.size()) {
+                this_thread::yield();   // queue full
+            }
+        }
+        pending.clear();
+    }
+}
+
+int main(int argc, char* argv[]) {
+    int producers = 4;
+    size_t total = 1000000;
+    size_t batch = 1;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--producers" && i + 1 < argc) {
+            producers = max(1, atoi(argv[++i]));
+        } else if (arg == "--requests" && i + 1 < argc) {
+            total = size_t(max(1L, atol(argv[++i])));
+        } else if (arg == "--batch" && i + 1 < argc) {
+            batch = size_t(max(1, atoi(argv[++i])));
+        }
+    }
+
+    Collector c;
+    c.completions.resize(total);
+    c.submitTimes.resize(total);
+    c.completeTimes.resize(total);
+    c.received.store(0);
+    c.portReceived.store(0);
+    c.portValid.store(true);
+    c.start = chrono::steady_clock::now();
+    collector = &c;
+
+    CalculatorEngine* engine = create_calculator_engine();
+    AsyncCalculator* async = calculator_async_create(engine);
+    calculator_async_set_callback(async, onCompletions, &c);
+    calculator_async_init_dart_api(reinterpret_cast<void*>(&fakePostCObject));
+    calculator_async_set_dart_port(async, stubPort);
+
+    auto start = chrono::steady_clock::now();
+    vector<thread> pool;
+    for (int p = 0; p < producers; p++) {
+        pool.emplace_back(produce, async, p, producers, total, batch);
+    }
+    for (auto& producer : pool) {
+        producer.join();
+    }
+    while (c.received.load(memory_order_acquire) < total) {
+        this_thread::yield();
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    calculator_async_destroy(async);
+    destroy_calculator_engine(engine);
+
+    // Same requests on a synchronous engine
+    CalculatorEngine reference;
+    static const char basic[] = {'+', '-', '*', '/'};
+    static const char* const trig[] = {"sin", "cos", "tan", "asin", "acos", "atan"};
+    size_t mismatches = 0;
+    for (size_t id = 0; id < total; id++) {
+        int operation = operations[id % operationCount];
+        double a = double(id % 1000) * 0.37 + 1;
+        double b = double(id % 97) + 1;
+        double expected = operation <= AsyncDivide
+            ? reference.performBasicOperation(a, b, basic[operation])
+            : reference.performTrigOperation(trig[operation - AsyncSine], a);
+        const CalculatorCompletion& got = c.completions[id];
+        if (got.id != id || got.status != AsyncOk || memcmp(&got.result, &expected, sizeof(double)) != 0) {
+            mismatches++;
+        }
+    }
+
+    vector<int64_t> latencies(total);
+    for (size_t id = 0; id < total; id++) {
+        latencies[id] = c.completeTimes[id] - c.submitTimes[id];
+    }
+    sort(latencies.begin(), latencies.end());
+    uint64_t largest = *max_element(c.batchSizes.begin(), c.batchSizes.end());
+
+    cout << "Producers:      " << producers << " (submit batch " << batch << ")" << endl;
+    cout << "Requests:       " << total << " in " << seconds * 1000 << " ms ("
+         << total / seconds / 1e6 << " M/s)" << endl;
+    cout << "Deliveries:     " << c.batchSizes.size() << " (mean batch "
+         << double(total) / c.batchSizes.size() << ", max " << largest << ")" << endl;
+    cout << "Latency:        p50 " << latencies[total / 2] << " ns, p99 "
+         << latencies[total * 99 / 100] << " ns" << endl;
+    cout << "Port messages:  " << c.portReceived.load() << " results, "
+         << (c.portValid.load() ? "well-formed" : "MALFORMED") << endl;
+    cout << "Mismatches:     " << mismatches << endl;
+    return (mismatches == 0 && c.portValid.load() && c.portReceived.load() == total) ? 0 : 2;
+}
@@ -0,0 +1,178 @@
+// Replays a workload trace recorded with CalculatorEngine::startRecording
+// (console: --record <file>) and reports throughput, latency percentiles
+// and a checksum of the results.  A checksum that differs from the
+// recorded one means the engine's behaviour changed.  Every pass begins
+// with the trace's leading angle mode and memory records, which restore the
+// recorded engine's state before the first operation.
+// Build: g++ -O2 -std=c++17 -pthread -I./core tools/calc_replay.cpp core/*.cpp -o calc_replay
+// Usage: calc_replay <trace> [--paced] [--threads N] [--repeat N]
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../core/CalculatorEngine.h"
+#include "../core/WorkloadTrace.h"
+
+using namespace std;
+
+struct ReplayResult {
+    vector<uint32_t> latencies;   // nanoseconds per event
+    uint64_t checksum;
+    uint64_t mismatches;
+    double seconds;
+};
+
+// FNV-1a over the bit patterns of the results
+void mix(uint64_t& hash, double value) {
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    for (int i = 0; i < 8; i++) {
+        hash ^= (bits >> (8 * i)) & 0xff;
+        hash *= 0x100000001b3ULL;
+    }
+}
+
+uint64_t recordedChecksum(const vector<WorkloadEvent>& events) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (const WorkloadEvent& event : events) {
+        if (WorkloadTrace::hasResult(event.kind)) {
+            mix(hash, event.result);
+        }
+    }
+    return hash;
+}
+
+void replay(const vector<WorkloadEvent>& events, bool paced, int repeat, ReplayResult& out) {
+    CalculatorEngine engine;
+    out.latencies.reserve(events.size() * repeat);
+    out.checksum = 0xcbf29ce484222325ULL;
+    out.mismatches = 0;
+
+    auto start = chrono::steady_clock::now();
+    for (int pass = 0; pass < repeat; pass++) {
+        auto passStart = chrono::steady_clock::now();
+        for (const WorkloadEvent& event : events) {
+            if (paced) {
+                auto due = passStart + chrono::nanoseconds(event.timeNanoseconds);
+                auto now = chrono::steady_clock::now();
+                if (due - now > chrono::microseconds(200)) {
+                    this_thread::sleep_until(due - chrono::microseconds(100));
+                }
+                while (chrono::steady_clock::now() < due) {
+                }
+            }
+
+            auto before = chrono::steady_clock::now();
+            double result = 0;
+            switch (event.kind) {
+                case WorkloadKind::Basic:
+                    result = engine.performBasicOperation(event.a, event.b, char(event.code));
+                    break;
+                case WorkloadKind::Trig:
+                    result = engine.performTrigOperation(WorkloadTrace::trigFunctions[event.code % 6], event.a);
+                    break;
+                case WorkloadKind::MemoryStore:
+                    engine.storeInMemory(event.a);
+                    break;
+                case WorkloadKind::MemoryRecall:
+                    result = engine.recallFromMemory();
+                    break;
+                case WorkloadKind::MemoryClear:
+                    engine.clearMemory();
+                    break;
+                case WorkloadKind::SetAngleMode:
+                    engine.setAngleMode(event.code != 0);
+                    break;
+            }
+            auto after = chrono::steady_clock::now();
+            out.latencies.push_back(uint32_t(min<int64_t>(
+                chrono::duration_cast<chrono::nanoseconds>(after - before).count(), UINT32_MAX)));
+
+            if (WorkloadTrace::hasResult(event.kind)) {
+                if (pass == 0) {
+                    mix(out.checksum, result);
+                }
+                if (memcmp(&result, &event.result, sizeof(double)) != 0) {
+                    out.mismatches++;
+                }
+            }
+        }
+    }
+    out.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        cout << "Usage: " << argv[0] << " <trace> [--paced] [--threads N] [--repeat N]" << endl;
+        return 1;
+    }
+    bool paced = false;
+    int threads = 1;
+    int repeat = 1;
+    for (int i = 2; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--paced") {
+            paced = true;
+        } else if (arg == "--threads" && i + 1 < argc) {
+            threads = max(1, atoi(argv[++i]));
+        } else if (arg == "--repeat" && i + 1 < argc) {
+            repeat = max(1, atoi(argv[++i]));
+        }
+    }
+
+    vector<WorkloadEvent> events;
+    if (!WorkloadTrace::load(argv[1], events)) {
+        return 1;
+    }
+
+    // The engine reports errors and mode changes on cout; keep the
+    // replay quiet
+    streambuf* console = cout.rdbuf(nullptr);
+    vector<ReplayResult> results(threads);
+    vector<thread> pool;
+    auto start = chrono::steady_clock::now();
+    for (int t = 0; t < threads; t++) {
+        pool.emplace_back(replay, cref(events), paced, repeat, ref(results[t]));
+    }
+    for (auto& worker : pool) {
+        worker.join();
+    }
+    double wall = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cout.rdbuf(console);
+    cout.clear();
+
+    vector<uint32_t> latencies;
+    uint64_t mismatches = 0;
+    bool consistent = true;
+    for (const ReplayResult& result : results) {
+        latencies.insert(latencies.end(), result.latencies.begin(), result.latencies.end());
+        mismatches += result.mismatches;
+        consistent = consistent && result.checksum == results[0].checksum;
+    }
+    sort(latencies.begin(), latencies.end());
+    auto percentile = [&](double p) {
+        if (latencies.empty()) {
+            return uint32_t(0);
+        }
+        return latencies[min(latencies.size() - 1, size_t(p / 100.0 * latencies.size()))];
+    };
+
+    uint64_t total = uint64_t(events.size()) * repeat * threads;
+    cout << "Events:      " << events.size() << " x " << repeat << " pass(es) x " << threads
+         << " thread(s)" << (paced ? ", paced" : "") << endl;
+    cout << "Throughput:  " << total / wall / 1e6 << " M events/s (" << wall << " s)" << endl;
+    cout << "Latency ns:  p50 " << percentile(50) << "  p90 " << percentile(90) << "  p99 " << percentile(99)
+         << "  p99.9 " << percentile(99.9) << "  max " << (latencies.empty() ? 0 : latencies.back()) << endl;
+    cout << hex << setfill('0');
+    cout << "Checksum:    " << setw(16) << results[0].checksum
+         << (consistent ? "" : " (threads disagree!)") << endl;
+    cout << "Recorded:    " << setw(16) << recordedChecksum(events) << endl;
+    cout << dec << "Mismatches:  " << mismatches << endl;
+    return mismatches == 0 && consistent ? 0 : 2;
+}
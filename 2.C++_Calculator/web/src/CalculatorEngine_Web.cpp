@@ -1,6 +1,11 @@
 #include "../../../core/CalculatorEngine.h"
 #include "../../../core/Memory.h"
 #include "../../../core/TrigCalculator.h"
+#include "../../../core/EngineStats.h"
+#include "../../../core/NumberFormat.h"
+#include <cmath>
+#include <string>
+#include <vector>
 
 #ifdef EMSCRIPTEN
 #include <emscripten/bind.h>
@@ -63,6 +68,130 @@ public:
         return engine->performTrigOperation("atan", value);
     }
     
+    // [sine, cosine]
+    std::vector<double> sincos(double angle) {
+        std::vector<double> out(2);
+        engine->performSineCosine(angle, out[0], out[1]);
+        return out;
+    }
+    
+    // Exponential, logarithmic and hyperbolic operations
+    double exp(double value) {
+        return engine->performScientificOperation("exp", value);
+    }
+    
+    double ln(double value) {
+        return engine->performScientificOperation("ln", value);
+    }
+    
+    double log10(double value) {
+        return engine->performScientificOperation("log10", value);
+    }
+    
+    double sqrt(double value) {
+        return engine->performScientificOperation("sqrt", value);
+    }
+    
+    double sinh(double value) {
+        return engine->performScientificOperation("sinh", value);
+    }
+    
+    double cosh(double value) {
+        return engine->performScientificOperation("cosh", value);
+    }
+    
+    double tanh(double value) {
+        return engine->performScientificOperation("tanh", value);
+    }
+    
+    double asinh(double value) {
+        return engine->performScientificOperation("asinh", value);
+    }
+    
+    double acosh(double value) {
+        return engine->performScientificOperation("acosh", value);
+    }
+    
+    double atanh(double value) {
+        return engine->performScientificOperation("atanh", value);
+    }
+    
+    double power(double base, double exponent) {
+        return engine->power(base, exponent);
+    }
+    
+    double factorial(double n) {
+        return engine->factorial(n);
+    }
+    
+    double gamma(double x) {
+        return engine->gamma(x);
+    }
+    
+    double permutations(double n, double k) {
+        return engine->permutations(n, k);
+    }
+    
+    double combinations(double n, double k) {
+        return engine->combinations(n, k);
+    }
+    
+    // Every digit of C(n, k); empty above the exact limit
+    std::string exactCombinations(double n, double k) {
+        if (!Combinatorics::isNonNegativeInteger(n) || !Combinatorics::isNonNegativeInteger(k)) return "";
+        return engine->exactCombinations(uint64_t(n), uint64_t(k));
+    }
+    
+    // Batches; domain errors give 0.  Unknown functions return an empty array.
+    std::vector<double> scientificArray(const std::string& function, const std::vector<double>& values) {
+        if (!engine->isValidScientificFunction(function)) return std::vector<double>();
+        std::vector<double> out(values.size());
+        engine->performScientificOperation(function, values.data(), out.data(), values.size());
+        return out;
+    }
+    
+    std::vector<double> powerArray(const std::vector<double>& bases, const std::vector<double>& exponents) {
+        std::vector<double> out(std::min(bases.size(), exponents.size()));
+        engine->performPowerOperation(bases.data(), exponents.data(), out.data(), out.size());
+        return out;
+    }
+    
+    // The pair batches return both outputs in one array: all sines, then
+    // all cosines (x then y, magnitude then angle for the conversions).
+    std::vector<double> sincosArray(const std::vector<double>& angles) {
+        size_t count = angles.size();
+        std::vector<double> out(2 * count);
+        engine->performSineCosine(angles.data(), out.data(), out.data() + count, count);
+        return out;
+    }
+    
+    std::vector<double> polarToRectangularArray(const std::vector<double>& magnitudes, const std::vector<double>& angles) {
+        size_t count = std::min(magnitudes.size(), angles.size());
+        std::vector<double> out(2 * count);
+        engine->polarToRectangular(magnitudes.data(), angles.data(), out.data(), out.data() + count, count);
+        return out;
+    }
+    
+    std::vector<double> rectangularToPolarArray(const std::vector<double>& xs, const std::vector<double>& ys) {
+        size_t count = std::min(xs.size(), ys.size());
+        std::vector<double> out(2 * count);
+        engine->rectangularToPolar(xs.data(), ys.data(), out.data(), out.data() + count, count);
+        return out;
+    }
+    
+    // Text matching the native front ends: digits 0 = shortest round trip;
+    // notation 0 general, 1 scientific, 2 engineering
+    std::string formatNumber(double value, int digits, int notation) {
+        if (notation < 0 || notation > 2) notation = 0;
+        return NumberFormat::toString(value, digits, Notation(notation));
+    }
+    
+    // NaN when the text is not a number
+    double parseNumber(const std::string& text) {
+        double value;
+        return NumberFormat::parse(text, value) ? value : NAN;
+    }
+    
     // Memory operations
     void storeInMemory(double value) {
         engine->storeInMemory(value);
@@ -92,11 +221,36 @@ public:
     double getLastResult() {
         return engine->getLastResult();
     }
+    
+    // Instrumentation
+    void setStatsEnabled(bool enabled) {
+        EngineStats::setEnabled(enabled);
+    }
+    
+    void resetStats() {
+        EngineStats::reset();
+    }
+    
+    std::string getStatsReport() {
+        return EngineStats::snapshot().toString();
+    }
+    
+    double getCallCount(int operation) {
+        if (operation < 0 || operation >= EngineStats::OperationCount) return 0;
+        return double(EngineStats::snapshot().calls[operation]);
+    }
+    
+    double getErrorCount(int error) {
+        if (error < 0 || error >= EngineStats::ErrorCount) return 0;
+        return double(EngineStats::snapshot().errors[error]);
+    }
 };
 
 #ifdef EMSCRIPTEN
 // Emscripten bindings for WebAssembly
 EMSCRIPTEN_BINDINGS(calculator_module) {
+    emscripten::register_vector<double>("VectorDouble");
+    
     emscripten::class_<WebCalculatorEngine>("WebCalculatorEngine")
         .constructor()
         
@@ -113,6 +267,34 @@ EMSCRIPTEN_BINDINGS(calculator_module) {
         .function("arcsine", &WebCalculatorEngine::arcsine)
         .function("arccosine", &WebCalculatorEngine::arccosine)
         .function("arctangent", &WebCalculatorEngine::arctangent)
+        .function("sincos", &WebCalculatorEngine::sincos)
+        
+        // Exponential, logarithmic and hyperbolic operations
+        .function("exp", &WebCalculatorEngine::exp)
+        .function("ln", &WebCalculatorEngine::ln)
+        .function("log10", &WebCalculatorEngine::log10)
+        .function("sqrt", &WebCalculatorEngine::sqrt)
+        .function("sinh", &WebCalculatorEngine::sinh)
+        .function("cosh", &WebCalculatorEngine::cosh)
+        .function("tanh", &WebCalculatorEngine::tanh)
+        .function("asinh", &WebCalculatorEngine::asinh)
+        .function("acosh", &WebCalculatorEngine::acosh)
+        .function("atanh", &WebCalculatorEngine::atanh)
+        .function("power", &WebCalculatorEngine::power)
+        .function("factorial", &WebCalculatorEngine::factorial)
+        .function("gamma", &WebCalculatorEngine::gamma)
+        .function("permutations", &WebCalculatorEngine::permutations)
+        .function("combinations", &WebCalculatorEngine::combinations)
+        .function("exactCombinations", &WebCalculatorEngine::exactCombinations)
+        .function("scientificArray", &WebCalculatorEngine::scientificArray)
+        .function("powerArray", &WebCalculatorEngine::powerArray)
+        .function("sincosArray", &WebCalculatorEngine::sincosArray)
+        .function("polarToRectangularArray", &WebCalculatorEngine::polarToRectangularArray)
+        .function("rectangularToPolarArray", &WebCalculatorEngine::rectangularToPolarArray)
+        
+        // Number text
+        .function("formatNumber", &WebCalculatorEngine::formatNumber)
+        .function("parseNumber", &WebCalculatorEngine::parseNumber)
         
         // Memory operations
         .function("storeInMemory", &WebCalculatorEngine::storeInMemory)
@@ -123,6 +305,13 @@ EMSCRIPTEN_BINDINGS(calculator_module) {
         // Mode operations
         .function("setAngleMode", &WebCalculatorEngine::setAngleMode)
         .function("getAngleMode", &WebCalculatorEngine::getAngleMode)
-        .function("getLastResult", &WebCalculatorEngine::getLastResult);
+        .function("getLastResult", &WebCalculatorEngine::getLastResult)
+        
+        // Instrumentation
+        .function("setStatsEnabled", &WebCalculatorEngine::setStatsEnabled)
+        .function("resetStats", &WebCalculatorEngine::resetStats)
+        .function("getStatsReport", &WebCalculatorEngine::getStatsReport)
+        .function("getCallCount", &WebCalculatorEngine::getCallCount)
+        .function("getErrorCount", &WebCalculatorEngine::getErrorCount);
 }
 #endif
\ No newline at end of file
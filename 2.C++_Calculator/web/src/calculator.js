@@ -69,7 +69,8 @@ class WebCalculator {
             'btn-add': '+',
             'btn-subtract': '-',
             'btn-multiply': '*',
-            'btn-divide': '/'
+            'btn-divide': '/',
+            'btn-power': '^'
         };
         
         Object.entries(operations).forEach(([id, op]) => {
@@ -108,6 +109,27 @@ class WebCalculator {
             }
         });
         
+        // Exponential, logarithmic and hyperbolic buttons
+        const scientificFunctions = {
+            'btn-exp': 'exp',
+            'btn-ln': 'ln',
+            'btn-log10': 'log10',
+            'btn-sqrt': 'sqrt',
+            'btn-sinh': 'sinh',
+            'btn-cosh': 'cosh',
+            'btn-tanh': 'tanh',
+            'btn-asinh': 'asinh',
+            'btn-acosh': 'acosh',
+            'btn-atanh': 'atanh'
+        };
+        
+        Object.entries(scientificFunctions).forEach(([id, func]) => {
+            const button = document.getElementById(id);
+            if (button) {
+                button.addEventListener('click', () => this.onScientificFunctionClick(func));
+            }
+        });
+        
         // Mode toggle
         document.getElementById('btn-deg-rad')?.addEventListener('click', () => this.onModeToggle());
         
@@ -273,6 +295,41 @@ class WebCalculator {
         }
     }
     
+    // Exponential, logarithmic and hyperbolic operations
+    onScientificFunctionClick(functionName) {
+        const inputValue = parseFloat(this.currentInput);
+        const domains = {
+            'ln': [inputValue > 0, 'Domain error: Input must be positive'],
+            'log10': [inputValue > 0, 'Domain error: Input must be positive'],
+            'sqrt': [inputValue >= 0, 'Square root of a negative number'],
+            'acosh': [inputValue >= 1, 'Domain error: Input must be at least 1'],
+            'atanh': [inputValue > -1 && inputValue < 1, 'Domain error: Input must be between -1 and 1 (exclusive)']
+        };
+        const domain = domains[functionName];
+        if (domain && !domain[0]) {
+            this.showToast(domain[1]);
+            return;
+        }
+        
+        try {
+            const fallback = {
+                'exp': Math.exp, 'ln': Math.log, 'log10': Math.log10, 'sqrt': Math.sqrt,
+                'sinh': Math.sinh, 'cosh': Math.cosh, 'tanh': Math.tanh,
+                'asinh': Math.asinh, 'acosh': Math.acosh, 'atanh': Math.atanh
+            };
+            const result = this.engine ? this.engine[functionName](inputValue) : fallback[functionName](inputValue);
+            
+            this.currentInput = String(result);
+            this.lastResult = result;
+            this.waitingForOperand = true;
+            this.updateDisplay();
+            
+        } catch (error) {
+            console.error('Scientific calculation error:', error);
+            this.showToast('Calculation error');
+        }
+    }
+    
     onModeToggle() {
         this.isDegreesMode = !this.isDegreesMode;
         if (this.engine) {
@@ -299,6 +356,7 @@ class WebCalculator {
                         return firstValue;
                     }
                     return firstValue / secondValue;
+                case '^': return Math.pow(firstValue, secondValue);
                 default: return secondValue;
             }
         }
@@ -309,6 +367,7 @@ class WebCalculator {
             case '-': return this.engine.subtract(firstValue, secondValue);
             case '*': return this.engine.multiply(firstValue, secondValue);
             case '/': return this.engine.divide(firstValue, secondValue);
+            case '^': return this.engine.power(firstValue, secondValue);
             default: return secondValue;
         }
     }
@@ -351,6 +410,7 @@ class WebCalculator {
         else if (key === '-') this.onOperationClick('-');
         else if (key === '*') this.onOperationClick('*');
         else if (key === '/') this.onOperationClick('/');
+        else if (key === '^') this.onOperationClick('^');
         else if (key === '.' || key === ',') this.onDecimalClick();
         else if (key === 'Enter' || key === '=') this.onEqualsClick();
         else if (key === 'Escape') this.onClearClick();
@@ -405,6 +465,19 @@ class JavaScriptCalculatorEngine {
         if (b === 0) throw new Error('Division by zero');
         return a / b; 
     }
+    power(base, exponent) { return Math.pow(base, exponent); }
+    
+    // Exponential, logarithmic and hyperbolic operations
+    exp(value) { return Math.exp(value); }
+    ln(value) { return Math.log(value); }
+    log10(value) { return Math.log10(value); }
+    sqrt(value) { return Math.sqrt(value); }
+    sinh(value) { return Math.sinh(value); }
+    cosh(value) { return Math.cosh(value); }
+    tanh(value) { return Math.tanh(value); }
+    asinh(value) { return Math.asinh(value); }
+    acosh(value) { return Math.acosh(value); }
+    atanh(value) { return Math.atanh(value); }
     
     // Trigonometric operations
     sine(angle) {
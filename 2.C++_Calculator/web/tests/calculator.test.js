@@ -0,0 +1,137 @@
+/**
+ * Click-through test for the web calculator with the JavaScript engine.
+ * Builds a minimal DOM from the ids in index.html, so a button that is not
+ * wired up (or wired to a missing handler) fails here.
+ *
+ * Run: node web/tests/calculator.test.js
+ */
+
+const assert = require('assert');
+const fs = require('fs');
+const path = require('path');
+
+class StubElement {
+    constructor(id) {
+        this.id = id;
+        this.listeners = {};
+        this.style = {};
+        this.textContent = '';
+        this.className = '';
+    }
+
+    addEventListener(type, listener) {
+        (this.listeners[type] = this.listeners[type] || []).push(listener);
+    }
+
+    click() {
+        (this.listeners.click || []).forEach((listener) => listener());
+    }
+
+    appendChild() {}
+    removeChild() {}
+}
+
+const html = fs.readFileSync(path.join(__dirname, '..', 'index.html'), 'utf8');
+const elements = {};
+for (const match of html.matchAll(/id="([^"]+)"/g)) {
+    elements[match[1]] = new StubElement(match[1]);
+}
+
+const toasts = [];
+global.document = {
+    head: new StubElement('head'),
+    body: new StubElement('body'),
+    getElementById: (id) => elements[id] || null,
+    createElement: () => new StubElement(''),
+    addEventListener: () => {}
+};
+global.setTimeout = () => {};
+
+const { WebCalculator } = require('../src/calculator.js');
+
+function newCalculator() {
+    const calculator = new WebCalculator();
+    calculator.showToast = (message) => toasts.push(message);
+    calculator.initializeEngine();
+    return calculator;
+}
+
+function press(...ids) {
+    ids.forEach((id) => elements[id].click());
+}
+
+function displayed() {
+    return parseFloat(elements.display.textContent);
+}
+
+// Listeners accumulate across calculators, so each case clears the elements
+function reset() {
+    Object.values(elements).forEach((element) => { element.listeners = {}; });
+    toasts.length = 0;
+    return newCalculator();
+}
+
+let failures = 0;
+function check(name, body) {
+    try {
+        body();
+        console.log(`ok   ${name}`);
+    } catch (error) {
+        failures++;
+        console.log(`FAIL ${name}: ${error.message}`);
+    }
+}
+
+check('exp button', () => {
+    reset();
+    press('btn-2', 'btn-exp');
+    assert.ok(Math.abs(displayed() - Math.exp(2)) < 1e-5);
+});
+
+check('ln, log10 and sqrt buttons', () => {
+    reset();
+    press('btn-1', 'btn-0', 'btn-0', 'btn-log10');
+    assert.strictEqual(displayed(), 2);
+    press('btn-c', 'btn-1', 'btn-6', 'btn-sqrt');
+    assert.strictEqual(displayed(), 4);
+    press('btn-c', 'btn-1', 'btn-ln');
+    assert.strictEqual(displayed(), 0);
+});
+
+check('hyperbolic buttons', () => {
+    reset();
+    for (const name of ['sinh', 'cosh', 'tanh', 'asinh', 'acosh', 'atanh']) {
+        press('btn-c', 'btn-0', 'btn-decimal', 'btn-5', `btn-${name}`);
+        if (name === 'acosh') {
+            assert.deepStrictEqual(toasts, ['Domain error: Input must be at least 1']);
+        } else {
+            // The display rounds long results to seven significant digits
+            assert.ok(Math.abs(displayed() - Math[name](0.5)) < 1e-6, name);
+        }
+    }
+});
+
+check('domain errors leave the display alone', () => {
+    reset();
+    press('btn-0', 'btn-ln');
+    assert.strictEqual(displayed(), 0);
+    assert.deepStrictEqual(toasts, ['Domain error: Input must be positive']);
+});
+
+check('power button', () => {
+    reset();
+    press('btn-2', 'btn-power', 'btn-1', 'btn-0', 'btn-equals');
+    assert.strictEqual(displayed(), 1024);
+});
+
+check('power chained with another operator', () => {
+    reset();
+    press('btn-3', 'btn-power', 'btn-2', 'btn-add', 'btn-1', 'btn-equals');
+    assert.strictEqual(displayed(), 10);
+});
+
+if (failures > 0) {
+    console.log(`${failures} failed`);
+    process.exit(1);
+}
+console.log('all passed');